@@ -1,29 +1,51 @@
 #ifndef AD_INPUT_H
 #define AD_INPUT_H
 
+#include "hot_path.h"
 #include <Arduino.h>
 
 /**
- * @brief AD変換値をチャンネルごとに管理するクラス
+ * @brief AD変換値をチャンネルごとに管理するクラスの共通部
  *
  * リングバッファを用いた移動平均処理と、物理量への変換機能を提供します。
+ * 移動平均バッファは派生クラスが持ちます。
+ * - ADInputChannel<N>: N (2のべき乗) をコンパイル時に固定した静的配列。
+ *   折り返しはマスク、平均はシフトで計算します。
+ * - ADInputChannelDynamic: サイズを実行時に指定 (2のべき乗以外も可)。
+ *   バッファは new で確保し、折り返しと平均は除算で計算します。
+ * どちらもバッファが埋まるまでは、それまでのサンプルの平均を返します。
+ * 値は 16bit 基準 (0〜65535, 12bit の変換値の16倍) で扱います。
+ *
+ * DMA で取得したサンプルは、2^decimationShift 個の合計を1サンプルに
+ * 間引いてから (ボックスカー + 間引き) リングバッファに格納します。
+ * ノイズがディザとして働くため、オーバーサンプリング 4^n 倍で
+ * 実効分解能が n bit 増えます (64倍で 12bit → 15bit)。
+ *
+ * 平滑化は移動平均 (既定) または One-Euro フィルタを選択できます。
+ * One-Euro フィルタは1次ローパスの遮断周波数を信号の速度に応じて
+ * 上げるため、静止時はノイズを抑え、急な踏み込みでは遅れを減らします。
+ * 係数は setOneEuro() で Q16 固定小数点に変換し、サンプルごとの演算は
+ * 整数のみで行います。
+ *
+ * ## クラス構成
+ * - ADInputChannelBase: DMAADCSampler が扱う共通のインターフェースと、
+ *   間引き・One-Euro フィルタ・変換関数の状態。仮想関数の呼び出しは
+ *   ブロック (putSamples()) または読み出し (getFiltered()) ごとの1回です。
+ * - ADInputChannelImpl<Derived>: サンプルごとの処理 (間引き → 移動平均)。
+ *   移動平均バッファの操作は派生クラスの関数を静的に呼び出す (CRTP) ため、
+ *   呼び出し元へ展開されます。
  */
-class ADInputChannel {
+class ADInputChannelBase {
 public:
   /**
-   * @brief コンストラクタ
-   * @param pin ピン番号
-   * @param bufferSize 移動平均バッファサイズ
-   * @param transform
-   * 物理量への変換関数ポインタ（デフォルトはそのままの値を返す）
+   * @brief 平滑化フィルタの種類
    */
-  ADInputChannel(uint8_t pin, uint16_t bufferSize,
-                 int (*transform)(int) = nullptr);
+  enum FilterMode : uint8_t {
+    FILTER_AVERAGE, ///< 移動平均 (バッファサイズ分のサンプル)
+    FILTER_ONE_EURO ///< 速度適応ローパス (One-Euro フィルタ)
+  };
 
-  /**
-   * @brief デストラクタ（バッファの解放）
-   */
-  ~ADInputChannel();
+  virtual ~ADInputChannelBase() = default;
 
   /**
    * @brief 初期化（ピンモード設定、バッファクリア）
@@ -34,29 +56,340 @@ public:
    * @brief AD変換値を取得し、リングバッファに格納する
    * 同期性を優先するため、このメソッドでは変換処理は行いません。
    */
-  void getadc();
+  virtual void getadc() = 0;
 
   /**
-   * @brief 移動平均を計算し、物理量に変換した値を返す
-   * @return 物理量に変換された値。サンプル数が不足している場合は0。
+   * @brief DMA で取得済みの AD 変換値をまとめてリングバッファに格納する
+   *
+   * DMAADCSampler::read() から呼ばれます。サンプルは 12bit で、
+   * 2^decimationShift 個ごとの合計を 16bit 基準に揃えて格納します
+   * (端数のサンプルは次回の呼び出しへ持ち越します)。
+   *
+   * @param samples 先頭サンプル (複数チャンネルが交互に並ぶ)
+   * @param count 格納するサンプル数
+   * @param stride 同じチャンネルのサンプルの間隔
+   */
+  virtual void putSamples(const volatile uint16_t *samples, uint16_t count,
+                          uint8_t stride) = 0;
+
+  /**
+   * @brief One-Euro フィルタの設定と有効化
+   *
+   * 遮断周波数 fc = minCutoffHz + beta × |速度| (速度は 16bit 基準の値/s)。
+   * 内部では 1サンプルあたりの角周波数 w = 2π fc / fs として扱い、
+   * 係数 α = w / (1 + w) で平滑化します。
+   *
+   * @param minCutoffHz 静止時の遮断周波数 (Hz)
+   * @param beta 速度に対する遮断周波数の増加率 (Hz / (値/s))
+   * @param derivCutoffHz 速度推定の遮断周波数 (Hz)
+   * @param sampleRateHz サンプルレート (間引き後, Hz)
+   */
+  void setOneEuro(float minCutoffHz, float beta, float derivCutoffHz,
+                  float sampleRateHz);
+
+  /**
+   * @brief 平滑化フィルタの切り替え (フィルタの状態はリセットする)
+   */
+  void setFilterMode(FilterMode mode);
+  FilterMode getFilterMode() const { return _filterMode; }
+
+  /**
+   * @brief 平滑化した値 (移動平均または One-Euro) を物理量に変換して返す
+   * @return 物理量に変換された値。サンプルなしの場合は0。
    */
   int getvalue();
 
+  /**
+   * @brief 平滑化した値 (変換関数の適用前, 16bit 基準) を取得する
+   * @param value 格納先
+   * @return true: 取得した, false: サンプルなし
+   */
+  virtual bool getFiltered(int &value) const = 0;
+
   /**
    * @brief バッファ内の最新のAD変換生値を返す（デバッグ用）
    * @return 最後にgetadc()で取得した生のAD変換値。サンプルなしの場合は0。
    */
-  int getRawLatest() const;
+  virtual int getRawLatest() const = 0;
+
+  /**
+   * @brief ピン番号
+   */
+  uint8_t getPin() const { return _pin; }
+
+protected:
+  /**
+   * @brief コンストラクタ
+   * @param pin ピン番号
+   * @param transform
+   * 物理量への変換関数ポインタ（デフォルトはそのままの値を返す）
+   * @param decimationShift 間引き率の log2 (putSamples() のみ, 0: 間引きなし)
+   */
+  ADInputChannelBase(uint8_t pin, int (*transform)(int),
+                     uint8_t decimationShift);
+
+  /// 移動平均バッファのクリア (派生クラスで実装)
+  virtual void clearAverage() = 0;
+
+  /**
+   * @brief 1サンプルを間引きの合計に加える
+   * @param sample 12bit の変換値
+   * @param value 間引き後のサンプル (16bit 基準) の格納先
+   * @return true: 2^decimationShift 個たまり、value を格納した
+   */
+  bool decimate(uint16_t sample, int &value) {
+    _decimSum += sample;
+    if (!(++_decimCount >> _decimationShift)) {
+      return false;
+    }
+    // 2^n 個の合計 → 平均を 16bit 基準へ (下位の端数も実効分解能)
+    value = (int)((_decimSum << (VALUE_BITS - DMA_SAMPLE_BITS)) >>
+                  _decimationShift);
+    _decimSum = 0;
+    _decimCount = 0;
+    return true;
+  }
+
+  /// analogRead() の値を 16bit 基準へ
+  int readAnalog() const {
+    return analogRead(_pin) << (VALUE_BITS - ANALOG_READ_BITS);
+  }
+
+  /// One-Euro フィルタを使用するか
+  bool usesOneEuro() const { return _filterMode == FILTER_ONE_EURO; }
+
+  /**
+   * @brief One-Euro フィルタを1サンプル進める
+   */
+  void updateOneEuro(int newValue);
+
+  /**
+   * @brief One-Euro フィルタの出力
+   * @return true: 取得した, false: 初回サンプルの前
+   */
+  bool getOneEuro(int &value) const;
 
 private:
+  /// 値の基準 (16bit)
+  static constexpr uint8_t VALUE_BITS = 16;
+  /// DMA サンプルのビット数
+  static constexpr uint8_t DMA_SAMPLE_BITS = 12;
+  /// analogRead() のビット数 (analogReadResolution() の既定値)
+  static constexpr uint8_t ANALOG_READ_BITS = 10;
+  /// One-Euro フィルタの状態の小数部ビット数
+  static constexpr uint8_t OE_FRAC_BITS = 8;
+  /// One-Euro フィルタの係数の1.0 (Q16)
+  static constexpr uint32_t OE_ONE = 1UL << 16;
+
+  /**
+   * @brief 平滑化係数 α = w / (1 + w) (Q16)
+   * @param w 1サンプルあたりの角周波数 (Q16)
+   */
+  static uint32_t oneEuroAlpha(uint32_t w);
+
   uint8_t _pin;
-  uint16_t _bufferSize;
   int (*_transform)(int);
 
+  uint8_t _decimationShift; ///< 間引き率の log2
+  uint32_t _decimSum;       ///< 間引き中のサンプルの合計
+  uint16_t _decimCount;     ///< 間引き中のサンプル数
+
+  FilterMode _filterMode; ///< 平滑化フィルタの種類
+  uint32_t _oeMinW;       ///< 静止時の w (Q16)
+  uint32_t _oeBetaK;      ///< 速度 (値/サンプル) 1 あたりの w の増分 (Q16)
+  uint32_t _oeDerivAlpha; ///< 速度推定の α (Q16)
+  int32_t _oeValue;       ///< 平滑化した値 (小数部 OE_FRAC_BITS)
+  int32_t _oeSpeed; ///< 平滑化した速度 (値/サンプル, 小数部 OE_FRAC_BITS)
+  int _oePrev;      ///< 前回の入力値
+  bool _oeReady;    ///< 初回サンプルで初期化済み
+};
+
+/**
+ * @brief サンプルごとの処理 (間引き → 移動平均) の共通実装
+ *
+ * Derived は次の非仮想関数を持ちます (このクラスから静的に呼び出す)。
+ * - void pushAverage(int newValue): 1サンプル格納
+ * - bool hasAverage() const: サンプルあり
+ * - int averageValue() const: 格納済みサンプルの平均
+ * - int latestValue() const: 最新値 (サンプルなしは0)
+ *
+ * @tparam Derived 移動平均バッファを持つ派生クラス
+ */
+template <class Derived> class ADInputChannelImpl : public ADInputChannelBase {
+public:
+  void getadc() override { putSample(readAnalog()); }
+
+  void putSamples(const volatile uint16_t *samples, uint16_t count,
+                  uint8_t stride) override {
+    decimateSamples(samples, count, stride);
+  }
+
+  bool getFiltered(int &value) const override {
+    if (usesOneEuro()) {
+      return getOneEuro(value);
+    }
+    if (!derived().hasAverage()) {
+      return false;
+    }
+    value = derived().averageValue();
+    return true;
+  }
+
+  int getRawLatest() const override { return derived().latestValue(); }
+
+protected:
+  using ADInputChannelBase::ADInputChannelBase;
+
+private:
+  Derived &derived() { return static_cast<Derived &>(*this); }
+  const Derived &derived() const {
+    return static_cast<const Derived &>(*this);
+  }
+
+  /// putSamples() の本体 (間引き → 移動平均)
+  void decimateSamples(const volatile uint16_t *samples, uint16_t count,
+                       uint8_t stride) {
+    for (uint16_t i = 0; i < count; i++) {
+      int value;
+      if (decimate(samples[(uint32_t)i * stride], value)) {
+        putSample(value);
+      }
+    }
+  }
+
+  /// 1サンプルを移動平均バッファ (と One-Euro フィルタ) に格納する
+  void putSample(int newValue) {
+    derived().pushAverage(newValue);
+    if (usesOneEuro()) {
+      updateOneEuro(newValue);
+    }
+  }
+};
+
+/**
+ * @brief 移動平均バッファをコンパイル時に固定した AD 入力チャンネル
+ * @tparam N 移動平均サンプル数 (2のべき乗)
+ */
+template <uint16_t N>
+class ADInputChannel : public ADInputChannelImpl<ADInputChannel<N>> {
+  static_assert(N > 0 && (N & (N - 1)) == 0, "N must be a power of two");
+  friend class ADInputChannelImpl<ADInputChannel<N>>;
+
+public:
+  /**
+   * @brief コンストラクタ
+   * @param pin ピン番号
+   * @param transform
+   * 物理量への変換関数ポインタ（デフォルトはそのままの値を返す）
+   * @param decimationShift 間引き率の log2 (putSamples() のみ, 0: 間引きなし)
+   */
+  explicit ADInputChannel(uint8_t pin, int (*transform)(int) = nullptr,
+                          uint8_t decimationShift = 0)
+      : ADInputChannelImpl<ADInputChannel<N>>(pin, transform,
+                                              decimationShift),
+        _buffer{}, _head(0), _sampleCount(0), _sum(0) {}
+
+protected:
+  void clearAverage() override {
+    _head = 0;
+    _sampleCount = 0;
+    _sum = 0;
+    for (uint16_t i = 0; i < N; i++) {
+      _buffer[i] = 0;
+    }
+  }
+
+private:
+  void pushAverage(int newValue) {
+    // 合計値から一番古い値を引き、新しい値を足す（差分更新）
+    if (_sampleCount >= N) {
+      _sum -= _buffer[_head];
+    } else {
+      _sampleCount++;
+    }
+    _buffer[_head] = newValue;
+    _sum += newValue;
+    _head = (_head + 1) & MASK;
+  }
+
+  bool hasAverage() const { return _sampleCount > 0; }
+
+  int averageValue() const {
+    if (_sampleCount >= N) {
+      return (int)(_sum >> SHIFT);
+    }
+    // バッファが埋まるまでは格納済みサンプルの平均
+    return (_sampleCount > 0) ? (int)(_sum / _sampleCount) : 0;
+  }
+
+  int latestValue() const {
+    // _head は次に書き込む位置なので、最新値はその一つ前
+    return (_sampleCount > 0) ? _buffer[(_head - 1) & MASK] : 0;
+  }
+
+  static constexpr uint16_t MASK = N - 1;
+  static constexpr uint8_t log2(uint16_t n) {
+    return (n <= 1) ? 0 : (uint8_t)(1 + log2(n >> 1));
+  }
+  static constexpr uint8_t SHIFT = log2(N);
+
+  int _buffer[N];
+  uint16_t _head;
+  uint16_t _sampleCount;
+  int32_t _sum; // 高速化のため合計値を保持（リングバッファ更新時に差分更新）
+};
+
+/**
+ * @brief 移動平均バッファのサイズを実行時に指定する AD 入力チャンネル
+ *
+ * 設定値からサイズを決める場合など、2のべき乗以外のサイズ向けです。
+ */
+class ADInputChannelDynamic
+    : public ADInputChannelImpl<ADInputChannelDynamic> {
+  friend class ADInputChannelImpl<ADInputChannelDynamic>;
+
+public:
+  /**
+   * @brief コンストラクタ
+   * @param pin ピン番号
+   * @param bufferSize 移動平均バッファサイズ
+   * @param transform
+   * 物理量への変換関数ポインタ（デフォルトはそのままの値を返す）
+   * @param decimationShift 間引き率の log2 (putSamples() のみ, 0: 間引きなし)
+   */
+  ADInputChannelDynamic(uint8_t pin, uint16_t bufferSize,
+                        int (*transform)(int) = nullptr,
+                        uint8_t decimationShift = 0);
+
+  /**
+   * @brief デストラクタ（バッファの解放）
+   */
+  ~ADInputChannelDynamic() override;
+
+protected:
+  void clearAverage() override;
+
+private:
+  void pushAverage(int newValue);
+  bool hasAverage() const { return _sampleCount > 0; }
+  int averageValue() const;
+  int latestValue() const;
+
+  uint16_t _bufferSize;
   int *_buffer;
   uint16_t _head;
   uint16_t _sampleCount;
   int32_t _sum; // 高速化のため合計値を保持（リングバッファ更新時に差分更新）
 };
 
+// putSamples() は DMAADCSampler から仮想関数として呼ばれ、呼び出し元へ
+// 展開されません。テンプレートの関数には HOT_FUNC (section 属性) が効かない
+// ため、使用する型は明示的特殊化として ADInput.cpp に定義します。
+template <>
+void ADInputChannelImpl<ADInputChannel<Config::Adc::AVERAGE_COUNT>>::putSamples(
+    const volatile uint16_t *samples, uint16_t count, uint8_t stride);
+template <>
+void ADInputChannelImpl<ADInputChannelDynamic>::putSamples(
+    const volatile uint16_t *samples, uint16_t count, uint8_t stride);
+
 #endif // AD_INPUT_H
@@ -0,0 +1,88 @@
+#ifndef ALARM_TRIGGER_H
+#define ALARM_TRIGGER_H
+
+#include <cstdint>
+
+/**
+ * @file AlarmTrigger.h
+ * @brief RP2040 のハードウェアアラームで周期を刻むトリガ
+ * @date 2026-10-18
+ *
+ * IntervalTrigger_u と同じ使い方 (init() → ループで hasExpired()) で、
+ * 周期の基準をループの判定タイミングではなくハードウェアアラームに
+ * 置き換えます。
+ *
+ * - 割り込み (アラーム) 側: 期限の時刻の記録、次の期限の設定、
+ *   発生数の加算のみ行う
+ * - ループ側: hasExpired() で発生を検出して周期処理を行う
+ *
+ * 期限は 64bit のタイマ値で保持し、周期の整数倍で進めるため
+ * ドリフトしません。ループ側の処理が1周期以上遅れて複数の発生が
+ * 溜まった場合は、最新の1回だけを実行し残りを欠落として数えます
+ * (連続実行しない)。
+ *
+ * @note アラーム割り込みは init() を呼び出したコアで処理されます。
+ */
+
+/**
+ * @class AlarmTrigger
+ * @brief ハードウェアアラーム駆動の周期トリガ
+ */
+class AlarmTrigger {
+public:
+  /**
+   * @brief コンストラクタ
+   * @param interval_us 実行周期（マイクロ秒）
+   */
+  explicit AlarmTrigger(uint32_t interval_us);
+
+  /**
+   * @brief アラームを確保し、周期の判定を開始する
+   *
+   * 空きアラームがない場合は停止します (dma_claim_unused_channel() と同様)。
+   *
+   * @param phase_us 最初の期限に加える遅れ (周期の位相, us)
+   */
+  void init(uint32_t phase_us = 0);
+
+  /**
+   * @brief 周期判定を行う (アラーム発生後、最初の呼び出しで true)
+   */
+  bool hasExpired();
+
+  /**
+   * @brief 直近に hasExpired() が true を返した周期の期限 (micros() 基準)
+   */
+  uint32_t getDeadlineUs() const { return deadlineUs; }
+
+  /**
+   * @brief ループ側が取りこぼした周期の数 (累積)
+   */
+  uint32_t getMissedCount() const { return missed + skipped; }
+
+private:
+  /**
+   * @brief アラーム割り込み (アラーム番号から対象を引く)
+   */
+  static void onAlarm(unsigned int alarmNum);
+
+  /**
+   * @brief 期限の記録と次の期限の設定 (割り込み内)
+   */
+  void fire();
+
+  /// アラーム番号 → トリガ (RP2040 のアラームは4本)
+  static AlarmTrigger *instances[4];
+
+  uint32_t interval;               ///< 実行周期 (us)
+  int alarmNum;                    ///< 確保したアラーム番号 (-1: 未確保)
+  uint64_t nextDeadline;           ///< 次のアラームの期限 (割り込み側)
+  volatile uint32_t firedDeadline; ///< 直近に発生した期限 (下位 32bit)
+  volatile uint32_t fired;         ///< 発生数 (割り込み側)
+  volatile uint32_t skipped;       ///< 割り込み側で読み飛ばした期限の数
+  uint32_t consumed;               ///< 処理済みの発生数 (ループ側)
+  uint32_t deadlineUs;             ///< 処理中の周期の期限
+  uint32_t missed;                 ///< ループ側で取りこぼした周期の数
+};
+
+#endif // ALARM_TRIGGER_H
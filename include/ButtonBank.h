@@ -0,0 +1,95 @@
+#ifndef BUTTON_BANK_H
+#define BUTTON_BANK_H
+
+#include <Arduino.h>
+
+/**
+ * @file ButtonBank.h
+ * @brief 最大32個のボタンをまとめてデバウンスするボタンバンク
+ * @date 2026-10-18
+ *
+ * 全ボタンの入力を1つの 32bit ワード (ビット i = ボタン i, 1 = HIGH) で
+ * 受け取り、ボタンごとの 2bit カウンタをビット位置ごとに2つのワードへ
+ * 分けて持つ「縦型カウンタ」で、全ビットを並列にデバウンスします。
+ * 1サンプルの処理はボタン数によらずビット演算数回です。
+ *
+ * 確定状態と異なる値が CONFIRM_SAMPLES 回連続すると状態を反転し、
+ * 途中で確定状態と同じ値に戻るとカウンタを 0 に戻します。
+ *
+ * 入力元:
+ * - update(): 連続した GPIO (firstPin から count 個) を gpio_get_all()
+ *   の1回の読み出しで取得する (ボタンボックスの直結用)
+ * - update(raw): シフトレジスタや PIO のマトリクス走査など、
+ *   別の方法で読み出したワードを渡す
+ */
+
+/**
+ * @class ButtonBank
+ * @brief 縦型カウンタによるビット並列デバウンス
+ */
+class ButtonBank {
+public:
+  /// 状態の反転に必要な連続サンプル数 (2bit カウンタ)
+  static constexpr uint8_t CONFIRM_SAMPLES = 4;
+  /// 最大ボタン数
+  static constexpr uint8_t MAX_BUTTONS = 32;
+
+  /**
+   * @brief コンストラクタ
+   * @param firstPin update() で読み出す先頭の GPIO 番号
+   * @param count ボタン数 (0〜MAX_BUTTONS, GPIO は firstPin から連続)
+   */
+  ButtonBank(uint8_t firstPin, uint8_t count);
+
+  /**
+   * @brief 初期化（GPIO のプルアップ設定、全ボタンを HIGH に戻す）
+   */
+  void Init();
+
+  /**
+   * @brief GPIO を読み取り、デバウンス処理を更新する
+   * @return 確定した状態 (ビット i = ボタン i, 1 = HIGH)
+   */
+  uint32_t update();
+
+  /**
+   * @brief 読み出し済みの入力でデバウンス処理を更新する
+   * @param raw 入力 (ビット i = ボタン i, 1 = HIGH)
+   * @return 確定した状態 (ビット i = ボタン i, 1 = HIGH)
+   */
+  uint32_t update(uint32_t raw) {
+    uint32_t delta = (raw ^ state) & mask; // 確定状態と異なるビット
+    // 異なるビットのカウンタを進め、一致したビットは 0 に戻す
+    count1 = (count1 ^ count0) & delta;
+    count0 = ~count0 & delta;
+    // カウンタが一周 (CONFIRM_SAMPLES 回連続) したビットを反転
+    state ^= delta & ~(count0 | count1);
+    return state;
+  }
+
+  /**
+   * @brief 確定済みのボタンの論理状態を取得する
+   * @param index ボタン番号 (0〜count-1)
+   * @return HIGH/LOW
+   */
+  int getState(uint8_t index) const {
+    return ((state >> index) & 1) ? HIGH : LOW;
+  }
+
+  /**
+   * @brief 押下中 (LOW) のボタンのビットマスク
+   */
+  uint32_t getPressedMask() const { return ~state & mask; }
+
+  uint8_t getCount() const { return count; } ///< ボタン数
+
+private:
+  uint8_t firstPin; ///< 先頭の GPIO 番号
+  uint8_t count;    ///< ボタン数
+  uint32_t mask;    ///< 使用するビット
+  uint32_t state;   ///< 確定状態 (1 = HIGH)
+  uint32_t count0;  ///< 縦型カウンタの下位ビット
+  uint32_t count1;  ///< 縦型カウンタの上位ビット
+};
+
+#endif // BUTTON_BANK_H
@@ -13,12 +13,83 @@
  * また、テスト時のモック実装も可能になります。
  */
 
+/**
+ * @struct CANFrame
+ * @brief 受信CANフレーム (受信時刻付き)
+ *
+ * readFrames() で複数フレームを一括取得する際の格納単位です。
+ */
+struct CANFrame {
+  uint32_t id;          ///< CAN識別子
+  uint8_t len;          ///< データ長 (0-8バイト)
+  uint8_t data[8];      ///< 受信データ
+  uint32_t timestampUs; ///< 受信時刻 (micros())
+};
+
+/**
+ * @brief 送信優先度
+ *
+ * 送信キュー内の順序と、MCP2515 送信バッファの優先度ビット (TXP) に
+ * 対応します。値が大きいほど先に送信されます。
+ */
+enum CANTxPriority : uint8_t {
+  CAN_TX_PRIO_LOW = 0,    ///< ステータス要求など
+  CAN_TX_PRIO_NORMAL = 1, ///< sendFrame() の既定
+  CAN_TX_PRIO_HIGH = 2,   ///< 状態変更コマンドなど
+  CAN_TX_PRIO_URGENT = 3, ///< トルク指令など周期制御
+};
+
+/**
+ * @brief 未送信フレームの置き換え条件
+ *
+ * 周期的に送る指令値が、古い値の後ろに溜まらないようにするために使用します。
+ */
+enum CANTxSupersede : uint8_t {
+  CAN_TX_APPEND = 0,        ///< 置き換えない (キューに追加)
+  CAN_TX_SUPERSEDE_CMD = 1, ///< 同じCAN IDかつ同じ先頭データバイトを置き換え
+  CAN_TX_SUPERSEDE_ID = 2,  ///< 同じCAN IDを置き換え (一括指令フレームなど)
+};
+
+/**
+ * @struct CANFilter
+ * @brief 受信フィルタ (アクセプタンスフィルタ) の設定
+ *
+ * (受信ID & mask) == (id & mask) のフレームを受信します。
+ * 拡張フレームを対象とする場合は id に EXT_ID_FLAG を付与してください。
+ */
+struct CANFilter {
+  /// 拡張フレーム (29bit ID) を示すフラグ
+  static constexpr uint32_t EXT_ID_FLAG = 0x80000000UL;
+
+  uint32_t id;   ///< 受信するCAN識別子 (拡張フレームは EXT_ID_FLAG 付き)
+  uint32_t mask; ///< 比較するビット (1: 一致が必要, 0: 不問)
+};
+
+/**
+ * @brief 1フレームの最大ビット数 (ビットスタッフィング最悪値込み)
+ *
+ * SOF から フレーム間スペース (3bit) までを含みます。
+ * バス使用率の見積もりに使用します。
+ *
+ * @param len データ長 (0-8バイト)
+ * @param ext true: 拡張フレーム (29bit ID)
+ * @return ビット数 (標準フレーム 8バイトで 135bit)
+ */
+inline constexpr uint32_t canFrameBitsMax(uint8_t len, bool ext) {
+  uint32_t n = (len > 8) ? 8 : len;
+  // スタッフィング対象: SOF〜CRC (標準 34+8n bit, 拡張 54+8n bit)
+  uint32_t stuffed = (ext ? 54 : 34) + 8 * n;
+  // 固定長: スタッフィング対象 + CRCデリミタ(1) + ACK(2) + EOF(7) + IFS(3)
+  return (ext ? 67 : 47) + 8 * n + (stuffed - 1) / 4;
+}
+
 /**
  * @class CANInterface
  * @brief CAN通信の抽象インターフェース
  *
- * 純粋仮想関数のみを持つ抽象クラスです。
- * 実装クラスはこのインターフェースを継承し、各関数を実装してください。
+ * 実装クラスはこのインターフェースを継承し、純粋仮想関数を実装してください。
+ * readFrames() は readFrame() を用いた既定実装を持つため、
+ * 一括受信に対応しない実装 (モック等) では上書き不要です。
  */
 class CANInterface {
 public:
@@ -49,6 +120,30 @@ public:
    */
   virtual bool sendFrame(uint32_t id, uint8_t len, const uint8_t *data) = 0;
 
+  /**
+   * @brief 優先度付きのCANフレーム送信
+   *
+   * 送信キューを持つ実装では、フレームをキューに積んで即座に戻ります。
+   * supersede の条件に一致する未送信フレームがキューにあれば、
+   * それを置き換えます (CANTxSupersede を参照)。
+   *
+   * 既定実装は優先度を無視して sendFrame() を呼び出します。
+   *
+   * @param id CAN識別子
+   * @param len データ長 (0-8バイト)
+   * @param data 送信データへのポインタ (len バイト分)
+   * @param priority 送信優先度
+   * @param supersede 未送信フレームの置き換え条件
+   * @return true: 送信(キュー投入)成功, false: 失敗 (キュー満杯など)
+   */
+  virtual bool queueFrame(uint32_t id, uint8_t len, const uint8_t *data,
+                          CANTxPriority priority,
+                          CANTxSupersede supersede) {
+    (void)priority;
+    (void)supersede;
+    return sendFrame(id, len, data);
+  }
+
   /**
    * @brief CANフレームの受信
    *
@@ -70,6 +165,90 @@ public:
    * @return true: 受信データあり, false: 受信データなし
    */
   virtual bool available() = 0;
+
+  /**
+   * @brief 受信済みフレームの一括取得
+   *
+   * 未読のフレームを最大 maxFrames 個まで受信順に取り出します。
+   * 1ループ内で複数の応答 (トルク応答 + ステータス応答など) を
+   * 取りこぼしなく処理するために使用します。
+   *
+   * @param frames 受信フレームの格納先 (maxFrames 個分確保すること)
+   * @param maxFrames 取得する最大フレーム数
+   * @return 取得したフレーム数 (0: 受信データなし)
+   */
+  virtual uint8_t readFrames(CANFrame *frames, uint8_t maxFrames) {
+    uint8_t count = 0;
+    while (count < maxFrames && available()) {
+      CANFrame &f = frames[count];
+      if (!readFrame(f.id, f.len, f.data)) {
+        break;
+      }
+      f.timestampUs = micros();
+      count++;
+    }
+    return count;
+  }
+
+  /**
+   * @brief ビットレートの設定
+   *
+   * begin() の前に呼び出した場合は begin() で適用されます。
+   * 動作中に呼び出した場合は、その場でCANコントローラを再設定します
+   * (通信相手も同じビットレートであること)。
+   * 既定実装はビットレート変更に対応しない実装向けで、false を返します。
+   *
+   * @param bitrate ビットレート (bps, 例: 500000, 1000000)
+   * @return true: 設定成功, false: 未対応のビットレート
+   */
+  virtual bool setBitrate(uint32_t bitrate) {
+    (void)bitrate;
+    return false;
+  }
+
+  /**
+   * @brief 設定中のビットレートを取得
+   * @return ビットレート (bps, 0: 不明)
+   */
+  virtual uint32_t getBitrate() const { return 0; }
+
+  /**
+   * @brief 送受信したフレームの累積ビット数を取得 (診断用)
+   *
+   * canFrameBitsMax() による見積もり値の累積です。
+   * 一定時間の増分をビットレートで割るとバス使用率の目安になります
+   * (受信フィルタで破棄した他ノードのフレームは含みません)。
+   */
+  virtual uint32_t getBusBitCount() const { return 0; }
+
+  /**
+   * @brief 受信フィルタの設定
+   *
+   * 指定したフィルタのいずれかに一致するフレームのみを受信します。
+   * begin() の前に呼び出した場合は begin() で適用されます。
+   * 既定実装はフィルタに対応しない実装 (モック等) 向けで、
+   * 何もせず false を返します (全フレームを受信)。
+   *
+   * @param filters フィルタ設定の配列
+   * @param count フィルタ数 (0: フィルタ解除, 全フレーム受信)
+   * @return true: 設定成功, false: 未対応またはフィルタ数超過
+   */
+  virtual bool setFilters(const CANFilter *filters, uint8_t count) {
+    (void)filters;
+    (void)count;
+    return false;
+  }
+
+  /**
+   * @brief フィルタごとの受信数を取得 (診断用)
+   *
+   * @param index setFilters() に渡した配列のインデックス
+   * @return フィルタに一致して受信したフレーム数
+   */
+  virtual uint32_t getFilterHitCount(uint8_t index) const {
+    (void)index;
+    return 0;
+  }
 };
 
 #endif // CAN_INTERFACE_H
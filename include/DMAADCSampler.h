@@ -0,0 +1,114 @@
+#ifndef DMA_ADC_SAMPLER_H
+#define DMA_ADC_SAMPLER_H
+
+#include "ADInput.h"
+#include <cstdint>
+
+/**
+ * @file DMAADCSampler.h
+ * @brief RP2040 の ADC を DMA でフリーランさせるサンプラ
+ * @date 2026-10-18
+ *
+ * ADC をラウンドロビン (登録したピンの ADC 入力を番号順に巡回) で
+ * 連続変換させ、変換結果を DMA でリングバッファへ書き込みます。
+ * 変換ごとの CPU 処理はなく、サンプリング周期はループの実行状況に
+ * 依存しません。
+ *
+ * ## DMA 構成
+ * - データチャネル: ADC FIFO → リングバッファ (16bit, 書き込み側リング)
+ *   RING_SAMPLES 個で1周し、制御チャネルへチェインする
+ * - 制御チャネル: 転送数をデータチャネルの al1_transfer_count_trig へ
+ *   書き込み、データチャネルを再始動する (割り込みなしで無限に継続)
+ *
+ * read() はデータチャネルの書き込みアドレスから書き込み位置を求め、
+ * 前回からの新しいサンプルを登録順のチャンネルへブロック単位で渡します
+ * (ADInputChannelBase::putSamples())。
+ *
+ * @note 巡回順とリング位置を対応させるため、登録数は 1, 2, 4 のいずれか
+ *       (RING_SAMPLES の約数) とします。
+ * @note begin() 後は ADC を占有するため、analogRead() および
+ *       ADInputChannelBase::getadc() は使用できません。
+ */
+
+/**
+ * @class DMAADCSampler
+ * @brief DMA 駆動のラウンドロビン ADC サンプラ
+ */
+class DMAADCSampler {
+public:
+  /// 登録できる入力数 (ADC0〜ADC3: GPIO26〜29)
+  static constexpr uint8_t MAX_INPUTS = 4;
+  /// リングバッファのサンプル数 (2のべき乗, 128kHz で 8ms 分)
+  /// 数 ms の遅れは吸収するが、フラッシュ書き込み (Core 1 も停止,
+  /// セクタ消去は数十〜数百 ms) の間はオーバーランになる
+  static constexpr uint16_t RING_SAMPLES = 1024;
+
+  /**
+   * @brief コンストラクタ
+   * @param sampleRateHz 変換レート (全入力の合計, Hz)
+   */
+  explicit DMAADCSampler(uint32_t sampleRateHz);
+
+  /**
+   * @brief チャンネルの登録 (begin() の前に呼び出す)
+   * @param channel 登録するチャンネル (ピンは GPIO26〜29)
+   * @return true: 登録成功, false: ADC ピン以外・重複・登録数超過
+   */
+  bool attach(ADInputChannelBase *channel);
+
+  /**
+   * @brief ADC と DMA の初期化、連続変換の開始
+   * @return true: 開始, false: 登録数が 1, 2, 4 以外
+   */
+  bool begin();
+
+  /**
+   * @brief 新しいサンプルを各チャンネルのリングバッファへ渡す
+   *
+   * リングバッファ1周分 (RING_SAMPLES / 変換レート) より短い間隔で
+   * 呼び出してください。間隔が空いた場合は上書きされたサンプルを
+   * 読み飛ばし、オーバーランとして数えます。
+   *
+   * @return 渡したサンプル数 (全チャンネル合計)
+   */
+  uint16_t read();
+
+  uint32_t getSampleRateHz() const { return sampleRateHz; }
+  uint32_t getOverrunCount() const { return overruns; } ///< オーバーラン数
+
+private:
+  static constexpr uint16_t RING_MASK = RING_SAMPLES - 1;
+  /// ADC クロック (48MHz)
+  static constexpr uint32_t ADC_CLOCK_HZ = 48000000;
+  /// ADC 入力 0 の GPIO 番号
+  static constexpr uint8_t ADC_FIRST_PIN = 26;
+
+  /**
+   * @brief データチャネルの書き込み位置 (次に書き込むリング位置)
+   */
+  uint16_t writeIndex() const;
+
+  /**
+   * @brief リング上で連続するサンプルを各チャンネルへ振り分ける
+   * @param start 先頭のリング位置
+   * @param count サンプル数
+   */
+  void distribute(uint16_t start, uint16_t count);
+
+  /// DMA 書き込み先 (リング動作のためサイズ境界に配置)
+  alignas(RING_SAMPLES * sizeof(uint16_t))
+      volatile uint16_t ring[RING_SAMPLES];
+
+  ADInputChannelBase *inputs[MAX_INPUTS]; ///< ADC 入力番号順のチャンネル
+  uint8_t inputCount;                 ///< 登録数
+  uint32_t sampleRateHz;              ///< 変換レート (全入力の合計)
+  uint32_t ringPeriodUs;              ///< リング1周の時間 (us)
+  int dataChannel;                    ///< データ DMA チャネル
+  int ctrlChannel;                    ///< 制御 DMA チャネル
+  uint32_t reloadCount; ///< 制御チャネルが書き込む転送数
+  uint16_t readIndex;   ///< 次に読み出すリング位置
+  uint32_t lastReadUs;  ///< 前回 read() の時刻
+  uint32_t overruns;    ///< オーバーラン数
+};
+
+#endif // DMA_ADC_SAMPLER_H
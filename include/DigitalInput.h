@@ -7,18 +7,34 @@
  * @brief デジタル入力をチャンネルごとに管理するクラス
  *
  * チャタリング防止（デバウンス）処理をカプセル化します。
+ *
+ * ## サンプリング方式 (lockoutUs = 0)
+ * update() ごとにピンを読み、threshold 回連続で一致した状態を確定します。
+ * 確定までサンプリング周期 × threshold の遅れが生じます。
+ *
+ * ## エッジ方式 (lockoutUs > 0)
+ * GPIO の両エッジ割り込みで、安定状態からの最初のエッジを即座に
+ * 状態の反転として確定し、以後 lockoutUs の間のエッジ (チャタリング) は
+ * 無視します。update() はロックアウト明けにピンと状態が食い違って
+ * いれば (ロックアウトより短い操作・ノイズ)、ピンの値で確定し直します。
+ * 割り込みは Init() を呼び出したコアで処理されるため、update() と
+ * 同じコアで Init() を呼び出してください。
+ *
+ * いずれの方式も、状態の変化を確定した元のエッジの時刻を記録します
+ * (サンプリング方式では変化を最初に検出したサンプルの時刻)。
  */
 class DigitalInputChannel {
 public:
   /**
    * @brief コンストラクタ
    * @param pin ピン番号
-   * @param threshold デバウンス用の連続一致サンプル数
+   * @param threshold デバウンス用の連続一致サンプル数 (サンプリング方式)
+   * @param lockoutUs エッジ方式のロックアウト時間 (0 でサンプリング方式)
    */
-  DigitalInputChannel(uint8_t pin, int threshold);
+  DigitalInputChannel(uint8_t pin, int threshold, uint32_t lockoutUs = 0);
 
   /**
-   * @brief 初期化（ピンモードの設定、内部状態のリセット）
+   * @brief 初期化（ピンモードの設定、内部状態のリセット、割り込みの登録）
    */
   void Init();
 
@@ -34,11 +50,33 @@ public:
    */
   int getState() const { return _currentStatus; }
 
+  bool isEdgeTriggered() const { return _lockoutUs > 0; }
+  /// 直近の状態変化のエッジ時刻 (micros())
+  uint32_t getLastEdgeUs() const { return _lastEdgeUs; }
+  uint32_t getEdgeCount() const { return _edgeCount; } ///< 状態変化の回数
+  /// ロックアウト中に無視したエッジ数 (エッジ方式)
+  uint32_t getBounceCount() const { return _bounceCount; }
+
 private:
+  /**
+   * @brief GPIO エッジ割り込み (param: 対象のチャンネル)
+   */
+  static void onEdge(void *param);
+
+  /**
+   * @brief 状態の確定と時刻の記録
+   */
+  void setState(int state, uint32_t edgeUs);
+
   uint8_t _pin;
   int _threshold;
   int _counter;
-  int _currentStatus;
+  uint32_t _lockoutUs;            ///< チャタリングを無視する時間
+  volatile int _currentStatus;    ///< 確定した状態
+  volatile uint32_t _lastEdgeUs;  ///< 直近の状態変化のエッジ時刻
+  volatile uint32_t _edgeCount;   ///< 状態変化の回数
+  volatile uint32_t _bounceCount; ///< 無視したエッジ数
+  uint32_t _pendingUs;            ///< 変化を最初に検出したサンプルの時刻
 };
 
 #endif // DIGITAL_INPUT_H
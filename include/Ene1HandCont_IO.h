@@ -2,17 +2,51 @@
 #define ENE1_HANDCONT_IO_H
 
 #include "ADInput.h"
+#include "ButtonBank.h"
+#include "DMAADCSampler.h"
 #include "DigitalInput.h"
+#include "PedalCalibration.h"
+#include "PedalCurve.h"
+#include "config.h"
 
 /**
  * @file Ene1HandCont_IO.h
  * @brief IOインスタンスの外部参照用定義
  */
 
+/// ペダル入力チャンネル (移動平均バッファは静的配列)
+using PedalInputChannel = ADInputChannel<Config::Adc::AVERAGE_COUNT>;
+
 // グローバルIOインスタンス
-extern ADInputChannel adAccel;
-extern ADInputChannel adBrake;
+extern PedalInputChannel adAccel;
+extern PedalInputChannel adBrake;
+extern DMAADCSampler adcSampler;
 extern DigitalInputChannel diKeyUp;
 extern DigitalInputChannel diKeyDown;
+extern ButtonBank buttonBox;
+extern PedalCalibration accelCal;
+extern PedalCalibration brakeCal;
+extern PedalCurve accelCurve;
+extern PedalCurve brakeCurve;
+
+/**
+ * @brief アクセル・ブレーキの応答曲線 LUT を作成する (Core 0)
+ * @return true: 作成した, false: 前回の切り替えが未完了 (後で再試行)
+ */
+bool stagePedalCurves(const PedalCurveConfig &accel,
+                      const PedalCurveConfig &brake);
+
+/**
+ * @brief 作成済みの応答曲線 LUT へ切り替える (Core 1, 変換の合間)
+ */
+void commitPedalCurves();
+
+/**
+ * @brief 校正値の変更の反映と自動校正の処理 (Core 1, 制御周期ごと)
+ *
+ * SharedData::pedalCalibSeq の変更で変換係数を更新し、
+ * SharedData::pedalCalibMode に従って観測・校正値の作成を行います。
+ */
+void updatePedalCalibration();
 
 #endif // ENE1_HANDCONT_IO_H
\ No newline at end of file
@@ -0,0 +1,147 @@
+#ifndef PEDAL_CALIBRATION_H
+#define PEDAL_CALIBRATION_H
+
+#include <cstdint>
+
+/**
+ * @file PedalCalibration.h
+ * @brief ペダルの校正値 (ADC範囲・デッドゾーン) とストロークへの変換
+ * @date 2026-10-18
+ *
+ * 校正値から、ADC 値 (16bit 基準) → ストローク (0〜65536) の変換に
+ * 使う下限とスケール (Q16 の逆数) を load() 時に求めておき、
+ * 変換時は減算・乗算・シフトだけで済ませます (除算なし)。
+ *
+ * ## デッドゾーン
+ * - 内側 (innerDeadzone): 離した位置からこの範囲はストローク 0
+ * - 外側 (outerDeadzone): 全踏み込み位置からこの範囲はストローク最大
+ * いずれも校正範囲に対する 0.1% 単位です。
+ *
+ * ## 自動校正
+ * beginCapture() の後、capture() に平滑化済みの ADC 値を渡し続けると
+ * 観測した最小・最大値を記録します。endCapture() で校正値を作成します。
+ */
+
+/**
+ * @brief 自動校正の状態 (SharedData::pedalCalibMode)
+ */
+enum PedalCalibMode : uint8_t {
+  PEDAL_CALIB_IDLE = 0,   ///< 校正していない
+  PEDAL_CALIB_RUN = 1,    ///< 観測中 (書き込みで開始)
+  PEDAL_CALIB_FINISH = 2, ///< 終了要求 (書き込みで校正値を作成)
+  PEDAL_CALIB_FAILED = 3  ///< 観測範囲が狭く、校正値を作成できなかった
+};
+
+/**
+ * @brief ペダルの校正値 (SharedData に保持し、ConfigManager で保存)
+ *
+ * rawMax - rawMin が PedalCalibration::MIN_SPAN 未満 (0 初期化を含む)
+ * の場合は、config.h の既定値を使用します。
+ */
+struct PedalCalibConfig {
+  uint16_t rawMin;        ///< ADC 最小値 (16bit 基準)
+  uint16_t rawMax;        ///< ADC 最大値 (16bit 基準)
+  uint16_t innerDeadzone; ///< 離した側のデッドゾーン (0.1%)
+  uint16_t outerDeadzone; ///< 踏み込み側のデッドゾーン (0.1%)
+};
+
+/**
+ * @class PedalCalibration
+ * @brief ADC 値 → ストロークの変換と自動校正
+ */
+class PedalCalibration {
+public:
+  /// 全踏み込みのストローク値 (PedalCurve::TRAVEL_FULL と同じ)
+  static constexpr uint32_t TRAVEL_FULL = 65536;
+  /// 有効とみなす校正範囲の最小幅 (16bit 基準)
+  static constexpr uint16_t MIN_SPAN = 1024;
+  /// デッドゾーンの合計の上限 (0.1%)
+  static constexpr uint16_t MAX_DEADZONE_TOTAL = 900;
+
+  /**
+   * @brief コンストラクタ (既定値で load() 済みの状態にする)
+   * @param defaults 既定の校正値 (config.h)
+   * @param invert true: 踏み込みで ADC 値が減るペダル
+   */
+  PedalCalibration(const PedalCalibConfig &defaults, bool invert);
+
+  /**
+   * @brief 校正値を読み込み、変換係数を求める
+   *
+   * 範囲が不正な場合は既定値を使用します。
+   * apply() と同じコア (Core 1) から呼び出してください。
+   *
+   * @param config 校正値
+   * @return true: 指定値を使用, false: 既定値を使用
+   */
+  bool load(const PedalCalibConfig &config);
+
+  /**
+   * @brief 使用中の校正値
+   */
+  const PedalCalibConfig &getConfig() const { return current; }
+
+  /**
+   * @brief ADC 値をストロークに変換する
+   * @param raw 平滑化済みの ADC 値 (16bit 基準)
+   * @return ストローク (0〜TRAVEL_FULL)
+   */
+  uint32_t apply(int raw) const {
+    // 離した位置からの距離 (反転ペダルは上限側から測る)
+    int32_t d = invert ? (int32_t)hi - raw : raw - (int32_t)lo;
+    if (d <= 0) {
+      return 0;
+    }
+    if ((uint32_t)d >= span) {
+      return TRAVEL_FULL;
+    }
+    // d < span のため d × (2^32 / span) は 32bit に収まる
+    return ((uint32_t)d * scale) >> 16;
+  }
+
+  /**
+   * @brief 自動校正の開始 (観測範囲をリセット)
+   */
+  void beginCapture();
+
+  /**
+   * @brief 自動校正中の観測値の記録
+   * @param raw 平滑化済みの ADC 値 (16bit 基準)
+   */
+  void capture(int raw);
+
+  /**
+   * @brief 自動校正の終了
+   *
+   * デッドゾーンは使用中の値を引き継ぎます。
+   *
+   * @param result 作成した校正値の格納先
+   * @return true: 作成した, false: 観測範囲が MIN_SPAN 未満
+   */
+  bool endCapture(PedalCalibConfig &result);
+
+  bool isCapturing() const { return capturing; }
+
+private:
+  /**
+   * @brief 校正値が有効か
+   */
+  static bool isValid(const PedalCalibConfig &config);
+
+  PedalCalibConfig defaults; ///< 既定の校正値
+  PedalCalibConfig current;  ///< 使用中の校正値
+  bool invert;               ///< 踏み込みで ADC 値が減る
+
+  // --- 変換係数 (load() で算出) ---
+  uint16_t lo;    ///< デッドゾーン適用後の範囲の下限
+  uint16_t hi;    ///< デッドゾーン適用後の範囲の上限
+  uint32_t span;  ///< hi - lo
+  uint32_t scale; ///< 2^32 / span (d × scale >> 16 がストローク)
+
+  // --- 自動校正 ---
+  bool capturing;      ///< 観測中
+  uint16_t captureMin; ///< 観測した最小値
+  uint16_t captureMax; ///< 観測した最大値
+};
+
+#endif // PEDAL_CALIBRATION_H
@@ -0,0 +1,141 @@
+#ifndef PEDAL_CURVE_H
+#define PEDAL_CURVE_H
+
+#include <cstdint>
+
+/**
+ * @file PedalCurve.h
+ * @brief ペダルの応答曲線 (ストローク → HID 値) のルックアップテーブル
+ * @date 2026-10-18
+ *
+ * 応答曲線 (直線・ガンマ・S字・折れ線) を設定の読み込み時に
+ * LUT_SEGMENTS 区間の補間テーブルへ変換します。変換時は
+ * テーブル参照と1回の線形補間だけで済みます (浮動小数点演算なし)。
+ *
+ * ## 実行中の切り替え
+ * テーブルは2面持ち、stage() で非使用側へ作成し、commit() で
+ * 使用側を切り替えます。stage() は Core 0 (設定の読み込み側)、
+ * commit() と apply() は Core 1 (変換側) から呼び出します。
+ * 切り替えは Core 1 の apply() の合間にしか起きないため、変換途中で
+ * テーブルが書き換わることはありません。切り替えが済むまで次の
+ * stage() は受け付けません。
+ */
+
+/**
+ * @brief 応答曲線の種類
+ */
+enum PedalCurveType : uint8_t {
+  PEDAL_CURVE_LINEAR = 0, ///< 直線 (既定値, 0 初期化で有効な設定になる)
+  PEDAL_CURVE_GAMMA = 1,  ///< y = t^(param/100)
+  PEDAL_CURVE_SCURVE = 2, ///< 直線と smoothstep の混合 (param: 混合率 %)
+  PEDAL_CURVE_POINTS = 3, ///< 折れ線 (points[0..pointCount-1])
+  PEDAL_CURVE_TYPE_COUNT
+};
+
+/// 折れ線の最大点数
+inline constexpr uint8_t PEDAL_CURVE_MAX_POINTS = 8;
+
+/**
+ * @brief 折れ線の点 (ストローク・出力とも 0〜65535 で正規化)
+ */
+struct PedalCurvePoint {
+  uint16_t x; ///< ストローク
+  uint16_t y; ///< 出力
+};
+
+/**
+ * @brief 応答曲線の設定 (SharedData に保持し、ConfigManager で保存)
+ *
+ * 折れ線は x の昇順に並べます。両端の点 (0,0), (65535,65535) は
+ * 常に補われるため、途中の点だけを指定できます。
+ */
+struct PedalCurveConfig {
+  uint8_t type;       ///< PedalCurveType
+  uint8_t pointCount; ///< 折れ線の点数 (PEDAL_CURVE_POINTS)
+  uint16_t param;     ///< ガンマ値 x100 (0 は 100) / S字の混合率 (%)
+  PedalCurvePoint points[PEDAL_CURVE_MAX_POINTS]; ///< 折れ線の点
+};
+
+/**
+ * @class PedalCurve
+ * @brief 2面切り替えの応答曲線テーブル
+ */
+class PedalCurve {
+public:
+  /// 補間区間数 (入力の上位8bitが区間, 下位8bitが補間係数)
+  static constexpr uint16_t LUT_SEGMENTS = 256;
+  /// 全踏み込みのストローク値
+  static constexpr uint32_t TRAVEL_FULL = 65536;
+
+  /**
+   * @brief コンストラクタ (両面を直線で初期化)
+   * @param outMin ストローク 0 の出力値
+   * @param outMax 全踏み込みの出力値
+   */
+  PedalCurve(uint16_t outMin, uint16_t outMax);
+
+  /**
+   * @brief 設定から非使用側のテーブルを作成する (Core 0)
+   *
+   * 不正な設定 (種類・点数・x の並び) の場合は直線で作成します。
+   *
+   * @param config 応答曲線の設定
+   * @return true: 作成した, false: 前回の切り替えが未完了
+   */
+  bool stage(const PedalCurveConfig &config);
+
+  /**
+   * @brief 作成済みのテーブルへ切り替える (Core 1, 変換の合間)
+   */
+  void commit() {
+    if (pending) {
+      active ^= 1;
+      pending = false;
+    }
+  }
+
+  /**
+   * @brief 切り替え待ちのテーブルがある
+   */
+  bool isPending() const { return pending; }
+
+  /**
+   * @brief 直前の stage() で設定が不正だった
+   */
+  bool lastStageInvalid() const { return stageInvalid; }
+
+  /**
+   * @brief ストロークを出力値に変換する
+   * @param travel ストローク (0〜TRAVEL_FULL)
+   * @return 出力値 (outMin〜outMax)
+   */
+  uint16_t apply(uint32_t travel) const {
+    const uint16_t *t = tables[active];
+    if (travel >= TRAVEL_FULL) {
+      return t[LUT_SEGMENTS];
+    }
+    uint32_t i = travel >> 8;
+    int32_t frac = (int32_t)(travel & 0xFF);
+    return (uint16_t)(t[i] + (((int32_t)t[i + 1] - t[i]) * frac + 128) / 256);
+  }
+
+  /**
+   * @brief 設定が有効か (種類・点数・x の並び)
+   */
+  static bool isValid(const PedalCurveConfig &config);
+
+private:
+  /**
+   * @brief 正規化ストローク t (0..1) に対する曲線の値 (0..1)
+   */
+  static float evaluate(const PedalCurveConfig &config, float t);
+
+  uint16_t outMin; ///< ストローク 0 の出力値
+  uint16_t outMax; ///< 全踏み込みの出力値
+  uint16_t tables[2][LUT_SEGMENTS + 1]; ///< 補間テーブル (2面)
+  volatile uint8_t active;              ///< 使用中のテーブル
+  volatile bool pending;                ///< 切り替え待ち
+  bool stageInvalid;                    ///< 直前の設定が不正
+};
+
+#endif // PEDAL_CURVE_H
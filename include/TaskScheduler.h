@@ -0,0 +1,145 @@
+#ifndef TASK_SCHEDULER_H
+#define TASK_SCHEDULER_H
+
+#include "AlarmTrigger.h"
+#include "util.h"
+#include <cstdint>
+
+/**
+ * @file TaskScheduler.h
+ * @brief コアごとの静的タスク表による協調スケジューラ
+ * @date 2026-10-18
+ *
+ * タスク (周期・位相・優先度・実行時間の予算) をコンパイル時の表で
+ * 定義し、loop() / loop1() から runOnce() を呼び出すだけで周期処理を
+ * 行います。
+ *
+ * ## runOnce() の動作
+ * 1. 周期タスクの起動判定: アラーム (TaskEntry::alarm) の発生、または
+ *    micros() が起動時刻に達したタスクを実行可能にする
+ * 2. ポーリングタスク (周期 0) を表の順にすべて実行する
+ * 3. 実行可能な周期タスクのうち、期限 (起動時刻 + 周期) が最も早い
+ *    1つを実行する (同じ期限なら優先度の大きい方)
+ *
+ * 周期タスクの起動判定は、アラームがあれば AlarmTrigger、なければ
+ * IntervalTrigger_u (OVERRUN_SKIP) で行います。どちらも起動が1周期以上
+ * 遅れた場合は1回だけ実行し、遅れた分を取りこぼしとして数えます
+ * (連続実行しない)。
+ * 実行時間が予算を超えた場合は予算超過として数えます。
+ *
+ * ## CPU 利用率
+ * 周期タスクと、作業を行った (true を返した) ポーリングタスクの
+ * 実行時間の合計を、takeUtilizationPermil() の呼び出し間隔で割った値です。
+ */
+
+/// タスクの処理 (作業を行った場合 true, 利用率の集計用)
+using TaskFunc = bool (*)();
+
+/**
+ * @brief タスクの定義 (コンパイル時の表)
+ */
+struct TaskEntry {
+  const char *name;    ///< タスク名 (テレメトリ用)
+  TaskFunc run;        ///< 処理
+  uint32_t periodUs;   ///< 周期 (us, 0: ループごとのポーリングタスク)
+  uint32_t phaseUs;    ///< 最初の起動の追加の遅れ (us, 周期の位相)
+  uint8_t priority;    ///< 期限が同じ場合の優先度 (大きいほど先)
+  uint32_t budgetUs;   ///< 実行時間の予算 (us, 0: なし)
+  AlarmTrigger *alarm; ///< 起動元のアラーム (nullptr: micros() で判定)
+};
+
+/**
+ * @brief タスクごとの実行統計
+ */
+struct TaskStats {
+  uint32_t runs;          ///< 実行回数
+  uint32_t overBudget;    ///< 予算超過の回数
+  uint32_t execMaxUs;     ///< 最大実行時間
+  LatenessStats lateness; ///< 起動時刻から実行開始までの遅れ
+};
+
+/**
+ * @brief タスクごとの実行状態 (スケジューラ内部)
+ */
+struct TaskRuntime {
+  TaskStats stats;           ///< 実行統計
+  IntervalTrigger_u trigger; ///< micros() 判定の周期 (アラームがない場合)
+  uint32_t releaseUs;        ///< 起動時刻 (実行可能になった時刻)
+  bool ready;                ///< 実行可能
+};
+
+/**
+ * @class TaskScheduler
+ * @brief 期限順の協調スケジューラ (実行状態の配列は StaticTaskScheduler)
+ */
+class TaskScheduler {
+public:
+  /**
+   * @brief 統計のリセットと起動時刻の設定 (アラームの確保)
+   *
+   * アラームは呼び出したコアで処理されるため、runOnce() と同じコアで
+   * 呼び出してください。
+   */
+  void start();
+
+  /**
+   * @brief ポーリングタスクと、期限が最も早い周期タスク1つを実行する
+   */
+  void runOnce();
+
+  /**
+   * @brief 前回の呼び出しからの CPU 利用率 (0.1% 単位)
+   */
+  uint16_t takeUtilizationPermil();
+
+  uint8_t getTaskCount() const { return count; }
+  const TaskEntry &getTask(uint8_t index) const { return tasks[index]; }
+  TaskStats &getStats(uint8_t index) { return runtime[index].stats; }
+
+  /**
+   * @brief 取りこぼした周期の数 (AlarmTrigger / IntervalTrigger_u の累積)
+   */
+  uint32_t getMissedCount(uint8_t index) const;
+
+  /**
+   * @brief 全タスクの予算超過の回数
+   */
+  uint32_t getBudgetViolations() const;
+
+protected:
+  TaskScheduler(const TaskEntry *tasks, TaskRuntime *runtime, uint8_t count)
+      : tasks(tasks), runtime(runtime), count(count), windowStartUs(0),
+        busyUs(0) {}
+
+private:
+  /**
+   * @brief a の期限が b より早いか (同じなら優先度で比較)
+   */
+  bool runsBefore(uint8_t a, uint8_t b) const;
+
+  /**
+   * @brief 実行時間の記録
+   */
+  void account(uint8_t index, uint32_t execUs);
+
+  const TaskEntry *tasks; ///< タスクの定義
+  TaskRuntime *runtime;   ///< 実行状態
+  uint8_t count;          ///< タスク数
+  uint32_t windowStartUs; ///< 利用率の集計開始時刻
+  uint32_t busyUs;        ///< 集計区間の実行時間の合計
+};
+
+/**
+ * @class StaticTaskScheduler
+ * @brief タスク数 N の実行状態を静的に持つスケジューラ
+ */
+template <uint8_t N> class StaticTaskScheduler : public TaskScheduler {
+public:
+  explicit StaticTaskScheduler(const TaskEntry (&tasks)[N])
+      : TaskScheduler(tasks, runtime, N) {}
+
+private:
+  TaskRuntime runtime[N];
+};
+
+#endif // TASK_SCHEDULER_H
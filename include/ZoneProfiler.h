@@ -0,0 +1,133 @@
+#ifndef ZONE_PROFILER_H
+#define ZONE_PROFILER_H
+
+#include "config.h"
+#include <cstdint>
+
+/**
+ * @file ZoneProfiler.h
+ * @brief 処理区間 (ゾーン) ごとの所要時間の計測
+ * @date 2026-10-18
+ *
+ * ループ内の各段の所要時間を RP2040 のタイマ (1us) で計測し、
+ * ゾーンごとに件数・最小・平均・最大・p99・予算超過数を集計します。
+ * p99 は固定サイズのヒストグラム (PROFILE_BINS 個, 幅はゾーンごと) から
+ * 求めます。
+ *
+ * config.h の ZONE_PROFILER_ENABLE を定義した場合のみ有効です。
+ * 未定義の場合、計測用マクロは空になり、クラスもコンパイルされません。
+ *
+ * ## 使い方
+ * - PROFILE_SCOPE(zone): スコープの終わりまでを計測 (RAII)
+ * - PROFILE_BEGIN(zone) / PROFILE_END(zone): 同じスコープ内の区間を計測
+ *
+ * 各ゾーンは1つのコアからのみ記録します。集計値は記録するコアが
+ * ZoneProfiler::takeStats() で取り出して (同時にリセットして)
+ * SharedData::zoneStats へ書き出し、もう一方のコアはそちらを読みます。
+ */
+
+/**
+ * @brief 計測ゾーン
+ */
+enum ProfileZone : uint8_t {
+  // --- Core 1 ---
+  PROFILE_CAN_RX = 0,  ///< 受信フレームの取得 (readFrames)
+  PROFILE_PARSE,       ///< 受信フレームの解析と入力レポート更新
+  PROFILE_SHARED,      ///< 共有メモリとの同期
+  PROFILE_EFFECT,      ///< エフェクト演算 (FFBEngine)
+  PROFILE_SCALE,       ///< トルクスケーリングと物理エフェクト加算
+  PROFILE_CAN_SEND,    ///< トルク指令の送信 (setTorque / flush)
+  PROFILE_CONTROL,     ///< 制御周期の処理全体
+  PROFILE_SAMPLE,      ///< ADC/DI サンプリング
+  // --- Core 0 ---
+  PROFILE_LOOP0,       ///< loop() 1回分
+  PROFILE_USB_BG,      ///< loop() の外 (USB スタックなど) の時間
+  PROFILE_PID_PARSE,   ///< PID レポートの解析
+  PROFILE_HID_SEND,    ///< 入力レポートの送信
+  PROFILE_ZONE_COUNT,
+  PROFILE_CORE0_FIRST = PROFILE_LOOP0 ///< Core 0 が記録する先頭のゾーン
+};
+
+#ifdef ZONE_PROFILER_ENABLE
+
+/**
+ * @brief ゾーンの集計値
+ */
+struct ZoneStats {
+  uint32_t count;    ///< 計測回数
+  uint32_t overruns; ///< 予算超過の回数
+  uint16_t minUs;    ///< 最小値
+  uint16_t avgUs;    ///< 平均値
+  uint16_t maxUs;    ///< 最大値
+  uint16_t p99Us;    ///< 99パーセンタイル (ヒストグラム分解能)
+  uint16_t budgetUs; ///< 予算 (0: なし)
+};
+
+/**
+ * @class ZoneProfiler
+ * @brief ゾーンごとの集計 (静的メンバのみ)
+ */
+class ZoneProfiler {
+public:
+  /// ヒストグラムのビン数 (最後のビンは範囲外をまとめる)
+  static constexpr uint8_t PROFILE_BINS = 64;
+
+  /**
+   * @brief 1回分の所要時間を記録する
+   * @param zone ゾーン
+   * @param elapsedUs 所要時間 (us)
+   */
+  static void record(ProfileZone zone, uint32_t elapsedUs);
+
+  /**
+   * @brief 集計値を取得し、集計をリセットする
+   *
+   * ゾーンを記録するコアから呼ぶこと (記録と重ならないため、
+   * 全項目が同時に 0 に戻る)。p99 のためヒストグラムを走査する。
+   */
+  static ZoneStats takeStats(ProfileZone zone);
+
+  /**
+   * @brief ゾーンの名前
+   */
+  static const char *getName(ProfileZone zone);
+
+  /**
+   * @brief タイマの現在値 (us)
+   */
+  static uint32_t now();
+};
+
+/**
+ * @class ZoneScope
+ * @brief 生成からスコープ終了までを計測する
+ */
+class ZoneScope {
+public:
+  explicit ZoneScope(ProfileZone zone)
+      : zone(zone), startUs(ZoneProfiler::now()) {}
+  ~ZoneScope() { ZoneProfiler::record(zone, ZoneProfiler::now() - startUs); }
+
+private:
+  ProfileZone zone;
+  uint32_t startUs;
+};
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#define PROFILE_SCOPE(zone)                                                    \
+  ZoneScope PROFILE_CONCAT(profileScope_, __LINE__)(zone)
+#define PROFILE_BEGIN(zone)                                                    \
+  uint32_t profileStart_##zone = ZoneProfiler::now()
+#define PROFILE_END(zone)                                                      \
+  ZoneProfiler::record(zone, ZoneProfiler::now() - profileStart_##zone)
+
+#else
+
+#define PROFILE_SCOPE(zone) ((void)0)
+#define PROFILE_BEGIN(zone) ((void)0)
+#define PROFILE_END(zone) ((void)0)
+
+#endif // ZONE_PROFILER_ENABLE
+
+#endif // ZONE_PROFILER_H
@@ -6,6 +6,7 @@
  * @brief Ene1_HandCont_rp2040_FFB プロジェクト全体の設定ファイル
  */
 
+#include "CANInterface.h" // canFrameBitsMax()
 #include <stdint.h>
 
 namespace Config {
@@ -23,8 +24,30 @@ inline constexpr uint8_t CAN_CS = 5;  // MCP2515 Chip Select
 inline constexpr uint8_t SHIFT_UP = 14;   // シフトアップボタン (D6, Active Low)
 inline constexpr uint8_t SHIFT_DOWN = 15; // シフトダウンボタン (D7, Active Low)
 
+// ボタンボックス (ButtonBank, 連続した GPIO に直結, Active Low)
+// HID のボタン 3 以降に割り当てる (0 で未使用)
+inline constexpr uint8_t BUTTON_BOX_FIRST = 6;
+inline constexpr uint8_t BUTTON_BOX_COUNT = 0;
+
 inline constexpr uint8_t ACCEL = 26; // ADC0 (A0) - アクセルペダル
 inline constexpr uint8_t BRAKE = 28; // ADC2 (A2) - ブレーキペダル
+
+// ボタンボックスの GPIO 範囲 [FIRST, FIRST + COUNT) に pin が含まれるか
+constexpr bool inButtonBox(uint8_t pin) {
+  return pin >= BUTTON_BOX_FIRST && pin < BUTTON_BOX_FIRST + BUTTON_BOX_COUNT;
+}
+// 他の用途の GPIO と重ならないこと
+// (FIRST = 6 では SHIFT_UP (14) の手前まで、COUNT は 8 以下)
+static_assert(BUTTON_BOX_FIRST + BUTTON_BOX_COUNT <= 30,
+              "button box exceeds GPIO29");
+static_assert(!inButtonBox(SHIFT_UP) && !inButtonBox(SHIFT_DOWN),
+              "button box overlaps the shift paddles");
+static_assert(!inButtonBox(SPI_INT) && !inButtonBox(SPI_SCK) &&
+                  !inButtonBox(SPI_TX) && !inButtonBox(SPI_RX) &&
+                  !inButtonBox(CAN_CS),
+              "button box overlaps the MCP2515 pins");
+static_assert(!inButtonBox(ACCEL) && !inButtonBox(BRAKE),
+              "button box overlaps the pedal ADC pins");
 } // namespace Pin
 
 // ============================================================================
@@ -33,14 +56,25 @@ inline constexpr uint8_t BRAKE = 28; // ADC2 (A2) - ブレーキペダル
 namespace Steer {
 inline constexpr uint32_t CAN_ID = 0x141; // MF4015のCAN ID
 inline constexpr uint8_t DEVICE_ID = 1;   // MF4015デバイスID
+// トルク指令で制御するモーター数 (setup1() で MotorGroup に登録する台数)
+// トルク指令1回の応答フレーム数になる (Time::TORQUE_CMD_BUS_BITS)
+inline constexpr uint8_t MOTOR_COUNT = 1;
+static_assert(MOTOR_COUNT >= 1 && MOTOR_COUNT <= 4,
+              "MotorGroup controls 1 to 4 motors");
 
 // エンコーダ分解能: 16bit(65536カウント) / 360度
-inline constexpr double ENCODER_COUNTS_PER_DEG = 65536.0 / 360.0;
+inline constexpr int32_t ENCODER_COUNTS_PER_REV = 65536;
+inline constexpr double ENCODER_COUNTS_PER_DEG =
+    (double)ENCODER_COUNTS_PER_REV / 360.0;
 
-// 有効角度範囲 (0を中心とした片側角度, 単位: deg)
+// 有効角度範囲 (0を中心とした片側角度, 単位: deg) の既定値
+// 実行時は sharedData.steerRangeDeg で変更する (ロックtoロックはこの2倍)
 inline constexpr double ANGLE_RANGE_DEG = 30.0;
+// 実行時に設定できる片側角度の範囲 (deg)
+inline constexpr uint16_t ANGLE_RANGE_DEG_MIN = 10;
+inline constexpr uint16_t ANGLE_RANGE_DEG_MAX = 720;
 
-// 有効角度範囲 (エンコーダカウント値, constexpr算出)
+// 既定の有効角度範囲 (エンコーダカウント値, constexpr算出)
 inline constexpr int32_t ANGLE_MIN =
     -(int32_t)(ANGLE_RANGE_DEG * ENCODER_COUNTS_PER_DEG);
 inline constexpr int32_t ANGLE_MAX =
@@ -60,8 +94,57 @@ inline constexpr float SPRING_COEFF =
 inline constexpr float FRICTION_COEFF = 0.0f;  // 摩擦係数（現状無効）
 inline constexpr float DAMPER_COEFF = 0.0001f; // ダンパー係数（現状無効）
 inline constexpr float INERTIA_COEFF = 0.0f;   // 慣性係数（現状無効）
+
+// 状態要求の周期 (ms, 0: 要求しない)
+// トルク指令の応答後、次のトルク指令までにバスが空いている場合のみ送信する
+inline constexpr uint32_t STATUS1_POLL_MS = 100;   // 0x9A (電圧・エラー状態)
+inline constexpr uint32_t STATUS2_POLL_MS = 500;   // 0x9C (温度・電流・速度)
+inline constexpr uint32_t MULTI_ANGLE_POLL_MS = 0; // 0x92 (多回転角度)
 } // namespace Steer
 
+// ============================================================================
+// CAN受信設定
+// ============================================================================
+namespace Can {
+// 1ループで一括取得する受信フレーム数の上限
+inline constexpr uint8_t RX_BATCH_SIZE = 8;
+// MCP2515 SPIクロック (Hz) MCP2515の上限 10MHz
+inline constexpr uint32_t SPI_CLOCK_HZ = 10000000;
+// 受信フィルタのマスク (標準フレーム 11bit の完全一致)
+inline constexpr uint32_t STD_ID_MASK = 0x7FF;
+// CANビットレート (bps) 125000/250000/500000/1000000
+// モーター側の設定 (LKTECH 設定ツール) と一致させること
+inline constexpr uint32_t BITRATE = 500000;
+// 起動時のモーター応答確認の待ち時間 (ms)
+inline constexpr uint32_t MOTOR_PROBE_TIMEOUT_MS = 50;
+// バス使用率・通信品質の集計周期 (ms)
+inline constexpr uint32_t BUS_LOAD_WINDOW_MS = 100;
+// 指令→応答の往復時間 (RTT) がこれを超えたら遅延応答として数える (us)
+inline constexpr uint32_t RTT_LATE_US = 1000;
+// 状態要求の送信判定で、次のトルク指令までに残す余裕 (us)
+inline constexpr uint32_t POLL_GUARD_US = 50;
+} // namespace Can
+
+// ============================================================================
+// シミュレーション設定 (CAN_BACKEND_SIM 定義時, SimulatedMotorBus)
+// ============================================================================
+namespace Sim {
+// 慣性モーメント (kg*m^2, ハンドル + ロータ)
+inline constexpr float INERTIA = 0.02f;
+// 粘性摩擦 (N*m/(rad/s))
+inline constexpr float VISCOUS_FRICTION = 0.01f;
+// クーロン摩擦 (N*m)
+inline constexpr float COULOMB_FRICTION = 0.02f;
+// トルク定数 (N*m/A)
+inline constexpr float TORQUE_CONSTANT = 0.07f;
+// モーターの応答処理時間 (us, バス占有時間は別途加算)
+inline constexpr uint32_t REPLY_LATENCY_US = 50;
+// 応答の欠落率 (0.1% 単位)
+inline constexpr uint16_t DROP_PERMIL = 0;
+// 欠落判定の乱数の種
+inline constexpr uint32_t RANDOM_SEED = 1;
+} // namespace Sim
+
 // ============================================================================
 // タイミング設定
 // ============================================================================
@@ -69,7 +152,33 @@ namespace Time {
 // ADC/DI サンプリング周期 (us)
 inline constexpr uint32_t SAMPLING_INTERVAL_US = 250;
 // ステアリング制御インターバル(us)
+// 制御の基本周期: FFB 命令の取得・設定の反映 (共有メモリとの交換)
 inline constexpr uint32_t STEAR_CONT_INTERVAL_US = 1000;
+// エフェクト演算の倍率 (基本周期あたりの演算回数, 1: 1kHz 2: 2kHz 4: 4kHz)
+// 指令の間の演算は Periodic 系の平均に使う (FFBEngine::samplePeriodic())
+inline constexpr uint32_t EFFECT_RATE_MULTIPLIER = 1;
+static_assert(EFFECT_RATE_MULTIPLIER == 1 || EFFECT_RATE_MULTIPLIER == 2 ||
+                  EFFECT_RATE_MULTIPLIER == 4,
+              "EFFECT_RATE_MULTIPLIER must be 1, 2 or 4");
+// エフェクト演算周期 (us, Control タスクの周期)
+inline constexpr uint32_t EFFECT_INTERVAL_US =
+    STEAR_CONT_INTERVAL_US / EFFECT_RATE_MULTIPLIER;
+// トルク指令 (CAN) の周期 (us, エフェクト演算周期の整数倍, 基本周期の約数)
+// 角度 (指令の応答) の取得周期でもあり、速度推定の dt になる
+inline constexpr uint32_t TORQUE_CMD_INTERVAL_US = 1000;
+static_assert(TORQUE_CMD_INTERVAL_US % EFFECT_INTERVAL_US == 0,
+              "TORQUE_CMD_INTERVAL_US must be a multiple of "
+              "EFFECT_INTERVAL_US");
+static_assert(STEAR_CONT_INTERVAL_US % TORQUE_CMD_INTERVAL_US == 0,
+              "TORQUE_CMD_INTERVAL_US must divide STEAR_CONT_INTERVAL_US");
+// トルク指令1回のバス占有 (指令1フレーム + モーター台数分の応答, bit)
+// MotorGroup::torqueCycleBits() と同じ。1台で 500kbps 540us, 1Mbps 270us
+inline constexpr uint32_t TORQUE_CMD_BUS_BITS =
+    (1 + (uint32_t)Steer::MOTOR_COUNT) * canFrameBitsMax(8, false);
+static_assert((uint64_t)TORQUE_CMD_BUS_BITS * 1000000 / Can::BITRATE +
+                      Can::POLL_GUARD_US <=
+                  TORQUE_CMD_INTERVAL_US,
+              "TORQUE_CMD_INTERVAL_US is too short for Can::BITRATE");
 // HIDレポート送信周期 (ms) デバイス側の送信間隔(最大値)
 inline constexpr uint32_t HIDREPO_INTERVAL_MS = 1;
 // USB HID ポーリング周期 (ms) ホスト側のポーリング間隔(最大値)
@@ -80,20 +189,48 @@ inline constexpr uint32_t USB_POLL_INTERVAL_MS = 5;
 // アナログ入力設定
 // ============================================================================
 namespace Adc {
-inline constexpr uint16_t ACCEL_MIN = 180; // ADC最小値 (10bit基準)
-inline constexpr uint16_t ACCEL_MAX = 400; // ADC最大値 (10bit基準)
+// 範囲値は 16bit 基準 (0〜65535 = 12bit の変換値の16倍, 旧 10bit 値の64倍)
+inline constexpr uint16_t ACCEL_MIN = 11520; // ADC最小値 (10bit: 180)
+inline constexpr uint16_t ACCEL_MAX = 25600; // ADC最大値 (10bit: 400)
 
 inline constexpr uint32_t ACCEL_HID_MIN = 0;
 inline constexpr uint32_t ACCEL_HID_MAX = 65535;
 
-inline constexpr uint16_t BRAKE_MIN = 100; // ADC最小値 (10bit基準)
-inline constexpr uint16_t BRAKE_MAX = 750; // ADC最大値 (10bit基準)
+inline constexpr uint16_t BRAKE_MIN = 6400;  // ADC最小値 (10bit: 100)
+inline constexpr uint16_t BRAKE_MAX = 48000; // ADC最大値 (10bit: 750)
 
 inline constexpr uint32_t BRAKE_HID_MIN = 0;
 inline constexpr uint32_t BRAKE_HID_MAX = 65535;
 
+// デッドゾーン (校正範囲に対する 0.1% 単位, 両ペダル共通の既定値)
+// 範囲・デッドゾーンは自動校正で更新され、ConfigManager で保存される
+inline constexpr uint16_t DEADZONE_INNER_PERMIL = 20; // 離した側
+inline constexpr uint16_t DEADZONE_OUTER_PERMIL = 10; // 踏み込み側
+
 inline constexpr uint8_t BUFFER_SIZE = 12;  // 移動平均バッファサイズ
-inline constexpr uint8_t AVERAGE_COUNT = 8; // 移動平均サンプル数
+inline constexpr uint8_t AVERAGE_COUNT = 2; // 移動平均サンプル数 (2のべき乗)
+
+// DMA サンプリングの変換レート (Hz, 全入力の合計)
+// 2入力の巡回で各 64kHz。ADC の上限は 500kHz
+inline constexpr uint32_t DMA_SAMPLE_RATE_HZ = 128000;
+// 間引き率の log2: 64 サンプル (1ms) の合計を1サンプルにする
+// (64倍オーバーサンプリングで実効 15bit, 間引き後は各 1kHz)
+// 平均窓は 64 x AVERAGE_COUNT サンプル = 2ms (群遅延 約1ms)
+inline constexpr uint8_t DECIMATION_SHIFT = 6;
+// 間引き後の各チャンネルのサンプルレート (Hz, アクセル・ブレーキの2入力)
+inline constexpr uint32_t FILTER_SAMPLE_RATE_HZ =
+    (DMA_SAMPLE_RATE_HZ / 2) >> DECIMATION_SHIFT;
+
+// 平滑化フィルタ: true で One-Euro (速度適応ローパス), false で移動平均
+inline constexpr bool ACCEL_ONE_EURO = true;
+inline constexpr bool BRAKE_ONE_EURO = true;
+// One-Euro: 遮断周波数 = MIN_CUTOFF + BETA × |速度 (16bit基準の値/s)|
+// フルストローク 60ms の踏み込み (約70万/s) で数kHz まで上がる
+// 速度推定の遮断周波数が低いと踏み込みの始まりで遮断周波数が上がりきらず、
+// 移動平均より遅れる (test_one_euro)
+inline constexpr float ONE_EURO_MIN_CUTOFF_HZ = 5.0f; // 静止時の遮断周波数
+inline constexpr float ONE_EURO_BETA = 0.005f;        // Hz / (値/s)
+inline constexpr float ONE_EURO_DCUTOFF_HZ = 30.0f;   // 速度推定の遮断周波数
 } // namespace Adc
 
 // ============================================================================
@@ -101,13 +238,19 @@ inline constexpr uint8_t AVERAGE_COUNT = 8; // 移動平均サンプル数
 // ============================================================================
 namespace Input {
 inline constexpr uint8_t BUTTON_DEBOUNCE_THRESHOLD = 4; // 連続一致サンプル数
-}
+// エッジ方式: 最初のエッジで即確定し、この時間のチャタリングを無視する
+// (0 でサンプリング方式, 押下・解放とも最短操作間隔になる)
+inline constexpr uint32_t BUTTON_LOCKOUT_US = 5000;
+} // namespace Input
 
 // ============================================================================
 // USB HID設定
 // ============================================================================
 namespace Hid {
-inline constexpr uint8_t BUTTON_COUNT = 2; // ボタン数
+inline constexpr uint8_t PADDLE_COUNT = 2; // シフトパドル (ボタン 1, 2)
+inline constexpr uint8_t BUTTON_COUNT =    // ボタン数
+    PADDLE_COUNT + Pin::BUTTON_BOX_COUNT;
+static_assert(BUTTON_COUNT <= 16, "HID report has 16 button bits");
 inline constexpr uint8_t AXIS_COUNT = 3;   // 軸数
 } // namespace Hid
 
@@ -123,5 +266,10 @@ inline constexpr uint32_t SERIAL_BAUDRATE = 115200;
 // #define PHYSICAL_INPUT_DEBUG_ENABLE // 物理入力のデバッグを有効にする
 // #define FFB_DEBUG_ENABLE // FFBのデバッグを有効にする
 // #define CALLBACK_TEST_ENABLE // コールバックテストを有効にする
+// #define CAN_BACKEND_AUTOWP // CANをautowpライブラリ経由(MCP2515_Wrapper)にする
+// #define CAN_BACKEND_SIM // CANをモーター・ハンドルの模擬(SimulatedMotorBus)にする
+// #define TICK_SOFTWARE_TIMER // Core1の周期をmicros()判定にする(比較用)
+// #define ZONE_PROFILER_ENABLE // 処理区間ごとの時間計測を有効にする
+// #define HOT_PATH_IN_RAM // 制御周期の関数・テーブルをSRAMに配置する
 
 #endif // CONFIG_H
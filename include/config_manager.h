@@ -5,12 +5,35 @@
 #include <Arduino.h>
 #include <LittleFS.h>
 
-
 /**
  * @file config_manager.h
  * @brief 設定値の保存・復元を行うクラス
  */
 
+/**
+ * @struct StoredConfig
+ * @brief 保存する設定値 (CONFIG_FILE の内容)
+ *
+ * SharedData のうち、ホストや自動校正で変更する設定だけを保存します。
+ * 実行中の状態 (変更番号・自動校正の状態・計測値) は含めません。
+ * 構成を変えた場合は VERSION を進めます (版の異なるファイルは読み込まず、
+ * 既定値で起動します)。
+ */
+struct StoredConfig {
+  static constexpr uint32_t MAGIC = 0x45314646; ///< "FF1E"
+  static constexpr uint16_t VERSION = 1;
+
+  uint32_t magic;   ///< MAGIC
+  uint16_t version; ///< VERSION
+  uint16_t size;    ///< sizeof(StoredConfig)
+
+  uint16_t steerRangeDeg;      ///< SharedData::steerRangeDeg
+  PedalCurveConfig accelCurve; ///< SharedData::accelCurve
+  PedalCurveConfig brakeCurve; ///< SharedData::brakeCurve
+  PedalCalibConfig accelCalib; ///< SharedData::accelCalib
+  PedalCalibConfig brakeCalib; ///< SharedData::brakeCalib
+};
+
 class ConfigManager {
 public:
   /**
@@ -21,13 +44,16 @@ public:
 
   /**
    * @brief 設定値をFlash(LittleFS)に保存する
+   *
+   * 書き込み中は Core 1 が停止するため、呼び出し側でトルク出力を
+   * 止めておくこと (SharedData::torqueHoldSeq)。
    * @return true: 成功, false: 失敗
    */
   static bool saveConfig();
 
   /**
-   * @brief Flash(LittleFS)から設定値を読み込む
-   * @return true: 成功, false: 失敗
+   * @brief Flash(LittleFS)から設定値を読み込む (起動時)
+   * @return true: 成功, false: 失敗 (ファイルなし・版の不一致)
    */
   static bool loadConfig();
 
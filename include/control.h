@@ -10,6 +10,9 @@
 
 /**
  * @brief 物理エフェクト計算クラス
+ *
+ * update() は角度の取得ごとに呼び出す。period_us には取得周期
+ * (Config::Time::TORQUE_CMD_INTERVAL_US) を渡す。
  */
 class PhysicalEffect {
 public:
@@ -23,7 +26,7 @@ private:
   float _k_spring;
   float _k_damper;
   float _k_inertia;
-  float _dt_sec;
+  float _inv_dt; ///< 1 / 周期 (1/s, 差分 → 速度・加速度)
 
   float _prev_angle;
   float _prev_velocity;
@@ -32,6 +35,8 @@ private:
 
 /**
  * @brief PID制御クラス
+ *
+ * update() は period_us ごとに呼び出す。
  */
 class PID {
 public:
@@ -42,7 +47,8 @@ public:
 
 private:
   float _kp, _ki, _kd;
-  float _dt_sec;
+  float _dt_sec; ///< 周期 (s, 積分)
+  float _inv_dt; ///< 1 / 周期 (1/s, 微分)
   int16_t _target;
 
   float _integral;
@@ -34,8 +34,8 @@
  *
  * @param eff        エフェクト共有状態 (FFB_Shared_State_t)
  * @param steer_hid  ハンドル位置 (HID 単位 -32767..32767)
- * @param vel_norm   正規化速度   (-10000..10000 スケール / ループ周期)
- * @param accel_norm 正規化加速度 (-10000..10000 スケール / ループ周期²)
+ * @param vel_norm   正規化速度   (-10000..10000 スケール / 基準周期)
+ * @param accel_norm 正規化加速度 (-10000..10000 スケール / 基準周期²)
  * @return           エフェクト力 (-10000..10000, PID 単位)
  */
 int16_t ffb_calc_condition_force(const FFB_Shared_State_t &eff,
@@ -64,18 +64,50 @@ int16_t ffb_calc_periodic_force(const FFB_Shared_State_t &eff);
  * ステアリング位置の差分から速度・加速度を推定し、全エフェクトを合算する。
  * 状態（前回値）をメンバ変数で保持し、外部から reset() で初期化可能。
  *
+ * 速度・加速度は角度の取得ごと (updateMotion()) に推定し、
+ * エフェクトの合算 (update()) はトルク指令ごとに行う。
+ * 推定値は基準周期 (REFERENCE_PERIOD_US) あたりの変化量に換算するため、
+ * 取得周期を変えても Damper / Inertia / Friction の効きは変わらない。
+ *
+ * エフェクト演算周期がトルク指令周期より短い場合は、指令の間の演算周期
+ * ごとに samplePeriodic() を呼ぶ。時間で変化する Periodic 系は指令周期の
+ * 平均を送り (指令周期に近い周期の波形の折り返しを抑える)、角度で決まる
+ * Condition 系は最新の角度・速度で演算する。
+ *
  * @note PhysicalEffect (control.h) と同じ設計パターン。
- *       Core1 の制御周期ごとに update() を 1 回呼び出すこと。
  */
 class FFBEngine {
 public:
-  FFBEngine();
+  /// 速度・加速度の正規化の基準周期 (us, 従来の制御周期)
+  static constexpr uint32_t REFERENCE_PERIOD_US = 1000;
+
+  /**
+   * @brief コンストラクタ
+   * @param sample_period_us 角度の取得周期 (us, updateMotion() の呼び出し周期)
+   */
+  explicit FFBEngine(uint32_t sample_period_us);
+
+  /**
+   * @brief 角度の取得ごとに速度・加速度を推定する
+   * @param steer_hid  取得したハンドル位置 (HID 単位 -32767..32767)
+   */
+  void updateMotion(int16_t steer_hid);
+
+  /**
+   * @brief トルク指令の間の演算周期ごとに Periodic 系の出力を積算する
+   *
+   * 積算値は次の update() で平均して使い、破棄する。
+   *
+   * @param effects    共有エフェクト配列 (要素数 MAX_EFFECTS)
+   */
+  void samplePeriodic(const FFB_Shared_State_t *effects);
 
   /**
    * @brief 全アクティブエフェクトを合算した FFB トルク値を返す
    *
-   * Core1 の制御周期ごとに 1 回呼び出すこと。
-   * 内部で速度・加速度を推定してから Condition/Periodic エフェクトを合算する。
+   * トルク指令周期ごとに 1 回呼び出すこと。
+   * 速度・加速度は直近の updateMotion() の推定値を使用する。
+   * Periodic 系は前回の update() 以降の samplePeriodic() と今回の値の平均。
    *
    * @param effects    共有エフェクト配列 (要素数 MAX_EFFECTS)
    * @param steer_hid  現在のハンドル位置 (HID 単位 -32767..32767)
@@ -92,8 +124,13 @@ public:
   void reset();
 
 private:
+  float _rate_scale;    ///< 基準周期 / 取得周期 (差分 → 基準周期あたり)
+  float _vel_scale;     ///< 位置差分 → 正規化速度の係数
   int16_t _prev_steer;  ///< 前回ハンドル位置 (HID 単位)
-  float _prev_vel_norm; ///< 前回正規化速度
+  float _vel_norm;      ///< 正規化速度 (基準周期あたり)
+  float _accel_norm;    ///< 正規化加速度 (基準周期²あたり)
+  int32_t _periodic_sum;   ///< Periodic 系の出力の積算 (gain 適用後)
+  uint16_t _periodic_count; ///< 積算した演算周期の数
 };
 
 #endif // FFB_ENGINE_H
@@ -40,6 +40,15 @@
  * - ID 0x05 : Create New Effect       (エフェクト生成要求)
  * - ID 0x06 : PID Block Load          (スロット割当結果の応答)
  * - ID 0x07 : PID Pool Report         (デバイス容量情報)
+ *
+ * Application Collection: Vendor Defined (Usage Page 0xFF00, Usage 0x01)
+ *
+ * [Feature Reports] (Host -> Device / 設定)
+ * - ID 0x20 : Pedal Curve             (ペダルの応答曲線)
+ *
+ * [Feature Reports] (Host <-> Device / 操作・状態)
+ * - ID 0x21 : Pedal Calibration       (自動校正の開始・終了, 状態の読み出し)
+ * - ID 0x22 : Steer Range             (有効角度範囲の設定, 適用値の読み出し)
  */
 #ifndef HID_PID_DESCRIPTOR_H
 #define HID_PID_DESCRIPTOR_H
@@ -692,6 +701,33 @@ static uint8_t const desc_hid_report[] = {
 	0x95, 0x01, // REPORT_COUNT (01)
 	0xB1, 0x03, // FEATURE ( Cnst,Var,Abs)
   0xC0, // END COLLECTION ()
+  0xC0, // END COLLECTION (Application)
+
+  // -----------------------------------------------------------------------
+  // Application Collection: Vendor Defined (設定用 Feature Report)
+  // DirectInput は参照しない。内容は hidwffb.h の構造体を参照
+  // -----------------------------------------------------------------------
+  0x06, 0x00, 0xFF, // USAGE_PAGE (Vendor Defined 0xFF00)
+  0x09, 0x01,       // USAGE (Vendor Usage 1)
+  0xA1, 0x01,       // COLLECTION (Application)
+	0x15, 0x00,       // LOGICAL_MINIMUM (00)
+	0x26, 0xFF, 0x00, // LOGICAL_MAXIMUM (00 FF)
+	0x75, 0x08,       // REPORT_SIZE (08)
+	// Pedal Curve (USB_Feature_PedalCurve_t)
+	0x85, HID_ID_PEDAL_CURVE, // REPORT_ID (20)
+	0x09, 0x20,       // USAGE (Vendor Usage 0x20)
+	0x95, sizeof(USB_Feature_PedalCurve_t) - 1, // REPORT_COUNT (37)
+	0xB1, 0x02,       // FEATURE (Data,Var,Abs)
+	// Pedal Calibration (USB_Feature_PedalCalib_t)
+	0x85, HID_ID_PEDAL_CALIB, // REPORT_ID (21)
+	0x09, 0x21,       // USAGE (Vendor Usage 0x21)
+	0x95, sizeof(USB_Feature_PedalCalib_t) - 1, // REPORT_COUNT (01)
+	0xB1, 0x02,       // FEATURE (Data,Var,Abs)
+	// Steer Range (USB_Feature_SteerRange_t)
+	0x85, HID_ID_STEER_RANGE, // REPORT_ID (22)
+	0x09, 0x22,       // USAGE (Vendor Usage 0x22)
+	0x95, sizeof(USB_Feature_SteerRange_t) - 1, // REPORT_COUNT (02)
+	0xB1, 0x02,       // FEATURE (Data,Var,Abs)
   0xC0 // END COLLECTION (Application)
 };
 #endif // HID_PID_DESCRIPTOR_H
\ No newline at end of file
@@ -7,6 +7,7 @@
 #ifndef HIDWFFB_H
 #define HIDWFFB_H
 
+#include "PedalCurve.h"
 #include "pico/mutex.h"
 #include <Adafruit_TinyUSB.h>
 #include <Arduino.h>
@@ -41,6 +42,16 @@
 #define HID_ID_PID_BLOCK_LOAD 0x06    ///< PID Block Load Report (Feature)
 #define HID_ID_PID_POOL 0x07          ///< PID Pool Report (Feature)
 
+// --- Report IDs (Vendor Defined Feature Reports: 設定) ---
+#define HID_ID_PEDAL_CURVE 0x20 ///< Pedal Curve (Feature, HostWrite)
+#define HID_ID_PEDAL_CALIB 0x21 ///< Pedal Calibration (Feature, HostRW)
+#define HID_ID_STEER_RANGE 0x22 ///< Steer Range (Feature, HostRW)
+
+// --- ペダル番号 (設定レポート) ---
+#define HID_PEDAL_ACCEL 0x00 ///< アクセル
+#define HID_PEDAL_BRAKE 0x01 ///< ブレーキ
+#define HID_PEDAL_COUNT 2
+
 // --- Effect Types (ET) ---
 #define HID_ET_CONSTANT 0x01 ///< ET Constant Force
 #define HID_ET_RAMP 0x02     ///< ET Ramp
@@ -251,6 +262,43 @@ typedef struct {
   uint8_t memoryManagement; ///< bit0=deviceManagedPool, bit1=sharedParamBlocks
 } __attribute__((packed)) USB_FFB_Feature_PIDPool_t;
 
+/**
+ * @brief Pedal Curve Feature Report (ID: 0x20, Feature - Host Write)
+ *
+ * ベンダー定義。ペダルの応答曲線 (PedalCurveConfig) を設定する。
+ * 受信した設定は Core 0 が SharedData へ書き込み、保存する。
+ */
+typedef struct {
+  uint8_t reportId;   ///< = 0x20
+  uint8_t pedal;      ///< HID_PEDAL_ACCEL / HID_PEDAL_BRAKE
+  uint8_t type;       ///< PedalCurveType
+  uint8_t pointCount; ///< 折れ線の点数 (0..PEDAL_CURVE_MAX_POINTS)
+  uint16_t param;     ///< ガンマ値 x100 / S字の混合率 (%)
+  uint16_t points[PEDAL_CURVE_MAX_POINTS * 2]; ///< 折れ線の点 (x, y の順)
+} __attribute__((packed)) USB_Feature_PedalCurve_t;
+
+/**
+ * @brief Pedal Calibration Feature Report (ID: 0x21, Feature - Host R/W)
+ *
+ * ベンダー定義。SET で自動校正を操作し (PEDAL_CALIB_RUN: 観測開始,
+ * PEDAL_CALIB_FINISH: 校正値の作成と保存)、GET で状態を読み出す。
+ */
+typedef struct {
+  uint8_t reportId; ///< = 0x21
+  uint8_t mode;     ///< PedalCalibMode
+} __attribute__((packed)) USB_Feature_PedalCalib_t;
+
+/**
+ * @brief Steer Range Feature Report (ID: 0x22, Feature - Host R/W)
+ *
+ * ベンダー定義。SET でステアリングの有効角度範囲を設定して保存し、
+ * GET で適用中の値 (ANGLE_RANGE_DEG_MIN..MAX に丸めた値) を読み出す。
+ */
+typedef struct {
+  uint8_t reportId;      ///< = 0x22
+  uint16_t halfRangeDeg; ///< センターからの片側角度 (deg)
+} __attribute__((packed)) USB_Feature_SteerRange_t;
+
 /**
  * @brief パースされたPIDデータの要約（デバッグ出力用）
  */
@@ -297,6 +345,11 @@ bool hidwffb_is_mounted(void);
 void hidwffb_wait_for_mount(void);
 bool hidwffb_ready(void);
 bool hidwffb_get_ffb_data(uint8_t *buffer);
+bool hidwffb_get_pedal_curve(uint8_t pedal, PedalCurveConfig *config);
+bool hidwffb_get_pedal_calib_command(uint8_t *mode);
+void hidwffb_set_pedal_calib_status(uint8_t mode);
+bool hidwffb_get_steer_range(uint16_t *halfRangeDeg);
+void hidwffb_set_steer_range_status(uint16_t halfRangeDeg);
 void hidwffb_clear_ffb_flag(void);
 
 void PID_ParseReport(uint8_t const *buffer, uint16_t bufsize);
@@ -0,0 +1,50 @@
+#ifndef HOT_PATH_H
+#define HOT_PATH_H
+
+#include "config.h"
+#include <Arduino.h> // __not_in_flash_func / __not_in_flash (pico/platform.h)
+
+/**
+ * @file hot_path.h
+ * @brief 制御周期の関数・テーブルを SRAM に配置する指定
+ * @date 2026-10-18
+ *
+ * RP2040 のプログラムは XIP フラッシュ (16KB のキャッシュ付き) から
+ * 実行されます。キャッシュは両コアと USB スタックで共有されるため、
+ * Core 0 側の処理でキャッシュラインが追い出されると、Core 1 の制御周期で
+ * フラッシュ読み出し (1ライン数 us) が発生し、処理時間がばらつきます。
+ *
+ * config.h の HOT_PATH_IN_RAM を定義すると、HOT_FUNC / HOT_DATA を
+ * 付けた関数・テーブルを ".time_critical.<名前>" セクションに置きます。
+ * arduino-pico のリンカスクリプト (memmap_default.ld) はこのセクションを
+ * .data に含めるため、起動時に SRAM へコピーされ、以後はフラッシュを
+ * 経由せずに実行・参照されます (リンカスクリプトの変更は不要)。
+ * 未定義の場合はどちらも何もしません (従来どおりフラッシュに配置)。
+ *
+ * ## 使い方
+ * - 関数: 定義側の名前を囲む (宣言は変更しない)
+ *   @code
+ *   int32_t HOT_FUNC(FFBEngine::update)(const FFB_Shared_State_t *e, ...)
+ *   @endcode
+ * - テーブル: 定義の前に付ける (名前はオブジェクトごとに一意にする)
+ *   @code
+ *   HOT_DATA(zone_info) constexpr ZoneInfo ZONE_INFO[] = {...};
+ *   @endcode
+ *
+ * @note 対象は両コアの周期処理と、そこから呼ばれる CAN の割り込み経路に
+ *       限ります (配置先と RAM 消費の一覧は SteeringModule.md §6.5)。
+ *       ヘッダ内のインライン関数は呼び出し元に展開されるため指定不要です。
+ *       テンプレートの関数 (暗黙の実体化) には section 属性が効かないため、
+ *       展開されない関数 (仮想関数など) は明示的特殊化として .cpp に定義し、
+ *       そこに指定します (ADInputChannelImpl::putSamples())。
+ */
+
+#ifdef HOT_PATH_IN_RAM
+#define HOT_FUNC(name) __not_in_flash_func(name)
+#define HOT_DATA(group) __not_in_flash(#group)
+#else
+#define HOT_FUNC(name) name
+#define HOT_DATA(group)
+#endif // HOT_PATH_IN_RAM
+
+#endif // HOT_PATH_H
@@ -1,6 +1,9 @@
 #ifndef SHARED_DATA_H
 #define SHARED_DATA_H
 
+#include "PedalCalibration.h"
+#include "PedalCurve.h"
+#include "ZoneProfiler.h"
 #include "hidwffb.h"
 
 /**
@@ -12,6 +15,62 @@
  * 物理入力およびFFB情報の詳細は hidwffb.h の構造体定義を参照してください。
  */
 
+/**
+ * @struct TickTiming
+ * @brief Core 1 制御周期内の処理時間の内訳 (マイクロ秒)
+ *
+ * Core 1 が制御周期ごとに更新し、監視用に参照する。
+ * CAN送信はDMAで非同期に行われるため、canSendUs (CPU拘束時間) と
+ * canTxDoneUs (周期開始から送信要求完了まで) を分けて記録する。
+ */
+struct TickTiming {
+  volatile uint16_t rxParseUs;   ///< 受信フレーム解析と入力レポート更新
+  volatile uint16_t sharedUs;    ///< 共有メモリとの同期
+  volatile uint16_t effectUs;    ///< エフェクト演算とトルクスケーリング
+  volatile uint16_t canSendUs;   ///< setTorque() の CPU 拘束時間
+  volatile uint16_t canTxDoneUs; ///< 周期開始から送信要求 (RTS) 完了まで
+  volatile uint16_t sampleUs;    ///< ADC/DI サンプリング
+};
+
+/**
+ * @struct TickJitter
+ * @brief 周期処理の開始遅れ (期限から処理開始までの時間, マイクロ秒)
+ *
+ * Core 1 が Config::Can::BUS_LOAD_WINDOW_MS ごとに集計区間の値で更新する。
+ */
+struct TickJitter {
+  volatile uint16_t lateMinUs; ///< 開始遅れ 最小値
+  volatile uint16_t lateAvgUs; ///< 開始遅れ 平均値
+  volatile uint16_t lateMaxUs; ///< 開始遅れ 最大値
+  volatile uint32_t missed;    ///< 取りこぼした周期の数 (累積)
+};
+
+/**
+ * @struct CoreLoad
+ * @brief コアごとの CPU 利用率 (TaskScheduler の集計値)
+ *
+ * 各コアが Config::Can::BUS_LOAD_WINDOW_MS ごとに更新する。
+ */
+struct CoreLoad {
+  volatile uint16_t utilPermil;       ///< CPU 利用率 (0.1% 単位)
+  volatile uint32_t budgetViolations; ///< 実行時間の予算超過数 (累積)
+};
+
+/**
+ * @struct CanLinkTelemetry
+ * @brief モーターとの通信品質 (MF4015_Driver::getLinkStats() の写し)
+ *
+ * Core 1 が Config::Can::BUS_LOAD_WINDOW_MS ごとに更新する。
+ */
+struct CanLinkTelemetry {
+  volatile uint32_t missed;   ///< 応答欠落数 (累積)
+  volatile uint32_t late;     ///< 遅延応答数 (累積)
+  volatile uint16_t rttMinUs; ///< 往復時間 最小値
+  volatile uint16_t rttAvgUs; ///< 往復時間 平均値
+  volatile uint16_t rttMaxUs; ///< 往復時間 最大値
+  volatile uint16_t rttP99Us; ///< 往復時間 99パーセンタイル
+};
+
 /**
  * @struct SharedData
  * @brief Core 0 と Core 1
@@ -43,6 +102,108 @@ struct SharedData {
    * Core 0側でタイムアウト検出に使用可能。
    */
   volatile uint32_t lastCore1Micros;
+
+  /**
+   * @brief ステアリングの有効角度範囲 (センターからの片側角度, deg)
+   *
+   * 書き込むと Core 1 が次の制御周期で MF4015_Driver::setAngleRange()
+   * に反映し、Config::Steer::ANGLE_RANGE_DEG_MIN..MAX に丸めた値を書き戻す。
+   * 0 の場合は起動時に Config::Steer::ANGLE_RANGE_DEG で初期化される。
+   */
+  volatile uint16_t steerRangeDeg;
+
+  /**
+   * @brief ペダルの応答曲線 (アクセル・ブレーキ)
+   *
+   * ConfigManager で保存・復元される。実行中に変更する場合は、
+   * 書き換えた後に pedalCurveSeq を進めると Core 0 が LUT を作成し、
+   * Core 1 が次の制御周期で切り替える。
+   */
+  PedalCurveConfig accelCurve;
+  PedalCurveConfig brakeCurve;
+  volatile uint8_t pedalCurveSeq; ///< 応答曲線の変更番号
+
+  /**
+   * @brief ペダルの校正値 (アクセル・ブレーキ)
+   *
+   * ConfigManager で保存・復元される。範囲が不正 (0 初期化を含む) の
+   * 場合は config.h の既定値を使用する。書き換えた後に pedalCalibSeq を
+   * 進めると Core 1 が次の制御周期で変換係数を更新する。
+   *
+   * pedalCalibMode に PEDAL_CALIB_RUN を書き込むと Core 1 が平滑化済みの
+   * ADC 値の最小・最大を観測し、PEDAL_CALIB_FINISH で校正値を作成する。
+   * ホストからは Pedal Calibration Feature Report で操作する。
+   * 作成した校正値は configSaveRequest により Core 0 が保存する
+   * (Core 1 は校正値の書き込みと configSaveRequest の間にバリアを置く)。
+   */
+  PedalCalibConfig accelCalib;
+  PedalCalibConfig brakeCalib;
+  volatile uint8_t pedalCalibSeq;  ///< 校正値の変更番号
+  volatile uint8_t pedalCalibMode; ///< 自動校正の状態 (PedalCalibMode)
+
+  /**
+   * @brief 設定の保存要求 (Core 0 が ConfigManager::saveConfig() を実行)
+   */
+  volatile bool configSaveRequest;
+
+  /**
+   * @brief トルク出力の一時停止 (フラッシュ書き込みによる Core 1 の停止対策)
+   *
+   * フラッシュの書き込み中は Core 1 が止まり、モーターは最後に受け取った
+   * トルクを出し続ける。Core 0 は書き込みの前に torqueHoldSeq へ 0 以外の
+   * 番号を書き込み、Core 1 がトルク 0 を送信済みであること
+   * (torqueHeldSeq が同じ番号) を待ってから書き込む。0 に戻すと通常の出力。
+   */
+  volatile uint8_t torqueHoldSeq;
+  volatile uint8_t torqueHeldSeq; ///< トルク 0 を送信済みの torqueHoldSeq
+
+  /**
+   * @brief Core 1 制御周期の処理時間内訳
+   */
+  TickTiming tickTiming;
+
+  /**
+   * @brief 周期処理の開始遅れ (制御周期・サンプリング周期)
+   */
+  TickJitter controlJitter;
+  TickJitter sampleJitter;
+
+  /**
+   * @brief コアごとの CPU 利用率
+   */
+  CoreLoad core0Load;
+  CoreLoad core1Load;
+
+  /**
+   * @brief ボタン入力の遅延 (マイクロ秒)
+   *
+   * 直近にボタン状態が変化した際の、エッジ (DigitalInputChannel の
+   * 記録時刻) から Core 1 が入力レポートへ反映するまでの時間。
+   */
+  volatile uint16_t buttonLatencyUs;
+
+  /**
+   * @brief CANバス使用率の見積もり (0.1% 単位)
+   *
+   * 送受信フレームの最大ビット数 (スタッフィング最悪値) の累積から
+   * Config::Can::BUS_LOAD_WINDOW_MS ごとに Core 1 が算出する。
+   */
+  volatile uint16_t canBusLoadPermil;
+
+  /**
+   * @brief モーターとの通信品質 (指令→応答の往復時間と欠落数)
+   */
+  CanLinkTelemetry canLink;
+
+#ifdef ZONE_PROFILER_ENABLE
+  /**
+   * @brief ゾーンごとの所要時間 (直近の集計区間)
+   *
+   * 各ゾーンを記録するコアが 1 秒ごとに ZoneProfiler::takeStats() の値で
+   * 更新する (Zones0 / Zones1 タスク)。
+   */
+  volatile ZoneStats zoneStats[PROFILE_ZONE_COUNT];
+#endif // ZONE_PROFILER_ENABLE
 };
 
 /**
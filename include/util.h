@@ -37,65 +37,145 @@ inline bool checkInterval_m(uint32_t &last_ms, uint32_t interval_ms) {
   return false;
 }
 /**
- * 非ブロッキング周期判定 マイクロ秒版 クラス版
- * @param IntervalTrigger_u 実行周期（マイクロ秒）
+ * 周期判定で期限を過ぎていた場合 (停止・長い処理の後) の動作
+ */
+enum OverrunPolicy : uint8_t {
+  OVERRUN_BURST,    // 遅れた周期をすべて連続で実行する (従来の動作)
+  OVERRUN_SKIP,     // 1回だけ実行し、残りは読み飛ばして現在に合わせる
+  OVERRUN_CATCH_UP, // maxCatchUp 回まで連続で実行し、残りは読み飛ばす
+};
+
+/**
+ * 周期判定の共通処理 (時刻の単位は派生クラスによる)
+ * 期限は周期の整数倍で進め、読み飛ばした周期の数と最大の遅れを記録する
  */
-class IntervalTrigger_u {
+class IntervalTriggerBase {
 public:
-  IntervalTrigger_u(uint32_t interval_us)
-      : interval(interval_us), running(false) {}
+  uint32_t getMissedCount() const { return missed; } // 読み飛ばした周期の数
+  uint32_t getMaxLate() const { return maxLate; } // 期限からの最大の遅れ
+  void resetStats() {
+    missed = 0;
+    maxLate = 0;
+  }
 
-  void init() { // 周期判定を開始する
-    prev = micros();
+  // 直近に hasExpired() が true を返した周期の期限
+  uint32_t getDeadline() const { return prev; }
+
+protected:
+  IntervalTriggerBase(uint32_t interval, OverrunPolicy policy,
+                      uint8_t maxCatchUp)
+      : interval(interval), prev(0), running(false), policy(policy),
+        maxCatchUp(maxCatchUp), missed(0), maxLate(0) {}
+
+  void start(uint32_t now) {
+    prev = now;
     running = true;
   }
 
-  bool hasExpired() { // 周期判定を行う
+  bool check(uint32_t now) {
     if (!running)
       return false;
-    uint32_t now = micros();
-    if ((uint32_t)(now - prev) >= interval) {
-      prev += interval;
-      return true;
+    uint32_t elapsed = now - prev;
+    // 期限前 (init() の位相による開始前を含む)
+    if ((int32_t)elapsed < (int32_t)interval)
+      return false;
+    uint32_t late = elapsed - interval; // 今回の期限からの遅れ
+    if (late > maxLate)
+      maxLate = late;
+    if (late >= interval && policy != OVERRUN_BURST) {
+      // 2周期以上遅れている: 許容数を超える分の期限を読み飛ばす
+      uint32_t behind = late / interval; // 今回の後に溜まっている周期数
+      uint32_t allowed = (policy == OVERRUN_CATCH_UP) ? maxCatchUp : 0;
+      if (behind > allowed) {
+        missed += behind - allowed;
+        prev += (behind - allowed) * interval;
+      }
     }
-    return false;
+    prev += interval;
+    return true;
   }
 
 private:
   uint32_t interval;
   uint32_t prev;
   bool running;
+  OverrunPolicy policy;
+  uint8_t maxCatchUp;
+  uint32_t missed;
+  uint32_t maxLate;
 };
 
 /**
- * 非ブロッキング周期判定 ミリ秒版 クラス版
- * @param IntervalTrigger_m 実行周期（ミリ秒）
+ * 非ブロッキング周期判定 マイクロ秒版 クラス版
+ * @param IntervalTrigger_u 実行周期（マイクロ秒）
  */
-class IntervalTrigger_m {
+class IntervalTrigger_u : public IntervalTriggerBase {
 public:
-  IntervalTrigger_m(uint32_t interval_ms)
-      : interval(interval_ms), running(false) {}
+  IntervalTrigger_u(uint32_t interval_us = 0,
+                    OverrunPolicy policy = OVERRUN_BURST,
+                    uint8_t maxCatchUp = 0)
+      : IntervalTriggerBase(interval_us, policy, maxCatchUp) {}
 
-  void init() { // 周期判定を開始する
-    prev = millis();
-    running = true;
+  // 周期判定を開始する (最初の期限に phase_us を加える)
+  void init(uint32_t phase_us = 0) { start(micros() + phase_us); }
+
+  bool hasExpired() { return check(micros()); } // 周期判定を行う
+
+  // 直近に hasExpired() が true を返した周期の期限 (micros() 基準)
+  uint32_t getDeadlineUs() const { return getDeadline(); }
+};
+
+/**
+ * 周期処理の開始遅れ (期限からの経過時間) の集計
+ * 最小・平均・最大を集計し、reset() で次の集計区間を始める
+ */
+class LatenessStats {
+public:
+  LatenessStats() { reset(); }
+
+  void add(uint32_t late_us) { // 1周期分の遅れを加える
+    if (late_us < minUs)
+      minUs = late_us;
+    if (late_us > maxUs)
+      maxUs = late_us;
+    sumUs += late_us;
+    count++;
   }
 
-  bool hasExpired() { // 周期判定を行う
-    if (!running)
-      return false;
-    uint32_t now = millis();
-    if ((uint32_t)(now - prev) >= interval) {
-      prev += interval;
-      return true;
-    }
-    return false;
+  void reset() {
+    minUs = UINT32_MAX;
+    maxUs = 0;
+    sumUs = 0;
+    count = 0;
+  }
+
+  uint32_t getMinUs() const { return count > 0 ? minUs : 0; }
+  uint32_t getMaxUs() const { return maxUs; }
+  uint32_t getAvgUs() const {
+    return count > 0 ? (uint32_t)(sumUs / count) : 0;
   }
 
 private:
-  uint32_t interval;
-  uint32_t prev;
-  bool running;
+  uint32_t minUs;
+  uint32_t maxUs;
+  uint64_t sumUs;
+  uint32_t count;
+};
+
+/**
+ * 非ブロッキング周期判定 ミリ秒版 クラス版
+ * @param IntervalTrigger_m 実行周期（ミリ秒）
+ */
+class IntervalTrigger_m : public IntervalTriggerBase {
+public:
+  IntervalTrigger_m(uint32_t interval_ms,
+                    OverrunPolicy policy = OVERRUN_BURST,
+                    uint8_t maxCatchUp = 0)
+      : IntervalTriggerBase(interval_ms, policy, maxCatchUp) {}
+
+  void init() { start(millis()); } // 周期判定を開始する
+
+  bool hasExpired() { return check(millis()); } // 周期判定を行う
 };
 
 /**
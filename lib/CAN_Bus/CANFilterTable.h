@@ -0,0 +1,178 @@
+#ifndef CAN_FILTER_TABLE_H
+#define CAN_FILTER_TABLE_H
+
+#include <CANInterface.h> // includeディレクトリから参照
+#include <cstdint>
+
+/**
+ * @file CANFilterTable.h
+ * @brief MCP2515 の受信フィルタ割り当てとフィルタ別受信カウンタ
+ * @date 2026-10-18
+ *
+ * MCP2515 は受信バッファごとにマスクを1つだけ持つため
+ * (RXB0: RXM0 + RXF0/1, RXB1: RXM1 + RXF2..5)、
+ * 任意の CANFilter 列をそのまま書き込むことはできません。
+ * 本クラスはフィルタ列をハードウェアの枠に割り当て、
+ * 同じバッファに属するフィルタのマスクは論理積 (より緩い条件) とします。
+ *
+ * そのためハードウェアは設定より広い範囲を受信する場合があり、
+ * 受信したフレームは match() で設定どおりに再照合します。
+ * 一致したフィルタの受信数を数え、どれにも一致しないフレームは破棄します。
+ *
+ * @note match() は受信割り込みから、カウンタの読み出しは loop1 から
+ *       行われます。カウンタの書き込みは割り込み側のみです。
+ */
+
+/**
+ * @class CANFilterTable
+ * @brief 受信フィルタの設定・照合
+ */
+class CANFilterTable {
+public:
+  /// MCP2515 のフィルタ数 (RXF0..RXF5)
+  static constexpr uint8_t MAX_FILTERS = 6;
+  /// RXB0 に割り当てるフィルタ数 (RXF0, RXF1)
+  static constexpr uint8_t RXB0_FILTERS = 2;
+
+  CANFilterTable() : count(0), rejectCount(0) {
+    for (uint8_t i = 0; i < MAX_FILTERS; i++) {
+      hits[i] = 0;
+    }
+  }
+
+  /**
+   * @brief フィルタ列を設定する (受信カウンタはクリア)
+   * @return true: 設定成功, false: フィルタ数超過
+   */
+  bool set(const CANFilter *list, uint8_t n) {
+    if (n > MAX_FILTERS || (n > 0 && list == nullptr)) {
+      return false;
+    }
+    count = 0;
+    for (uint8_t i = 0; i < n; i++) {
+      filters[i] = list[i];
+      hits[i] = 0;
+    }
+    rejectCount = 0;
+    count = n;
+    return true;
+  }
+
+  /**
+   * @brief フィルタが設定されているか (false: 全フレーム受信)
+   */
+  bool enabled() const { return count > 0; }
+
+  /**
+   * @brief 受信フレームを照合し、受信カウンタを更新する
+   * @param id 受信した CAN ID (拡張フレームは EXT_ID_FLAG 付き)
+   * @return true: 受信する, false: 破棄する
+   */
+  bool match(uint32_t id) {
+    if (count == 0) {
+      return true;
+    }
+    for (uint8_t i = 0; i < count; i++) {
+      // 標準/拡張の区別は常に比較する
+      uint32_t mask = filters[i].mask | CANFilter::EXT_ID_FLAG;
+      if (((id ^ filters[i].id) & mask) == 0) {
+        hits[i]++;
+        return true;
+      }
+    }
+    rejectCount++;
+    return false;
+  }
+
+  /**
+   * @brief フィルタごとの受信数を取得
+   */
+  uint32_t getHitCount(uint8_t index) const {
+    return (index < count) ? hits[index] : 0;
+  }
+
+  /**
+   * @brief ハードウェアを通過したが、どのフィルタにも一致せず破棄した数
+   */
+  uint32_t getRejectCount() const { return rejectCount; }
+
+  /**
+   * @brief ハードウェアフィルタ RXFn に書き込む設定を取得
+   *
+   * フィルタ 0,1 を RXB0 へ、2..5 を RXB1 へ割り当てます。
+   * 空き枠には同じバッファの直前のフィルタを複製し、
+   * RXB1 に割り当てがない場合は RXB0 と同じ設定にします
+   * (RXB0 満杯時のロールオーバー先として同じフレームを受けるため)。
+   *
+   * @param slot フィルタ番号 (0..5)
+   */
+  const CANFilter &hardwareFilter(uint8_t slot) const {
+    uint8_t first, n;
+    bufferRange(slot < RXB0_FILTERS ? 0 : 1, first, n);
+    uint8_t base = (slot < RXB0_FILTERS) ? 0 : RXB0_FILTERS;
+    uint8_t idx = slot - base;
+    return filters[first + ((idx < n) ? idx : n - 1)];
+  }
+
+  /**
+   * @brief ハードウェアマスク RXMn に書き込む設定を取得
+   *
+   * 同じバッファに割り当てたフィルタのマスクの論理積を返します。
+   * 標準・拡張が混在する場合は拡張IDの下位ビット (EID) を比較しません
+   * (標準フレームでは EID マスクがデータ先頭2バイトに適用されるため)。
+   *
+   * @param buffer 受信バッファ番号 (0: RXM0, 1: RXM1)
+   * @return id に拡張フレーム用か (EXT_ID_FLAG), mask にマスクを格納
+   */
+  CANFilter hardwareMask(uint8_t buffer) const {
+    uint8_t first, n;
+    bufferRange(buffer, first, n);
+    uint32_t stdMask = 0x7FF;        // 標準フィルタのマスク (11bit)
+    uint32_t extMask = 0x1FFFFFFFUL; // 拡張フィルタのマスク (29bit)
+    bool hasStd = false;
+    bool hasExt = false;
+    for (uint8_t i = first; i < first + n; i++) {
+      if (filters[i].id & CANFilter::EXT_ID_FLAG) {
+        extMask &= filters[i].mask;
+        hasExt = true;
+      } else {
+        stdMask &= filters[i].mask;
+        hasStd = true;
+      }
+    }
+    CANFilter result;
+    if (hasExt && !hasStd) {
+      result.id = CANFilter::EXT_ID_FLAG;
+      result.mask = extMask;
+    } else if (hasExt) {
+      // 混在: 拡張IDの上位11bit (SID部) のみ比較
+      result.id = 0;
+      result.mask = stdMask & (extMask >> 18);
+    } else {
+      result.id = 0;
+      result.mask = stdMask;
+    }
+    return result;
+  }
+
+private:
+  /**
+   * @brief 受信バッファに割り当てたフィルタの範囲を求める
+   */
+  void bufferRange(uint8_t buffer, uint8_t &first, uint8_t &n) const {
+    if (buffer == 0 || count <= RXB0_FILTERS) {
+      first = 0;
+      n = (count < RXB0_FILTERS) ? count : RXB0_FILTERS;
+    } else {
+      first = RXB0_FILTERS;
+      n = count - RXB0_FILTERS;
+    }
+  }
+
+  CANFilter filters[MAX_FILTERS];      ///< 設定されたフィルタ
+  uint8_t count;                       ///< 設定されたフィルタ数
+  volatile uint32_t hits[MAX_FILTERS]; ///< フィルタごとの受信数
+  volatile uint32_t rejectCount;       ///< 再照合で破棄したフレーム数
+};
+
+#endif // CAN_FILTER_TABLE_H
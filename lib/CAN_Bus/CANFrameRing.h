@@ -0,0 +1,91 @@
+#ifndef CAN_FRAME_RING_H
+#define CAN_FRAME_RING_H
+
+#include <CANInterface.h> // includeディレクトリから参照
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @file CANFrameRing.h
+ * @brief 受信CANフレーム用のロックフリー・リングバッファ
+ * @date 2026-10-18
+ *
+ * 単一プロデューサ (INT割り込みハンドラ) / 単一コンシューマ (loop1)
+ * を前提としたリングバッファです。
+ * head はプロデューサのみ、tail はコンシューマのみが更新するため、
+ * 排他制御なしで割り込みとメインループの間でフレームを受け渡せます。
+ *
+ * @note Cortex-M0+ は LDREX/STREX を持たないため、インデックスは
+ *       std::atomic の load/store のみで操作し、RMW 命令は使用しません。
+ */
+
+/**
+ * @class CANFrameRing
+ * @brief 固定長 CANFrame リングバッファ
+ * @tparam N バッファ段数 (2のべき乗)
+ */
+template <uint16_t N> class CANFrameRing {
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "N must be a power of two");
+
+public:
+  CANFrameRing() : head(0), tail(0), overflowCount(0) {}
+
+  /**
+   * @brief フレームを格納する (プロデューサ側)
+   * @return true: 格納成功, false: バッファ満杯 (フレームは破棄)
+   */
+  bool push(uint32_t id, uint8_t len, const uint8_t *data, uint32_t tsUs) {
+    uint16_t h = head.load(std::memory_order_relaxed);
+    uint16_t t = tail.load(std::memory_order_acquire);
+    if ((uint16_t)(h - t) >= N) {
+      overflowCount++;
+      return false;
+    }
+    CANFrame &f = buffer[h & (N - 1)];
+    f.id = id;
+    f.len = (len > 8) ? 8 : len;
+    for (uint8_t i = 0; i < f.len; i++) {
+      f.data[i] = data[i];
+    }
+    f.timestampUs = tsUs;
+    head.store((uint16_t)(h + 1), std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief 最古のフレームを取り出す (コンシューマ側)
+   * @return true: 取得成功, false: バッファ空
+   */
+  bool pop(CANFrame &out) {
+    uint16_t t = tail.load(std::memory_order_relaxed);
+    uint16_t h = head.load(std::memory_order_acquire);
+    if (h == t) {
+      return false;
+    }
+    out = buffer[t & (N - 1)];
+    tail.store((uint16_t)(t + 1), std::memory_order_release);
+    return true;
+  }
+
+  bool empty() const {
+    return head.load(std::memory_order_acquire) ==
+           tail.load(std::memory_order_acquire);
+  }
+
+  /** @brief 格納中のフレーム数 */
+  uint16_t size() const {
+    return (uint16_t)(head.load(std::memory_order_acquire) -
+                      tail.load(std::memory_order_acquire));
+  }
+
+  /** @brief バッファ満杯により破棄したフレーム数 (診断用) */
+  uint32_t getOverflowCount() const { return overflowCount; }
+
+private:
+  CANFrame buffer[N];
+  std::atomic<uint16_t> head; ///< 次の書き込み位置 (プロデューサ専用)
+  std::atomic<uint16_t> tail; ///< 次の読み出し位置 (コンシューマ専用)
+  volatile uint32_t overflowCount;
+};
+
+#endif // CAN_FRAME_RING_H
@@ -0,0 +1,208 @@
+#ifndef CAN_TX_QUEUE_H
+#define CAN_TX_QUEUE_H
+
+#include <CANInterface.h> // includeディレクトリから参照
+#include <cstdint>
+
+/**
+ * @file CANTxQueue.h
+ * @brief 優先度付きのCAN送信キュー
+ * @date 2026-10-18
+ *
+ * 送信バッファ (MCP2515 は3段) が空くまでフレームを保持します。
+ * キューは優先度の高い順、同じ優先度内は投入順に並びます。
+ *
+ * - supersede 指定時は、条件 (CANTxSupersede) に一致する
+ *   未送信フレームを置き換えます。
+ * - 満杯時は、キュー内で最も優先度の低いフレームより新しいフレームの
+ *   優先度が高ければそれを破棄して投入し、そうでなければ新しいフレームを
+ *   破棄します。
+ *
+ * @note 排他制御は行いません。割り込みから操作する場合は、
+ *       呼び出し側で割り込みを禁止してください。
+ */
+
+/**
+ * @struct CANTxEntry
+ * @brief 送信キューの要素
+ */
+struct CANTxEntry {
+  uint32_t id;      ///< CAN識別子
+  uint8_t len;      ///< データ長 (0-8バイト)
+  uint8_t data[8];  ///< 送信データ
+  uint8_t priority;  ///< 送信優先度 (CANTxPriority)
+  uint8_t supersede; ///< 未送信フレームの置き換え条件 (CANTxSupersede)
+};
+
+/**
+ * @brief 新しいフレームが未送信のフレームを置き換える対象か
+ *
+ * 送信キュー内のフレームと、送信バッファに書き込み済みのフレーム
+ * (MCP2515_Driver) の照合で共通の条件。
+ *
+ * @param supersede 新しいフレームの置き換え条件
+ * @param id 新しいフレームの CAN ID
+ * @param len 新しいフレームのデータ長
+ * @param cmd 新しいフレームの先頭データバイト
+ * @param pendingId 未送信フレームの CAN ID
+ * @param pendingLen 未送信フレームのデータ長
+ * @param pendingCmd 未送信フレームの先頭データバイト
+ */
+inline bool canTxSupersedes(uint8_t supersede, uint32_t id, uint8_t len,
+                            uint8_t cmd, uint32_t pendingId,
+                            uint8_t pendingLen, uint8_t pendingCmd) {
+  if (supersede == CAN_TX_APPEND || id != pendingId) {
+    return false;
+  }
+  if (supersede == CAN_TX_SUPERSEDE_CMD) {
+    return len > 0 && pendingLen > 0 && cmd == pendingCmd;
+  }
+  return true;
+}
+
+/**
+ * @struct CANTxStats
+ * @brief 送信キューの統計情報 (診断用)
+ */
+struct CANTxStats {
+  uint32_t queued;     ///< キューに投入したフレーム数
+  uint32_t superseded; ///< 未送信のまま置き換えられたフレーム数
+  uint32_t dropped;    ///< キュー満杯で破棄したフレーム数
+  uint8_t depth;       ///< 現在のキュー長
+  uint8_t maxDepth;    ///< キュー長の最大値
+};
+
+/**
+ * @class CANTxQueue
+ * @brief 優先度付き送信キュー
+ * @tparam N キュー段数
+ */
+template <uint8_t N> class CANTxQueue {
+  static_assert(N >= 1, "N must be at least 1");
+
+public:
+  /**
+   * @brief push() の結果
+   */
+  enum Result : uint8_t {
+    QUEUED = 0,     ///< 新規に投入した
+    SUPERSEDED = 1, ///< 未送信の同種フレームを置き換えた
+    DROPPED = 2,    ///< キュー満杯のため破棄した
+  };
+
+  CANTxQueue() : count(0), stats{0, 0, 0, 0, 0} {}
+
+  /**
+   * @brief フレームを投入する
+   */
+  Result push(uint32_t id, uint8_t len, const uint8_t *data, uint8_t priority,
+              CANTxSupersede supersede) {
+    if (len > 8) {
+      len = 8;
+    }
+
+    if (supersede != CAN_TX_APPEND) {
+      const uint8_t cmd = (len > 0) ? data[0] : 0;
+      for (uint8_t i = 0; i < count; i++) {
+        CANTxEntry &e = entries[i];
+        if (canTxSupersedes(supersede, id, len, cmd, e.id, e.len,
+                            e.data[0])) {
+          if (e.priority == priority) {
+            // 同じ優先度なら順番を保ったまま内容だけ差し替える
+            e.len = len;
+            for (uint8_t j = 0; j < len; j++) {
+              e.data[j] = data[j];
+            }
+          } else {
+            remove(i);
+            insert(id, len, data, priority, supersede);
+          }
+          stats.superseded++;
+          return SUPERSEDED;
+        }
+      }
+    }
+
+    if (count >= N) {
+      // 末尾 = 最も優先度が低く、その中で最も新しいフレーム
+      if (entries[count - 1].priority >= priority) {
+        stats.dropped++;
+        return DROPPED;
+      }
+      remove(count - 1);
+      stats.dropped++;
+    }
+
+    insert(id, len, data, priority, supersede);
+    stats.queued++;
+    return QUEUED;
+  }
+
+  /**
+   * @brief 先頭 (最も優先度の高い) フレームを参照する
+   * @return 先頭要素へのポインタ, キューが空なら nullptr
+   */
+  const CANTxEntry *front() const {
+    return (count > 0) ? &entries[0] : nullptr;
+  }
+
+  /**
+   * @brief 先頭フレームを取り除く
+   */
+  void pop() {
+    if (count > 0) {
+      remove(0);
+    }
+  }
+
+  bool empty() const { return count == 0; }
+  uint8_t size() const { return count; }
+
+  /**
+   * @brief キューの外 (送信バッファ) で置き換えたフレームを計上する
+   */
+  void countSuperseded() { stats.superseded++; }
+
+  /**
+   * @brief 統計情報を取得
+   */
+  const CANTxStats &getStats() const { return stats; }
+
+private:
+  void insert(uint32_t id, uint8_t len, const uint8_t *data, uint8_t priority,
+              CANTxSupersede supersede) {
+    // 同じ優先度の末尾 (投入順) に挿入する
+    uint8_t pos = count;
+    while (pos > 0 && entries[pos - 1].priority < priority) {
+      entries[pos] = entries[pos - 1];
+      pos--;
+    }
+    CANTxEntry &e = entries[pos];
+    e.id = id;
+    e.len = len;
+    for (uint8_t i = 0; i < len; i++) {
+      e.data[i] = data[i];
+    }
+    e.priority = priority;
+    e.supersede = supersede;
+    count++;
+    stats.depth = count;
+    if (count > stats.maxDepth) {
+      stats.maxDepth = count;
+    }
+  }
+
+  void remove(uint8_t index) {
+    for (uint8_t i = index; i + 1 < count; i++) {
+      entries[i] = entries[i + 1];
+    }
+    count--;
+    stats.depth = count;
+  }
+
+  CANTxEntry entries[N]; ///< 優先度順に並んだフレーム
+  uint8_t count;         ///< 格納数
+  CANTxStats stats;      ///< 統計情報
+};
+
+#endif // CAN_TX_QUEUE_H
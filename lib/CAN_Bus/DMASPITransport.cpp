@@ -0,0 +1,111 @@
+/**
+ * @file DMASPITransport.cpp
+ * @brief RP2040 の DMA を用いた SPITransport の実装
+ * @date 2026-10-18
+ */
+
+#include "DMASPITransport.h"
+#include "hot_path.h"
+#include <Arduino.h>
+#include <hardware/dma.h>
+#include <hardware/gpio.h>
+#include <hardware/irq.h>
+#include <hardware/spi.h>
+
+DMASPITransport *DMASPITransport::instance = nullptr;
+
+DMASPITransport::DMASPITransport(uint8_t cs, uint8_t sck, uint8_t mosi,
+                                 uint8_t miso, uint32_t spiClockHz)
+    : csPin(cs), sckPin(sck), mosiPin(mosi), misoPin(miso),
+      clockHz(spiClockHz), spiHw(nullptr), txChannel(-1), rxChannel(-1),
+      active(false), pendingCallback(nullptr), pendingCtx(nullptr) {}
+
+void DMASPITransport::begin() {
+  // GPIO 番号から SPI ペリフェラルを決定 (GP0-7, 16-23: SPI0 / GP8-15,
+  // 24-29: SPI1)
+  spiHw = ((sckPin >> 3) & 1) ? spi1 : spi0;
+
+  spi_init(spiHw, clockHz);
+  spi_set_format(spiHw, 8, SPI_CPOL_0, SPI_CPHA_0, SPI_MSB_FIRST);
+  gpio_set_function(sckPin, GPIO_FUNC_SPI);
+  gpio_set_function(mosiPin, GPIO_FUNC_SPI);
+  gpio_set_function(misoPin, GPIO_FUNC_SPI);
+
+  gpio_init(csPin);
+  gpio_set_dir(csPin, GPIO_OUT);
+  gpio_put(csPin, 1);
+
+  if (txChannel < 0) {
+    txChannel = dma_claim_unused_channel(true);
+    rxChannel = dma_claim_unused_channel(true);
+
+    // 受信完了で転送終了とみなす (最終バイトの受信 = シフト完了)
+    instance = this;
+    dma_channel_set_irq1_enabled(rxChannel, true);
+    irq_add_shared_handler(DMA_IRQ_1, onDmaIrq,
+                           PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(DMA_IRQ_1, true);
+  }
+}
+
+void HOT_FUNC(DMASPITransport::transfer)(const uint8_t *tx, uint8_t *rx,
+                                         uint16_t len) {
+  // 非同期転送中はバスが空くまで待つ
+  while (active) {
+    tight_loop_contents();
+  }
+  gpio_put(csPin, 0);
+  spi_write_read_blocking(spiHw, tx, rx, len);
+  gpio_put(csPin, 1);
+}
+
+bool HOT_FUNC(DMASPITransport::transferAsync)(const uint8_t *tx, uint8_t *rx,
+                                              uint16_t len, Callback callback,
+                                              void *ctx) {
+  if (active || len == 0) {
+    return false;
+  }
+  active = true;
+  pendingCallback = callback;
+  pendingCtx = ctx;
+
+  dma_channel_config txc = dma_channel_get_default_config(txChannel);
+  channel_config_set_transfer_data_size(&txc, DMA_SIZE_8);
+  channel_config_set_dreq(&txc, spi_get_dreq(spiHw, true));
+  channel_config_set_read_increment(&txc, true);
+  channel_config_set_write_increment(&txc, false);
+  dma_channel_configure(txChannel, &txc, &spi_get_hw(spiHw)->dr, tx, len,
+                        false);
+
+  dma_channel_config rxc = dma_channel_get_default_config(rxChannel);
+  channel_config_set_transfer_data_size(&rxc, DMA_SIZE_8);
+  channel_config_set_dreq(&rxc, spi_get_dreq(spiHw, false));
+  channel_config_set_read_increment(&rxc, false);
+  channel_config_set_write_increment(&rxc, true);
+  dma_channel_configure(rxChannel, &rxc, rx, &spi_get_hw(spiHw)->dr, len,
+                        false);
+
+  gpio_put(csPin, 0);
+  // 送受信チャネルを同時に起動 (受信の取りこぼし防止)
+  dma_start_channel_mask((1u << txChannel) | (1u << rxChannel));
+  return true;
+}
+
+void HOT_FUNC(DMASPITransport::onDmaIrq)() {
+  DMASPITransport *self = instance;
+  if (self == nullptr || self->rxChannel < 0 ||
+      !dma_channel_get_irq1_status(self->rxChannel)) {
+    return; // 共有ハンドラ: 他チャネルの割り込み
+  }
+  dma_channel_acknowledge_irq1(self->rxChannel);
+  gpio_put(self->csPin, 1);
+
+  // コールバック内で次の非同期転送を開始できるよう、先に解放する
+  Callback cb = self->pendingCallback;
+  void *ctx = self->pendingCtx;
+  self->pendingCallback = nullptr;
+  self->active = false;
+  if (cb != nullptr) {
+    cb(ctx);
+  }
+}
@@ -0,0 +1,69 @@
+#ifndef DMA_SPI_TRANSPORT_H
+#define DMA_SPI_TRANSPORT_H
+
+#include "SPITransport.h"
+#include <cstdint>
+
+/**
+ * @file DMASPITransport.h
+ * @brief RP2040 の DMA を用いた SPITransport の実装
+ * @date 2026-10-18
+ *
+ * 送信・受信それぞれに DMA チャネルを割り当て、SPI のシフト中に
+ * CPU を解放します。受信チャネルの完了割り込み (DMA_IRQ_1) で
+ * CS を解除し、登録されたコールバックを呼び出します。
+ *
+ * @note begin() を呼び出したコアで DMA 割り込みが有効になるため、
+ *       CAN 処理を行う Core 1 (setup1) から初期化してください。
+ * @note 同期転送 transfer() は設定 (レジスタの読み書き) 向けで、
+ *       非同期転送の完了を待ってから CPU で送受信します。
+ */
+
+struct spi_inst;
+
+/**
+ * @class DMASPITransport
+ * @brief DMA 駆動 SPI 転送
+ */
+class DMASPITransport : public SPITransport {
+public:
+  /**
+   * @brief コンストラクタ
+   *
+   * @param cs CSピン番号
+   * @param sck SPI SCKピン番号
+   * @param mosi SPI MOSI (TX)ピン番号
+   * @param miso SPI MISO (RX)ピン番号
+   * @param spiClockHz SPIクロック周波数 (Hz)
+   */
+  DMASPITransport(uint8_t cs, uint8_t sck, uint8_t mosi, uint8_t miso,
+                  uint32_t spiClockHz);
+
+  void begin() override;
+  void transfer(const uint8_t *tx, uint8_t *rx, uint16_t len) override;
+  bool transferAsync(const uint8_t *tx, uint8_t *rx, uint16_t len,
+                     Callback callback, void *ctx) override;
+  bool busy() const override { return active; }
+
+private:
+  /**
+   * @brief DMA 受信チャネル完了割り込みハンドラ
+   */
+  static void onDmaIrq();
+
+  static DMASPITransport *instance; ///< 割り込みハンドラの転送先
+
+  uint8_t csPin;           ///< CSピン番号
+  uint8_t sckPin;          ///< SPI SCKピン番号
+  uint8_t mosiPin;         ///< SPI MOSIピン番号
+  uint8_t misoPin;         ///< SPI MISOピン番号
+  uint32_t clockHz;        ///< SPIクロック周波数
+  spi_inst *spiHw;         ///< 使用する SPI ペリフェラル
+  int txChannel;           ///< 送信 DMA チャネル
+  int rxChannel;           ///< 受信 DMA チャネル
+  volatile bool active;    ///< 非同期転送中フラグ
+  Callback pendingCallback; ///< 完了時に呼び出すコールバック
+  void *pendingCtx;        ///< コールバックのコンテキスト
+};
+
+#endif // DMA_SPI_TRANSPORT_H
@@ -0,0 +1,146 @@
+#ifndef MCP2515_DEFS_H
+#define MCP2515_DEFS_H
+
+#include <cstdint>
+
+/**
+ * @file MCP2515_Defs.h
+ * @brief MCP2515 の SPI 命令・レジスタ定義
+ * @date 2026-10-18
+ *
+ * MCP2515 データシート (DS20001801) に基づく定数のうち、
+ * MCP2515_Driver で使用するもののみを定義します。
+ */
+
+namespace MCP2515Defs {
+
+// ============================================================================
+// SPI 命令
+// ============================================================================
+inline constexpr uint8_t INSTR_RESET = 0xC0;
+inline constexpr uint8_t INSTR_READ = 0x03;
+inline constexpr uint8_t INSTR_WRITE = 0x02;
+inline constexpr uint8_t INSTR_BIT_MODIFY = 0x05;
+inline constexpr uint8_t INSTR_READ_STATUS = 0xA0;
+inline constexpr uint8_t INSTR_RX_STATUS = 0xB0;
+
+// READ RX BUFFER: RXBnSIDH から読み出し、CS解除時に RXnIF を自動クリア
+inline constexpr uint8_t INSTR_READ_RXB0_SIDH = 0x90;
+inline constexpr uint8_t INSTR_READ_RXB1_SIDH = 0x94;
+
+// LOAD TX BUFFER: TXBnSIDH から書き込み
+inline constexpr uint8_t INSTR_LOAD_TXB0_SIDH = 0x40;
+inline constexpr uint8_t INSTR_LOAD_TXB1_SIDH = 0x42;
+inline constexpr uint8_t INSTR_LOAD_TXB2_SIDH = 0x44;
+
+// RTS (Request To Send): 下位3bitで TXB0/1/2 を指定
+inline constexpr uint8_t INSTR_RTS = 0x80;
+
+// ============================================================================
+// レジスタアドレス
+// ============================================================================
+inline constexpr uint8_t REG_RXF0SIDH = 0x00;
+inline constexpr uint8_t REG_RXF3SIDH = 0x10;
+inline constexpr uint8_t REG_RXM0SIDH = 0x20;
+inline constexpr uint8_t REG_CANSTAT = 0x0E;
+inline constexpr uint8_t REG_CANCTRL = 0x0F;
+inline constexpr uint8_t REG_TEC = 0x1C;
+inline constexpr uint8_t REG_REC = 0x1D;
+inline constexpr uint8_t REG_CNF3 = 0x28;
+inline constexpr uint8_t REG_CNF2 = 0x29;
+inline constexpr uint8_t REG_CNF1 = 0x2A;
+inline constexpr uint8_t REG_CANINTE = 0x2B;
+inline constexpr uint8_t REG_CANINTF = 0x2C;
+inline constexpr uint8_t REG_EFLG = 0x2D;
+inline constexpr uint8_t REG_TXB0CTRL = 0x30;
+inline constexpr uint8_t REG_TXB1CTRL = 0x40;
+inline constexpr uint8_t REG_TXB2CTRL = 0x50;
+inline constexpr uint8_t REG_RXB0CTRL = 0x60;
+inline constexpr uint8_t REG_RXB1CTRL = 0x70;
+
+// ============================================================================
+// ビット定義
+// ============================================================================
+
+// CANCTRL / CANSTAT: 動作モード (REQOP / OPMOD)
+inline constexpr uint8_t MODE_MASK = 0xE0;
+inline constexpr uint8_t MODE_NORMAL = 0x00;
+inline constexpr uint8_t MODE_LOOPBACK = 0x40;
+inline constexpr uint8_t MODE_LISTENONLY = 0x60;
+inline constexpr uint8_t MODE_CONFIG = 0x80;
+
+// CANINTE / CANINTF
+inline constexpr uint8_t INT_RX0 = 0x01;
+inline constexpr uint8_t INT_RX1 = 0x02;
+
+// TXBnCTRL
+inline constexpr uint8_t TXB_TXP_MASK = 0x03; ///< 送信優先度 (3: 最高)
+inline constexpr uint8_t TXB_TXREQ = 0x08;    ///< 送信要求 (0 を書くと中止要求)
+inline constexpr uint8_t TXB_ABTF = 0x40;     ///< 中止により送信しなかった
+
+// RXBnCTRL
+inline constexpr uint8_t RXB_RXM_MASK = 0x60; ///< 受信モード (00: フィルタ使用)
+inline constexpr uint8_t RXB0_BUKT = 0x04;    ///< RXB0 満杯時に RXB1 へロールオーバー
+
+// READ STATUS 応答
+inline constexpr uint8_t STAT_RX0IF = 0x01;
+inline constexpr uint8_t STAT_RX1IF = 0x02;
+inline constexpr uint8_t STAT_TXB0REQ = 0x04;
+inline constexpr uint8_t STAT_TXB1REQ = 0x10;
+inline constexpr uint8_t STAT_TXB2REQ = 0x40;
+
+// TXBnSIDL / RXBnSIDL
+inline constexpr uint8_t SIDL_IDE = 0x08; ///< 拡張フレーム
+
+// DLC
+inline constexpr uint8_t DLC_MASK = 0x0F;
+
+// 受信フレームのバッファ長 (SIDH, SIDL, EID8, EID0, DLC, D0..D7)
+inline constexpr uint8_t FRAME_HEADER_LEN = 5;
+inline constexpr uint8_t FRAME_BUFFER_LEN = FRAME_HEADER_LEN + 8;
+
+/// 拡張フレームを示す CAN ID フラグ (CANFilter::EXT_ID_FLAG と同じ値)
+inline constexpr uint32_t CAN_EFF_FLAG = 0x80000000UL;
+
+// ============================================================================
+// ビットタイミング (16MHz 発振子)
+// ============================================================================
+
+/**
+ * @struct BitTiming
+ * @brief ビットレートと CNF1..3 の組
+ */
+struct BitTiming {
+  uint32_t bitrate; ///< ビットレート (bps)
+  uint8_t cnf1;     ///< CNF1 (SJW, BRP)
+  uint8_t cnf2;     ///< CNF2 (BTLMODE, SAM, PHSEG1, PRSEG)
+  uint8_t cnf3;     ///< CNF3 (PHSEG2)
+};
+
+/// 16MHz 発振子での設定値 (サンプル点 約75-80%)
+inline constexpr BitTiming BIT_TIMINGS_16MHZ[] = {
+    {1000000, 0x00, 0xD0, 0x82}, // TQ=125ns x 8
+    {500000, 0x00, 0xF0, 0x86},  // TQ=125ns x 16
+    {250000, 0x41, 0xF1, 0x85},  // TQ=250ns x 16
+    {125000, 0x03, 0xF0, 0x86},  // TQ=500ns x 16
+};
+
+/**
+ * @brief ビットレートに対応する設定値を検索
+ * @return 設定値へのポインタ, 未対応なら nullptr
+ */
+inline const BitTiming *findBitTiming16MHz(uint32_t bitrate) {
+  for (const BitTiming &t : BIT_TIMINGS_16MHZ) {
+    if (t.bitrate == bitrate) {
+      return &t;
+    }
+  }
+  return nullptr;
+}
+
+/// MCP2515 の SPI 最大クロック (データシート上限)
+inline constexpr uint32_t SPI_CLOCK_MAX_HZ = 10000000;
+
+} // namespace MCP2515Defs
+
+#endif // MCP2515_DEFS_H
@@ -0,0 +1,853 @@
+/**
+ * @file MCP2515_Driver.cpp
+ * @brief MCP2515 CANコントローラのネイティブドライバ実装
+ * @date 2026-10-18
+ *
+ * レジスタ・命令の定義は MCP2515_Defs.h を参照。
+ */
+
+#include "MCP2515_Driver.h"
+#include "MCP2515_Defs.h"
+#include "hot_path.h"
+#include <Arduino.h>
+#include <hardware/sync.h>
+
+using namespace MCP2515Defs;
+
+MCP2515_Driver *MCP2515_Driver::isrInstance = nullptr;
+
+/// 送信バッファごとの LOAD TX BUFFER 命令 (SIDH から)
+HOT_DATA(mcp2515_load_instr) static constexpr uint8_t TXB_LOAD_INSTR[3] = {
+    INSTR_LOAD_TXB0_SIDH, INSTR_LOAD_TXB1_SIDH, INSTR_LOAD_TXB2_SIDH};
+/// 送信バッファごとの TXBnCTRL のアドレス
+HOT_DATA(mcp2515_ctrl_reg) static constexpr uint8_t TXB_CTRL_REG[3] = {
+    REG_TXB0CTRL, REG_TXB1CTRL, REG_TXB2CTRL};
+
+/**
+ * @brief CAN ID を ID レジスタ形式 (SIDH, SIDL, EID8, EID0) に変換
+ *
+ * 送信バッファ・マスク・フィルタで共通の形式。
+ *
+ * @param id CAN ID (拡張フレームは 29bit)
+ * @param ext true: 拡張フレーム (SIDL の EXIDE を設定)
+ * @param out 変換結果 (4バイト)
+ */
+static void HOT_FUNC(encodeId)(uint32_t id, bool ext, uint8_t *out) {
+  if (ext) {
+    out[0] = (uint8_t)(id >> 21);
+    out[1] = (uint8_t)(((id >> 13) & 0xE0) | ((id >> 16) & 0x03) | SIDL_IDE);
+    out[2] = (uint8_t)(id >> 8);
+    out[3] = (uint8_t)id;
+  } else {
+    out[0] = (uint8_t)(id >> 3);
+    out[1] = (uint8_t)((id & 0x07) << 5);
+    out[2] = 0x00;
+    out[3] = 0x00;
+  }
+}
+
+/**
+ * @brief コンストラクタ
+ *
+ * @param spi SPI転送インターフェース
+ * @param interrupt MCP2515 INTピン番号 (255: 割り込み未使用)
+ */
+MCP2515_Driver::MCP2515_Driver(SPITransport *spi, uint8_t interrupt)
+    : spi(spi), intPin(interrupt), lastError(ERROR_OK), rxIrqEnabled(false),
+      spiStats{0, 0, 0, 0, 0}, started(false), bitrate(DEFAULT_BITRATE),
+      busBitsTx(0), busBitsRx(0), busActive(false), rxPending(false),
+      rxEdgeUs(0), rxFlags(0), rxCurrent(0), rxPass(0), rxTsUs(0),
+      txCurrent(0), txStatus(0), txbPriority{0, 0, 0}, txbFrame{},
+      txFrameBits(0), txAllBusyUs(0),
+      txAllBusy(false),
+      lastTxCompleteUs(0) {}
+
+/**
+ * @brief デストラクタ
+ */
+MCP2515_Driver::~MCP2515_Driver() {
+  if (rxIrqEnabled) {
+    detachInterrupt(digitalPinToInterrupt(intPin));
+    rxIrqEnabled = false;
+  }
+  if (isrInstance == this) {
+    isrInstance = nullptr;
+  }
+}
+
+// ============================================================================
+// SPI命令ヘルパー
+// ============================================================================
+
+void HOT_FUNC(MCP2515_Driver::xfer)(const uint8_t *tx, uint8_t *rx,
+                                    uint16_t len, bool rxPath) {
+  spi->transfer(tx, rx, len);
+  if (rxPath) {
+    spiStats.rxTransactions++;
+    spiStats.rxBytes += len;
+  } else {
+    spiStats.txTransactions++;
+    spiStats.txBytes += len;
+  }
+}
+
+void HOT_FUNC(MCP2515_Driver::xferAsync)(const uint8_t *tx, uint8_t *rx,
+                                         uint16_t len, bool rxPath,
+                                         SPITransport::Callback callback) {
+  // 統計はコールバックより先に更新する (同期実装ではその場で呼ばれるため)
+  if (rxPath) {
+    spiStats.rxTransactions++;
+    spiStats.rxBytes += len;
+  } else {
+    spiStats.txTransactions++;
+    spiStats.txBytes += len;
+  }
+  // バス使用権を持っている間は転送中の非同期転送は存在しないため失敗しない
+  spi->transferAsync(tx, rx, len, callback, this);
+}
+
+void MCP2515_Driver::reset() {
+  uint8_t tx[1] = {INSTR_RESET};
+  uint8_t rx[1];
+  xfer(tx, rx, 1, false);
+}
+
+uint8_t MCP2515_Driver::readRegister(uint8_t addr) {
+  uint8_t tx[3] = {INSTR_READ, addr, 0x00};
+  uint8_t rx[3];
+  xfer(tx, rx, 3, false);
+  return rx[2];
+}
+
+void MCP2515_Driver::writeRegisters(uint8_t addr, const uint8_t *values,
+                                    uint8_t n) {
+  // WRITE はアドレスが自動インクリメントされるため連続レジスタを一括で書ける
+  uint8_t tx[2 + 16];
+  uint8_t rx[2 + 16];
+  if (n > 16) {
+    n = 16;
+  }
+  tx[0] = INSTR_WRITE;
+  tx[1] = addr;
+  for (uint8_t i = 0; i < n; i++) {
+    tx[2 + i] = values[i];
+  }
+  xfer(tx, rx, 2 + n, false);
+}
+
+void MCP2515_Driver::modifyRegister(uint8_t addr, uint8_t mask,
+                                    uint8_t value) {
+  uint8_t tx[4] = {INSTR_BIT_MODIFY, addr, mask, value};
+  uint8_t rx[4];
+  xfer(tx, rx, 4, false);
+}
+
+bool MCP2515_Driver::setMode(uint8_t mode) {
+  modifyRegister(REG_CANCTRL, MODE_MASK, mode);
+
+  // モード遷移は送受信中のフレーム完了を待つため、一定時間ポーリングする
+  uint32_t start = millis();
+  while (millis() - start < 10) {
+    if ((readRegister(REG_CANSTAT) & MODE_MASK) == mode) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief CNF1..3 の書き込み
+ *
+ * @return true: 書き込み成功, false: 未対応のビットレートまたは読み返し不一致
+ */
+bool MCP2515_Driver::writeBitTiming() {
+  const BitTiming *timing = findBitTiming16MHz(bitrate);
+  if (timing == nullptr) {
+    return false;
+  }
+  // CNF3, CNF2, CNF1 は連続アドレス
+  const uint8_t cnf[3] = {timing->cnf3, timing->cnf2, timing->cnf1};
+  writeRegisters(REG_CNF3, cnf, 3);
+  return readRegister(REG_CNF1) == timing->cnf1 &&
+         readRegister(REG_CNF2) == timing->cnf2;
+}
+
+/**
+ * @brief マスク・フィルタレジスタの書き込み
+ *
+ * フィルタ未設定時はマスクを 0 とし、全フレームを受信する。
+ * リセット後の値は不定のため、未設定時も明示的に書き込む。
+ */
+void MCP2515_Driver::writeFilters() {
+  uint8_t filt[12];
+  uint8_t mask[8];
+  if (!filterTable.enabled()) {
+    for (uint8_t i = 0; i < sizeof(filt); i++) {
+      filt[i] = 0x00;
+    }
+    writeRegisters(REG_RXF0SIDH, filt, 12); // RXF0..RXF2
+    writeRegisters(REG_RXF3SIDH, filt, 12); // RXF3..RXF5
+    writeRegisters(REG_RXM0SIDH, filt, 8);  // RXM0, RXM1
+    return;
+  }
+
+  // RXF0..RXF2 (0x00-0x0B) と RXF3..RXF5 (0x10-0x1B) はそれぞれ連続アドレス
+  for (uint8_t bank = 0; bank < 2; bank++) {
+    for (uint8_t i = 0; i < 3; i++) {
+      const CANFilter &f = filterTable.hardwareFilter(bank * 3 + i);
+      encodeId(f.id & ~CANFilter::EXT_ID_FLAG,
+                     (f.id & CANFilter::EXT_ID_FLAG) != 0, &filt[i * 4]);
+    }
+    writeRegisters(bank == 0 ? REG_RXF0SIDH : REG_RXF3SIDH, filt, 12);
+  }
+
+  // RXM0, RXM1 (0x20-0x27)
+  for (uint8_t buffer = 0; buffer < 2; buffer++) {
+    CANFilter m = filterTable.hardwareMask(buffer);
+    encodeId(m.mask, (m.id & CANFilter::EXT_ID_FLAG) != 0,
+                   &mask[buffer * 4]);
+    mask[buffer * 4 + 1] &= ~SIDL_IDE; // マスクに EXIDE ビットはない
+  }
+  writeRegisters(REG_RXM0SIDH, mask, 8);
+}
+
+// ============================================================================
+// CANInterface 実装
+// ============================================================================
+
+/**
+ * @brief CANコントローラの初期化
+ *
+ * @return true: 初期化成功, false: 初期化失敗
+ */
+bool MCP2515_Driver::begin() {
+  if (spi == nullptr) {
+    return false;
+  }
+
+  lastError = ERROR_OK;
+  spi->begin();
+
+  // INTピンの初期化 (外部プルアップを想定しているが、安全のため入力設定)
+  if (intPin != 255) {
+    pinMode(intPin, INPUT_PULLUP);
+  }
+
+  // リセット後はコンフィグモードで起動する
+  reset();
+  delay(10);
+  if ((readRegister(REG_CANSTAT) & MODE_MASK) != MODE_CONFIG) {
+    lastError = ERROR_FAIL;
+    return false;
+  }
+
+  // ビットタイミング
+  if (!writeBitTiming()) {
+    lastError = ERROR_FAILINIT;
+    return false;
+  }
+
+  // マスク・フィルタ (setFilters() 未設定時は全フレーム受信)
+  writeFilters();
+
+  // 送信バッファ制御をクリア
+  writeRegister(REG_TXB0CTRL, 0x00);
+  writeRegister(REG_TXB1CTRL, 0x00);
+  writeRegister(REG_TXB2CTRL, 0x00);
+  txbPriority[0] = txbPriority[1] = txbPriority[2] = 0;
+
+  // 受信バッファ: フィルタ使用、RXB0 満杯時は RXB1 へロールオーバー
+  writeRegister(REG_RXB0CTRL, RXB0_BUKT);
+  writeRegister(REG_RXB1CTRL, 0x00);
+
+  // 受信割り込みのみ有効化 (INT Low ⇔ 未読フレームあり)
+  writeRegister(REG_CANINTF, 0x00);
+  writeRegister(REG_CANINTE, INT_RX0 | INT_RX1);
+
+  if (!setMode(MODE_NORMAL)) {
+    lastError = ERROR_FAILINIT;
+    return false;
+  }
+
+  // INTピンの立ち下がりで受信割り込み
+  if (intPin != 255 && !rxIrqEnabled) {
+    isrInstance = this;
+    spi->usingInterrupt(intPin);
+    attachInterrupt(digitalPinToInterrupt(intPin), onIntPin, FALLING);
+    rxIrqEnabled = true;
+
+    // 登録前に既にINTがLowになっていた場合はエッジが来ないため回収しておく
+    if (digitalRead(intPin) == LOW && acquireBus()) {
+      startRx(micros());
+    }
+  }
+
+  started = true;
+  return true;
+}
+
+/**
+ * @brief ビットレートの設定
+ *
+ * @param newBitrate ビットレート (bps)
+ * @return true: 設定成功, false: 未対応のビットレートまたはモード切替失敗
+ */
+bool MCP2515_Driver::setBitrate(uint32_t newBitrate) {
+  if (findBitTiming16MHz(newBitrate) == nullptr) {
+    return false;
+  }
+  if (!started) {
+    bitrate = newBitrate; // begin() で書き込む
+    return true;
+  }
+
+  // 実行中の送受信手順の完了を待ってからバスを占有する
+  while (!acquireBus()) {
+    tight_loop_contents();
+  }
+  bool ok = setMode(MODE_CONFIG);
+  if (ok) {
+    bitrate = newBitrate;
+    ok = writeBitTiming();
+  }
+  ok = setMode(MODE_NORMAL) && ok;
+  releaseBus();
+  return ok;
+}
+
+/**
+ * @brief 受信フィルタの設定
+ *
+ * @param filters フィルタ設定の配列
+ * @param count フィルタ数
+ * @return true: 設定成功, false: フィルタ数超過またはモード切替失敗
+ */
+bool MCP2515_Driver::setFilters(const CANFilter *filters, uint8_t count) {
+  if (!started) {
+    // begin() で書き込む
+    return filterTable.set(filters, count);
+  }
+
+  // 実行中の送受信手順の完了を待ってからバスを占有する
+  // (手順は DMA 完了割り込みで進むため、メインコンテキストでは待ってよい)
+  while (!acquireBus()) {
+    tight_loop_contents();
+  }
+  bool ok = filterTable.set(filters, count);
+  if (ok) {
+    ok = setMode(MODE_CONFIG);
+    if (ok) {
+      writeFilters();
+    }
+    ok = setMode(MODE_NORMAL) && ok;
+  }
+  releaseBus();
+  return ok;
+}
+
+// ============================================================================
+// バス調停
+// ============================================================================
+
+bool HOT_FUNC(MCP2515_Driver::acquireBus)() {
+  uint32_t irqState = save_and_disable_interrupts();
+  bool acquired = !busActive;
+  if (acquired) {
+    busActive = true;
+  }
+  restore_interrupts(irqState);
+  return acquired;
+}
+
+/**
+ * @brief バスの使用権を解放し、保留中の受信・送信を開始する
+ *
+ * 受信を優先する (MCP2515の受信バッファは2段しかないため)。
+ * 割り込みコンテキスト (DMA完了) からも呼ばれる。
+ */
+void HOT_FUNC(MCP2515_Driver::releaseBus)(bool tryTx) {
+  uint32_t irqState = save_and_disable_interrupts();
+  busActive = false;
+  bool startRxNow = false;
+  bool startTxNow = false;
+  uint32_t edgeUs = 0;
+  if (rxPending) {
+    rxPending = false;
+    edgeUs = rxEdgeUs;
+    busActive = true;
+    startRxNow = true;
+  } else if (tryTx && !txAllBusy && !txQueue.empty()) {
+    busActive = true;
+    startTxNow = true;
+  }
+  restore_interrupts(irqState);
+
+  if (startRxNow) {
+    startRx(edgeUs);
+  } else if (startTxNow) {
+    startTx();
+  }
+}
+
+/**
+ * @brief 送信キューにフレームがあれば送信手順を開始する
+ *
+ * 全送信バッファが送信待ちだった場合は、1フレーム分の時間が
+ * 経過するまで再試行しない (READ STATUS の空打ちを避けるため)。
+ */
+void HOT_FUNC(MCP2515_Driver::pumpTx)() {
+  if (txQueue.empty()) {
+    return;
+  }
+  if (txAllBusy) {
+    if (micros() - txAllBusyUs < TX_RETRY_INTERVAL_US) {
+      return;
+    }
+    txAllBusy = false;
+  }
+  if (acquireBus()) {
+    startTx();
+  }
+}
+
+// ============================================================================
+// 受信手順
+// ============================================================================
+
+void HOT_FUNC(MCP2515_Driver::startRx)(uint32_t edgeUs) {
+  rxPass = 0;
+  rxTsUs = edgeUs;
+  rxPoll();
+}
+
+void HOT_FUNC(MCP2515_Driver::rxPoll)() {
+  rxDmaOut[0] = INSTR_READ_STATUS;
+  rxDmaOut[1] = 0x00;
+  xferAsync(rxDmaOut, rxDmaIn, 2, true, onRxStatusDone);
+}
+
+void HOT_FUNC(MCP2515_Driver::onRxStatusDone)(void *ctx) {
+  MCP2515_Driver *self = static_cast<MCP2515_Driver *>(ctx);
+  self->rxFlags = self->rxDmaIn[1] & (STAT_RX0IF | STAT_RX1IF);
+  if (self->rxFlags != 0) {
+    self->rxReadNext();
+    return;
+  }
+  self->releaseBus();
+}
+
+/**
+ * @brief READ RX BUFFER の非同期転送を開始する
+ *
+ * CS解除時に対応する RXnIF が自動クリアされるため、
+ * 割り込みフラグのクリアに別トランザクションは不要。
+ */
+void HOT_FUNC(MCP2515_Driver::rxReadNext)() {
+  if (rxFlags & STAT_RX0IF) {
+    rxCurrent = 0;
+    rxFlags &= ~STAT_RX0IF;
+  } else {
+    rxCurrent = 1;
+    rxFlags &= ~STAT_RX1IF;
+  }
+  for (uint8_t i = 0; i < sizeof(rxDmaOut); i++) {
+    rxDmaOut[i] = 0x00;
+  }
+  rxDmaOut[0] = (rxCurrent == 0) ? INSTR_READ_RXB0_SIDH : INSTR_READ_RXB1_SIDH;
+  xferAsync(rxDmaOut, rxDmaIn, sizeof(rxDmaOut), true, onRxReadDone);
+}
+
+void HOT_FUNC(MCP2515_Driver::onRxReadDone)(void *ctx) {
+  MCP2515_Driver *self = static_cast<MCP2515_Driver *>(ctx);
+
+  const uint8_t *buf = &self->rxDmaIn[1];
+  uint32_t id;
+  if (buf[1] & SIDL_IDE) {
+    // 拡張フレーム: 29bit ID にフラグを付与して上位レイヤーへ渡す
+    id = ((uint32_t)buf[0] << 21) | ((uint32_t)(buf[1] & 0xE0) << 13) |
+         ((uint32_t)(buf[1] & 0x03) << 16) | ((uint32_t)buf[2] << 8) |
+         buf[3];
+    id |= CAN_EFF_FLAG;
+  } else {
+    id = ((uint32_t)buf[0] << 3) | (buf[1] >> 5);
+  }
+  uint8_t len = buf[4] & DLC_MASK;
+  if (len > 8) {
+    len = 8;
+  }
+  // 受信フィルタで破棄するフレームもバスを占有していたため計上する
+  self->busBitsRx += canFrameBitsMax(len, (id & CAN_EFF_FLAG) != 0);
+  if (self->filterTable.match(id)) {
+    self->rxRing.push(id, len, &buf[FRAME_HEADER_LEN], self->rxTsUs);
+  }
+
+  if (self->rxFlags != 0) {
+    self->rxReadNext();
+    return;
+  }
+
+  // 読み出し中に次のフレームが届くと INT は Low のまま残り、
+  // 立ち下がりエッジが発生しないため、INT が High に戻るまで繰り返す
+  if (self->intPin != 255 && digitalRead(self->intPin) == LOW &&
+      ++self->rxPass < RX_SERVICE_MAX_PASSES) {
+    self->rxTsUs = micros();
+    self->rxPoll();
+    return;
+  }
+  self->releaseBus();
+}
+
+/**
+ * @brief INTピン割り込みハンドラ
+ *
+ * 送信手順の実行中は受信を保留し、その手順の完了時に開始する。
+ * 受信時刻はエッジの時刻とする (保留した時間を往復時間に含めない)。
+ */
+void HOT_FUNC(MCP2515_Driver::onIntPin)() {
+  MCP2515_Driver *self = isrInstance;
+  if (self == nullptr) {
+    return;
+  }
+  uint32_t edgeUs = micros();
+  if (self->acquireBus()) {
+    self->startRx(edgeUs);
+  } else if (!self->rxPending) {
+    // 保留中に続くエッジは同じ読み出しで回収するため、最初の時刻を残す
+    self->rxEdgeUs = edgeUs;
+    self->rxPending = true;
+  }
+}
+
+// ============================================================================
+// 送信手順
+// ============================================================================
+
+/**
+ * @brief 送信バッファの選択
+ *
+ * MCP2515 は送信待ちのバッファを TXP の高い順、同じ TXP ではバッファ番号の
+ * 大きい順に送信する。同じ優先度のフレームを投入順に送信するため、
+ * 同じ TXP で送信待ちのバッファより番号の小さい空きバッファのうち、
+ * 最も番号の大きいものを選ぶ (全バッファが空なら TXB2, TXB1, TXB0 の順)。
+ *
+ * @param status READ STATUS の応答
+ * @param prio 送信するフレームの TXP
+ * @return バッファ番号, -1: 投入順を守れる空きバッファがない
+ */
+int8_t HOT_FUNC(MCP2515_Driver::selectTxBuffer)(uint8_t status,
+                                                uint8_t prio) const {
+  // STAT_TXB0REQ, STAT_TXB1REQ, STAT_TXB2REQ は2bit間隔
+  int8_t limit = 3;
+  for (int8_t n = 0; n < 3; n++) {
+    if ((status & (STAT_TXB0REQ << (2 * n))) && txbPriority[n] == prio) {
+      limit = n;
+      break;
+    }
+  }
+  for (int8_t n = limit - 1; n >= 0; n--) {
+    if (!(status & (STAT_TXB0REQ << (2 * n)))) {
+      return n;
+    }
+  }
+  return -1;
+}
+
+void HOT_FUNC(MCP2515_Driver::startTx)() {
+  // 送信待ちのバッファ (READ STATUS の TXREQ ビット)
+  txDmaOut[0] = INSTR_READ_STATUS;
+  txDmaOut[1] = 0x00;
+  xferAsync(txDmaOut, txDmaIn, 2, false, onTxStatusDone);
+}
+
+void HOT_FUNC(MCP2515_Driver::onTxStatusDone)(void *ctx) {
+  MCP2515_Driver *self = static_cast<MCP2515_Driver *>(ctx);
+  self->loadTx(self->txDmaIn[1], true);
+}
+
+/**
+ * @brief 置き換え対象のフレームを書き込み済みで送信待ちの送信バッファ
+ *
+ * @param status READ STATUS の応答
+ * @param entry 送信するフレーム
+ * @return バッファ番号, -1: 該当なし
+ */
+int8_t HOT_FUNC(MCP2515_Driver::findSupersededBuffer)(
+    uint8_t status, const CANTxEntry &entry) const {
+  if (entry.supersede == CAN_TX_APPEND) {
+    return -1;
+  }
+  for (int8_t n = 0; n < 3; n++) {
+    const TxbFrame &loaded = txbFrame[n];
+    if ((status & (STAT_TXB0REQ << (2 * n))) &&
+        canTxSupersedes(entry.supersede, entry.id, entry.len, entry.data[0],
+                        loaded.id, loaded.len, loaded.cmd)) {
+      return n;
+    }
+  }
+  return -1;
+}
+
+void HOT_FUNC(MCP2515_Driver::loadTx)(uint8_t status, bool replace) {
+  // キュー先頭の優先度で送信バッファを選び、取り出す
+  // (送信要求と競合しないよう割り込み禁止)
+  CANTxEntry entry;
+  int8_t buffer = -1;
+  int8_t superseded = -1;
+  uint32_t irqState = save_and_disable_interrupts();
+  const CANTxEntry *head = txQueue.front();
+  bool hasFrame = (head != nullptr);
+  if (hasFrame) {
+    if (replace) {
+      superseded = findSupersededBuffer(status, *head);
+    }
+    if (superseded < 0) {
+      buffer = selectTxBuffer(status, head->priority & TXB_TXP_MASK);
+      if (buffer >= 0) {
+        entry = *head;
+        txQueue.pop();
+      }
+    }
+  }
+  restore_interrupts(irqState);
+  if (!hasFrame) {
+    releaseBus(false);
+    return;
+  }
+  if (superseded >= 0) {
+    // 送信待ちの古いフレームの送信要求を取り消し、同じバッファに書き直す
+    // (空いている番号の小さいバッファに書くと、古いフレームが先に送信される)
+    txCurrent = (uint8_t)superseded;
+    txStatus = status;
+    txDmaOut[0] = INSTR_BIT_MODIFY;
+    txDmaOut[1] = TXB_CTRL_REG[txCurrent];
+    txDmaOut[2] = TXB_TXREQ;
+    txDmaOut[3] = 0x00;
+    xferAsync(txDmaOut, txDmaIn, 4, false, onTxAbortRequested);
+    return;
+  }
+  if (buffer < 0) {
+    // 送信完了割り込みは使用しないため、一定時間後に再試行する
+    spiStats.txAllBusy++;
+    txAllBusyUs = micros();
+    txAllBusy = true;
+    releaseBus(false);
+    return;
+  }
+  writeTxBuffer((uint8_t)buffer, entry);
+}
+
+void HOT_FUNC(MCP2515_Driver::onTxAbortRequested)(void *ctx) {
+  MCP2515_Driver *self = static_cast<MCP2515_Driver *>(ctx);
+
+  // 取り消せたかを TXBnCTRL で確認する (送信中なら TXREQ が残る)
+  self->txDmaOut[0] = INSTR_READ;
+  self->txDmaOut[1] = TXB_CTRL_REG[self->txCurrent];
+  self->txDmaOut[2] = 0x00;
+  self->xferAsync(self->txDmaOut, self->txDmaIn, 3, false, onTxAbortChecked);
+}
+
+void HOT_FUNC(MCP2515_Driver::onTxAbortChecked)(void *ctx) {
+  MCP2515_Driver *self = static_cast<MCP2515_Driver *>(ctx);
+  const uint8_t ctrl = self->txDmaIn[2];
+  const uint8_t n = self->txCurrent;
+
+  if (ctrl & TXB_TXREQ) {
+    // 調停に勝って送信中のため取り消せない: その後に送信する
+    self->loadTx(self->txStatus, false);
+    return;
+  }
+
+  // 空いたバッファに書き直す (確認の間に先頭が変わった場合は通常の選択)
+  CANTxEntry entry;
+  bool same = false;
+  uint32_t irqState = save_and_disable_interrupts();
+  const CANTxEntry *head = self->txQueue.front();
+  if (head != nullptr && self->findSupersededBuffer(
+                             STAT_TXB0REQ << (2 * n), *head) == (int8_t)n) {
+    entry = *head;
+    self->txQueue.pop();
+    same = true;
+    // ABTF: 送信せずに取り消した (0 なら確認の前に送信を終えていた)
+    if (ctrl & TXB_ABTF) {
+      self->txQueue.countSuperseded();
+    }
+  }
+  restore_interrupts(irqState);
+  if (!same) {
+    self->loadTx(self->txStatus & ~(STAT_TXB0REQ << (2 * n)), false);
+    return;
+  }
+  self->writeTxBuffer(n, entry);
+}
+
+/**
+ * @brief フレームを送信バッファに書き込む (完了後に RTS を発行する)
+ *
+ * @param n 送信バッファ番号
+ * @param entry 送信するフレーム
+ */
+void HOT_FUNC(MCP2515_Driver::writeTxBuffer)(uint8_t n,
+                                             const CANTxEntry &entry) {
+  txCurrent = n;
+  txbFrame[n] = TxbFrame{entry.id, entry.len, entry.data[0]};
+
+  // 優先度が前回と同じなら LOAD TX BUFFER (SIDH から)、
+  // 異なる場合は TXBnCTRL から WRITE して TXP も同時に書き込む
+  uint8_t prio = entry.priority & TXB_TXP_MASK;
+  uint8_t *frame;
+  uint8_t header;
+  if (prio == txbPriority[n]) {
+    txDmaOut[0] = TXB_LOAD_INSTR[n];
+    header = 1;
+  } else {
+    txDmaOut[0] = INSTR_WRITE;
+    txDmaOut[1] = TXB_CTRL_REG[n];
+    txDmaOut[2] = prio; // TXREQ = 0 (RTS で要求する)
+    txbPriority[n] = prio;
+    header = 3;
+  }
+  frame = &txDmaOut[header];
+
+  // SIDH..D7
+  bool ext = (entry.id & CAN_EFF_FLAG) != 0;
+  encodeId(entry.id & ~CAN_EFF_FLAG, ext, frame);
+  frame[4] = entry.len & DLC_MASK;
+  for (uint8_t i = 0; i < entry.len; i++) {
+    frame[FRAME_HEADER_LEN + i] = entry.data[i];
+  }
+  txFrameBits = (uint16_t)canFrameBitsMax(entry.len, ext);
+  xferAsync(txDmaOut, txDmaIn, header + FRAME_HEADER_LEN + entry.len, false,
+            onTxLoaded);
+}
+
+void HOT_FUNC(MCP2515_Driver::onTxLoaded)(void *ctx) {
+  MCP2515_Driver *self = static_cast<MCP2515_Driver *>(ctx);
+
+  // RTS: 送信要求 (1バイトでも DMA 完了割り込みの中で SPI を待たない)
+  self->txDmaOut[0] = (uint8_t)(INSTR_RTS | (1 << self->txCurrent));
+  self->xferAsync(self->txDmaOut, self->txDmaIn, 1, false, onTxRequested);
+}
+
+void HOT_FUNC(MCP2515_Driver::onTxRequested)(void *ctx) {
+  MCP2515_Driver *self = static_cast<MCP2515_Driver *>(ctx);
+  self->lastTxCompleteUs = micros();
+  self->busBitsTx += self->txFrameBits;
+
+  self->releaseBus();
+}
+
+// ============================================================================
+// CANInterface 実装
+// ============================================================================
+
+/**
+ * @brief CANフレームの送信
+ *
+ * @param id CAN識別子 (11bit標準フレーム)
+ * @param len データ長 (0-8バイト)
+ * @param data 送信データへのポインタ
+ * @return true: キュー投入成功, false: キュー満杯で破棄
+ */
+bool HOT_FUNC(MCP2515_Driver::sendFrame)(uint32_t id, uint8_t len,
+                                         const uint8_t *data) {
+  return queueFrame(id, len, data, CAN_TX_PRIO_NORMAL, CAN_TX_APPEND);
+}
+
+/**
+ * @brief 優先度付きのCANフレーム送信
+ *
+ * @param id CAN識別子
+ * @param len データ長 (0-8バイト)
+ * @param data 送信データへのポインタ
+ * @param priority 送信優先度
+ * @param supersede 未送信フレームの置き換え条件
+ * @return true: キュー投入成功, false: キュー満杯で破棄
+ */
+bool HOT_FUNC(MCP2515_Driver::queueFrame)(uint32_t id, uint8_t len,
+                                          const uint8_t *data,
+                                          CANTxPriority priority,
+                                          CANTxSupersede supersede) {
+  if (spi == nullptr || data == nullptr) {
+    return false;
+  }
+
+  // キューは送信手順 (DMA完了割り込み) からも取り出されるため割り込み禁止
+  uint32_t irqState = save_and_disable_interrupts();
+  CANTxQueue<TX_QUEUE_SIZE>::Result result =
+      txQueue.push(id, len, data, priority, supersede);
+  restore_interrupts(irqState);
+
+  if (result == CANTxQueue<TX_QUEUE_SIZE>::DROPPED) {
+    lastError = ERROR_ALLTXBUSY;
+    return false;
+  }
+  // 置き換え指定のフレームは送信待ちのバッファを置き換えられるため、
+  // 全バッファ使用中でも再試行間隔を待たない
+  if (supersede != CAN_TX_APPEND) {
+    txAllBusy = false;
+  }
+
+  // 新しいフレームで即座に送信を試みる (全バッファ使用中なら再試行待ち)
+  pumpTx();
+  return true;
+}
+
+/**
+ * @brief CANフレームの受信
+ */
+bool MCP2515_Driver::readFrame(uint32_t &id, uint8_t &len, uint8_t *data) {
+  if (data == nullptr || !available()) {
+    return false;
+  }
+
+  CANFrame frame;
+  if (!rxRing.pop(frame)) {
+    return false;
+  }
+  id = frame.id;
+  len = frame.len;
+  for (uint8_t i = 0; i < len; i++) {
+    data[i] = frame.data[i];
+  }
+  return true;
+}
+
+/**
+ * @brief 受信バッファの確認
+ *
+ * 割り込み未使用時はここで受信手順を開始する。
+ * 割り込み使用時はエッジの取りこぼし (INTがLowのまま) を回収する。
+ */
+bool HOT_FUNC(MCP2515_Driver::available)() {
+  if (spi == nullptr) {
+    return false;
+  }
+
+  if (rxRing.empty()) {
+    bool missedEdge = rxIrqEnabled && digitalRead(intPin) == LOW;
+    if ((!rxIrqEnabled || missedEdge) && acquireBus()) {
+      startRx(micros());
+    }
+  }
+
+  // 全送信バッファ使用中で残っていた送信フレームを再試行する
+  // (受信手順の実行中であれば、その完了時に送信される)
+  pumpTx();
+  return !rxRing.empty();
+}
+
+/**
+ * @brief 受信済みフレームの一括取得
+ */
+uint8_t HOT_FUNC(MCP2515_Driver::readFrames)(CANFrame *frames,
+                                             uint8_t maxFrames) {
+  if (frames == nullptr || !available()) {
+    return 0;
+  }
+
+  uint8_t count = 0;
+  while (count < maxFrames && rxRing.pop(frames[count])) {
+    count++;
+  }
+  return count;
+}
@@ -0,0 +1,481 @@
+#ifndef MCP2515_DRIVER_H
+#define MCP2515_DRIVER_H
+
+#include "CANFilterTable.h"
+#include "CANFrameRing.h"
+#include "CANTxQueue.h"
+#include "MCP2515_Defs.h"
+#include "SPITransport.h"
+#include <CANInterface.h> // includeディレクトリから参照
+#include <cstdint>
+
+/**
+ * @file MCP2515_Driver.h
+ * @brief MCP2515 CANコントローラのネイティブドライバ
+ * @date 2026-10-18
+ *
+ * 外部ライブラリを使用せず、MCP2515 の専用高速命令で CANInterface を
+ * 実装します。SPI 転送は SPITransport 経由で行うため、
+ * モックSPIを注入してハードウェアなしに検証できます。
+ *
+ * ## SPIトランザクション
+ * - 送信: READ STATUS (2B) → LOAD TX BUFFER (14B) → RTS (1B)
+ *   (送信バッファの優先度を変更する場合は LOAD TX BUFFER の代わりに
+ *    TXBnCTRL から連続書き込みする WRITE (16B))
+ * - 受信: READ STATUS (2B) → READ RX BUFFER (14B, RXnIF 自動クリア)
+ *
+ * レジスタ単位の READ/WRITE/BIT MODIFY を組み合わせる MCP2515_Wrapper
+ * (autowp ライブラリ経由) と比べ、トランザクション数とバイト数を削減します。
+ *
+ * ## 受信経路
+ * MCP2515_Wrapper と同様に、INTピンの立ち下がりエッジ割り込みで
+ * 両受信バッファを読み出してリングバッファへ格納します。
+ * CANINTE は受信割り込みのみ有効にするため、INT が Low であることは
+ * 受信バッファに未読フレームがあることと等価です。
+ *
+ * ## 非同期転送とバス調停
+ * 送受信の手順の各トランザクション (READ STATUS / LOAD TX BUFFER / RTS /
+ * READ RX BUFFER) は transferAsync() で転送し、完了コールバックで次の
+ * トランザクションに進みます。INTピン割り込みと DMA 完了割り込みの中で
+ * SPI の完了を待つことはありません (同期転送は begin() などの設定のみ)。
+ * DMA 転送中に sendFrame() は即座に戻るため、送信中のシフト時間を
+ * ADCサンプリングやエフェクト演算と重ねられます。
+ *
+ * 送信・受信の一連の手順は busActive フラグで排他し、
+ * 実行中に発生した受信割り込みは保留して、手順完了時 (releaseBus()) に
+ * 続けて開始します。
+ *
+ * ## 送信キュー
+ * 送信フレームは優先度付きの送信キュー (CANTxQueue) に積み、
+ * 空いている送信バッファ (TXB0..2) へ順に書き込みます。
+ * 各送信バッファの TXP ビットにフレームの優先度を設定するため、
+ * 複数のバッファが送信待ちのときは優先度の高いフレームから送信されます。
+ * MCP2515 は同じ TXP のバッファを番号の大きい順に送信するため、
+ * 同じ優先度のフレームは送信待ちのバッファより番号の小さいバッファへ
+ * 書き込み、投入順に送信されるようにします (selectTxBuffer())。
+ * 書き込めるバッファがない場合はキューに残し、送信要求・バス解放時・
+ * available() の呼び出し時に再試行します。
+ * トルク指令は supersede 指定で投入し、未送信の古い指令を置き換えます。
+ * 古い指令が既に送信バッファに書き込まれて送信待ちの場合は、BIT MODIFY で
+ * TXREQ を取り消して同じバッファに書き直します (後から空いたバッファに
+ * 書くと古い指令が先に送信されるため)。調停に勝って送信中で取り消せない
+ * 場合は、その後に送信します。
+ *
+ * ## 受信フィルタ
+ * setFilters() の設定を RXM0/1, RXF0..5 に書き込み、対象外のフレームは
+ * MCP2515 内で破棄します (INT も発生せず、SPI 転送も行いません)。
+ * 割り当ては CANFilterTable を参照。
+ */
+
+/**
+ * @class MCP2515_Driver
+ * @brief MCP2515 ネイティブドライバ
+ */
+class MCP2515_Driver : public CANInterface {
+public:
+  /**
+   * @brief エラーコード (MCP2515_Wrapper::getLastError() と同じ値)
+   */
+  enum Error : uint8_t {
+    ERROR_OK = 0,
+    ERROR_FAIL = 1,
+    ERROR_ALLTXBUSY = 2,
+    ERROR_FAILINIT = 3,
+    ERROR_FAILTX = 4,
+    ERROR_NOMSG = 5,
+  };
+
+  /**
+   * @brief SPI転送の統計情報 (診断用)
+   *
+   * SPI転送はバス調停下でのみ行われるため、カウンタ更新は競合しません。
+   *
+   * (*) 全送信バッファが送信待ちの場合と、投入順を守れる空きバッファが
+   *     ない場合 (selectTxBuffer() を参照) を含みます。
+   */
+  struct SpiStats {
+    uint32_t txTransactions; ///< 送信経路のトランザクション数
+    uint32_t txBytes;        ///< 送信経路の転送バイト数
+    uint32_t rxTransactions; ///< 受信経路のトランザクション数
+    uint32_t rxBytes;        ///< 受信経路の転送バイト数
+    uint32_t txAllBusy;      ///< 空きバッファがなく見送った回数 (*)
+  };
+
+  /**
+   * @brief コンストラクタ
+   *
+   * @param spi SPI転送インターフェース
+   * @param interrupt MCP2515 INTピン番号 (255: 割り込み未使用)
+   */
+  MCP2515_Driver(SPITransport *spi, uint8_t interrupt);
+
+  /**
+   * @brief デストラクタ
+   *
+   * 受信割り込みを解除します。
+   */
+  ~MCP2515_Driver();
+
+  /**
+   * @brief CANコントローラの初期化
+   *
+   * MCP2515をリセットし、ビットタイミング・受信バッファ・割り込みを
+   * 設定してノーマルモードで動作を開始します。
+   *
+   * 設定値:
+   * - ボーレート: setBitrate() の設定値 (既定 500kbps)
+   * - クロック: 16MHz
+   *
+   * @return true: 初期化成功, false: 初期化失敗
+   */
+  bool begin() override;
+
+  /**
+   * @brief CANフレームの送信
+   *
+   * 優先度 CAN_TX_PRIO_NORMAL で送信キューに積みます (queueFrame() を参照)。
+   * 空いている送信バッファへの書き込みは非同期に行われ、完了前に戻ります。
+   *
+   * @param id CAN識別子 (11bit標準フレーム)
+   * @param len データ長 (0-8バイト)
+   * @param data 送信データへのポインタ
+   * @return true: キュー投入成功, false: キュー満杯で破棄
+   */
+  bool sendFrame(uint32_t id, uint8_t len, const uint8_t *data) override;
+
+  /**
+   * @brief 優先度付きのCANフレーム送信
+   *
+   * 送信キューに積み、送信バッファが空いていれば書き込みを開始します。
+   *
+   * @param id CAN識別子 (拡張フレームは CAN_EFF_FLAG 付き)
+   * @param len データ長 (0-8バイト)
+   * @param data 送信データへのポインタ
+   * @param priority 送信優先度 (TXP ビットに設定)
+   * @param supersede 未送信フレームの置き換え条件
+   * @return true: キュー投入成功, false: キュー満杯で破棄
+   */
+  bool queueFrame(uint32_t id, uint8_t len, const uint8_t *data,
+                  CANTxPriority priority,
+                  CANTxSupersede supersede) override;
+
+  /**
+   * @brief CANフレームの受信
+   *
+   * @param id 受信したCAN識別子を格納する変数への参照
+   * @param len 受信したデータ長を格納する変数への参照
+   * @param data 受信データを格納するバッファへのポインタ
+   * (最低8バイト確保すること)
+   * @return true: 受信成功, false: 受信データなし
+   */
+  bool readFrame(uint32_t &id, uint8_t &len, uint8_t *data) override;
+
+  /**
+   * @brief 受信バッファの確認
+   *
+   * @return true: 受信データあり, false: 受信データなし
+   */
+  bool available() override;
+
+  /**
+   * @brief 受信済みフレームの一括取得
+   *
+   * @param frames 受信フレームの格納先
+   * @param maxFrames 取得する最大フレーム数
+   * @return 取得したフレーム数
+   */
+  uint8_t readFrames(CANFrame *frames, uint8_t maxFrames) override;
+
+  /**
+   * @brief ビットレートの設定
+   *
+   * 16MHz 発振子で 125k/250k/500k/1Mbps に対応します。
+   * 動作中に呼び出した場合は、コンフィグモードに切り替えて CNF1..3 を
+   * 書き込み、ノーマルモードに戻します。
+   *
+   * @param bitrate ビットレート (bps)
+   * @return true: 設定成功, false: 未対応のビットレートまたはモード切替失敗
+   */
+  bool setBitrate(uint32_t bitrate) override;
+
+  /**
+   * @brief 設定中のビットレートを取得 (bps)
+   */
+  uint32_t getBitrate() const override { return bitrate; }
+
+  /**
+   * @brief 送受信したフレームの累積ビット数を取得 (見積もり値, 診断用)
+   */
+  uint32_t getBusBitCount() const override { return busBitsTx + busBitsRx; }
+
+  /**
+   * @brief 受信フィルタの設定
+   *
+   * 動作中に呼び出した場合は、コンフィグモードに切り替えて書き込み、
+   * ノーマルモードに戻します (切り替え中のフレームは受信できません)。
+   *
+   * @param filters フィルタ設定の配列
+   * @param count フィルタ数 (0: 全フレーム受信, 最大6)
+   * @return true: 設定成功, false: フィルタ数超過またはモード切替失敗
+   */
+  bool setFilters(const CANFilter *filters, uint8_t count) override;
+
+  /**
+   * @brief フィルタごとの受信数を取得 (診断用)
+   */
+  uint32_t getFilterHitCount(uint8_t index) const override {
+    return filterTable.getHitCount(index);
+  }
+
+  /**
+   * @brief ハードウェアフィルタを通過したが設定に一致せず破棄した数 (診断用)
+   *
+   * 同じ受信バッファのフィルタ間でマスクが異なる場合に発生します。
+   */
+  uint32_t getFilterRejectCount() const {
+    return filterTable.getRejectCount();
+  }
+
+  /**
+   * @brief 最後に発生したエラーコードを取得
+   * @return Error 列挙型の値
+   */
+  uint8_t getLastError() const { return lastError; }
+
+  /**
+   * @brief リングバッファ満杯により破棄したフレーム数を取得 (診断用)
+   */
+  uint32_t getRxOverflowCount() const { return rxRing.getOverflowCount(); }
+
+  /**
+   * @brief SPI転送の統計情報を取得 (診断用)
+   */
+  const SpiStats &getSpiStats() const { return spiStats; }
+
+  /**
+   * @brief 送信キューの統計情報を取得 (診断用)
+   */
+  const CANTxStats &getTxStats() const { return txQueue.getStats(); }
+
+  /**
+   * @brief 最後に送信要求 (RTS) が完了した時刻を取得 (micros())
+   *
+   * 制御周期内のパイプライン時間計測に使用します。
+   */
+  uint32_t getLastTxCompleteUs() const { return lastTxCompleteUs; }
+
+private:
+  /// 受信リングバッファ段数 (1msあたりの応答数に対して十分な余裕)
+  static constexpr uint16_t RX_RING_SIZE = 16;
+  /// 既定のビットレート (bps)
+  static constexpr uint32_t DEFAULT_BITRATE = 500000;
+  /// 送信キュー段数
+  static constexpr uint8_t TX_QUEUE_SIZE = 8;
+  /// 全送信バッファ使用中の場合の再試行間隔 (us, 8バイトフレーム約1個分)
+  static constexpr uint32_t TX_RETRY_INTERVAL_US = 100;
+  /// 割り込み1回あたりの受信バッファ走査回数の上限
+  static constexpr uint8_t RX_SERVICE_MAX_PASSES = 4;
+  /// フレームバッファ長 (SIDH, SIDL, EID8, EID0, DLC, D0..D7)
+  static constexpr uint8_t FRAME_LEN = MCP2515Defs::FRAME_BUFFER_LEN;
+
+  /**
+   * @struct TxbFrame
+   * @brief 送信バッファに書き込んだフレーム (置き換えの照合用)
+   */
+  struct TxbFrame {
+    uint32_t id; ///< CAN識別子
+    uint8_t len; ///< データ長
+    uint8_t cmd; ///< 先頭データバイト
+  };
+
+  // --- SPI命令ヘルパー (同期転送) ---
+  void reset();
+  uint8_t readRegister(uint8_t addr);
+  void writeRegisters(uint8_t addr, const uint8_t *values, uint8_t n);
+  void writeRegister(uint8_t addr, uint8_t value) {
+    writeRegisters(addr, &value, 1);
+  }
+  void modifyRegister(uint8_t addr, uint8_t mask, uint8_t value);
+  bool setMode(uint8_t mode);
+
+  /**
+   * @brief マスク・フィルタレジスタの書き込み (コンフィグモードで呼ぶこと)
+   */
+  void writeFilters();
+
+  /**
+   * @brief CNF1..3 の書き込み (コンフィグモードで呼ぶこと)
+   * @return true: 書き込み成功 (読み返し一致)
+   */
+  bool writeBitTiming();
+
+  /**
+   * @brief SPI同期転送 (統計カウンタ更新付き)
+   * @param rxPath true: 受信経路のカウンタに計上
+   */
+  void xfer(const uint8_t *tx, uint8_t *rx, uint16_t len, bool rxPath);
+
+  /**
+   * @brief SPI非同期転送 (統計カウンタ更新付き)
+   */
+  void xferAsync(const uint8_t *tx, uint8_t *rx, uint16_t len, bool rxPath,
+                 SPITransport::Callback callback);
+
+  // --- バス調停 ---
+  /**
+   * @brief バスの使用権を取得する
+   * @return true: 取得成功, false: 他の手順が実行中
+   */
+  bool acquireBus();
+
+  /**
+   * @brief バスの使用権を解放し、保留中の受信・送信を開始する
+   * @param tryTx false: 送信キューの処理を行わない (全バッファ使用中の場合)
+   */
+  void releaseBus(bool tryTx = true);
+
+  /**
+   * @brief 送信キューにフレームがあれば送信手順を開始する
+   */
+  void pumpTx();
+
+  // --- 受信手順 ---
+  /**
+   * @brief 受信手順の開始 (バス使用権を取得済みであること)
+   * @param edgeUs 受信時刻 (INTピンの立ち下がりエッジの時刻)
+   */
+  void startRx(uint32_t edgeUs);
+
+  /**
+   * @brief 受信バッファを確認する READ STATUS の非同期転送を開始する
+   */
+  void rxPoll();
+
+  /**
+   * @brief READ STATUS 完了コールバック (受信バッファの読み出しを開始する)
+   */
+  static void onRxStatusDone(void *ctx);
+
+  /**
+   * @brief READ RX BUFFER の非同期転送を開始する
+   */
+  void rxReadNext();
+
+  /**
+   * @brief READ RX BUFFER 完了コールバック
+   */
+  static void onRxReadDone(void *ctx);
+
+  // --- 送信手順 ---
+  /**
+   * @brief 送信手順の開始 (バス使用権を取得済みであること)
+   *
+   * 送信バッファの状態を確認する READ STATUS の非同期転送を開始します。
+   */
+  void startTx();
+
+  /**
+   * @brief READ STATUS 完了コールバック (loadTx() を呼ぶ)
+   */
+  static void onTxStatusDone(void *ctx);
+
+  /**
+   * @brief 送信キューの先頭フレームを空いている送信バッファに書き込む
+   *
+   * 先頭フレームが送信待ちのバッファのフレームを置き換える場合は、
+   * そのバッファの送信要求の取り消しを開始します。
+   * キューが空、または書き込めるバッファがない場合はバスを解放します。
+   *
+   * @param status READ STATUS の応答
+   * @param replace false: 送信待ちのバッファを置き換えない (取り消し失敗後)
+   */
+  void loadTx(uint8_t status, bool replace);
+
+  /**
+   * @brief 置き換え対象のフレームが送信待ちの送信バッファを探す
+   */
+  int8_t findSupersededBuffer(uint8_t status, const CANTxEntry &entry) const;
+
+  /**
+   * @brief 送信要求の取り消し (BIT MODIFY) 完了コールバック
+   */
+  static void onTxAbortRequested(void *ctx);
+
+  /**
+   * @brief TXBnCTRL の読み出し完了コールバック (取り消せたバッファに書き直す)
+   */
+  static void onTxAbortChecked(void *ctx);
+
+  /**
+   * @brief フレームを送信バッファに書き込む (LOAD TX BUFFER または WRITE)
+   */
+  void writeTxBuffer(uint8_t n, const CANTxEntry &entry);
+
+  /**
+   * @brief 投入順を守れる送信バッファの選択
+   * @param status READ STATUS の応答
+   * @param prio 送信するフレームの TXP
+   * @return バッファ番号, -1: 書き込めるバッファがない
+   */
+  int8_t selectTxBuffer(uint8_t status, uint8_t prio) const;
+
+  /**
+   * @brief LOAD TX BUFFER 完了コールバック (RTS を発行する)
+   */
+  static void onTxLoaded(void *ctx);
+
+  /**
+   * @brief RTS 完了コールバック (バスを解放する)
+   */
+  static void onTxRequested(void *ctx);
+
+  /**
+   * @brief INTピン割り込みハンドラ (登録用の静的関数)
+   */
+  static void onIntPin();
+
+  static MCP2515_Driver *isrInstance; ///< 割り込みハンドラの転送先
+
+  SPITransport *spi;  ///< SPI転送インターフェース
+  uint8_t intPin;     ///< MCP2515 INTピン番号
+  uint8_t lastError;  ///< 最後に発生したエラーコード
+  bool rxIrqEnabled;  ///< 割り込み受信が有効か
+  SpiStats spiStats;  ///< SPI転送の統計情報
+  CANFrameRing<RX_RING_SIZE> rxRing; ///< 受信フレームのリングバッファ
+  CANFilterTable filterTable;        ///< 受信フィルタ設定と受信カウンタ
+  bool started;                      ///< begin() に成功したか
+  uint32_t bitrate;                  ///< ビットレート (bps)
+  volatile uint32_t busBitsTx;       ///< 送信フレームの累積ビット数
+  volatile uint32_t busBitsRx;       ///< 受信フレームの累積ビット数
+
+  // --- バス調停状態 ---
+  volatile bool busActive;    ///< 送信・受信の手順が実行中
+  volatile bool rxPending;    ///< 実行中に受信割り込みが発生した
+  volatile uint32_t rxEdgeUs; ///< 保留した受信割り込みの発生時刻
+
+  // --- 受信手順の状態 ---
+  uint8_t rxFlags;   ///< 未読の受信バッファ (READ STATUS の RXnIF)
+  uint8_t rxCurrent; ///< 読み出し中の受信バッファ番号
+  uint8_t rxPass;    ///< 現在の走査回数
+  uint32_t rxTsUs;   ///< 受信時刻 (割り込み発生時刻)
+
+  // --- 送信手順の状態 ---
+  CANTxQueue<TX_QUEUE_SIZE> txQueue;  ///< 優先度付き送信キュー
+  uint8_t txCurrent;                   ///< 書き込み中の送信バッファ番号
+  uint8_t txStatus;                    ///< 取り消し前の READ STATUS の応答
+  uint8_t txbPriority[3];              ///< 各送信バッファの TXP 設定値
+  TxbFrame txbFrame[3];                ///< 各送信バッファに書き込んだフレーム
+  uint16_t txFrameBits;                ///< 書き込み中フレームのビット数
+  volatile uint32_t txAllBusyUs;       ///< 全バッファ使用中を検出した時刻
+  volatile bool txAllBusy;             ///< 全バッファ使用中で再試行待ち
+  volatile uint32_t lastTxCompleteUs;  ///< 最後に RTS が完了した時刻
+
+  // --- DMA 転送用バッファ (転送完了まで保持が必要なためメンバに置く) ---
+  // 送信は WRITE (命令, アドレス, TXBnCTRL) + SIDH..D7 が最長
+  uint8_t txDmaOut[3 + FRAME_LEN];
+  uint8_t txDmaIn[3 + FRAME_LEN];
+  uint8_t rxDmaOut[1 + FRAME_LEN];
+  uint8_t rxDmaIn[1 + FRAME_LEN];
+};
+
+#endif // MCP2515_DRIVER_H
@@ -11,6 +11,34 @@
 #include <SPI.h>
 #include <mcp2515.h> // MCP2515ライブラリ（このファイル内でのみインクルード）
 
+MCP2515_Wrapper *MCP2515_Wrapper::isrInstance = nullptr;
+
+/**
+ * @brief ビットレート (bps) をライブラリの CAN_SPEED に変換
+ *
+ * @param bitrate ビットレート (bps)
+ * @param speed 変換結果
+ * @return true: 対応するビットレート
+ */
+static bool toCanSpeed(uint32_t bitrate, CAN_SPEED &speed) {
+  switch (bitrate) {
+  case 1000000:
+    speed = CAN_1000KBPS;
+    return true;
+  case 500000:
+    speed = CAN_500KBPS;
+    return true;
+  case 250000:
+    speed = CAN_250KBPS;
+    return true;
+  case 125000:
+    speed = CAN_125KBPS;
+    return true;
+  default:
+    return false;
+  }
+}
+
 /**
  * @brief コンストラクタ
  *
@@ -25,7 +53,9 @@
 MCP2515_Wrapper::MCP2515_Wrapper(uint8_t cs, uint8_t sck, uint8_t mosi,
                                  uint8_t miso, uint8_t interrupt)
     : csPin(cs), sckPin(sck), mosiPin(mosi), misoPin(miso), intPin(interrupt),
-      mcp2515(nullptr), rxFrame(nullptr) {
+      mcp2515(nullptr), rxFrame(nullptr), rxIrqEnabled(false),
+      lastTxCompleteUs(0), started(false), bitrate(500000), busBitsTx(0),
+      busBitsRx(0) {
   // MCP2515インスタンスを動的に生成
   mcp2515 = new MCP2515(csPin);
 
@@ -36,9 +66,17 @@ MCP2515_Wrapper::MCP2515_Wrapper(uint8_t cs, uint8_t sck, uint8_t mosi,
 /**
  * @brief デストラクタ
  *
- * MCP2515インスタンスと受信バッファを解放します。
+ * 受信割り込みを解除し、MCP2515インスタンスと受信バッファを解放します。
  */
 MCP2515_Wrapper::~MCP2515_Wrapper() {
+  if (rxIrqEnabled) {
+    detachInterrupt(digitalPinToInterrupt(intPin));
+    rxIrqEnabled = false;
+  }
+  if (isrInstance == this) {
+    isrInstance = nullptr;
+  }
+
   if (mcp2515 != nullptr) {
     delete mcp2515;
     mcp2515 = nullptr;
@@ -80,14 +118,24 @@ bool MCP2515_Wrapper::begin() {
   // MCP2515をリセット
   mcp2515->reset();
 
-  // ボーレートとクロック周波数を設定
-  // CAN_500KBPS: 500kbps, MCP_16MHZ: 16MHz クロック
-  MCP2515::ERROR result = mcp2515->setBitrate(CAN_500KBPS, MCP_16MHZ);
+  // ボーレートとクロック周波数を設定 (MCP_16MHZ: 16MHz クロック)
+  CAN_SPEED speed;
+  if (!toCanSpeed(bitrate, speed)) {
+    lastError = MCP2515::ERROR_FAILINIT;
+    return false;
+  }
+  MCP2515::ERROR result = mcp2515->setBitrate(speed, MCP_16MHZ);
   if (result != MCP2515::ERROR_OK) {
     lastError = static_cast<uint8_t>(result);
     return false;
   }
 
+  // マスク・フィルタ (reset() 直後は全フレーム受信)
+  if (filterTable.enabled() && !applyFilters()) {
+    lastError = MCP2515::ERROR_FAILINIT;
+    return false;
+  }
+
   // ノーマルモードに設定
   result = mcp2515->setNormalMode();
   if (result != MCP2515::ERROR_OK) {
@@ -95,41 +143,214 @@ bool MCP2515_Wrapper::begin() {
     return false;
   }
 
+  // INTピンの立ち下がりで受信割り込み
+  // SPI.usingInterrupt() により、メインコンテキストのSPIトランザクション中は
+  // この割り込みがマスクされるため、送信処理とSPIバスが衝突しない
+  if (intPin != 255 && !rxIrqEnabled) {
+    isrInstance = this;
+    SPI.usingInterrupt(digitalPinToInterrupt(intPin));
+    attachInterrupt(digitalPinToInterrupt(intPin), onIntPin, FALLING);
+    rxIrqEnabled = true;
+
+    // 登録前に既にINTがLowになっていた場合はエッジが来ないため回収しておく
+    noInterrupts();
+    serviceRx();
+    interrupts();
+  }
+
+  started = true;
+  return true;
+}
+
+/**
+ * @brief マスク・フィルタの書き込み
+ *
+ * 割り当ては CANFilterTable を参照。フィルタ未設定時はマスクを 0 とする。
+ *
+ * @return true: 書き込み成功
+ */
+bool MCP2515_Wrapper::applyFilters() {
+  if (!filterTable.enabled()) {
+    return mcp2515->setFilterMask(MCP2515::MASK0, false, 0) ==
+               MCP2515::ERROR_OK &&
+           mcp2515->setFilterMask(MCP2515::MASK1, false, 0) ==
+               MCP2515::ERROR_OK;
+  }
+
+  static const MCP2515::MASK MASKS[2] = {MCP2515::MASK0, MCP2515::MASK1};
+  for (uint8_t i = 0; i < 2; i++) {
+    CANFilter m = filterTable.hardwareMask(i);
+    bool ext = (m.id & CANFilter::EXT_ID_FLAG) != 0;
+    if (mcp2515->setFilterMask(MASKS[i], ext, m.mask) != MCP2515::ERROR_OK) {
+      return false;
+    }
+  }
+
+  static const MCP2515::RXF RXFS[CANFilterTable::MAX_FILTERS] = {
+      MCP2515::RXF0, MCP2515::RXF1, MCP2515::RXF2,
+      MCP2515::RXF3, MCP2515::RXF4, MCP2515::RXF5};
+  for (uint8_t i = 0; i < CANFilterTable::MAX_FILTERS; i++) {
+    const CANFilter &f = filterTable.hardwareFilter(i);
+    bool ext = (f.id & CANFilter::EXT_ID_FLAG) != 0;
+    if (mcp2515->setFilter(RXFS[i], ext, f.id & ~CANFilter::EXT_ID_FLAG) !=
+        MCP2515::ERROR_OK) {
+      return false;
+    }
+  }
   return true;
 }
 
+/**
+ * @brief ビットレートの設定
+ *
+ * @param newBitrate ビットレート (bps)
+ * @return true: 設定成功, false: 未対応のビットレートまたは設定失敗
+ */
+bool MCP2515_Wrapper::setBitrate(uint32_t newBitrate) {
+  CAN_SPEED speed;
+  if (mcp2515 == nullptr || !toCanSpeed(newBitrate, speed)) {
+    return false;
+  }
+  bitrate = newBitrate;
+  if (!started) {
+    return true; // begin() で書き込む
+  }
+
+  // setBitrate() はコンフィグモードへ切り替えてから CNF を書き込む
+  MCP2515::ERROR result = mcp2515->setBitrate(speed, MCP_16MHZ);
+  bool ok = (result == MCP2515::ERROR_OK);
+  return (mcp2515->setNormalMode() == MCP2515::ERROR_OK) && ok;
+}
+
+/**
+ * @brief 受信フィルタの設定
+ *
+ * @param filters フィルタ設定の配列
+ * @param count フィルタ数
+ * @return true: 設定成功, false: フィルタ数超過または書き込み失敗
+ */
+bool MCP2515_Wrapper::setFilters(const CANFilter *filters, uint8_t count) {
+  if (mcp2515 == nullptr) {
+    return false;
+  }
+
+  // 受信割り込み内の照合と競合しないよう、割り込み禁止で差し替える
+  noInterrupts();
+  bool ok = filterTable.set(filters, count);
+  interrupts();
+  if (!ok || !started) {
+    return ok; // 未初期化時は begin() で書き込む
+  }
+
+  if (mcp2515->setConfigMode() != MCP2515::ERROR_OK) {
+    return false;
+  }
+  ok = applyFilters();
+  return (mcp2515->setNormalMode() == MCP2515::ERROR_OK) && ok;
+}
+
+/**
+ * @brief INTピン割り込みハンドラ
+ */
+void MCP2515_Wrapper::onIntPin() {
+  if (isrInstance != nullptr) {
+    isrInstance->serviceRx();
+  }
+}
+
+/**
+ * @brief MCP2515の両受信バッファを読み出してリングへ格納する
+ *
+ * readMessage() は RXB0 → RXB1 の順に受信フラグを確認して読み出し、
+ * 受信フラグをクリアするため、受信データがなくなるまで繰り返す。
+ * 受信以外の要因 (エラー割り込み) でINTがLowのままだと次のエッジが
+ * 発生しないため、それらのフラグもクリアしておく。
+ */
+void MCP2515_Wrapper::serviceRx() {
+  uint32_t now = micros();
+  while (mcp2515->readMessage(rxFrame) == MCP2515::ERROR_OK) {
+    bool ext = (rxFrame->can_id & CANFilter::EXT_ID_FLAG) != 0;
+    busBitsRx += canFrameBitsMax(rxFrame->can_dlc, ext);
+    if (filterTable.match(rxFrame->can_id)) {
+      rxRing.push(rxFrame->can_id, rxFrame->can_dlc, rxFrame->data, now);
+    }
+  }
+
+  if (digitalRead(intPin) == LOW) {
+    mcp2515->clearERRIF();
+    mcp2515->clearMERR();
+  }
+}
+
 /**
  * @brief CANフレームの送信
  *
  * @param id CAN識別子 (11bit標準フレーム)
  * @param len データ長 (0-8バイト)
  * @param data 送信データへのポインタ
- * @return true: 送信成功, false: 送信失敗
+ * @return true: キュー投入成功, false: キュー満杯で破棄
  */
 bool MCP2515_Wrapper::sendFrame(uint32_t id, uint8_t len, const uint8_t *data) {
+  return queueFrame(id, len, data, CAN_TX_PRIO_NORMAL, CAN_TX_APPEND);
+}
+
+/**
+ * @brief 優先度付きのCANフレーム送信
+ *
+ * @param id CAN識別子
+ * @param len データ長 (0-8バイト)
+ * @param data 送信データへのポインタ
+ * @param priority 送信優先度
+ * @param supersede 未送信フレームの置き換え条件
+ * @return true: キュー投入成功, false: キュー満杯で破棄
+ */
+bool MCP2515_Wrapper::queueFrame(uint32_t id, uint8_t len, const uint8_t *data,
+                                 CANTxPriority priority,
+                                 CANTxSupersede supersede) {
   if (mcp2515 == nullptr || data == nullptr) {
     return false;
   }
 
-  // データ長の範囲チェック
-  if (len > 8) {
-    len = 8;
+  // 送信キューはメインコンテキストからのみ操作するため排他不要
+  if (txQueue.push(id, len, data, priority, supersede) ==
+      CANTxQueue<TX_QUEUE_SIZE>::DROPPED) {
+    lastError = MCP2515::ERROR_ALLTXBUSY;
+    return false;
   }
 
-  // CANフレームを構築
-  can_frame frame;
-  frame.can_id = id;
-  frame.can_dlc = len;
-
-  // データをコピー
-  for (uint8_t i = 0; i < len; i++) {
-    frame.data[i] = data[i];
-  }
+  pumpTx();
+  return true;
+}
 
-  // フレームを送信
-  MCP2515::ERROR result = mcp2515->sendMessage(&frame);
+/**
+ * @brief 送信キューのフレームを空いている送信バッファへ書き込む
+ *
+ * sendMessage() は空いている送信バッファを探して書き込むため、
+ * ERROR_ALLTXBUSY が返るまで先頭から順に書き込む。
+ */
+void MCP2515_Wrapper::pumpTx() {
+  const CANTxEntry *head;
+  while ((head = txQueue.front()) != nullptr) {
+    can_frame frame;
+    frame.can_id = head->id;
+    frame.can_dlc = head->len;
+    for (uint8_t i = 0; i < head->len; i++) {
+      frame.data[i] = head->data[i];
+    }
 
-  return (result == MCP2515::ERROR_OK);
+    MCP2515::ERROR result = mcp2515->sendMessage(&frame);
+    if (result == MCP2515::ERROR_ALLTXBUSY) {
+      return; // 次の送信要求または available() で再試行
+    }
+    txQueue.pop();
+    if (result != MCP2515::ERROR_OK) {
+      lastError = static_cast<uint8_t>(result);
+      continue;
+    }
+    bool ext = (frame.can_id & CANFilter::EXT_ID_FLAG) != 0;
+    busBitsTx += canFrameBitsMax(frame.can_dlc, ext);
+    lastTxCompleteUs = micros();
+  }
 }
 
 /**
@@ -145,8 +366,25 @@ bool MCP2515_Wrapper::readFrame(uint32_t &id, uint8_t &len, uint8_t *data) {
     return false;
   }
 
-  // フレームを受信
-  MCP2515::ERROR result = mcp2515->readMessage(rxFrame);
+  // 割り込み受信時はリングバッファから取り出す
+  if (rxIrqEnabled) {
+    CANFrame frame;
+    if (!rxRing.pop(frame)) {
+      return false;
+    }
+    id = frame.id;
+    len = frame.len;
+    for (uint8_t i = 0; i < len; i++) {
+      data[i] = frame.data[i];
+    }
+    return true;
+  }
+
+  // フレームを受信 (設定に一致しないフレームは読み捨てる)
+  MCP2515::ERROR result;
+  do {
+    result = mcp2515->readMessage(rxFrame);
+  } while (result == MCP2515::ERROR_OK && !filterTable.match(rxFrame->can_id));
 
   if (result == MCP2515::ERROR_OK) {
     // 受信成功：データをコピー
@@ -179,6 +417,20 @@ bool MCP2515_Wrapper::available() {
     return false;
   }
 
+  // 全送信バッファ使用中で残っていた送信フレームを再試行する
+  pumpTx();
+
+  // 割り込み受信時はリングバッファを確認
+  if (rxIrqEnabled) {
+    if (rxRing.empty() && digitalRead(intPin) == LOW) {
+      // エッジの取りこぼし: INTがLowのまま残っているので回収する
+      noInterrupts();
+      serviceRx();
+      interrupts();
+    }
+    return !rxRing.empty();
+  }
+
   // INTピンが設定されている場合はピンの状態を確認 (Active Low)
   if (intPin != 255) {
     return (digitalRead(intPin) == LOW);
@@ -187,3 +439,29 @@ bool MCP2515_Wrapper::available() {
   // 受信バッファをチェック (フォールバック: SPI通信)
   return mcp2515->checkReceive();
 }
+
+/**
+ * @brief 受信済みフレームの一括取得
+ *
+ * @param frames 受信フレームの格納先
+ * @param maxFrames 取得する最大フレーム数
+ * @return 取得したフレーム数
+ */
+uint8_t MCP2515_Wrapper::readFrames(CANFrame *frames, uint8_t maxFrames) {
+  if (!rxIrqEnabled) {
+    // 割り込み未使用時は既定実装 (readFrame の繰り返し)
+    return CANInterface::readFrames(frames, maxFrames);
+  }
+  if (frames == nullptr) {
+    return 0;
+  }
+
+  // 取りこぼし回収は available() に任せる
+  available();
+
+  uint8_t count = 0;
+  while (count < maxFrames && rxRing.pop(frames[count])) {
+    count++;
+  }
+  return count;
+}
@@ -1,6 +1,9 @@
 #ifndef MCP2515_WRAPPER_H
 #define MCP2515_WRAPPER_H
 
+#include "CANFilterTable.h"
+#include "CANFrameRing.h"
+#include "CANTxQueue.h"
 #include <CANInterface.h> // includeディレクトリから参照
 #include <cstdint>
 
@@ -21,6 +24,20 @@ struct can_frame;
  * 上位レイヤーはCANInterfaceに依存し、具体的な実装には依存しない
  * - テスト容易性: モックCANInterfaceを簡単に作成できる
  * - 移植性: 別のCANコントローラへの移植が容易
+ *
+ * ## 受信経路
+ * INTピンが指定されている場合、INTの立ち下がりエッジ割り込みで
+ * RXB0/RXB1 の両受信バッファを読み出し、受信時刻付きでリングバッファへ
+ * 格納します。上位レイヤーは readFrame()/readFrames() でリングバッファから
+ * 取り出すだけなので、ループ毎のSPIアクセスやINTピンのポーリングは不要です。
+ *
+ * ## 送信キュー
+ * 送信フレームは優先度付きの送信キュー (CANTxQueue) に積み、
+ * ライブラリの sendMessage() で空いている送信バッファへ書き込みます。
+ * 全バッファ使用中の場合はキューに残し、次の送信要求または
+ * available() の呼び出し時に再試行します。
+ * ライブラリは送信バッファの TXP ビットを設定できないため、
+ * 優先度はキュー内の順序にのみ反映されます。
  */
 
 /**
@@ -57,9 +74,11 @@ public:
    * ノーマルモードで動作を開始します。
    *
    * 設定値:
-   * - ボーレート: CAN_500KBPS (500kbps)
+   * - ボーレート: setBitrate() の設定値 (既定 500kbps)
    * - クロック: MCP_16MHZ (16MHz)
    *
+   * INTピンが指定されている場合は受信割り込みを登録します。
+   *
    * @return true: 初期化成功, false: 初期化失敗
    */
   bool begin() override;
@@ -67,19 +86,41 @@ public:
   /**
    * @brief CANフレームの送信
    *
-   * 指定されたCAN IDとデータを持つフレームを送信します。
+   * 優先度 CAN_TX_PRIO_NORMAL で送信キューに積みます (queueFrame() を参照)。
    *
    * @param id CAN識別子 (11bit標準フレーム)
    * @param len データ長 (0-8バイト)
    * @param data 送信データへのポインタ (len バイト分)
-   * @return true: 送信成功, false: 送信失敗
+   * @return true: キュー投入成功, false: キュー満杯で破棄
    */
   bool sendFrame(uint32_t id, uint8_t len, const uint8_t *data) override;
 
+  /**
+   * @brief 優先度付きのCANフレーム送信
+   *
+   * 送信キューに積み、空いている送信バッファへ書き込めるだけ書き込みます。
+   *
+   * @param id CAN識別子
+   * @param len データ長 (0-8バイト)
+   * @param data 送信データへのポインタ (len バイト分)
+   * @param priority 送信優先度 (キュー内の順序)
+   * @param supersede 未送信フレームの置き換え条件
+   * @return true: キュー投入成功, false: キュー満杯で破棄
+   */
+  bool queueFrame(uint32_t id, uint8_t len, const uint8_t *data,
+                  CANTxPriority priority,
+                  CANTxSupersede supersede) override;
+
+  /**
+   * @brief 送信キューの統計情報を取得 (診断用)
+   */
+  const CANTxStats &getTxStats() const { return txQueue.getStats(); }
+
   /**
    * @brief CANフレームの受信
    *
    * 受信バッファにフレームがあれば読み取ります。
+   * 割り込み受信時はリングバッファから最古のフレームを取り出します。
    *
    * @param id 受信したCAN識別子を格納する変数への参照
    * @param len 受信したデータ長を格納する変数への参照
@@ -93,11 +134,84 @@ public:
    * @brief 受信バッファの確認
    *
    * 受信バッファに未読のフレームがあるかを確認します。
+   * 割り込み受信時はリングバッファの残量を確認し、
+   * エッジの取りこぼし (INTがLowのまま) を検出した場合は回収します。
    *
    * @return true: 受信データあり, false: 受信データなし
    */
   bool available() override;
 
+  /**
+   * @brief 受信済みフレームの一括取得
+   *
+   * リングバッファに溜まったフレームを受信順にまとめて取り出します。
+   *
+   * @param frames 受信フレームの格納先
+   * @param maxFrames 取得する最大フレーム数
+   * @return 取得したフレーム数
+   */
+  uint8_t readFrames(CANFrame *frames, uint8_t maxFrames) override;
+
+  /**
+   * @brief ビットレートの設定
+   *
+   * 125k/250k/500k/1Mbps に対応します (16MHz 発振子)。
+   * 動作中に呼び出した場合は、ライブラリの setBitrate() (コンフィグモード
+   * へ切り替える) の後にノーマルモードに戻します。
+   *
+   * @param bitrate ビットレート (bps)
+   * @return true: 設定成功, false: 未対応のビットレートまたは設定失敗
+   */
+  bool setBitrate(uint32_t bitrate) override;
+
+  /**
+   * @brief 設定中のビットレートを取得 (bps)
+   */
+  uint32_t getBitrate() const override { return bitrate; }
+
+  /**
+   * @brief 送受信したフレームの累積ビット数を取得 (見積もり値, 診断用)
+   */
+  uint32_t getBusBitCount() const override { return busBitsTx + busBitsRx; }
+
+  /**
+   * @brief 受信フィルタの設定
+   *
+   * ライブラリの setFilterMask()/setFilter() で RXM0/1, RXF0..5 に
+   * 書き込みます。動作中に呼び出した場合はコンフィグモードを経由します。
+   *
+   * @param filters フィルタ設定の配列
+   * @param count フィルタ数 (0: 全フレーム受信, 最大6)
+   * @return true: 設定成功, false: フィルタ数超過または書き込み失敗
+   */
+  bool setFilters(const CANFilter *filters, uint8_t count) override;
+
+  /**
+   * @brief フィルタごとの受信数を取得 (診断用)
+   */
+  uint32_t getFilterHitCount(uint8_t index) const override {
+    return filterTable.getHitCount(index);
+  }
+
+  /**
+   * @brief ハードウェアフィルタを通過したが設定に一致せず破棄した数 (診断用)
+   */
+  uint32_t getFilterRejectCount() const {
+    return filterTable.getRejectCount();
+  }
+
+  /**
+   * @brief リングバッファ満杯により破棄したフレーム数を取得 (診断用)
+   */
+  uint32_t getRxOverflowCount() const { return rxRing.getOverflowCount(); }
+
+  /**
+   * @brief 最後に送信が完了した時刻を取得 (micros())
+   *
+   * 送信は同期処理のため、sendFrame() から戻った時刻と等しくなります。
+   */
+  uint32_t getLastTxCompleteUs() const { return lastTxCompleteUs; }
+
   /**
    * @brief 最後に発生したエラーコードを取得
    * @return MCP2515::ERROR 列挙型の値
@@ -105,6 +219,36 @@ public:
   uint8_t getLastError() const { return lastError; }
 
 private:
+  /// 受信リングバッファ段数 (1msあたりの応答数に対して十分な余裕)
+  static constexpr uint16_t RX_RING_SIZE = 16;
+  /// 送信キュー段数
+  static constexpr uint8_t TX_QUEUE_SIZE = 8;
+
+  /**
+   * @brief MCP2515の両受信バッファを読み出してリングへ格納する
+   *
+   * INT割り込みハンドラから呼び出されます。
+   */
+  void serviceRx();
+
+  /**
+   * @brief 送信キューのフレームを空いている送信バッファへ書き込む
+   */
+  void pumpTx();
+
+  /**
+   * @brief マスク・フィルタの書き込み (コンフィグモードで呼ぶこと)
+   * @return true: 書き込み成功
+   */
+  bool applyFilters();
+
+  /**
+   * @brief INTピン割り込みハンドラ (登録用の静的関数)
+   */
+  static void onIntPin();
+
+  static MCP2515_Wrapper *isrInstance; ///< 割り込みハンドラの転送先
+
   MCP2515 *mcp2515;   ///< MCP2515インスタンスへのポインタ
   uint8_t csPin;      ///< CSピン番号
   uint8_t sckPin;     ///< SPI SCKピン番号
@@ -113,6 +257,15 @@ private:
   uint8_t intPin;     ///< MCP2515 INTピン番号
   can_frame *rxFrame; ///< 受信フレーム用バッファ
   uint8_t lastError;  ///< 最後に発生したエラーコード
+  bool rxIrqEnabled;  ///< 割り込み受信が有効か
+  uint32_t lastTxCompleteUs; ///< 最後に送信が完了した時刻
+  CANFrameRing<RX_RING_SIZE> rxRing; ///< 受信フレームのリングバッファ
+  CANFilterTable filterTable;        ///< 受信フィルタ設定と受信カウンタ
+  CANTxQueue<TX_QUEUE_SIZE> txQueue; ///< 優先度付き送信キュー
+  bool started;                      ///< begin() に成功したか
+  uint32_t bitrate;                  ///< ビットレート (bps)
+  uint32_t busBitsTx;                ///< 送信フレームの累積ビット数
+  volatile uint32_t busBitsRx;       ///< 受信フレームの累積ビット数
 };
 
 #endif // MCP2515_WRAPPER_H
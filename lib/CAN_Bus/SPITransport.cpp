@@ -0,0 +1,39 @@
+/**
+ * @file SPITransport.cpp
+ * @brief Arduino SPI ライブラリによる SPITransport の実装
+ * @date 2026-10-18
+ */
+
+#include "SPITransport.h"
+#include <Arduino.h>
+#include <SPI.h>
+
+ArduinoSPITransport::ArduinoSPITransport(uint8_t cs, uint8_t sck, uint8_t mosi,
+                                         uint8_t miso, uint32_t spiClockHz)
+    : csPin(cs), sckPin(sck), mosiPin(mosi), misoPin(miso),
+      clockHz(spiClockHz) {}
+
+void ArduinoSPITransport::begin() {
+  // SPIの初期化 (RP2040コア固有の設定)
+  SPI.setRX(misoPin);
+  SPI.setTX(mosiPin);
+  SPI.setSCK(sckPin);
+  SPI.begin();
+
+  pinMode(csPin, OUTPUT);
+  digitalWrite(csPin, HIGH);
+}
+
+void ArduinoSPITransport::transfer(const uint8_t *tx, uint8_t *rx,
+                                   uint16_t len) {
+  SPI.beginTransaction(SPISettings(clockHz, MSBFIRST, SPI_MODE0));
+  digitalWrite(csPin, LOW);
+  SPI.transfer(tx, rx, len);
+  digitalWrite(csPin, HIGH);
+  SPI.endTransaction();
+}
+
+void ArduinoSPITransport::usingInterrupt(uint8_t pin) {
+  // beginTransaction() ～ endTransaction() の間、この割り込みをマスクする
+  SPI.usingInterrupt(digitalPinToInterrupt(pin));
+}
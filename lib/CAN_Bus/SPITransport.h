@@ -0,0 +1,119 @@
+#ifndef SPI_TRANSPORT_H
+#define SPI_TRANSPORT_H
+
+#include <cstdint>
+
+/**
+ * @file SPITransport.h
+ * @brief MCP2515_Driver が使用するSPI転送の抽象インターフェース
+ * @date 2026-10-18
+ *
+ * 1回の transfer() 呼び出しが、CSアサートからデアサートまでの
+ * 1トランザクションに対応します。
+ * 実機では DMASPITransport (または ArduinoSPITransport) を使用し、
+ * ホスト側の検証ではモックSPIを注入することで、ハードウェアなしに
+ * 転送内容を確認できます。
+ *
+ * transferAsync() は転送完了時にコールバックを呼び出す非同期転送です。
+ * 既定実装は同期転送の直後にコールバックを呼ぶため、DMAを持たない
+ * 実装でも同じ呼び出し手順で使用できます。
+ */
+
+/**
+ * @class SPITransport
+ * @brief SPI転送の抽象インターフェース
+ */
+class SPITransport {
+public:
+  /**
+   * @brief 非同期転送の完了コールバック
+   * @param ctx transferAsync() に渡したコンテキスト
+   */
+  typedef void (*Callback)(void *ctx);
+
+  virtual ~SPITransport() {}
+
+  /**
+   * @brief SPIペリフェラルとCSピンの初期化
+   */
+  virtual void begin() = 0;
+
+  /**
+   * @brief 1トランザクション分の全二重転送
+   *
+   * @param tx 送信データ (len バイト)
+   * @param rx 受信データの格納先 (len バイト)
+   * @param len 転送バイト数
+   */
+  virtual void transfer(const uint8_t *tx, uint8_t *rx, uint16_t len) = 0;
+
+  /**
+   * @brief 1トランザクション分の非同期転送
+   *
+   * 転送完了後に callback(ctx) を呼び出します。DMA実装では
+   * コールバックは割り込みコンテキストで実行されます。
+   * tx/rx は転送完了まで保持されている必要があります。
+   *
+   * @param tx 送信データ (len バイト)
+   * @param rx 受信データの格納先 (len バイト)
+   * @param len 転送バイト数
+   * @param callback 完了コールバック (nullptr 可)
+   * @param ctx コールバックに渡すコンテキスト
+   * @return true: 転送開始, false: 転送中のため開始できない
+   */
+  virtual bool transferAsync(const uint8_t *tx, uint8_t *rx, uint16_t len,
+                             Callback callback, void *ctx) {
+    transfer(tx, rx, len);
+    if (callback != nullptr) {
+      callback(ctx);
+    }
+    return true;
+  }
+
+  /**
+   * @brief 非同期転送中か
+   */
+  virtual bool busy() const { return false; }
+
+  /**
+   * @brief トランザクション中にマスクする割り込みピンを登録する
+   *
+   * 割り込みハンドラ内でもSPIを使用する場合に、メインコンテキストの
+   * トランザクションと衝突しないようにするために使用します。
+   *
+   * @param pin 割り込みピン番号
+   */
+  virtual void usingInterrupt(uint8_t pin) { (void)pin; }
+};
+
+/**
+ * @class ArduinoSPITransport
+ * @brief Arduino SPI ライブラリによる SPITransport の実装
+ */
+class ArduinoSPITransport : public SPITransport {
+public:
+  /**
+   * @brief コンストラクタ
+   *
+   * @param cs CSピン番号
+   * @param sck SPI SCKピン番号
+   * @param mosi SPI MOSI (TX)ピン番号
+   * @param miso SPI MISO (RX)ピン番号
+   * @param spiClockHz SPIクロック周波数 (Hz)
+   */
+  ArduinoSPITransport(uint8_t cs, uint8_t sck, uint8_t mosi, uint8_t miso,
+                      uint32_t spiClockHz);
+
+  void begin() override;
+  void transfer(const uint8_t *tx, uint8_t *rx, uint16_t len) override;
+  void usingInterrupt(uint8_t pin) override;
+
+private:
+  uint8_t csPin;     ///< CSピン番号
+  uint8_t sckPin;    ///< SPI SCKピン番号
+  uint8_t mosiPin;   ///< SPI MOSIピン番号
+  uint8_t misoPin;   ///< SPI MISOピン番号
+  uint32_t clockHz;  ///< SPIクロック周波数
+};
+
+#endif // SPI_TRANSPORT_H
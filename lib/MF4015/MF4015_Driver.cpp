@@ -6,13 +6,24 @@
 
 #include "MF4015_Driver.h"
 #include "config.h"
+#include "hot_path.h"
 #include <cstdint>
 
 MF4015_Driver::MF4015_Driver(CANInterface *canInterface, uint32_t motorCanId)
     : can(canInterface), canId(motorCanId) {
-  status = {0, 0, 0, 0, 0};
+  status = {0, 0, 0, 0, 0, 0, 0, 0};
   isTorqueLimited = false;
   encoderUpdated = false;
+  torqueReplyUpdated = false;
+  positionValid = false;
+  setAngleRange((uint16_t)Config::Steer::ANGLE_RANGE_DEG);
+  resetLinkStats();
+
+  pollCmd = 0;
+  pollSentUs = 0;
+  setPollInterval(POLL_STATUS1, Config::Steer::STATUS1_POLL_MS);
+  setPollInterval(POLL_STATUS2, Config::Steer::STATUS2_POLL_MS);
+  setPollInterval(POLL_MULTI_ANGLE, Config::Steer::MULTI_ANGLE_POLL_MS);
 }
 
 void MF4015_Driver::enable() {
@@ -32,7 +43,8 @@ void MF4015_Driver::stop() {
 
 void MF4015_Driver::requestEncoder() {
   uint8_t data[8] = {0};
-  sendCommand(CMD_READ_ENC, data, 7);
+  // 状態取得は低優先度。未送信の同じ要求があれば置き換える
+  sendCommand(CMD_READ_ENC, data, 7, CAN_TX_PRIO_LOW, CAN_TX_SUPERSEDE_CMD);
 }
 
 void MF4015_Driver::clearError() {
@@ -42,26 +54,139 @@ void MF4015_Driver::clearError() {
 
 void MF4015_Driver::requestStatus1() {
   uint8_t data[8] = {0};
-  sendCommand(CMD_READ_STAT1, data, 7);
+  sendCommand(CMD_READ_STAT1, data, 7, CAN_TX_PRIO_LOW,
+              CAN_TX_SUPERSEDE_CMD);
+}
+
+void MF4015_Driver::requestStatus2() {
+  uint8_t data[8] = {0};
+  sendCommand(CMD_READ_STAT2, data, 7, CAN_TX_PRIO_LOW,
+              CAN_TX_SUPERSEDE_CMD);
+}
+
+void MF4015_Driver::requestMultiAngle() {
+  uint8_t data[8] = {0};
+  sendCommand(CMD_READ_MULTI_ANGLE, data, 7, CAN_TX_PRIO_LOW,
+              CAN_TX_SUPERSEDE_CMD);
+}
+
+bool MF4015_Driver::probe(uint32_t timeoutMs) {
+  if (!can)
+    return false;
+
+  requestStatus1();
+  uint32_t start = millis();
+  while (millis() - start < timeoutMs) {
+    CANFrame frame;
+    if (can->readFrames(&frame, 1) > 0 &&
+        parseFrame(frame.id, frame.len, frame.data)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void MF4015_Driver::setPollInterval(PollType type, uint32_t intervalMs) {
+  if (type >= POLL_TYPE_COUNT)
+    return;
+  pollIntervalUs[type] = intervalMs * 1000;
+  pollLastUs[type] = micros();
+}
+
+bool HOT_FUNC(MF4015_Driver::servicePolls)(uint32_t nowUs,
+                                           uint32_t nextTorqueUs) {
+  if (!can)
+    return false;
+
+  // 送信済みの状態要求の応答待ち、またはトルク指令の応答待ち (バス使用中)
+  if (isPolling(nowUs) || isAwaitingReply(CMD_TORQUE_CTRL, nowUs))
+    return false;
+
+  // 要求・応答の2フレームが次のトルク指令までに収まるか。
+  // 往復時間は同じ長さのフレームをやり取りするトルク指令の実測値で見積もる
+  if (lastTorqueRttUs == 0)
+    return false; // 実測前は送信しない
+  int32_t spareUs = (int32_t)(nextTorqueUs - nowUs);
+  if (spareUs < (int32_t)(lastTorqueRttUs + Config::Can::POLL_GUARD_US))
+    return false;
+
+  // 周期が来た要求のうち、最も遅れているものを選ぶ
+  int8_t selected = -1;
+  uint32_t maxLateUs = 0;
+  for (uint8_t i = 0; i < POLL_TYPE_COUNT; i++) {
+    if (pollIntervalUs[i] == 0)
+      continue;
+    uint32_t elapsed = nowUs - pollLastUs[i];
+    if (elapsed < pollIntervalUs[i])
+      continue;
+    uint32_t lateUs = elapsed - pollIntervalUs[i];
+    if (selected < 0 || lateUs > maxLateUs) {
+      selected = (int8_t)i;
+      maxLateUs = lateUs;
+    }
+  }
+  if (selected < 0)
+    return false;
+
+  uint8_t data[8] = {0};
+  uint8_t cmd = POLL_COMMANDS[selected];
+  sendCommand(cmd, data, 7, CAN_TX_PRIO_LOW, CAN_TX_SUPERSEDE_CMD);
+  pollLastUs[selected] = nowUs;
+  pollCmd = cmd;
+  pollSentUs = nowUs;
+  return true;
+}
+
+bool HOT_FUNC(MF4015_Driver::isPolling)(uint32_t nowUs) const {
+  return pollCmd != 0 && (nowUs - pollSentUs) < Config::Can::RTT_LATE_US;
 }
 
-void MF4015_Driver::setTorque(int16_t torque) {
+bool HOT_FUNC(MF4015_Driver::isAwaitingReply)(uint8_t cmd,
+                                              uint32_t nowUs) const {
+  for (uint8_t i = 0; i < RTT_PENDING_SLOTS; i++) {
+    if (pending[i].cmd == cmd) {
+      return pending[i].waiting &&
+             (nowUs - pending[i].sentUs) < Config::Can::RTT_LATE_US;
+    }
+  }
+  return false;
+}
+
+void HOT_FUNC(MF4015_Driver::setTorque)(int16_t torque) {
+  torque = applyTorqueLimits(torque);
+
+  uint8_t data[8] = {0};
+  data[0] = torque & 0xFF;        // Low byte
+  data[1] = (torque >> 8) & 0xFF; // High byte
+
+  // トルク指令 (0xA1)
+  uint8_t frameData[8] = {CMD_TORQUE_CTRL, 0, 0, 0, data[0], data[1], 0, 0};
+
+  // 最優先で送信し、未送信の古いトルク指令があれば置き換える
+  if (can) {
+    if (can->queueFrame(canId, 8, frameData, CAN_TX_PRIO_URGENT,
+                        CAN_TX_SUPERSEDE_CMD)) {
+      markSent(CMD_TORQUE_CTRL);
+    }
+  }
+}
+
+int16_t HOT_FUNC(MF4015_Driver::applyTorqueLimits)(int16_t torque) {
   // アプリ座標とモータ座標が逆位相なので、反転させる
   torque = -1 * torque;
   // 1. 範囲制限判定 (ヒステリシス付き)
-  // status.encoder から直接生の相対位置を計算
-  int32_t rawPos = Config::Steer::ANGLE_CENTER - (int32_t)status.encoder;
+  // 多回転位置から直接生の相対位置を計算
+  int32_t rawPos = Config::Steer::ANGLE_CENTER - status.position;
 
   if (isTorqueLimited) {
     // 制限中の場合：境界からヒステリシス分内側に戻ったら解除
-    if (rawPos >= (Config::Steer::ANGLE_MIN + HYSTERESIS_WIDTH) &&
-        rawPos <= (Config::Steer::ANGLE_MAX - HYSTERESIS_WIDTH)) {
+    if (rawPos >= (angleMin + hysteresis) &&
+        rawPos <= (angleMax - hysteresis)) {
       isTorqueLimited = false;
     }
   } else {
     // 動作中の場合：境界を超えたら制限開始
-    if (rawPos < Config::Steer::ANGLE_MIN ||
-        rawPos > Config::Steer::ANGLE_MAX) {
+    if (rawPos < angleMin || rawPos > angleMax) {
       isTorqueLimited = true;
     }
   }
@@ -77,19 +202,12 @@ void MF4015_Driver::setTorque(int16_t torque) {
   if (torque > Config::Steer::TORQUE_MAX)
     torque = Config::Steer::TORQUE_MAX;
 
-  uint8_t data[8] = {0};
-  data[0] = torque & 0xFF;        // Low byte
-  data[1] = (torque >> 8) & 0xFF; // High byte
-
-  // トルク指令 (0xA1)
-  uint8_t frameData[8] = {CMD_TORQUE_CTRL, 0, 0, 0, data[0], data[1], 0, 0};
-
-  if (can) {
-    can->sendFrame(canId, 8, frameData);
-  }
+  return torque;
 }
 
-void MF4015_Driver::sendCommand(uint8_t cmd, const uint8_t *data, uint8_t len) {
+void HOT_FUNC(MF4015_Driver::sendCommand)(uint8_t cmd, const uint8_t *data,
+                                          uint8_t len, CANTxPriority priority,
+                                          CANTxSupersede supersede) {
   if (!can)
     return;
 
@@ -100,10 +218,21 @@ void MF4015_Driver::sendCommand(uint8_t cmd, const uint8_t *data, uint8_t len) {
       frameData[i + 1] = data[i];
     }
   }
-  can->sendFrame(canId, 8, frameData);
+  if (can->queueFrame(canId, 8, frameData, priority, supersede)) {
+    markSent(cmd);
+  }
+}
+
+bool HOT_FUNC(MF4015_Driver::parseFrame)(const CANFrame &frame) {
+  if (!parseFrame(frame.id, frame.len, frame.data))
+    return false;
+
+  markReply(frame.data[0], frame.timestampUs);
+  return true;
 }
 
-bool MF4015_Driver::parseFrame(uint32_t id, uint8_t len, const uint8_t *data) {
+bool HOT_FUNC(MF4015_Driver::parseFrame)(uint32_t id, uint8_t len,
+                                         const uint8_t *data) {
   if (id != canId || len < 8)
     return false;
 
@@ -112,9 +241,9 @@ bool MF4015_Driver::parseFrame(uint32_t id, uint8_t len, const uint8_t *data) {
   if (cmd == CMD_READ_ENC) {
     // エンコーダ読み取り応答
     // data[2]: Low, data[3]: High (14bit or 16bit depending on motor)
-    status.encoder = data[2] | (data[3] << 8);
-    encoderUpdated = true;
-  } else if (cmd == 0xA0 || cmd == CMD_TORQUE_CTRL) {
+    updateEncoder((uint16_t)(data[2] | (data[3] << 8)));
+  } else if (cmd == 0xA0 || cmd == CMD_TORQUE_CTRL ||
+             cmd == CMD_READ_STAT2) {
     // 制御コマンドの応答 (現在のステータスが返ってくる)
     // data[1]: 温度
     // data[2,3]: トルク電流
@@ -123,30 +252,214 @@ bool MF4015_Driver::parseFrame(uint32_t id, uint8_t len, const uint8_t *data) {
     status.temperature = (int8_t)data[1];
     status.torqueCurrent = (int16_t)(data[2] | (data[3] << 8));
     status.speed = (int16_t)(data[4] | (data[5] << 8));
-    status.encoder = (uint16_t)(data[6] | (data[7] << 8));
+    updateEncoder((uint16_t)(data[6] | (data[7] << 8)));
+    if (cmd == CMD_TORQUE_CTRL) {
+      torqueReplyUpdated = true; // 指令周期の角度の標本
+    }
   } else if (cmd == CMD_READ_STAT1) {
     // 状態1の応答: data[7] がエラー状態フラグ(低電圧、過熱)
     // bit 0: Voltage state | 0 Normal/ 1 UnderVoltage Potect
     // bit 3: Temperature state | 0 Normal/ 1 OverTemperature Potect
     // その他bitはinvalid
+    status.temperature = (int8_t)data[1];
+    status.voltage = (uint16_t)(data[3] | (data[4] << 8));
     status.errorState = data[7];
+  } else if (cmd == CMD_READ_MULTI_ANGLE) {
+    // 多回転角度の応答: data[1..7] が int64_t の下位7バイト (0.01deg/LSB)
+    uint64_t raw = 0;
+    for (uint8_t i = 7; i >= 1; i--) {
+      raw = (raw << 8) | data[i];
+    }
+    // 56bit の符号を拡張する
+    if (raw & (1ULL << 55)) {
+      raw |= 0xFF00000000000000ULL;
+    }
+    status.multiTurnAngle = (int64_t)raw;
+
+    // 回転数のみ多回転角度に合わせる (1回転未満はエンコーダ値を優先)
+    if (positionValid) {
+      int64_t counts = status.multiTurnAngle *
+                       Config::Steer::ENCODER_COUNTS_PER_REV / 36000;
+      int64_t diff = counts - status.position;
+      int64_t half = Config::Steer::ENCODER_COUNTS_PER_REV / 2;
+      int64_t turns = (diff >= 0 ? diff + half : diff - half) /
+                      Config::Steer::ENCODER_COUNTS_PER_REV;
+      status.position += (int32_t)turns * Config::Steer::ENCODER_COUNTS_PER_REV;
+    }
+  }
+
+  if (cmd == pollCmd) {
+    pollCmd = 0; // 状態要求の応答を受信 (バス解放)
   }
 
   return true;
 }
 
-int16_t MF4015_Driver::getSteerValue() const {
+int32_t HOT_FUNC(MF4015_Driver::getSteerValue)() const {
   // 1. センターオフセットを適用 (生値 - センター)
-  // int32_t を使うことでマイナス方向の計算を安全に行う
+  // 多回転位置を使うため、1回転を超える範囲でも連続した値になる
   // HIDレポートはモータ座標に対して逆位相なので、反転させる
-  int32_t relativePos = Config::Steer::ANGLE_CENTER - (int32_t)status.encoder;
+  int32_t relativePos = Config::Steer::ANGLE_CENTER - status.position;
 
   // 2. 範囲制限 (クランプ処理)
-  if (relativePos < Config::Steer::ANGLE_MIN) {
-    relativePos = Config::Steer::ANGLE_MIN;
-  } else if (relativePos > Config::Steer::ANGLE_MAX) {
-    relativePos = Config::Steer::ANGLE_MAX;
+  if (relativePos < angleMin) {
+    relativePos = angleMin;
+  } else if (relativePos > angleMax) {
+    relativePos = angleMax;
+  }
+
+  return relativePos;
+}
+
+int16_t HOT_FUNC(MF4015_Driver::getSteerHidValue)() const {
+  int32_t steer = getSteerValue();
+  // 符号を分けて絶対値で演算し、四捨五入する
+  // (|steer| <= angleMax なので積は STEER_HID_MAX << 16 程度に収まる)
+  uint32_t mag = (uint32_t)(steer < 0 ? -steer : steer);
+  uint32_t hid = (mag * hidScaleQ16 + 0x8000) >> 16;
+  if (hid > (uint32_t)STEER_HID_MAX) {
+    hid = STEER_HID_MAX;
+  }
+  return (steer < 0) ? -(int16_t)hid : (int16_t)hid;
+}
+
+uint16_t MF4015_Driver::setAngleRange(uint16_t halfRangeDeg) {
+  if (halfRangeDeg < Config::Steer::ANGLE_RANGE_DEG_MIN) {
+    halfRangeDeg = Config::Steer::ANGLE_RANGE_DEG_MIN;
+  } else if (halfRangeDeg > Config::Steer::ANGLE_RANGE_DEG_MAX) {
+    halfRangeDeg = Config::Steer::ANGLE_RANGE_DEG_MAX;
   }
+  angleRangeDeg = halfRangeDeg;
+  angleMax =
+      (int32_t)halfRangeDeg * Config::Steer::ENCODER_COUNTS_PER_REV / 360;
+  angleMin = -angleMax;
+  // ヒステリシス幅: 動作範囲の約5%
+  hysteresis = (angleMax - angleMin) / 20;
+  // HID 変換係数: 制御周期ごとの除算を避けるため、ここで逆数を求めておく
+  hidScaleQ16 = (((uint32_t)STEER_HID_MAX << 16) + (uint32_t)angleMax / 2) /
+                (uint32_t)angleMax;
+  return halfRangeDeg;
+}
+
+void HOT_FUNC(MF4015_Driver::updateEncoder)(uint16_t encoder) {
+  if (!positionValid) {
+    // 初回はエンコーダ値をそのまま使う (センター付近で起動する前提)
+    status.position = encoder;
+    positionValid = true;
+  } else {
+    // 前回値との差を ±半回転に折り返して加算する
+    int32_t delta = (int32_t)encoder - (int32_t)status.encoder;
+    if (delta > Config::Steer::ENCODER_COUNTS_PER_REV / 2) {
+      delta -= Config::Steer::ENCODER_COUNTS_PER_REV;
+    } else if (delta < -Config::Steer::ENCODER_COUNTS_PER_REV / 2) {
+      delta += Config::Steer::ENCODER_COUNTS_PER_REV;
+    }
+    status.position += delta;
+  }
+  status.encoder = encoder;
+  encoderUpdated = true;
+}
 
-  return (int16_t)relativePos;
+void HOT_FUNC(MF4015_Driver::markSent)(uint8_t cmd) {
+  uint32_t now = micros();
+  PendingCommand *slot = nullptr;
+  for (uint8_t i = 0; i < RTT_PENDING_SLOTS; i++) {
+    if (pending[i].cmd == cmd) {
+      slot = &pending[i];
+      break;
+    }
+    if (slot == nullptr && pending[i].cmd == 0) {
+      slot = &pending[i];
+    }
+  }
+  if (slot == nullptr) {
+    return; // 記録枠なし (計測対象外)
+  }
+
+  // 前回の同じコマンドに応答がないまま次を送った
+  if (slot->cmd == cmd && slot->waiting) {
+    rttMissed++;
+  }
+  slot->cmd = cmd;
+  slot->waiting = true;
+  slot->sentUs = now;
+}
+
+void HOT_FUNC(MF4015_Driver::markReply)(uint8_t cmd, uint32_t rxUs) {
+  for (uint8_t i = 0; i < RTT_PENDING_SLOTS; i++) {
+    PendingCommand &slot = pending[i];
+    if (slot.cmd != cmd || !slot.waiting) {
+      continue;
+    }
+    slot.waiting = false;
+
+    uint32_t rtt = rxUs - slot.sentUs;
+    if ((int32_t)rtt < 0) {
+      rtt = 0; // 送信記録より前の受信時刻 (前回の応答) は 0 とみなす
+    }
+    if (rtt > 0xFFFF) {
+      rtt = 0xFFFF;
+    }
+
+    uint16_t bin = rtt / RTT_BIN_US;
+    rttHistogram[bin < RTT_BINS ? bin : RTT_BINS - 1]++;
+    rttSamples++;
+    rttSumUs += rtt;
+    if (rtt < rttMinUs) {
+      rttMinUs = (uint16_t)rtt;
+    }
+    if (rtt > rttMaxUs) {
+      rttMaxUs = (uint16_t)rtt;
+    }
+    if (rtt > Config::Can::RTT_LATE_US) {
+      rttLate++;
+    }
+    if (cmd == CMD_TORQUE_CTRL) {
+      lastTorqueRttUs = (uint16_t)rtt;
+    }
+    return;
+  }
+}
+
+MF4015_Driver::LinkStats MF4015_Driver::getLinkStats() const {
+  LinkStats stats;
+  stats.samples = rttSamples;
+  stats.missed = rttMissed;
+  stats.late = rttLate;
+  stats.rttMinUs = (rttSamples > 0) ? rttMinUs : 0;
+  stats.rttMaxUs = rttMaxUs;
+  stats.rttAvgUs = (rttSamples > 0) ? (uint16_t)(rttSumUs / rttSamples) : 0;
+
+  // 99パーセンタイル: 累積度数が 99% に達したビンの上端
+  stats.rttP99Us = 0;
+  if (rttSamples > 0) {
+    uint32_t threshold = rttSamples - rttSamples / 100;
+    uint32_t cumulative = 0;
+    for (uint8_t i = 0; i < RTT_BINS; i++) {
+      cumulative += rttHistogram[i];
+      if (cumulative >= threshold) {
+        // 範囲外をまとめた最後のビンは最大値で代表する
+        stats.rttP99Us =
+            (i == RTT_BINS - 1) ? rttMaxUs : (uint16_t)((i + 1) * RTT_BIN_US);
+        break;
+      }
+    }
+  }
+  return stats;
+}
+
+void MF4015_Driver::resetLinkStats() {
+  for (uint8_t i = 0; i < RTT_PENDING_SLOTS; i++) {
+    pending[i] = {0, false, 0};
+  }
+  for (uint8_t i = 0; i < RTT_BINS; i++) {
+    rttHistogram[i] = 0;
+  }
+  rttSamples = 0;
+  rttMissed = 0;
+  rttLate = 0;
+  rttSumUs = 0;
+  rttMinUs = 0xFFFF;
+  rttMaxUs = 0;
+  lastTorqueRttUs = 0;
 }
@@ -11,7 +11,7 @@
 
 #include <Arduino.h>
 #include <CANInterface.h>
-#include <Config.h>
+#include <config.h>
 
 class MF4015_Driver {
 public:
@@ -19,12 +19,42 @@ public:
    * @brief モーターステータス構造体
    */
   struct Status {
-    uint16_t encoder;      ///< エンコーダ位置 (0-16383)
-    int16_t speed;         ///< 回転速度
-    int16_t torqueCurrent; ///< トルク電流
-    int8_t temperature;    ///< モーター温度
-    uint8_t errorState;    ///< エラー状態 bit 0: 1 Under Voltage Potect
-                           ///< bit 3: 1 Over temperature protect
+    uint16_t encoder;       ///< エンコーダ位置 (0-16383)
+    int16_t speed;          ///< 回転速度
+    int16_t torqueCurrent;  ///< トルク電流
+    int8_t temperature;     ///< モーター温度
+    uint8_t errorState;     ///< エラー状態 bit 0: 1 Under Voltage Potect
+                            ///< bit 3: 1 Over temperature protect
+    uint16_t voltage;       ///< 電源電圧 (0.1V/LSB, 0x9A の応答で更新)
+    int64_t multiTurnAngle; ///< 多回転角度 (0.01deg/LSB, 0x92 の応答で更新)
+    int32_t position;       ///< 多回転のエンコーダ位置 (アンラップ済み)
+  };
+
+  /**
+   * @brief 定期的に送信する状態要求の種類
+   */
+  enum PollType : uint8_t {
+    POLL_STATUS1 = 0,     ///< 状態1 (0x9A): 電圧・エラー状態
+    POLL_STATUS2 = 1,     ///< 状態2 (0x9C): 温度・電流・速度・エンコーダ
+    POLL_MULTI_ANGLE = 2, ///< 多回転角度 (0x92)
+    POLL_TYPE_COUNT = 3,
+  };
+
+  /**
+   * @brief 指令→応答の往復時間 (RTT) の統計 (診断用)
+   *
+   * 各コマンドの送信時刻 (キュー投入時) と、同じコマンドバイトの応答の
+   * 受信時刻 (CANFrame::timestampUs) の差を集計します。
+   */
+  struct LinkStats {
+    uint32_t samples;  ///< 応答を対応付けた回数
+    uint32_t missed;   ///< 応答前に次の同じコマンドを送った回数
+                       ///< (送信キューで置き換えられた場合を含む)
+    uint32_t late;     ///< RTT が Config::Can::RTT_LATE_US を超えた回数
+    uint16_t rttMinUs; ///< RTT 最小値 (us)
+    uint16_t rttAvgUs; ///< RTT 平均値 (us)
+    uint16_t rttMaxUs; ///< RTT 最大値 (us)
+    uint16_t rttP99Us; ///< RTT 99パーセンタイル (us, ヒストグラム分解能)
   };
 
   /**
@@ -44,14 +74,70 @@ public:
    * @param torque トルク値 (-2048 ～ 2048)
    */
   void setTorque(int16_t torque);
-  void clearError();     ///< エラー状態のクリア (0x9B)
-  void requestStatus1(); ///< 状態1/エラーフラグの要求 (0x9A)
+
+  /**
+   * @brief トルク指令値の変換と制限 (送信はしない)
+   *
+   * 座標の反転、動作範囲外でのトルク遮断 (ヒステリシス付き)、
+   * 出力範囲のクランプを行います。setTorque() と MotorGroup が使用します。
+   *
+   * @param torque アプリ座標のトルク値
+   * @return モーター座標のトルク指令値
+   */
+  int16_t applyTorqueLimits(int16_t torque);
+  void clearError();        ///< エラー状態のクリア (0x9B)
+  void requestStatus1();    ///< 状態1/エラーフラグの要求 (0x9A)
+  void requestStatus2();    ///< 状態2 (温度・電流・速度) の要求 (0x9C)
+  void requestMultiAngle(); ///< 多回転角度の要求 (0x92)
 
   /**
    * @brief エンコーダ読み取りリクエストの送信
    */
   void requestEncoder();
 
+  /**
+   * @brief モーターの応答確認 (起動時用)
+   *
+   * 状態1 (0x9A) を要求し、応答を受信するまで待ちます。
+   * 待機中に受信した他ノードのフレームは破棄します。
+   * ビットレートがモーターの設定と異なる場合は応答がありません。
+   *
+   * @param timeoutMs 応答待ちの上限 (ms)
+   * @return true: 応答あり, false: タイムアウト
+   */
+  bool probe(uint32_t timeoutMs);
+
+  // --- 状態要求のスケジューリング ---
+  /**
+   * @brief 状態要求の周期を設定
+   * @param type 状態要求の種類
+   * @param intervalMs 周期 (ms, 0: 要求しない)
+   */
+  void setPollInterval(PollType type, uint32_t intervalMs);
+
+  /**
+   * @brief 周期が来た状態要求を、バスの空き時間に1つだけ送信する
+   *
+   * 制御ループから頻繁に呼び出します。次の条件をすべて満たす場合のみ送信し、
+   * トルク指令を遅らせたり間引いたりしません。
+   * - 直前のトルク指令の応答を受信済み (バスが空いている)
+   * - 送信した状態要求の応答待ちがない
+   * - 次のトルク指令までの残り時間が、直近のトルク指令の往復時間
+   *   (要求・応答の2フレーム分) と Config::Can::POLL_GUARD_US の和以上
+   *
+   * 周期が来た要求が複数ある場合は、最も遅れているものを送信します。
+   *
+   * @param nowUs 現在時刻 (micros())
+   * @param nextTorqueUs 次のトルク指令の送信予定時刻 (micros())
+   * @return true: 状態要求を送信した
+   */
+  bool servicePolls(uint32_t nowUs, uint32_t nextTorqueUs);
+
+  /**
+   * @brief 状態要求の応答待ちか (応答が RTT_LATE_US 以内に来る見込みの間)
+   */
+  bool isPolling(uint32_t nowUs) const;
+
   // --- データ受信・解析 ---
   /**
    * @brief 受信したCANフレームがこのモーターのものか判定し、解析する
@@ -62,19 +148,67 @@ public:
    */
   bool parseFrame(uint32_t id, uint8_t len, const uint8_t *data);
 
+  /**
+   * @brief 受信時刻付きフレームの解析 (RTT を集計する)
+   * @param frame 受信フレーム (readFrames() の取得結果)
+   * @return true: このモーターのデータとして処理した, false: ID不一致
+   */
+  bool parseFrame(const CANFrame &frame);
+
+  // --- 通信品質 ---
+  /**
+   * @brief RTT 統計を取得
+   *
+   * p99 はヒストグラムから算出するため、呼び出しごとに走査します
+   * (制御周期ではなく監視周期で呼び出すこと)。
+   */
+  LinkStats getLinkStats() const;
+
+  /**
+   * @brief RTT 統計をクリア
+   */
+  void resetLinkStats();
+
   // --- ゲッター ---
+  uint32_t getCanId() const { return canId; }
   uint16_t getEncoderValue() const { return status.encoder; }
 
   /**
    * @brief センターオフセットおよび範囲制限を適用したステアリング値を取得
-   * @return int16_t 処理済みのステアリング値 (左負, 右正)
+   * @return 処理済みのステアリング値 (エンコーダカウント, 左負, 右正)
+   */
+  int32_t getSteerValue() const;
+
+  /**
+   * @brief ステアリング値を HID X軸のフルレンジに変換して取得
+   *
+   * 有効角度範囲 (-angleMax..angleMax) を -32767..32767 に写像します。
+   * 範囲設定時に求めた固定小数点 (Q16) の逆数を掛けるため、除算しません。
+   *
+   * @return HID X軸の値 (-32767..32767)
    */
-  int16_t getSteerValue() const;
+  int16_t getSteerHidValue() const;
+
+  /**
+   * @brief 有効角度範囲の設定 (片側角度)
+   *
+   * トルク遮断の境界・ヒステリシス幅・HID 変換係数を再計算します。
+   * 範囲外の値は Config::Steer::ANGLE_RANGE_DEG_MIN..MAX に丸めます。
+   *
+   * @param halfRangeDeg センターからの片側角度 (deg, ロックtoロックの半分)
+   * @return 設定した片側角度 (deg)
+   */
+  uint16_t setAngleRange(uint16_t halfRangeDeg);
+
+  uint16_t getAngleRange() const { return angleRangeDeg; }
 
   const Status &getStatus() const { return status; }
 
   /**
    * @brief エンコーダ値が更新されたか確認し、フラグをクリアする
+   *
+   * エンコーダ位置を含む応答 (0x90 / 0xA1 / 0x9C) の受信で更新されます。
+   *
    * @return true: 更新されていた, false: 更新されていない
    */
   bool checkEncoderUpdated() {
@@ -85,7 +219,26 @@ public:
     return false;
   }
 
+  /**
+   * @brief トルク指令の応答 (0xA1) を受信したか確認し、フラグをクリアする
+   *
+   * 応答はトルク指令の周期 (Config::Time::TORQUE_CMD_INTERVAL_US) で届くため、
+   * 速度推定の標本にはこちらを使います。状態要求 (0x90 / 0x9C) の応答は
+   * 周期の途中に届くため含めません。
+   *
+   * @return true: 受信していた, false: 受信していない
+   */
+  bool checkTorqueReplyUpdated() {
+    if (torqueReplyUpdated) {
+      torqueReplyUpdated = false;
+      return true;
+    }
+    return false;
+  }
+
 private:
+  friend class MotorGroup; // 一括トルク指令の送信時刻・応答待ちを参照するため
+
   CANInterface *can; ///< 外部から注入されたCANインターフェース
   uint32_t canId;    ///< ターゲットモーターのID
   Status status;     ///< 現在のステータス情報
@@ -99,23 +252,96 @@ private:
   static constexpr uint8_t CMD_READ_ENC = 0x90;
   static constexpr uint8_t CMD_READ_STAT1 = 0x9A;
   static constexpr uint8_t CMD_CLEAR_ERR = 0x9B;
+  static constexpr uint8_t CMD_READ_STAT2 = 0x9C;
+  static constexpr uint8_t CMD_READ_MULTI_ANGLE = 0x92;
+
+  // --- RTT 計測 ---
+  /// 応答待ちを記録するコマンド数 (トルク指令・状態要求・ON/OFF など)
+  static constexpr uint8_t RTT_PENDING_SLOTS = 8;
+  /// ヒストグラムのビン幅 (us)
+  static constexpr uint16_t RTT_BIN_US = 25;
+  /// ヒストグラムのビン数 (最後のビンは範囲外をまとめる, 25us x 64 = 1.6ms)
+  static constexpr uint8_t RTT_BINS = 64;
+
+  /**
+   * @brief 応答待ちのコマンド
+   */
+  struct PendingCommand {
+    uint8_t cmd;     ///< コマンドバイト (0: 未使用)
+    bool waiting;    ///< 応答待ち
+    uint32_t sentUs; ///< 送信時刻 (micros())
+  };
+
+  PendingCommand pending[RTT_PENDING_SLOTS]; ///< 応答待ちのコマンド
+  uint32_t rttHistogram[RTT_BINS];           ///< RTT ヒストグラム
+  uint32_t rttSamples;                       ///< 対応付けた応答数
+  uint32_t rttMissed;                        ///< 応答欠落数
+  uint32_t rttLate;                          ///< 遅延応答数
+  uint64_t rttSumUs;                         ///< RTT 合計 (平均算出用)
+  uint16_t rttMinUs;                         ///< RTT 最小値
+  uint16_t rttMaxUs;                         ///< RTT 最大値
+  uint16_t lastTorqueRttUs;                  ///< 直近のトルク指令の RTT
 
-  bool isTorqueLimited;         ///< トルク制限状態フラグ
-  volatile bool encoderUpdated; ///< エンコーダ値更新フラグ
+  // --- 状態要求のスケジューリング ---
+  /// 状態要求の種類ごとのコマンドバイト
+  static constexpr uint8_t POLL_COMMANDS[POLL_TYPE_COUNT] = {
+      CMD_READ_STAT1, CMD_READ_STAT2, CMD_READ_MULTI_ANGLE};
+
+  uint32_t pollIntervalUs[POLL_TYPE_COUNT]; ///< 周期 (us, 0: 無効)
+  uint32_t pollLastUs[POLL_TYPE_COUNT];     ///< 前回の送信時刻
+  uint8_t pollCmd;                          ///< 応答待ちの状態要求
+  uint32_t pollSentUs;                      ///< 応答待ちの状態要求の送信時刻
+
+  /**
+   * @brief 応答待ちのコマンドか (送信から RTT_LATE_US 以内)
+   */
+  bool isAwaitingReply(uint8_t cmd, uint32_t nowUs) const;
+
+  /**
+   * @brief コマンド送信時刻の記録
+   */
+  void markSent(uint8_t cmd);
+
+  /**
+   * @brief 応答受信時の RTT 集計
+   */
+  void markReply(uint8_t cmd, uint32_t rxUs);
+
+  bool isTorqueLimited;             ///< トルク制限状態フラグ
+  volatile bool encoderUpdated;     ///< エンコーダ値更新フラグ
+  volatile bool torqueReplyUpdated; ///< トルク指令の応答の受信フラグ
+
+  // --- 多回転位置・有効角度範囲 ---
+  /// HID X軸の最大値
+  static constexpr int32_t STEER_HID_MAX = 32767;
+
+  bool positionValid;     ///< status.position が初期化済み
+  uint16_t angleRangeDeg; ///< 有効角度範囲 (片側, deg)
+  int32_t angleMin;       ///< 有効角度範囲の下限 (エンコーダカウント)
+  int32_t angleMax;       ///< 有効角度範囲の上限 (エンコーダカウント)
+  int32_t hysteresis;     ///< トルク遮断解除のヒステリシス幅 (カウント)
+  uint32_t hidScaleQ16;   ///< STEER_HID_MAX / angleMax (Q16)
+
+  /**
+   * @brief エンコーダ値の更新と多回転位置のアンラップ
+   */
+  void updateEncoder(uint16_t encoder);
 
   // デフォルト設定値
   static constexpr uint32_t DEFAULT_CAN_ID = 0x141;
   static constexpr int16_t DEFAULT_TORQUE_LIMIT = 2048;
 
   /**
-   * @brief ヒステリシス幅 (エンコーダカウント単位)
-   * 動作範囲の約5%程度を目安に設定
+   * @brief コマンドの送信
+   * @param cmd コマンドバイト
+   * @param data コマンドに続くデータ (最大7バイト)
+   * @param len データ長
+   * @param priority 送信優先度 (既定: 状態変更コマンド用の HIGH)
+   * @param supersede 未送信フレームの置き換え条件
    */
-  static constexpr int32_t HYSTERESIS_WIDTH =
-      (int32_t)((float)(Config::Steer::ANGLE_MAX - Config::Steer::ANGLE_MIN) *
-                0.05);
-
-  void sendCommand(uint8_t cmd, const uint8_t *data = nullptr, uint8_t len = 0);
+  void sendCommand(uint8_t cmd, const uint8_t *data = nullptr, uint8_t len = 0,
+                   CANTxPriority priority = CAN_TX_PRIO_HIGH,
+                   CANTxSupersede supersede = CAN_TX_APPEND);
 };
 
 #endif // MF4015_DRIVER_H
@@ -0,0 +1,124 @@
+/**
+ * @file MotorGroup.cpp
+ * @brief 複数の MF シリーズモーターをまとめて制御するクラスの実装
+ * @note 0x280 のデータ配置: DATA[2n-2], DATA[2n-1] がモーター ID n の
+ *       トルク電流指令 (int16_t, リトルエンディアン)
+ */
+
+#include "MotorGroup.h"
+#include "config.h"
+#include "hot_path.h"
+
+// config.h のトルク指令周期の検査は同じバス占有で行う
+static_assert(MotorGroup::torqueCycleBits(Config::Steer::MOTOR_COUNT) ==
+                  Config::Time::TORQUE_CMD_BUS_BITS,
+              "TORQUE_CMD_BUS_BITS must match MotorGroup::torqueCycleBits()");
+
+MotorGroup::MotorGroup(CANInterface *canInterface)
+    : can(canInterface), count(0), pollNext(0) {
+  for (uint8_t i = 0; i < MAX_MOTORS; i++) {
+    motors[i] = nullptr;
+    torques[i] = 0;
+  }
+}
+
+bool MotorGroup::addMotor(MF4015_Driver *motor) {
+  if (motor == nullptr || count >= MAX_MOTORS) {
+    return false;
+  }
+  uint32_t id = motor->getCanId();
+  if (id <= MOTOR_CAN_ID_BASE || id > MOTOR_CAN_ID_BASE + MAX_MOTORS) {
+    return false; // 0x280 で指令できるのは ID 1〜4 のみ
+  }
+  for (uint8_t i = 0; i < count; i++) {
+    if (motors[i]->getCanId() == id) {
+      return false;
+    }
+  }
+  // 指令1フレーム + 応答 (count + 1) フレームが周期に収まること
+  uint32_t bitrate = (can != nullptr) ? can->getBitrate() : 0;
+  if (bitrate == 0) {
+    bitrate = Config::Can::BITRATE; // ビットレートを返さない実装
+  }
+  if (!fitsBusBudget(count + 1, bitrate, Config::Time::TORQUE_CMD_INTERVAL_US,
+                     Config::Can::POLL_GUARD_US)) {
+    return false;
+  }
+  motors[count] = motor;
+  torques[count] = 0;
+  count++;
+  return true;
+}
+
+void HOT_FUNC(MotorGroup::setTorque)(uint8_t index, int16_t torque) {
+  if (index < count) {
+    torques[index] = torque;
+  }
+}
+
+void HOT_FUNC(MotorGroup::flush)() {
+  if (can == nullptr || count == 0) {
+    return;
+  }
+
+  if (count == 1) {
+    motors[0]->setTorque(torques[0]);
+    return;
+  }
+
+  // 未登録の位置は 0 (トルクなし)
+  uint8_t frameData[8] = {0};
+  for (uint8_t i = 0; i < count; i++) {
+    int16_t torque = motors[i]->applyTorqueLimits(torques[i]);
+    uint8_t pos = (uint8_t)(motors[i]->getCanId() - MOTOR_CAN_ID_BASE - 1);
+    frameData[pos * 2] = torque & 0xFF;
+    frameData[pos * 2 + 1] = (torque >> 8) & 0xFF;
+  }
+
+  // 最優先で送信し、未送信の古い一括指令があれば置き換える
+  if (can->queueFrame(MULTI_TORQUE_CAN_ID, 8, frameData, CAN_TX_PRIO_URGENT,
+                      CAN_TX_SUPERSEDE_ID)) {
+    // 各モーターは 0xA1 形式で応答するため、トルク指令として記録する
+    for (uint8_t i = 0; i < count; i++) {
+      motors[i]->markSent(MF4015_Driver::CMD_TORQUE_CTRL);
+    }
+  }
+}
+
+bool HOT_FUNC(MotorGroup::servicePolls)(uint32_t nowUs, uint32_t nextTorqueUs) {
+  // 1台でも応答待ちならバスは空いていない
+  for (uint8_t i = 0; i < count; i++) {
+    if (motors[i]->isPolling(nowUs) ||
+        motors[i]->isAwaitingReply(MF4015_Driver::CMD_TORQUE_CTRL, nowUs)) {
+      return false;
+    }
+  }
+  for (uint8_t n = 0; n < count; n++) {
+    uint8_t i = (uint8_t)((pollNext + n) % count);
+    if (motors[i]->servicePolls(nowUs, nextTorqueUs)) {
+      pollNext = (uint8_t)((i + 1) % count);
+      return true;
+    }
+  }
+  return false;
+}
+
+bool HOT_FUNC(MotorGroup::parseFrame)(const CANFrame &frame) {
+  for (uint8_t i = 0; i < count; i++) {
+    if (motors[i]->parseFrame(frame)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+uint8_t MotorGroup::getRxFilters(CANFilter *filters,
+                                 uint8_t maxFilters) const {
+  uint8_t n = 0;
+  for (uint8_t i = 0; i < count && n < maxFilters; i++) {
+    filters[n].id = motors[i]->getCanId();
+    filters[n].mask = Config::Can::STD_ID_MASK;
+    n++;
+  }
+  return n;
+}
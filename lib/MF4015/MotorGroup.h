@@ -0,0 +1,147 @@
+/**
+ * @file MotorGroup.h
+ * @brief 複数の MF シリーズモーターをまとめて制御するクラス
+ * @date 2026-10-18
+ *
+ * LK プロトコルの複数モーター・トルク指令 (CAN ID 0x280) を使い、
+ * 最大4台 (ID 0x141〜0x144) のトルク指令を1フレームで送信します。
+ * モーターを追加しても送信フレーム数は1周期1フレームのまま変わりません。
+ * 各モーターは自身の ID (0x140 + n) で 0xA1 と同じ形式の応答を返すため、
+ * 応答は ID ごとに各 MF4015_Driver へ振り分けます。
+ *
+ * 応答は台数分あるため、1周期のバス占有は (1 + 台数) フレームです。
+ * addMotor() は、トルク指令の周期 (Config::Time::TORQUE_CMD_INTERVAL_US) に
+ * 収まらない台数の登録を拒否します (500kbps で2台, 1Mbps で4台まで)。
+ *
+ * 登録が1台の場合は通常のトルク指令 (0xA1) を送信します
+ * (0x280 と同じく1フレームで、単体運用時の挙動を変えないため)。
+ */
+
+#ifndef MOTOR_GROUP_H
+#define MOTOR_GROUP_H
+
+#include "MF4015_Driver.h"
+#include <CANInterface.h>
+#include <cstdint>
+
+class MotorGroup {
+public:
+  /// 一括指令で制御できるモーター数
+  static constexpr uint8_t MAX_MOTORS = 4;
+  /// 複数モーター・トルク指令の CAN ID
+  static constexpr uint32_t MULTI_TORQUE_CAN_ID = 0x280;
+  /// 単体指令の CAN ID の基準 (モーター ID n は 0x140 + n)
+  static constexpr uint32_t MOTOR_CAN_ID_BASE = 0x140;
+
+  /**
+   * @brief 1周期 (トルク指令1フレーム + 台数分の応答) の最大ビット数
+   * @param motorCount モーター数
+   */
+  static constexpr uint32_t torqueCycleBits(uint8_t motorCount) {
+    return (1 + (uint32_t)motorCount) * canFrameBitsMax(8, false);
+  }
+
+  /**
+   * @brief 1周期のバス占有が周期に収まるか
+   *
+   * 状態要求の余裕 (Config::Can::POLL_GUARD_US) を残せることを条件とします。
+   *
+   * @param motorCount モーター数
+   * @param bitrate ビットレート (bps)
+   * @param periodUs トルク指令の周期 (us)
+   * @param guardUs 周期内に残す余裕 (us)
+   */
+  static constexpr bool fitsBusBudget(uint8_t motorCount, uint32_t bitrate,
+                                      uint32_t periodUs, uint32_t guardUs) {
+    return (uint64_t)torqueCycleBits(motorCount) * 1000000 / bitrate +
+               guardUs <=
+           periodUs;
+  }
+
+  /**
+   * @brief コンストラクタ
+   * @param canInterface 一括指令の送信に使用するCANインターフェース
+   */
+  explicit MotorGroup(CANInterface *canInterface);
+
+  /**
+   * @brief モーターの登録
+   * 登録後の台数が CAN インターフェースのビットレートでトルク指令の周期に
+   * 収まらない場合は拒否します (fitsBusBudget())。ビットレートは
+   * 登録前に CANInterface::setBitrate() で設定しておくこと。
+   *
+   * @param motor 登録するモーター (CAN ID 0x141〜0x144)
+   * @return true: 登録成功,
+   *         false: ID範囲外・重複・登録数超過・バス占有が周期を超える
+   */
+  bool addMotor(MF4015_Driver *motor);
+
+  /**
+   * @brief 登録済みモーター数
+   */
+  uint8_t size() const { return count; }
+
+  /**
+   * @brief 登録順のモーターを取得
+   * @param index 登録順のインデックス
+   * @return モーター, 範囲外なら nullptr
+   */
+  MF4015_Driver *getMotor(uint8_t index) const {
+    return (index < count) ? motors[index] : nullptr;
+  }
+
+  /**
+   * @brief トルク指令値の設定 (送信は flush() で行う)
+   *
+   * 設定しなかったモーターは前回の指令値を保持します。
+   *
+   * @param index 登録順のインデックス
+   * @param torque アプリ座標のトルク値 (MF4015_Driver::setTorque() と同じ)
+   */
+  void setTorque(uint8_t index, int16_t torque);
+
+  /**
+   * @brief 全モーターのトルク指令を送信
+   *
+   * 制御周期ごとに1回呼び出します。2台以上の場合は 0x280 の1フレーム、
+   * 1台の場合は 0xA1 を送信します。いずれも最優先で送信し、
+   * 未送信の古い指令は置き換えます。
+   */
+  void flush();
+
+  /**
+   * @brief 周期が来た状態要求を、バスの空き時間に1台分だけ送信する
+   *
+   * 全モーターのトルク指令の応答を受信済みで、状態要求の応答待ちがない
+   * 場合のみ、モーターを順番に MF4015_Driver::servicePolls() へ委ねます。
+   *
+   * @param nowUs 現在時刻 (micros())
+   * @param nextTorqueUs 次のトルク指令の送信予定時刻 (micros())
+   * @return true: 状態要求を送信した
+   */
+  bool servicePolls(uint32_t nowUs, uint32_t nextTorqueUs);
+
+  /**
+   * @brief 受信フレームを該当するモーターへ振り分けて解析する
+   * @param frame 受信フレーム
+   * @return true: いずれかのモーターが処理した, false: 該当なし
+   */
+  bool parseFrame(const CANFrame &frame);
+
+  /**
+   * @brief 登録済みモーターの応答IDを受信フィルタとして取得
+   * @param filters 格納先
+   * @param maxFilters 格納先の要素数
+   * @return 格納したフィルタ数
+   */
+  uint8_t getRxFilters(CANFilter *filters, uint8_t maxFilters) const;
+
+private:
+  CANInterface *can;                 ///< CANインターフェース
+  MF4015_Driver *motors[MAX_MOTORS]; ///< 登録順のモーター
+  int16_t torques[MAX_MOTORS];       ///< 登録順のトルク指令値 (アプリ座標)
+  uint8_t count;                     ///< 登録数
+  uint8_t pollNext;                  ///< 次に状態要求を送るモーター
+};
+
+#endif // MOTOR_GROUP_H
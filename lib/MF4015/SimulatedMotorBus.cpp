@@ -0,0 +1,371 @@
+/**
+ * @file SimulatedMotorBus.cpp
+ * @brief MF4015 とハンドルを模擬する CANInterface 実装
+ * @note 応答の形式は MotorDriveProtocol.md を参照
+ */
+
+#include "SimulatedMotorBus.h"
+#include "config.h"
+#include <cmath>
+
+namespace {
+// MotorDriveProtocol.md のコマンドバイト
+constexpr uint8_t CMD_MOTOR_OFF = 0x80;
+constexpr uint8_t CMD_MOTOR_STOP = 0x81;
+constexpr uint8_t CMD_MOTOR_ON = 0x88;
+constexpr uint8_t CMD_READ_ENC = 0x90;
+constexpr uint8_t CMD_READ_MULTI_ANGLE = 0x92;
+constexpr uint8_t CMD_READ_STAT1 = 0x9A;
+constexpr uint8_t CMD_CLEAR_ERR = 0x9B;
+constexpr uint8_t CMD_READ_STAT2 = 0x9C;
+constexpr uint8_t CMD_TORQUE_CTRL = 0xA1;
+// 複数モーター・トルク指令の CAN ID と単体指令の ID の基準
+constexpr uint32_t MULTI_TORQUE_CAN_ID = 0x280;
+constexpr uint32_t MOTOR_CAN_ID_BASE = 0x140;
+
+constexpr float RAD_TO_DEG = 57.2957795f;
+constexpr float TWO_PI = 6.28318531f;
+} // namespace
+
+SimulatedMotorBus::SimulatedMotorBus(uint32_t motorCanId)
+    : canId(motorCanId), bitrate(Config::Can::BITRATE) {
+  params.inertia = Config::Sim::INERTIA;
+  params.viscousFriction = Config::Sim::VISCOUS_FRICTION;
+  params.coulombFriction = Config::Sim::COULOMB_FRICTION;
+  params.torqueConstant = Config::Sim::TORQUE_CONSTANT;
+  params.latencyUs = Config::Sim::REPLY_LATENCY_US;
+  params.dropPermil = Config::Sim::DROP_PERMIL;
+  params.seed = Config::Sim::RANDOM_SEED;
+
+  angle = 0.0f;
+  velocity = 0.0f;
+  externalTorque = 0.0f;
+  iq = 0;
+  enabled = false;
+  lastStepUs = 0;
+  busBits = 0;
+  lastTxCompleteUs = 0;
+  busFreeUs = 0;
+  rng = params.seed;
+  droppedReplies = 0;
+  replyCount = 0;
+  rxHead = 0;
+  rxCount = 0;
+  txStats = {0, 0, 0, 0, 0};
+}
+
+bool SimulatedMotorBus::begin() {
+  uint32_t now = micros();
+  lastStepUs = now;
+  busFreeUs = now;
+  lastTxCompleteUs = now;
+  rng = params.seed;
+  replyCount = 0;
+  rxCount = 0;
+  return true;
+}
+
+void SimulatedMotorBus::setParams(const Params &newParams) {
+  params = newParams;
+  rng = params.seed;
+}
+
+void SimulatedMotorBus::setAngle(float angleRad) {
+  angle = angleRad;
+  velocity = 0.0f;
+}
+
+bool SimulatedMotorBus::setBitrate(uint32_t newBitrate) {
+  if (newBitrate == 0) {
+    return false;
+  }
+  bitrate = newBitrate;
+  return true;
+}
+
+bool SimulatedMotorBus::setFilters(const CANFilter *filters, uint8_t count) {
+  return filterTable.set(filters, count);
+}
+
+bool SimulatedMotorBus::sendFrame(uint32_t id, uint8_t len,
+                                  const uint8_t *data) {
+  return queueFrame(id, len, data, CAN_TX_PRIO_NORMAL, CAN_TX_APPEND);
+}
+
+bool SimulatedMotorBus::queueFrame(uint32_t id, uint8_t len,
+                                   const uint8_t *data, CANTxPriority priority,
+                                   CANTxSupersede supersede) {
+  // 送信キューを持たないため、優先度・置き換え条件は使用しない
+  (void)priority;
+  (void)supersede;
+  if (len > 8) {
+    len = 8;
+  }
+
+  // コマンド受信時点の状態で応答するため、先にプラントを進める
+  update();
+  uint32_t now = micros();
+
+  // 指令フレームの送信 (バスが空くのを待つ)
+  uint32_t txStart = ((int32_t)(busFreeUs - now) > 0) ? busFreeUs : now;
+  uint32_t txEnd = txStart + frameTimeUs();
+  lastTxCompleteUs = txEnd;
+  busFreeUs = txEnd;
+  busBits += canFrameBitsMax(len, false);
+  txStats.queued++;
+
+  uint8_t cmdData[8] = {0};
+  for (uint8_t i = 0; i < len; i++) {
+    cmdData[i] = data[i];
+  }
+
+  // 宛先の判定 (単体指令, または 0x280 の一括指令の自分の位置)
+  uint8_t reply[8] = {0};
+  bool hasReply = false;
+  if (id == canId && len == 8) {
+    hasReply = handleCommand(cmdData, reply);
+  } else if (id == MULTI_TORQUE_CAN_ID && len == 8) {
+    uint32_t pos = canId - MOTOR_CAN_ID_BASE - 1;
+    if (pos < 4) {
+      // 一括指令の応答は 0xA1 と同じ形式
+      uint8_t single[8] = {CMD_TORQUE_CTRL, 0, 0, 0, cmdData[pos * 2],
+                           cmdData[pos * 2 + 1], 0, 0};
+      hasReply = handleCommand(single, reply);
+    }
+  }
+  if (!hasReply) {
+    return true;
+  }
+
+  if (dropNext()) {
+    droppedReplies++;
+    return true;
+  }
+  if (replyCount >= REPLY_SLOTS) {
+    droppedReplies++;
+    return true;
+  }
+
+  // 応答フレーム: 処理時間の後、バスが空いてから送信される
+  uint32_t replyStart = txEnd + params.latencyUs;
+  uint32_t replyEnd = replyStart + frameTimeUs();
+  busFreeUs = replyEnd;
+  PendingReply &p = replies[replyCount++];
+  p.deliverUs = replyEnd;
+  p.id = canId;
+  for (uint8_t i = 0; i < 8; i++) {
+    p.data[i] = reply[i];
+  }
+  return true;
+}
+
+bool SimulatedMotorBus::handleCommand(const uint8_t *cmdData,
+                                      uint8_t *reply) {
+  uint8_t cmd = cmdData[0];
+  switch (cmd) {
+  case CMD_MOTOR_OFF:
+  case CMD_MOTOR_ON:
+  case CMD_MOTOR_STOP:
+    // OFF: 指令をクリアして停止, ON: 指令の受付を開始, STOP: 指令をクリア
+    if (cmd == CMD_MOTOR_ON) {
+      enabled = true;
+    } else if (cmd == CMD_MOTOR_OFF) {
+      enabled = false;
+    }
+    iq = 0;
+    // 応答は送信コマンドと同一
+    for (uint8_t i = 0; i < 8; i++) {
+      reply[i] = cmdData[i];
+    }
+    return true;
+
+  case CMD_TORQUE_CTRL: {
+    // OFF 状態では応答するが動作しない
+    if (enabled) {
+      int16_t cmdIq = (int16_t)(cmdData[4] | (cmdData[5] << 8));
+      if (cmdIq > IQ_LIMIT) {
+        cmdIq = IQ_LIMIT;
+      } else if (cmdIq < -IQ_LIMIT) {
+        cmdIq = -IQ_LIMIT;
+      }
+      iq = cmdIq;
+    }
+    fillStatus2(CMD_TORQUE_CTRL, reply);
+    return true;
+  }
+
+  case CMD_READ_STAT2:
+    fillStatus2(CMD_READ_STAT2, reply);
+    return true;
+
+  case CMD_READ_ENC: {
+    // 補正後・生のエンコーダ値 (オフセットは 0)
+    uint16_t enc = (uint16_t)encoderCounts();
+    reply[0] = CMD_READ_ENC;
+    reply[2] = enc & 0xFF;
+    reply[3] = (enc >> 8) & 0xFF;
+    reply[4] = enc & 0xFF;
+    reply[5] = (enc >> 8) & 0xFF;
+    return true;
+  }
+
+  case CMD_READ_MULTI_ANGLE: {
+    // 多回転角度 (0.01deg/LSB) の下位7バイト
+    int64_t angle001 = (int64_t)encoderCounts() * 36000 /
+                       Config::Steer::ENCODER_COUNTS_PER_REV;
+    reply[0] = CMD_READ_MULTI_ANGLE;
+    for (uint8_t i = 1; i < 8; i++) {
+      reply[i] = (uint8_t)(((uint64_t)angle001 >> (8 * (i - 1))) & 0xFF);
+    }
+    return true;
+  }
+
+  case CMD_READ_STAT1:
+  case CMD_CLEAR_ERR:
+    // エラー解除の応答も状態1と同じ形式 (模擬モーターはエラーなし)
+    reply[0] = CMD_READ_STAT1;
+    reply[1] = (uint8_t)SIM_TEMPERATURE;
+    reply[3] = SIM_VOLTAGE & 0xFF;
+    reply[4] = (SIM_VOLTAGE >> 8) & 0xFF;
+    reply[7] = 0;
+    return true;
+
+  default:
+    return false; // 未対応のコマンドには応答しない
+  }
+}
+
+void SimulatedMotorBus::fillStatus2(uint8_t cmd, uint8_t *reply) const {
+  float dps = velocity * RAD_TO_DEG;
+  if (dps > 32767.0f) {
+    dps = 32767.0f;
+  } else if (dps < -32768.0f) {
+    dps = -32768.0f;
+  }
+  int16_t speed = (int16_t)dps;
+  uint16_t enc = (uint16_t)encoderCounts();
+
+  reply[0] = cmd;
+  reply[1] = (uint8_t)SIM_TEMPERATURE;
+  reply[2] = iq & 0xFF;
+  reply[3] = (iq >> 8) & 0xFF;
+  reply[4] = speed & 0xFF;
+  reply[5] = (speed >> 8) & 0xFF;
+  reply[6] = enc & 0xFF;
+  reply[7] = (enc >> 8) & 0xFF;
+}
+
+void SimulatedMotorBus::update() {
+  uint32_t now = micros();
+
+  // プラントを SUBSTEP_US 刻みで現在時刻まで進める
+  uint32_t elapsed = now - lastStepUs;
+  while (elapsed > 0) {
+    uint32_t dtUs = (elapsed > SUBSTEP_US) ? SUBSTEP_US : elapsed;
+    step((float)dtUs * 1e-6f);
+    elapsed -= dtUs;
+  }
+  lastStepUs = now;
+
+  // 受信時刻に達した応答を受信キューへ
+  uint8_t delivered = 0;
+  while (delivered < replyCount &&
+         (int32_t)(now - replies[delivered].deliverUs) >= 0) {
+    const PendingReply &p = replies[delivered];
+    busBits += canFrameBitsMax(8, false);
+    if (filterTable.match(p.id) && rxCount < RX_SLOTS) {
+      CANFrame &f = rxFrames[(rxHead + rxCount) % RX_SLOTS];
+      f.id = p.id;
+      f.len = 8;
+      for (uint8_t i = 0; i < 8; i++) {
+        f.data[i] = p.data[i];
+      }
+      f.timestampUs = p.deliverUs;
+      rxCount++;
+    }
+    delivered++;
+  }
+  if (delivered > 0) {
+    for (uint8_t i = delivered; i < replyCount; i++) {
+      replies[i - delivered] = replies[i];
+    }
+    replyCount -= delivered;
+  }
+}
+
+void SimulatedMotorBus::step(float dt) {
+  float motorTorque = params.torqueConstant * (float)iq * IQ_FULL_SCALE_A /
+                      (float)IQ_LIMIT;
+  float drive =
+      motorTorque + externalTorque - params.viscousFriction * velocity;
+
+  if (velocity == 0.0f) {
+    // 静止中: 駆動トルクがクーロン摩擦以下なら動かない
+    if (fabsf(drive) <= params.coulombFriction) {
+      return;
+    }
+    drive -= (drive > 0.0f) ? params.coulombFriction : -params.coulombFriction;
+  } else {
+    drive -= (velocity > 0.0f) ? params.coulombFriction
+                               : -params.coulombFriction;
+  }
+
+  float newVelocity = velocity + drive / params.inertia * dt;
+  // 摩擦で減速して符号が反転した場合は静止とする
+  if (velocity != 0.0f && (newVelocity > 0.0f) != (velocity > 0.0f)) {
+    newVelocity = 0.0f;
+  }
+  angle += 0.5f * (velocity + newVelocity) * dt;
+  velocity = newVelocity;
+}
+
+int32_t SimulatedMotorBus::encoderCounts() const {
+  return (int32_t)ENCODER_AT_ZERO +
+         (int32_t)lroundf(angle / TWO_PI *
+                          (float)Config::Steer::ENCODER_COUNTS_PER_REV);
+}
+
+uint32_t SimulatedMotorBus::frameTimeUs() const {
+  return (uint32_t)((uint64_t)canFrameBitsMax(8, false) * 1000000 / bitrate);
+}
+
+bool SimulatedMotorBus::dropNext() {
+  if (params.dropPermil == 0) {
+    return false;
+  }
+  // 線形合同法 (Numerical Recipes の定数)
+  rng = rng * 1664525UL + 1013904223UL;
+  return ((rng >> 16) % 1000) < params.dropPermil;
+}
+
+bool SimulatedMotorBus::available() {
+  update();
+  return rxCount > 0;
+}
+
+bool SimulatedMotorBus::readFrame(uint32_t &id, uint8_t &len, uint8_t *data) {
+  update();
+  if (rxCount == 0) {
+    return false;
+  }
+  const CANFrame &f = rxFrames[rxHead];
+  id = f.id;
+  len = f.len;
+  for (uint8_t i = 0; i < f.len; i++) {
+    data[i] = f.data[i];
+  }
+  rxHead = (rxHead + 1) % RX_SLOTS;
+  rxCount--;
+  return true;
+}
+
+uint8_t SimulatedMotorBus::readFrames(CANFrame *frames, uint8_t maxFrames) {
+  update();
+  uint8_t n = 0;
+  while (n < maxFrames && rxCount > 0) {
+    frames[n++] = rxFrames[rxHead];
+    rxHead = (rxHead + 1) % RX_SLOTS;
+    rxCount--;
+  }
+  return n;
+}
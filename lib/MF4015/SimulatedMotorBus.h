@@ -0,0 +1,191 @@
+#ifndef SIMULATED_MOTOR_BUS_H
+#define SIMULATED_MOTOR_BUS_H
+
+#include "CANFilterTable.h"
+#include "CANTxQueue.h"
+#include <CANInterface.h> // includeディレクトリから参照
+#include <cstdint>
+
+/**
+ * @file SimulatedMotorBus.h
+ * @brief MF4015 とハンドルを模擬する CANInterface 実装
+ * @date 2026-10-18
+ *
+ * CANコントローラの代わりに CANInterface を実装し、送信されたコマンドに
+ * MotorDriveProtocol.md どおりの応答を返します。実機のモーター・MCP2515
+ * なしで loop1() の制御ロジック (FFB 演算 → トルク指令 → 応答解析) を
+ * 閉ループで動かすために使用します (config.h の CAN_BACKEND_SIM)。
+ *
+ * ## プラントモデル
+ * モーターとハンドルを1つの回転体として扱います。
+ *   J * dω/dt = Kt * iq + τ_ext - B * ω - τ_c * sign(ω)
+ * - J: 慣性モーメント, B: 粘性摩擦, τ_c: クーロン摩擦, Kt: トルク定数
+ * - iq は指令値に即時追従するものとします (電流ループは制御周期より十分速い)
+ * - τ_ext はハンドルを操作する手のトルク (setExternalTorque())
+ *
+ * ## 通信モデル
+ * 応答は、指令・応答フレームのバス占有時間 (canFrameBitsMax() と
+ * ビットレートから算出) と応答処理時間 (latencyUs) の後に受信されます。
+ * dropPermil の確率で応答を欠落させます (乱数は seed から決定的に生成)。
+ *
+ * ## 時間の進め方
+ * 時刻は micros() から取得し、available()/readFrames() の呼び出し時に
+ * 前回からの経過時間だけプラントを進めます (最大 SUBSTEP_US 刻み)。
+ * micros() を仮想時刻で置き換えたホスト環境では、実時間より速く
+ * シミュレーションできます。
+ *
+ * @note 1台のモーター (単体指令と 0x280 の一括指令の自分の位置) を模擬します。
+ */
+
+/**
+ * @class SimulatedMotorBus
+ * @brief 模擬モーター付きの CANInterface
+ */
+class SimulatedMotorBus : public CANInterface {
+public:
+  /**
+   * @brief プラント・通信のパラメータ
+   */
+  struct Params {
+    float inertia;         ///< 慣性モーメント (kg*m^2)
+    float viscousFriction; ///< 粘性摩擦 (N*m/(rad/s))
+    float coulombFriction; ///< クーロン摩擦 (N*m)
+    float torqueConstant;  ///< トルク定数 (N*m/A)
+    uint32_t latencyUs;    ///< 応答処理時間 (us, バス占有時間は別途加算)
+    uint16_t dropPermil;   ///< 応答の欠落率 (0.1% 単位)
+    uint32_t seed;         ///< 欠落判定の乱数の種
+  };
+
+  /**
+   * @brief コンストラクタ (パラメータは Config::Sim の値)
+   * @param motorCanId 模擬するモーターのCAN ID
+   */
+  explicit SimulatedMotorBus(uint32_t motorCanId);
+
+  // --- CANInterface ---
+  bool begin() override;
+  bool sendFrame(uint32_t id, uint8_t len, const uint8_t *data) override;
+  bool queueFrame(uint32_t id, uint8_t len, const uint8_t *data,
+                  CANTxPriority priority, CANTxSupersede supersede) override;
+  bool readFrame(uint32_t &id, uint8_t &len, uint8_t *data) override;
+  bool available() override;
+  uint8_t readFrames(CANFrame *frames, uint8_t maxFrames) override;
+  bool setBitrate(uint32_t bitrate) override;
+  uint32_t getBitrate() const override { return bitrate; }
+  uint32_t getBusBitCount() const override { return busBits; }
+  bool setFilters(const CANFilter *filters, uint8_t count) override;
+  uint32_t getFilterHitCount(uint8_t index) const override {
+    return filterTable.getHitCount(index);
+  }
+
+  // --- MCP2515_Driver / MCP2515_Wrapper と共通の診断用 API ---
+  const CANTxStats &getTxStats() const { return txStats; }
+  uint32_t getFilterRejectCount() const {
+    return filterTable.getRejectCount();
+  }
+  uint32_t getLastTxCompleteUs() const { return lastTxCompleteUs; }
+  uint8_t getLastError() const { return 0; }
+
+  // --- シミュレーション ---
+  /**
+   * @brief パラメータの設定 (プラントの状態は保持)
+   */
+  void setParams(const Params &params);
+  const Params &getParams() const { return params; }
+
+  /**
+   * @brief 外部トルク (ハンドルを操作する手のトルク) の設定
+   * @param torqueNm トルク (N*m, モーター座標の正方向)
+   */
+  void setExternalTorque(float torqueNm) { externalTorque = torqueNm; }
+
+  /**
+   * @brief ハンドル角度の設定 (センターからの角度, 速度は0にする)
+   * @param angleRad 角度 (rad, モーター座標)
+   */
+  void setAngle(float angleRad);
+
+  /**
+   * @brief 現在時刻までプラントを進め、到着した応答を受信キューへ移す
+   *
+   * available()/readFrames() から呼ばれます。
+   */
+  void update();
+
+  float getAngle() const { return angle; }       ///< 角度 (rad)
+  float getVelocity() const { return velocity; } ///< 角速度 (rad/s)
+  int16_t getIq() const { return iq; }           ///< 現在の iq 指令値
+  bool isEnabled() const { return enabled; }     ///< モーターON状態
+  uint32_t getDroppedReplies() const { return droppedReplies; }
+
+private:
+  /// プラント積分の最大刻み (us)
+  static constexpr uint32_t SUBSTEP_US = 100;
+  /// 応答待ちフレームの最大数
+  static constexpr uint8_t REPLY_SLOTS = 16;
+  /// 受信済み (未読) フレームの最大数
+  static constexpr uint8_t RX_SLOTS = 16;
+  /// iq 指令値の範囲 (-2048..2048 が -16.5A..16.5A に対応)
+  static constexpr int16_t IQ_LIMIT = 2048;
+  static constexpr float IQ_FULL_SCALE_A = 16.5f;
+  /// 起動時のエンコーダ値 (センター)
+  static constexpr uint16_t ENCODER_AT_ZERO = 0x7FFF;
+  /// 模擬する温度 (degC) と電圧 (0.1V)
+  static constexpr int8_t SIM_TEMPERATURE = 30;
+  static constexpr uint16_t SIM_VOLTAGE = 120;
+
+  /**
+   * @brief 受信側に届くまでのフレーム
+   */
+  struct PendingReply {
+    uint32_t deliverUs; ///< 受信時刻
+    uint32_t id;        ///< CAN識別子
+    uint8_t data[8];    ///< データ
+  };
+
+  /**
+   * @brief コマンドの処理と応答の生成
+   * @param cmdData コマンドフレームのデータ (8バイト)
+   * @param reply 応答の格納先
+   * @return true: 応答あり
+   */
+  bool handleCommand(const uint8_t *cmdData, uint8_t *reply);
+
+  /**
+   * @brief 0xA1/0x9C 形式の状態応答
+   */
+  void fillStatus2(uint8_t cmd, uint8_t *reply) const;
+
+  void step(float dt);           ///< プラントを dt 秒進める
+  int32_t encoderCounts() const; ///< 多回転のエンコーダ位置
+  uint32_t frameTimeUs() const;  ///< 8バイト標準フレームのバス占有時間
+  bool dropNext();               ///< 応答を欠落させるか (乱数)
+
+  uint32_t canId; ///< 模擬するモーターのCAN ID
+  Params params;  ///< パラメータ
+
+  // --- プラントの状態 ---
+  float angle;          ///< 角度 (rad, センター基準)
+  float velocity;       ///< 角速度 (rad/s)
+  float externalTorque; ///< 外部トルク (N*m)
+  int16_t iq;           ///< iq 指令値
+  bool enabled;         ///< モーターON状態
+  uint32_t lastStepUs;  ///< 前回プラントを進めた時刻
+
+  // --- 通信の状態 ---
+  uint32_t bitrate;                  ///< ビットレート (bps)
+  uint32_t busBits;                  ///< 送受信ビット数の累積
+  uint32_t lastTxCompleteUs;         ///< 最後の送信完了時刻
+  uint32_t busFreeUs;                ///< バスが空く時刻
+  uint32_t rng;                      ///< 乱数の状態
+  uint32_t droppedReplies;           ///< 欠落させた応答数
+  PendingReply replies[REPLY_SLOTS]; ///< 応答待ち (到着順)
+  uint8_t replyCount;                ///< 応答待ちの数
+  CANFrame rxFrames[RX_SLOTS];       ///< 受信済みフレーム (到着順)
+  uint8_t rxHead;                    ///< 次に読み出す位置
+  uint8_t rxCount;                   ///< 受信済みフレーム数
+  CANTxStats txStats;                ///< 送信統計
+  CANFilterTable filterTable;        ///< 受信フィルタ
+};
+
+#endif // SIMULATED_MOTOR_BUS_H
@@ -1,22 +1,126 @@
 #include "ADInput.h"
+#include "hot_path.h"
 
-ADInputChannel::ADInputChannel(uint8_t pin, uint16_t bufferSize,
-                               int (*transform)(int))
-    : _pin(pin), _bufferSize(bufferSize), _transform(transform),
-      _buffer(nullptr), _head(0), _sampleCount(0), _sum(0) {
+ADInputChannelBase::ADInputChannelBase(uint8_t pin, int (*transform)(int),
+                                       uint8_t decimationShift)
+    : _pin(pin), _transform(transform), _decimationShift(decimationShift),
+      _decimSum(0), _decimCount(0), _filterMode(FILTER_AVERAGE), _oeMinW(0),
+      _oeBetaK(0), _oeDerivAlpha(0), _oeValue(0), _oeSpeed(0), _oePrev(0),
+      _oeReady(false) {}
+
+void ADInputChannelBase::Init() {
+  pinMode(_pin, INPUT);
+  clearAverage();
+  _decimSum = 0;
+  _decimCount = 0;
+  _oeReady = false;
+}
+
+template <>
+void HOT_FUNC(
+    ADInputChannelImpl<ADInputChannel<Config::Adc::AVERAGE_COUNT>>::putSamples)(
+    const volatile uint16_t *samples, uint16_t count, uint8_t stride) {
+  decimateSamples(samples, count, stride);
+}
+
+template <>
+void HOT_FUNC(ADInputChannelImpl<ADInputChannelDynamic>::putSamples)(
+    const volatile uint16_t *samples, uint16_t count, uint8_t stride) {
+  decimateSamples(samples, count, stride);
+}
+
+void ADInputChannelBase::setOneEuro(float minCutoffHz, float beta,
+                                    float derivCutoffHz,
+                                    float sampleRateHz) {
+  const float twoPi = 6.2831853f;
+  _oeMinW = (uint32_t)(twoPi * minCutoffHz / sampleRateHz * OE_ONE + 0.5f);
+  // fc = fmin + beta × 速度(値/サンプル) × fs より w の増分は 2π × beta
+  _oeBetaK = (uint32_t)(twoPi * beta * OE_ONE + 0.5f);
+  _oeDerivAlpha = oneEuroAlpha(
+      (uint32_t)(twoPi * derivCutoffHz / sampleRateHz * OE_ONE + 0.5f));
+  setFilterMode(FILTER_ONE_EURO);
+}
+
+void ADInputChannelBase::setFilterMode(FilterMode mode) {
+  _filterMode = mode;
+  _oeReady = false;
+}
+
+uint32_t HOT_FUNC(ADInputChannelBase::oneEuroAlpha)(uint32_t w) {
+  // α = 1 - 1 / (1 + w)。2^32 の代わりに 0xFFFFFFFF で割る (誤差 1LSB)
+  if (w > 0x7FFFFFFFUL) {
+    w = 0x7FFFFFFFUL;
+  }
+  return OE_ONE - 0xFFFFFFFFUL / (OE_ONE + w);
+}
+
+void HOT_FUNC(ADInputChannelBase::updateOneEuro)(int newValue) {
+  int32_t x = (int32_t)newValue << OE_FRAC_BITS;
+  if (!_oeReady) {
+    _oeValue = x;
+    _oeSpeed = 0;
+    _oePrev = newValue;
+    _oeReady = true;
+    return;
+  }
+
+  // 速度 (値/サンプル) を固定の遮断周波数で平滑化
+  int32_t dx = (int32_t)(newValue - _oePrev) << OE_FRAC_BITS;
+  _oePrev = newValue;
+  _oeSpeed += (int32_t)(((int64_t)_oeDerivAlpha * (dx - _oeSpeed)) >> 16);
+
+  // 速度に応じて遮断周波数を上げる
+  uint32_t speed =
+      (uint32_t)(_oeSpeed < 0 ? -_oeSpeed : _oeSpeed) >> OE_FRAC_BITS;
+  uint32_t alpha = oneEuroAlpha(_oeMinW + _oeBetaK * speed);
+  _oeValue += (int32_t)(((int64_t)alpha * (x - _oeValue)) >> 16);
+}
+
+bool HOT_FUNC(ADInputChannelBase::getOneEuro)(int &value) const {
+  if (!_oeReady) {
+    return false;
+  }
+  value = (int)((_oeValue + (1 << (OE_FRAC_BITS - 1))) >> OE_FRAC_BITS);
+  return true;
+}
+
+int HOT_FUNC(ADInputChannelBase::getvalue)() {
+  // サンプルがないとき (One-Euro は初回サンプルまで) は0を返す
+  int average;
+  if (!getFiltered(average)) {
+    return 0;
+  }
+
+  // 変換関数が指定されていれば適用する
+  if (_transform) {
+    return _transform(average);
+  }
+
+  return average;
+}
+
+// ============================================================================
+// ADInputChannelDynamic
+// ============================================================================
+
+ADInputChannelDynamic::ADInputChannelDynamic(uint8_t pin, uint16_t bufferSize,
+                                             int (*transform)(int),
+                                             uint8_t decimationShift)
+    : ADInputChannelImpl(pin, transform, decimationShift),
+      _bufferSize(bufferSize), _buffer(nullptr), _head(0), _sampleCount(0),
+      _sum(0) {
   if (_bufferSize > 0) {
     _buffer = new int[_bufferSize];
   }
 }
 
-ADInputChannel::~ADInputChannel() {
+ADInputChannelDynamic::~ADInputChannelDynamic() {
   if (_buffer) {
     delete[] _buffer;
   }
 }
 
-void ADInputChannel::Init() {
-  pinMode(_pin, INPUT);
+void ADInputChannelDynamic::clearAverage() {
   _head = 0;
   _sampleCount = 0;
   _sum = 0;
@@ -27,12 +131,10 @@ void ADInputChannel::Init() {
   }
 }
 
-void ADInputChannel::getadc() {
+void HOT_FUNC(ADInputChannelDynamic::pushAverage)(int newValue) {
   if (!_buffer)
     return;
 
-  int newValue = analogRead(_pin);
-
   // 合計値から一番古い値を引き、新しい値を足す（差分更新）
   // サンプル数がバッファサイズに達している場合のみ、古い値を引く
   if (_sampleCount >= _bufferSize) {
@@ -48,24 +150,12 @@ void ADInputChannel::getadc() {
   _head = (_head + 1) % _bufferSize;
 }
 
-int ADInputChannel::getvalue() {
-  // バッファサイズより入力回数が少ないときは0を返す
-  if (_sampleCount < _bufferSize) {
-    return 0;
-  }
-
-  // 平均値の計算
-  int average = (int)((float)_sum / (float)_bufferSize);
-
-  // 変換関数が指定されていれば適用する
-  if (_transform) {
-    return _transform(average);
-  }
-
-  return average;
+int HOT_FUNC(ADInputChannelDynamic::averageValue)() const {
+  // バッファが埋まるまでは格納済みサンプルの平均
+  return (_sampleCount > 0) ? (int)(_sum / _sampleCount) : 0;
 }
 
-int ADInputChannel::getRawLatest() const {
+int HOT_FUNC(ADInputChannelDynamic::latestValue)() const {
   if (!_buffer || _sampleCount == 0)
     return 0;
   // _head は次に書き込む位置なので、最新値はその一つ前
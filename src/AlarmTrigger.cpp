@@ -0,0 +1,64 @@
+/**
+ * @file AlarmTrigger.cpp
+ * @brief ハードウェアアラーム駆動の周期トリガの実装
+ * @date 2026-10-18
+ */
+
+#include "AlarmTrigger.h"
+#include "hot_path.h"
+#include <Arduino.h>
+#include <hardware/timer.h>
+
+AlarmTrigger *AlarmTrigger::instances[4] = {nullptr, nullptr, nullptr,
+                                            nullptr};
+
+AlarmTrigger::AlarmTrigger(uint32_t interval_us)
+    : interval(interval_us), alarmNum(-1), nextDeadline(0), firedDeadline(0),
+      fired(0), skipped(0), consumed(0), deadlineUs(0), missed(0) {}
+
+void AlarmTrigger::init(uint32_t phase_us) {
+  if (alarmNum < 0) {
+    alarmNum = hardware_alarm_claim_unused(true);
+    instances[alarmNum] = this;
+    // 割り込みはこの呼び出しを行ったコアで有効になる
+    hardware_alarm_set_callback(alarmNum, onAlarm);
+  }
+  noInterrupts();
+  consumed = fired;
+  nextDeadline = time_us_64() + phase_us + interval;
+  hardware_alarm_set_target(alarmNum, from_us_since_boot(nextDeadline));
+  interrupts();
+}
+
+void HOT_FUNC(AlarmTrigger::onAlarm)(unsigned int alarmNum) {
+  AlarmTrigger *trigger = instances[alarmNum];
+  if (trigger != nullptr) {
+    trigger->fire();
+  }
+}
+
+void HOT_FUNC(AlarmTrigger::fire)() {
+  firedDeadline = (uint32_t)nextDeadline;
+  fired++;
+  // 次の期限を設定 (既に過ぎている場合は周期単位で読み飛ばす)
+  nextDeadline += interval;
+  while (hardware_alarm_set_target(alarmNum,
+                                   from_us_since_boot(nextDeadline))) {
+    nextDeadline += interval;
+    skipped++;
+  }
+}
+
+bool HOT_FUNC(AlarmTrigger::hasExpired)() {
+  if (fired == consumed) {
+    return false;
+  }
+  // 発生数と期限を割り込みと競合せずに取得する
+  noInterrupts();
+  uint32_t count = fired;
+  deadlineUs = firedDeadline;
+  interrupts();
+  missed += count - consumed - 1; // 溜まった分は最新の1回だけ実行
+  consumed = count;
+  return true;
+}
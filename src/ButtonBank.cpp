@@ -0,0 +1,31 @@
+/**
+ * @file ButtonBank.cpp
+ * @brief 縦型カウンタによるボタンバンクの実装
+ * @date 2026-10-18
+ */
+
+#include "ButtonBank.h"
+#include "hot_path.h"
+#include <hardware/gpio.h>
+
+ButtonBank::ButtonBank(uint8_t firstPin, uint8_t count)
+    : firstPin(firstPin), count(count > MAX_BUTTONS ? MAX_BUTTONS : count),
+      mask(0), state(0), count0(0), count1(0) {
+  mask = (this->count >= MAX_BUTTONS) ? 0xFFFFFFFFu
+                                      : ((1u << this->count) - 1);
+  state = mask;
+}
+
+void ButtonBank::Init() {
+  for (uint8_t i = 0; i < count; i++) {
+    pinMode(firstPin + i, INPUT_PULLUP);
+  }
+  state = mask;
+  count0 = 0;
+  count1 = 0;
+}
+
+uint32_t HOT_FUNC(ButtonBank::update)() {
+  // 全 GPIO を1回で読み出し、先頭ピンをビット 0 に揃える
+  return update(gpio_get_all() >> firstPin);
+}
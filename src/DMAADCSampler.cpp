@@ -0,0 +1,160 @@
+/**
+ * @file DMAADCSampler.cpp
+ * @brief RP2040 の ADC を DMA でフリーランさせるサンプラの実装
+ * @date 2026-10-18
+ */
+
+#include "DMAADCSampler.h"
+#include "hot_path.h"
+#include <Arduino.h>
+#include <hardware/adc.h>
+#include <hardware/dma.h>
+
+namespace {
+/// リングのバイト数の log2 (channel_config_set_ring() の指定値)
+constexpr uint8_t RING_SIZE_BITS = 11;
+static_assert((1u << RING_SIZE_BITS) ==
+                  DMAADCSampler::RING_SAMPLES * sizeof(uint16_t),
+              "RING_SIZE_BITS must match RING_SAMPLES");
+/// ADC の最高変換レート (96 クロック/変換)
+constexpr uint32_t ADC_MAX_RATE_HZ = 500000;
+} // namespace
+
+DMAADCSampler::DMAADCSampler(uint32_t sampleRateHz)
+    : inputCount(0), sampleRateHz(sampleRateHz), ringPeriodUs(0),
+      dataChannel(-1), ctrlChannel(-1), reloadCount(RING_SAMPLES),
+      readIndex(0), lastReadUs(0), overruns(0) {
+  if (this->sampleRateHz == 0 || this->sampleRateHz > ADC_MAX_RATE_HZ) {
+    this->sampleRateHz = ADC_MAX_RATE_HZ;
+  }
+  ringPeriodUs =
+      (uint32_t)((uint64_t)RING_SAMPLES * 1000000 / this->sampleRateHz);
+  for (uint8_t i = 0; i < MAX_INPUTS; i++) {
+    inputs[i] = nullptr;
+  }
+  for (uint16_t i = 0; i < RING_SAMPLES; i++) {
+    ring[i] = 0;
+  }
+}
+
+bool DMAADCSampler::attach(ADInputChannelBase *channel) {
+  if (channel == nullptr || inputCount >= MAX_INPUTS ||
+      channel->getPin() < ADC_FIRST_PIN ||
+      channel->getPin() >= ADC_FIRST_PIN + MAX_INPUTS) {
+    return false;
+  }
+  // 巡回順 (ADC 入力番号の昇順) に並べる
+  uint8_t pos = inputCount;
+  while (pos > 0 && inputs[pos - 1]->getPin() >= channel->getPin()) {
+    if (inputs[pos - 1]->getPin() == channel->getPin()) {
+      return false;
+    }
+    pos--;
+  }
+  for (uint8_t i = inputCount; i > pos; i--) {
+    inputs[i] = inputs[i - 1];
+  }
+  inputs[pos] = channel;
+  inputCount++;
+  return true;
+}
+
+bool DMAADCSampler::begin() {
+  if (inputCount == 0 || (RING_SAMPLES % inputCount) != 0) {
+    return false;
+  }
+
+  adc_init();
+  uint8_t mask = 0;
+  for (uint8_t i = 0; i < inputCount; i++) {
+    adc_gpio_init(inputs[i]->getPin());
+    mask |= (uint8_t)(1u << (inputs[i]->getPin() - ADC_FIRST_PIN));
+  }
+  adc_select_input(inputs[0]->getPin() - ADC_FIRST_PIN);
+  adc_set_round_robin(inputCount > 1 ? mask : 0);
+  // FIFO の各エントリで DREQ を出す (12bit のまま, エラーフラグなし)
+  adc_fifo_setup(true, true, 1, false, false);
+  // 変換周期は (1 + div) クロック
+  adc_set_clkdiv((float)ADC_CLOCK_HZ / (float)sampleRateHz - 1.0f);
+
+  if (dataChannel < 0) {
+    dataChannel = dma_claim_unused_channel(true);
+    ctrlChannel = dma_claim_unused_channel(true);
+  }
+
+  // データチャネル: ADC FIFO → リング (1周ごとに制御チャネルへチェイン)
+  dma_channel_config dc = dma_channel_get_default_config(dataChannel);
+  channel_config_set_transfer_data_size(&dc, DMA_SIZE_16);
+  channel_config_set_read_increment(&dc, false);
+  channel_config_set_write_increment(&dc, true);
+  channel_config_set_ring(&dc, true, RING_SIZE_BITS);
+  channel_config_set_dreq(&dc, DREQ_ADC);
+  channel_config_set_chain_to(&dc, ctrlChannel);
+  dma_channel_configure(dataChannel, &dc, ring, &adc_hw->fifo, RING_SAMPLES,
+                        false);
+
+  // 制御チャネル: 転送数の書き込みでデータチャネルを再始動
+  dma_channel_config cc = dma_channel_get_default_config(ctrlChannel);
+  channel_config_set_transfer_data_size(&cc, DMA_SIZE_32);
+  channel_config_set_read_increment(&cc, false);
+  channel_config_set_write_increment(&cc, false);
+  dma_channel_configure(ctrlChannel, &cc,
+                        &dma_hw->ch[dataChannel].al1_transfer_count_trig,
+                        &reloadCount, 1, false);
+
+  // リング先頭が巡回の先頭入力になるよう、FIFO を空にしてから開始
+  adc_fifo_drain();
+  readIndex = 0;
+  dma_channel_start(dataChannel);
+  adc_run(true);
+  lastReadUs = micros();
+  return true;
+}
+
+uint16_t HOT_FUNC(DMAADCSampler::writeIndex)() const {
+  uint32_t offset =
+      dma_hw->ch[dataChannel].write_addr - (uint32_t)(uintptr_t)ring;
+  return (uint16_t)((offset / sizeof(uint16_t)) & RING_MASK);
+}
+
+uint16_t HOT_FUNC(DMAADCSampler::read)() {
+  if (dataChannel < 0) {
+    return 0;
+  }
+  uint32_t nowUs = micros();
+  uint16_t head = writeIndex();
+  if (nowUs - lastReadUs >= ringPeriodUs) {
+    // 1周以上経過: 未読分は上書きされているため読み飛ばす
+    overruns++;
+    readIndex = head;
+    lastReadUs = nowUs;
+    return 0;
+  }
+  lastReadUs = nowUs;
+
+  uint16_t available = (uint16_t)((head - readIndex) & RING_MASK);
+  uint16_t remaining = available;
+  while (remaining > 0) {
+    // リング終端で折り返すまでの連続部分ごとに渡す
+    uint16_t run = RING_SAMPLES - readIndex;
+    if (run > remaining) {
+      run = remaining;
+    }
+    distribute(readIndex, run);
+    readIndex = (uint16_t)((readIndex + run) & RING_MASK);
+    remaining -= run;
+  }
+  return available;
+}
+
+void HOT_FUNC(DMAADCSampler::distribute)(uint16_t start, uint16_t count) {
+  // リング位置 p のサンプルは inputs[p % inputCount] (RING_SAMPLES の約数)
+  for (uint8_t k = 0; k < inputCount; k++) {
+    uint16_t first =
+        (uint16_t)((k + inputCount - start % inputCount) % inputCount);
+    if (first < count) {
+      uint16_t n = (uint16_t)((count - first + inputCount - 1) / inputCount);
+      inputs[k]->putSamples(&ring[start + first], n, inputCount);
+    }
+  }
+}
@@ -1,29 +1,83 @@
 #include "DigitalInput.h"
+#include "hot_path.h"
 
-DigitalInputChannel::DigitalInputChannel(uint8_t pin, int threshold)
+DigitalInputChannel::DigitalInputChannel(uint8_t pin, int threshold,
+                                         uint32_t lockoutUs)
     : _pin(pin), _threshold(threshold), _counter(threshold),
-      _currentStatus(HIGH) {}
+      _lockoutUs(lockoutUs), _currentStatus(HIGH), _lastEdgeUs(0),
+      _edgeCount(0), _bounceCount(0), _pendingUs(0) {}
 
 void DigitalInputChannel::Init() {
   pinMode(_pin, INPUT_PULLUP);
   _counter = _threshold;
-  _currentStatus = HIGH;
+  _edgeCount = 0;
+  _bounceCount = 0;
+  if (_lockoutUs > 0) {
+    // 起動直後のエッジをロックアウトしないよう、時刻を過去にしておく
+    _currentStatus = digitalRead(_pin);
+    _lastEdgeUs = micros() - _lockoutUs;
+    attachInterruptParam(digitalPinToInterrupt(_pin), onEdge, CHANGE, this);
+  } else {
+    _currentStatus = HIGH;
+    _lastEdgeUs = micros();
+  }
+}
+
+void HOT_FUNC(DigitalInputChannel::setState)(int state, uint32_t edgeUs) {
+  _currentStatus = state;
+  _lastEdgeUs = edgeUs;
+  _edgeCount++;
+}
+
+void HOT_FUNC(DigitalInputChannel::onEdge)(void *param) {
+  DigitalInputChannel *ch = static_cast<DigitalInputChannel *>(param);
+  uint32_t now = micros();
+  if (now - ch->_lastEdgeUs < ch->_lockoutUs) {
+    ch->_bounceCount++;
+    return;
+  }
+  // 安定状態からの最初のエッジ: ピンはまだ揺れているため、読まずに反転する
+  ch->setState(ch->_currentStatus == HIGH ? LOW : HIGH, now);
 }
 
-int DigitalInputChannel::update() {
+int HOT_FUNC(DigitalInputChannel::update)() {
   int iBtn = digitalRead(_pin);
 
+  if (_lockoutUs > 0) {
+    // ロックアウト明けの食い違いをピンの値で確定し直す
+    // (割り込みと競合しないよう、判定と書き込みは割り込み禁止で行う)
+    if (iBtn != _currentStatus) {
+      noInterrupts();
+      uint32_t now = micros();
+      if (iBtn != _currentStatus && now - _lastEdgeUs >= _lockoutUs) {
+        setState(iBtn, now);
+      }
+      interrupts();
+    }
+    return _currentStatus;
+  }
+
   if (iBtn > 0) { // HIGH (ボタン非押下)
+    if (_counter == 0) {
+      _pendingUs = micros(); // 確定状態 LOW からの変化を検出
+    }
     _counter++;
     if (_counter > _threshold) {
       _counter = _threshold;
-      _currentStatus = HIGH;
+      if (_currentStatus != HIGH) {
+        setState(HIGH, _pendingUs);
+      }
     }
   } else { // LOW (ボタン押下)
+    if (_counter == _threshold) {
+      _pendingUs = micros(); // 確定状態 HIGH からの変化を検出
+    }
     _counter--;
     if (_counter < 0) {
       _counter = 0;
-      _currentStatus = LOW;
+      if (_currentStatus != LOW) {
+        setState(LOW, _pendingUs);
+      }
     }
   }
   return _currentStatus;
@@ -8,47 +8,138 @@
  */
 
 #include "ADInput.h"
+#include "DMAADCSampler.h"
 #include "DigitalInput.h"
+#include "Ene1HandCont_IO.h"
 #include "config.h"
+#include "hot_path.h"
+#include "shared_data.h"
 #include <Arduino.h>
+#include <hardware/sync.h>
 
 // ============================================================================
 // ボタン入力処理用クラス
 // ============================================================================
 
 DigitalInputChannel diKeyUp(Config::Pin::SHIFT_UP,
-                            Config::Input::BUTTON_DEBOUNCE_THRESHOLD);
+                            Config::Input::BUTTON_DEBOUNCE_THRESHOLD,
+                            Config::Input::BUTTON_LOCKOUT_US);
 DigitalInputChannel diKeyDown(Config::Pin::SHIFT_DOWN,
-                              Config::Input::BUTTON_DEBOUNCE_THRESHOLD);
+                              Config::Input::BUTTON_DEBOUNCE_THRESHOLD,
+                              Config::Input::BUTTON_LOCKOUT_US);
+ButtonBank buttonBox(Config::Pin::BUTTON_BOX_FIRST,
+                     Config::Pin::BUTTON_BOX_COUNT);
 
 // ============================================================================
 // アナログ入力処理用クラス
 // ============================================================================
 
-// 変換関数：ブレーキ用（範囲変換と反転処理）
-int transformBrake(int val) {
-  // map()は入力範囲外の値を外挿するため、先にADC範囲にクランプする
-  val = constrain(val, Config::Adc::BRAKE_MIN, Config::Adc::BRAKE_MAX);
+// 校正値 (ADC値 → ストローク, Core 1 が変換係数を更新する)
 #ifdef BRAKE_INVERT
-  // BRAKE_INVERT: 踏み込みで値が増えるように反転
-  return map(val, Config::Adc::BRAKE_MIN, Config::Adc::BRAKE_MAX,
-             Config::Adc::BRAKE_HID_MAX, Config::Adc::BRAKE_HID_MIN);
+static constexpr bool BRAKE_INVERTED = true; // 踏み込みで ADC 値が減る
 #else
-  return map(val, Config::Adc::BRAKE_MIN, Config::Adc::BRAKE_MAX,
-             Config::Adc::BRAKE_HID_MIN, Config::Adc::BRAKE_HID_MAX);
+static constexpr bool BRAKE_INVERTED = false;
 #endif // BRAKE_INVERT
+PedalCalibration accelCal({Config::Adc::ACCEL_MIN, Config::Adc::ACCEL_MAX,
+                           Config::Adc::DEADZONE_INNER_PERMIL,
+                           Config::Adc::DEADZONE_OUTER_PERMIL},
+                          false);
+PedalCalibration brakeCal({Config::Adc::BRAKE_MIN, Config::Adc::BRAKE_MAX,
+                           Config::Adc::DEADZONE_INNER_PERMIL,
+                           Config::Adc::DEADZONE_OUTER_PERMIL},
+                          BRAKE_INVERTED);
+
+// 応答曲線 (ストローク → HID値, Core 0 が作成し Core 1 が切り替える)
+PedalCurve accelCurve(Config::Adc::ACCEL_HID_MIN, Config::Adc::ACCEL_HID_MAX);
+PedalCurve brakeCurve(Config::Adc::BRAKE_HID_MIN, Config::Adc::BRAKE_HID_MAX);
+
+// 変換関数：ブレーキ用（校正値でストロークへ → 応答曲線）
+// BRAKE_INVERT: 踏み込みで値が増えるように反転 (brakeCal で処理)
+int HOT_FUNC(transformBrake)(int val) {
+  return brakeCurve.apply(brakeCal.apply(val));
+}
+
+// 変換関数：アクセル用（校正値でストロークへ → 応答曲線）
+int HOT_FUNC(transformAccel)(int val) {
+  return accelCurve.apply(accelCal.apply(val));
+}
+
+bool stagePedalCurves(const PedalCurveConfig &accel,
+                      const PedalCurveConfig &brake) {
+  // 片方だけ切り替わらないよう、両方の切り替えが済んでから作成する
+  if (accelCurve.isPending() || brakeCurve.isPending()) {
+    return false;
+  }
+  accelCurve.stage(accel);
+  brakeCurve.stage(brake);
+  return true;
 }
 
-// 変換関数：アクセル用（範囲変換）
-int transformAccel(int val) {
-  // map()は入力範囲外の値を外挿するため、先にADC範囲にクランプする
-  val = constrain(val, Config::Adc::ACCEL_MIN, Config::Adc::ACCEL_MAX);
-  return map(val, Config::Adc::ACCEL_MIN, Config::Adc::ACCEL_MAX,
-             Config::Adc::ACCEL_HID_MIN, Config::Adc::ACCEL_HID_MAX);
+void HOT_FUNC(commitPedalCurves)() {
+  accelCurve.commit();
+  brakeCurve.commit();
 }
 
 // AD入力チャンネルインスタンス
-ADInputChannel adAccel(Config::Pin::ACCEL, Config::Adc::AVERAGE_COUNT,
-                       transformAccel);
-ADInputChannel adBrake(Config::Pin::BRAKE, Config::Adc::AVERAGE_COUNT,
-                       transformBrake);
\ No newline at end of file
+PedalInputChannel adAccel(Config::Pin::ACCEL, transformAccel,
+                          Config::Adc::DECIMATION_SHIFT);
+PedalInputChannel adBrake(Config::Pin::BRAKE, transformBrake,
+                          Config::Adc::DECIMATION_SHIFT);
+
+// ADC の DMA サンプラ (アクセル・ブレーキを巡回して連続変換)
+DMAADCSampler adcSampler(Config::Adc::DMA_SAMPLE_RATE_HZ);
+
+void HOT_FUNC(updatePedalCalibration)() {
+  // 校正値の変更を反映 (初回は保存値または既定値を読み込む)
+  static bool loaded = false;
+  static uint8_t calibSeq = 0;
+  if (!loaded || sharedData.pedalCalibSeq != calibSeq) {
+    calibSeq = sharedData.pedalCalibSeq;
+    accelCal.load(sharedData.accelCalib);
+    brakeCal.load(sharedData.brakeCalib);
+    loaded = true;
+  }
+
+  int raw;
+  switch (sharedData.pedalCalibMode) {
+  case PEDAL_CALIB_RUN:
+    if (!accelCal.isCapturing()) {
+      accelCal.beginCapture();
+      brakeCal.beginCapture();
+    }
+    if (adAccel.getFiltered(raw)) {
+      accelCal.capture(raw);
+    }
+    if (adBrake.getFiltered(raw)) {
+      brakeCal.capture(raw);
+    }
+    break;
+
+  case PEDAL_CALIB_FINISH: {
+    // 観測範囲が十分なペダルだけ更新し、保存を要求する
+    PedalCalibConfig result;
+    bool accelOk = accelCal.endCapture(result);
+    if (accelOk) {
+      sharedData.accelCalib = result;
+    }
+    bool brakeOk = brakeCal.endCapture(result);
+    if (brakeOk) {
+      sharedData.brakeCalib = result;
+    }
+    if (accelOk || brakeOk) {
+      accelCal.load(sharedData.accelCalib);
+      brakeCal.load(sharedData.brakeCalib);
+      calibSeq = ++sharedData.pedalCalibSeq;
+      // 校正値を書き終えてから保存を要求する (Core 0 が読む順序を保証)
+      __dmb();
+      sharedData.configSaveRequest = true;
+    }
+    sharedData.pedalCalibMode =
+        (accelOk && brakeOk) ? PEDAL_CALIB_IDLE : PEDAL_CALIB_FAILED;
+    break;
+  }
+
+  default:
+    break;
+  }
+}
@@ -0,0 +1,75 @@
+/**
+ * @file PedalCalibration.cpp
+ * @brief ペダルの校正値とストロークへの変換の実装
+ * @date 2026-10-18
+ */
+
+#include "PedalCalibration.h"
+
+PedalCalibration::PedalCalibration(const PedalCalibConfig &defaults,
+                                   bool invert)
+    : defaults(defaults), current(defaults), invert(invert), lo(0), hi(0),
+      span(1), scale(0), capturing(false), captureMin(0), captureMax(0) {
+  load(defaults);
+}
+
+bool PedalCalibration::isValid(const PedalCalibConfig &config) {
+  return config.rawMax > config.rawMin &&
+         (uint16_t)(config.rawMax - config.rawMin) >= MIN_SPAN &&
+         config.innerDeadzone + config.outerDeadzone <= MAX_DEADZONE_TOTAL;
+}
+
+bool PedalCalibration::load(const PedalCalibConfig &config) {
+  bool valid = isValid(config);
+  current = valid ? config : defaults;
+
+  // デッドゾーンを校正範囲の割合から ADC 値へ (反転ペダルは離した側が上限)
+  uint32_t range = (uint32_t)current.rawMax - current.rawMin;
+  uint16_t restZone = (uint16_t)(range * current.innerDeadzone / 1000);
+  uint16_t fullZone = (uint16_t)(range * current.outerDeadzone / 1000);
+  if (invert) {
+    lo = (uint16_t)(current.rawMin + fullZone);
+    hi = (uint16_t)(current.rawMax - restZone);
+  } else {
+    lo = (uint16_t)(current.rawMin + restZone);
+    hi = (uint16_t)(current.rawMax - fullZone);
+  }
+  span = (uint32_t)(hi - lo);
+  scale = 0xFFFFFFFFUL / span;
+  return valid;
+}
+
+void PedalCalibration::beginCapture() {
+  captureMin = 0xFFFF;
+  captureMax = 0;
+  capturing = true;
+}
+
+void PedalCalibration::capture(int raw) {
+  if (!capturing) {
+    return;
+  }
+  if (raw < 0) {
+    raw = 0;
+  } else if (raw > 0xFFFF) {
+    raw = 0xFFFF;
+  }
+  if (raw < captureMin) {
+    captureMin = (uint16_t)raw;
+  }
+  if (raw > captureMax) {
+    captureMax = (uint16_t)raw;
+  }
+}
+
+bool PedalCalibration::endCapture(PedalCalibConfig &result) {
+  capturing = false;
+  if (captureMax <= captureMin ||
+      (uint16_t)(captureMax - captureMin) < MIN_SPAN) {
+    return false;
+  }
+  result = current;
+  result.rawMin = captureMin;
+  result.rawMax = captureMax;
+  return true;
+}
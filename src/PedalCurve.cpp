@@ -0,0 +1,101 @@
+/**
+ * @file PedalCurve.cpp
+ * @brief ペダルの応答曲線テーブルの実装
+ * @date 2026-10-18
+ */
+
+#include "PedalCurve.h"
+#include <math.h>
+
+PedalCurve::PedalCurve(uint16_t outMin, uint16_t outMax)
+    : outMin(outMin), outMax(outMax), active(0), pending(false),
+      stageInvalid(false) {
+  for (uint16_t i = 0; i <= LUT_SEGMENTS; i++) {
+    uint16_t y = (uint16_t)(outMin + ((int32_t)outMax - outMin) * i /
+                                         (int32_t)LUT_SEGMENTS);
+    tables[0][i] = y;
+    tables[1][i] = y;
+  }
+}
+
+bool PedalCurve::isValid(const PedalCurveConfig &config) {
+  if (config.type >= PEDAL_CURVE_TYPE_COUNT) {
+    return false;
+  }
+  if (config.type == PEDAL_CURVE_SCURVE && config.param > 100) {
+    return false;
+  }
+  if (config.type == PEDAL_CURVE_POINTS) {
+    if (config.pointCount < 1 || config.pointCount > PEDAL_CURVE_MAX_POINTS) {
+      return false;
+    }
+    for (uint8_t i = 1; i < config.pointCount; i++) {
+      if (config.points[i].x <= config.points[i - 1].x) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+float PedalCurve::evaluate(const PedalCurveConfig &config, float t) {
+  switch (config.type) {
+  case PEDAL_CURVE_GAMMA: {
+    float gamma = (config.param == 0) ? 1.0f : config.param / 100.0f;
+    return powf(t, gamma);
+  }
+  case PEDAL_CURVE_SCURVE: {
+    float k = config.param / 100.0f;
+    float smooth = t * t * (3.0f - 2.0f * t);
+    return (1.0f - k) * t + k * smooth;
+  }
+  case PEDAL_CURVE_POINTS: {
+    const PedalCurvePoint *p = config.points;
+    uint8_t n = config.pointCount;
+    float x = t * 65535.0f;
+    // 両端の点より外側は、省略された端点 (0,0)/(65535,65535) まで補間
+    float x0 = 0.0f, y0 = 0.0f;
+    for (uint8_t i = 0; i <= n; i++) {
+      float x1 = (i < n) ? p[i].x : 65535.0f;
+      float y1 = (i < n) ? p[i].y : 65535.0f;
+      if (x <= x1) {
+        float y = (x1 > x0) ? y0 + (y1 - y0) * (x - x0) / (x1 - x0) : y1;
+        return y / 65535.0f;
+      }
+      x0 = x1;
+      y0 = y1;
+    }
+    return 1.0f;
+  }
+  case PEDAL_CURVE_LINEAR:
+  default:
+    return t;
+  }
+}
+
+bool PedalCurve::stage(const PedalCurveConfig &config) {
+  if (pending) {
+    return false;
+  }
+
+  PedalCurveConfig linear = {};
+  stageInvalid = !isValid(config);
+  const PedalCurveConfig &use = stageInvalid ? linear : config;
+
+  uint16_t *t = tables[active ^ 1];
+  float span = (float)outMax - (float)outMin;
+  for (uint16_t i = 0; i <= LUT_SEGMENTS; i++) {
+    float y = evaluate(use, (float)i / LUT_SEGMENTS);
+    if (y < 0.0f) {
+      y = 0.0f;
+    } else if (y > 1.0f) {
+      y = 1.0f;
+    }
+    t[i] = (uint16_t)lroundf(outMin + y * span);
+  }
+
+  // テーブルの書き込みを完了してから切り替えを許可する
+  __sync_synchronize();
+  pending = true;
+  return true;
+}
@@ -0,0 +1,128 @@
+/**
+ * @file TaskScheduler.cpp
+ * @brief 静的タスク表による協調スケジューラの実装
+ * @date 2026-10-18
+ */
+
+#include "TaskScheduler.h"
+#include "hot_path.h"
+#include <Arduino.h>
+
+void TaskScheduler::start() {
+  for (uint8_t i = 0; i < count; i++) {
+    const TaskEntry &task = tasks[i];
+    TaskRuntime &rt = runtime[i];
+    rt.stats.runs = 0;
+    rt.stats.overBudget = 0;
+    rt.stats.execMaxUs = 0;
+    rt.stats.lateness.reset();
+    rt.ready = false;
+    if (task.periodUs == 0) {
+      continue;
+    }
+    if (task.alarm != nullptr) {
+      task.alarm->init(task.phaseUs);
+    } else {
+      rt.trigger = IntervalTrigger_u(task.periodUs, OVERRUN_SKIP);
+      rt.trigger.init(task.phaseUs);
+    }
+  }
+  windowStartUs = micros();
+  busyUs = 0;
+}
+
+bool HOT_FUNC(TaskScheduler::runsBefore)(uint8_t a, uint8_t b) const {
+  uint32_t deadlineA = runtime[a].releaseUs + tasks[a].periodUs;
+  uint32_t deadlineB = runtime[b].releaseUs + tasks[b].periodUs;
+  int32_t diff = (int32_t)(deadlineA - deadlineB);
+  if (diff != 0) {
+    return diff < 0;
+  }
+  return tasks[a].priority > tasks[b].priority;
+}
+
+void HOT_FUNC(TaskScheduler::account)(uint8_t index, uint32_t execUs) {
+  TaskStats &stats = runtime[index].stats;
+  stats.runs++;
+  if (execUs > stats.execMaxUs) {
+    stats.execMaxUs = execUs;
+  }
+  if (tasks[index].budgetUs > 0 && execUs > tasks[index].budgetUs) {
+    stats.overBudget++;
+  }
+  busyUs += execUs;
+}
+
+void HOT_FUNC(TaskScheduler::runOnce)() {
+  // 1. 周期タスクの起動判定と、期限が最も早いタスクの選択
+  int16_t next = -1;
+  for (uint8_t i = 0; i < count; i++) {
+    const TaskEntry &task = tasks[i];
+    TaskRuntime &rt = runtime[i];
+    if (task.periodUs == 0) {
+      continue;
+    }
+    if (!rt.ready) {
+      if (task.alarm != nullptr) {
+        if (task.alarm->hasExpired()) {
+          rt.releaseUs = task.alarm->getDeadlineUs();
+          rt.ready = true;
+        }
+      } else if (rt.trigger.hasExpired()) {
+        rt.releaseUs = rt.trigger.getDeadlineUs();
+        rt.ready = true;
+      }
+    }
+    if (rt.ready && (next < 0 || runsBefore(i, (uint8_t)next))) {
+      next = i;
+    }
+  }
+
+  // 2. ポーリングタスク
+  for (uint8_t i = 0; i < count; i++) {
+    if (tasks[i].periodUs != 0) {
+      continue;
+    }
+    uint32_t startUs = micros();
+    if (tasks[i].run()) {
+      account(i, micros() - startUs);
+    }
+  }
+
+  // 3. 期限が最も早い周期タスク
+  if (next >= 0) {
+    const TaskEntry &task = tasks[next];
+    TaskRuntime &rt = runtime[next];
+    uint32_t startUs = micros();
+    rt.stats.lateness.add(startUs - rt.releaseUs);
+    task.run();
+    account((uint8_t)next, micros() - startUs);
+    rt.ready = false;
+  }
+}
+
+uint16_t TaskScheduler::takeUtilizationPermil() {
+  uint32_t now = micros();
+  uint32_t window = now - windowStartUs;
+  uint32_t permil =
+      (window > 0) ? (uint32_t)((uint64_t)busyUs * 1000 / window) : 0;
+  windowStartUs = now;
+  busyUs = 0;
+  return (uint16_t)(permil > 1000 ? 1000 : permil);
+}
+
+uint32_t TaskScheduler::getMissedCount(uint8_t index) const {
+  const TaskEntry &task = tasks[index];
+  if (task.alarm != nullptr) {
+    return task.alarm->getMissedCount();
+  }
+  return runtime[index].trigger.getMissedCount();
+}
+
+uint32_t TaskScheduler::getBudgetViolations() const {
+  uint32_t total = 0;
+  for (uint8_t i = 0; i < count; i++) {
+    total += runtime[i].stats.overBudget;
+  }
+  return total;
+}
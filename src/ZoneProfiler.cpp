@@ -0,0 +1,127 @@
+/**
+ * @file ZoneProfiler.cpp
+ * @brief 処理区間ごとの所要時間の集計の実装
+ * @date 2026-10-18
+ */
+
+#include "ZoneProfiler.h"
+#include "hot_path.h"
+
+#ifdef ZONE_PROFILER_ENABLE
+
+#include <hardware/timer.h>
+
+namespace {
+/**
+ * @brief ゾーンの定義 (名前・ヒストグラムのビン幅・予算)
+ */
+struct ZoneInfo {
+  const char *name;
+  uint16_t binUs;    ///< ビン幅 (us)
+  uint16_t budgetUs; ///< 予算 (us, 0: なし)
+};
+
+constexpr uint16_t CONTROL_US = Config::Time::EFFECT_INTERVAL_US;
+constexpr uint16_t SAMPLE_US = Config::Time::SAMPLING_INTERVAL_US;
+
+HOT_DATA(zone_info) constexpr ZoneInfo ZONE_INFO[PROFILE_ZONE_COUNT] = {
+    {"CanRx", 1, 0},
+    {"Parse", 2, 0},
+    {"Shared", 1, 0},
+    {"Effect", 4, 0},
+    {"Scale", 1, 0},
+    {"CanSend", 1, 0},
+    {"Control", 16, CONTROL_US / 2}, // 受信解析・サンプリングの余地を残す
+    {"Sample", 2, SAMPLE_US / 2},
+    {"Loop0", 16, 1000},  // HID レポート周期 (1ms)
+    {"UsbBg", 16, 1000},
+    {"PidParse", 2, 0},
+    {"HidSend", 2, 0},
+};
+
+/**
+ * @brief ゾーンの集計状態 (記録するコアのみが書き込む)
+ */
+struct ZoneData {
+  uint32_t count;
+  uint32_t overruns;
+  uint64_t sumUs;
+  uint16_t minUs;
+  uint16_t maxUs;
+  uint32_t histogram[ZoneProfiler::PROFILE_BINS];
+};
+
+ZoneData zones[PROFILE_ZONE_COUNT];
+
+void HOT_FUNC(resetZone)(ZoneData &z) {
+  z.count = 0;
+  z.overruns = 0;
+  z.sumUs = 0;
+  z.minUs = 0xFFFF;
+  z.maxUs = 0;
+  for (uint8_t i = 0; i < ZoneProfiler::PROFILE_BINS; i++) {
+    z.histogram[i] = 0;
+  }
+}
+} // namespace
+
+uint32_t HOT_FUNC(ZoneProfiler::now)() { return time_us_32(); }
+
+void HOT_FUNC(ZoneProfiler::record)(ProfileZone zone, uint32_t elapsedUs) {
+  ZoneData &z = zones[zone];
+  if (z.count == 0) {
+    resetZone(z);
+  }
+  const ZoneInfo &info = ZONE_INFO[zone];
+  uint16_t us = (uint16_t)(elapsedUs > 0xFFFF ? 0xFFFF : elapsedUs);
+  uint32_t bin = us / info.binUs;
+  z.histogram[bin < PROFILE_BINS ? bin : PROFILE_BINS - 1]++;
+  z.count++;
+  z.sumUs += us;
+  if (us < z.minUs) {
+    z.minUs = us;
+  }
+  if (us > z.maxUs) {
+    z.maxUs = us;
+  }
+  if (info.budgetUs > 0 && us > info.budgetUs) {
+    z.overruns++;
+  }
+}
+
+ZoneStats ZoneProfiler::takeStats(ProfileZone zone) {
+  ZoneData &z = zones[zone];
+  const ZoneInfo &info = ZONE_INFO[zone];
+  ZoneStats stats;
+  stats.count = z.count;
+  stats.overruns = z.overruns;
+  stats.minUs = (stats.count > 0) ? z.minUs : 0;
+  stats.maxUs = z.maxUs;
+  stats.avgUs = (stats.count > 0) ? (uint16_t)(z.sumUs / stats.count) : 0;
+  stats.budgetUs = info.budgetUs;
+
+  // 99パーセンタイル: 累積度数が 99% に達したビンの上端
+  stats.p99Us = 0;
+  if (stats.count > 0) {
+    uint32_t threshold = stats.count - stats.count / 100;
+    uint32_t cumulative = 0;
+    for (uint8_t i = 0; i < PROFILE_BINS; i++) {
+      cumulative += z.histogram[i];
+      if (cumulative >= threshold) {
+        // 範囲外をまとめた最後のビンは最大値で代表する
+        stats.p99Us = (i == PROFILE_BINS - 1)
+                          ? stats.maxUs
+                          : (uint16_t)((i + 1) * info.binUs);
+        break;
+      }
+    }
+  }
+  resetZone(z);
+  return stats;
+}
+
+const char *ZoneProfiler::getName(ProfileZone zone) {
+  return ZONE_INFO[zone].name;
+}
+
+#endif // ZONE_PROFILER_ENABLE
@@ -23,23 +23,25 @@ bool ConfigManager::begin() {
 }
 
 bool ConfigManager::saveConfig() {
+  StoredConfig config = {};
+  config.magic = StoredConfig::MAGIC;
+  config.version = StoredConfig::VERSION;
+  config.size = sizeof(StoredConfig);
+  config.steerRangeDeg = sharedData.steerRangeDeg;
+  config.accelCurve = sharedData.accelCurve;
+  config.brakeCurve = sharedData.brakeCurve;
+  config.accelCalib = sharedData.accelCalib;
+  config.brakeCalib = sharedData.brakeCalib;
+
   File file = LittleFS.open(CONFIG_FILE, "w");
   if (!file) {
     Serial.println("ConfigManager: Failed to open file for writing");
     return false;
   }
-
-  // 現在のところsharedDataにはconfig構造体がないため、将来的な拡張性を考慮しつつ
-  // 現状の主要な設定値をデモとして保存するロジック（またはプレースホルダ）
-  // ユーザーの要求どおり「shared_data.config」が存在することを想定したコードにする場合は
-  // 構造体の追加が必要。一旦、SharedData全体をバイナリとして保存する例：
-
-  // 注意:
-  // volatileポインタからの書き込み時は注意が必要だが、バイナリ一括なら可能
-  size_t written = file.write((const uint8_t *)&sharedData, sizeof(SharedData));
+  size_t written = file.write((const uint8_t *)&config, sizeof(config));
   file.close();
 
-  if (written == sizeof(SharedData)) {
+  if (written == sizeof(config)) {
     Serial.println("ConfigManager: Config saved successfully");
     return true;
   } else {
@@ -60,17 +62,25 @@ bool ConfigManager::loadConfig() {
     return false;
   }
 
-  SharedData temp;
-  size_t readLen = file.read((uint8_t *)&temp, sizeof(SharedData));
+  StoredConfig config;
+  size_t fileLen = file.size();
+  size_t readLen = file.read((uint8_t *)&config, sizeof(config));
   file.close();
 
-  if (readLen == sizeof(SharedData)) {
-    // Core1動作中ならミューテックスが必要だが、起動時想定
-    sharedData = temp;
-    Serial.println("ConfigManager: Config loaded successfully");
-    return true;
-  } else {
-    Serial.println("ConfigManager: Load failed (size mismatch)");
+  if (fileLen != sizeof(config) || readLen != sizeof(config) ||
+      config.magic != StoredConfig::MAGIC ||
+      config.version != StoredConfig::VERSION ||
+      config.size != sizeof(config)) {
+    Serial.println("ConfigManager: Unsupported config file. Using defaults.");
     return false;
   }
+
+  // 設定値のみ復元する (Core 1 の制御周期の開始前に呼ぶため排他は不要)
+  sharedData.steerRangeDeg = config.steerRangeDeg;
+  sharedData.accelCurve = config.accelCurve;
+  sharedData.brakeCurve = config.brakeCurve;
+  sharedData.accelCalib = config.accelCalib;
+  sharedData.brakeCalib = config.brakeCalib;
+  Serial.println("ConfigManager: Config loaded successfully");
+  return true;
 }
@@ -4,6 +4,7 @@
  */
 
 #include "control.h"
+#include "hot_path.h"
 
 // --- PhysicalEffect Class Implementation ---
 
@@ -11,13 +12,13 @@ PhysicalEffect::PhysicalEffect(float k_f, float k_s, float k_d, float k_i,
                                uint32_t period_us)
     : _k_friction(k_f), _k_spring(k_s), _k_damper(k_d), _k_inertia(k_i),
       _prev_angle(0.0f), _prev_velocity(0.0f), _current_output(0) {
-  _dt_sec = (float)period_us / 1000000.0f;
+  _inv_dt = 1000000.0f / (float)period_us;
 }
 
-void PhysicalEffect::update(int16_t angle) {
+void HOT_FUNC(PhysicalEffect::update)(int16_t angle) {
   float f_angle = (float)angle;
-  float velocity = (f_angle - _prev_angle) / _dt_sec;
-  float acceleration = (velocity - _prev_velocity) / _dt_sec;
+  float velocity = (f_angle - _prev_angle) * _inv_dt;
+  float acceleration = (velocity - _prev_velocity) * _inv_dt;
 
   // フリクション項: 定数 * sign(速度)
   float friction_val = 0.0f;
@@ -47,7 +48,7 @@ void PhysicalEffect::update(int16_t angle) {
   _prev_velocity = velocity;
 }
 
-int16_t PhysicalEffect::getEffect() const { return _current_output; }
+int16_t HOT_FUNC(PhysicalEffect::getEffect)() const { return _current_output; }
 
 // --- PID Class Implementation ---
 
@@ -55,6 +56,7 @@ PID::PID(float kp, float ki, float kd, uint32_t period_us, int16_t target)
     : _kp(kp), _ki(ki), _kd(kd), _target(target), _integral(0.0f),
       _prev_error(0.0f), _current_output(0) {
   _dt_sec = (float)period_us / 1000000.0f;
+  _inv_dt = 1000000.0f / (float)period_us;
 }
 
 void PID::update(int16_t current_angle) {
@@ -68,7 +70,7 @@ void PID::update(int16_t current_angle) {
   float i_term = _ki * _integral;
 
   // D項
-  float derivative = (error - _prev_error) / _dt_sec;
+  float derivative = (error - _prev_error) * _inv_dt;
   float d_term = _kd * derivative;
 
   float total_pid = p_term + i_term + d_term;
@@ -7,6 +7,7 @@
  */
 
 #include "ffb_engine.h"
+#include "hot_path.h"
 #include <Arduino.h> // micros()
 #include <math.h>    // sinf(), floorf(), M_PI
 
@@ -15,9 +16,9 @@
 // (Spring / Damper / Inertia / Friction)
 // ============================================================================
 
-int16_t ffb_calc_condition_force(const FFB_Shared_State_t &eff,
-                                 int16_t steer_hid, float vel_norm,
-                                 float accel_norm) {
+int16_t HOT_FUNC(ffb_calc_condition_force)(const FFB_Shared_State_t &eff,
+                                           int16_t steer_hid, float vel_norm,
+                                           float accel_norm) {
   // HID 座標系 (-32767..32767) → PID 座標系 (-10000..10000) へ変換
   float pos = (float)steer_hid * 10000.0f / 32767.0f;
   float force = 0.0f;
@@ -105,7 +106,7 @@ int16_t ffb_calc_condition_force(const FFB_Shared_State_t &eff,
 // (Sine / Square / Triangle / Sawtooth Up / Sawtooth Down)
 // ============================================================================
 
-int16_t ffb_calc_periodic_force(const FFB_Shared_State_t &eff) {
+int16_t HOT_FUNC(ffb_calc_periodic_force)(const FFB_Shared_State_t &eff) {
   if (eff.periodicPeriod == 0) {
     // 周期未指定の場合は DC オフセットのみ返す
     return (int16_t)eff.periodicOffset;
@@ -164,22 +165,63 @@ int16_t ffb_calc_periodic_force(const FFB_Shared_State_t &eff) {
 // FFBEngine クラス実装
 // ============================================================================
 
-FFBEngine::FFBEngine() : _prev_steer(0), _prev_vel_norm(0.0f) {}
+FFBEngine::FFBEngine(uint32_t sample_period_us)
+    : _rate_scale((float)REFERENCE_PERIOD_US / (float)sample_period_us),
+      _vel_scale(10000.0f / 32767.0f * _rate_scale), _prev_steer(0),
+      _vel_norm(0.0f), _accel_norm(0.0f), _periodic_sum(0),
+      _periodic_count(0) {}
 
 void FFBEngine::reset() {
   _prev_steer = 0;
-  _prev_vel_norm = 0.0f;
+  _vel_norm = 0.0f;
+  _accel_norm = 0.0f;
+  _periodic_sum = 0;
+  _periodic_count = 0;
 }
 
-int32_t FFBEngine::update(const FFB_Shared_State_t *effects,
-                          int16_t steer_hid) {
-  // ステアリング差分から速度・加速度を推定 (メンバ変数で状態保持)
-  float vel_norm = ((float)(steer_hid - _prev_steer)) / 32767.0f * 10000.0f;
-  float accel_norm = vel_norm - _prev_vel_norm;
+void HOT_FUNC(FFBEngine::updateMotion)(int16_t steer_hid) {
+  // ステアリング差分から速度・加速度を推定し、基準周期あたりに換算
+  float vel_norm = (float)(steer_hid - _prev_steer) * _vel_scale;
+  _accel_norm = (vel_norm - _vel_norm) * _rate_scale;
+  _vel_norm = vel_norm;
   _prev_steer = steer_hid;
-  _prev_vel_norm = vel_norm;
+}
+
+void HOT_FUNC(FFBEngine::samplePeriodic)(const FFB_Shared_State_t *effects) {
+  int32_t periodic_force = 0;
+  for (int i = 0; i < MAX_EFFECTS; i++) {
+    if (!effects[i].active)
+      continue;
+    switch (effects[i].type) {
+    case HID_ET_SINE:
+    case HID_ET_SQUARE:
+    case HID_ET_TRIANGLE:
+    case HID_ET_SAW_UP:
+    case HID_ET_SAW_DOWN:
+      periodic_force +=
+          (int32_t)ffb_calc_periodic_force(effects[i]) * effects[i].gain / 255;
+      break;
+    default:
+      break;
+    }
+  }
+  _periodic_sum += periodic_force;
+  _periodic_count++;
+}
 
-  int32_t total_force = 0;
+int32_t HOT_FUNC(FFBEngine::update)(const FFB_Shared_State_t *effects,
+                                    int16_t steer_hid) {
+  float vel_norm = _vel_norm;
+  float accel_norm = _accel_norm;
+
+  // Periodic 系: 指令周期の平均 (四捨五入)
+  samplePeriodic(effects);
+  int32_t half = _periodic_count / 2;
+  int32_t total_force =
+      (_periodic_sum + (_periodic_sum >= 0 ? half : -half)) /
+      (int32_t)_periodic_count;
+  _periodic_sum = 0;
+  _periodic_count = 0;
 
   for (int i = 0; i < MAX_EFFECTS; i++) {
     if (!effects[i].active)
@@ -200,15 +242,7 @@ int32_t FFBEngine::update(const FFB_Shared_State_t *effects,
           ffb_calc_condition_force(effects[i], steer_hid, vel_norm, accel_norm);
       break;
 
-    case HID_ET_SINE:
-    case HID_ET_SQUARE:
-    case HID_ET_TRIANGLE:
-    case HID_ET_SAW_UP:
-    case HID_ET_SAW_DOWN:
-      eff_force = ffb_calc_periodic_force(effects[i]);
-      break;
-
-    default:
+    default: // Periodic 系は samplePeriodic() で合算済み
       break;
     }
 
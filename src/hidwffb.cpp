@@ -4,7 +4,9 @@
  */
 
 #include "hidwffb.h"
+#include "ZoneProfiler.h"
 #include "hid_pid_descriptor.h" // HIDレポートディスクリプタ (USB PID仕様準拠)
+#include "hot_path.h"
 #include <stddef.h>
 #include <string.h>
 
@@ -18,6 +20,20 @@ static Adafruit_USBD_HID _usb_hid;
 static uint8_t _ffb_data[HID_FFB_REPORT_SIZE];
 static volatile bool _ffb_updated = false;
 
+// 設定レポートで受信したペダルの応答曲線 (ペダルごと, Core 0 のタスクが取得)
+static PedalCurveConfig _pedal_curve[HID_PEDAL_COUNT];
+static volatile bool _pedal_curve_updated[HID_PEDAL_COUNT] = {false};
+
+// 自動校正の操作 (SET) と状態 (GET 応答, Core 0 のタスクが更新)
+static volatile uint8_t _pedal_calib_command = 0;
+static volatile bool _pedal_calib_updated = false;
+static volatile uint8_t _pedal_calib_status = 0;
+
+// 有効角度範囲の設定 (SET) と適用値 (GET 応答, Core 0 のタスクが更新)
+static volatile uint16_t _steer_range_command = 0;
+static volatile bool _steer_range_updated = false;
+static volatile uint16_t _steer_range_status = 0;
+
 static pid_debug_info_t _pid_debug = {0, false, 0, 0, false};
 static FFB_Shared_State_t core0_ffb_effects[MAX_EFFECTS];
 static uint8_t core0_global_gain = 255;
@@ -38,7 +54,7 @@ static bool _slot_used[MAX_EFFECTS + 1] = {
  * スロットを即座に再利用できるため、長時間使用でも DIERR_DEVICEFULL が
  * 発生しにくくなる。
  */
-static uint8_t _alloc_slot() {
+static uint8_t HOT_FUNC(_alloc_slot)() {
   for (uint8_t i = 1; i <= MAX_EFFECTS; i++) {
     if (!_slot_used[i]) {
       _slot_used[i] = true;
@@ -55,7 +71,7 @@ static uint8_t _alloc_slot() {
 }
 
 /** @brief スロットを解放する */
-static void _free_slot(uint8_t idx) {
+static void HOT_FUNC(_free_slot)(uint8_t idx) {
   if (idx >= 1 && idx <= MAX_EFFECTS)
     _slot_used[idx] = false;
 }
@@ -158,6 +174,86 @@ static void _prepare_pid_pool(uint8_t *buf, uint16_t *len) {
   *len = payloadLen;
 }
 
+// ============================================================================
+// 設定レポート (ベンダー定義 Feature Report)
+// ============================================================================
+
+/**
+ * @brief Pedal Curve (0x20) の受信
+ * @param buffer レポートIDを除いたペイロード
+ * @param bufsize ペイロード長
+ */
+static void _receive_pedal_curve(uint8_t const *buffer, uint16_t bufsize) {
+  USB_Feature_PedalCurve_t rep;
+  if (bufsize < sizeof(rep) - 1) {
+    return;
+  }
+  memcpy((uint8_t *)&rep + 1, buffer, sizeof(rep) - 1);
+  if (rep.pedal >= HID_PEDAL_COUNT) {
+    return;
+  }
+  // 内容の検査は PedalCurve::stage() が行う (不正な設定は直線)
+  PedalCurveConfig &curve = _pedal_curve[rep.pedal];
+  curve.type = rep.type;
+  curve.pointCount = rep.pointCount;
+  curve.param = rep.param;
+  for (uint8_t i = 0; i < PEDAL_CURVE_MAX_POINTS; i++) {
+    curve.points[i].x = rep.points[i * 2];
+    curve.points[i].y = rep.points[i * 2 + 1];
+  }
+  _pedal_curve_updated[rep.pedal] = true;
+}
+
+/**
+ * @brief Pedal Calibration (0x21) の受信
+ * @param buffer レポートIDを除いたペイロード
+ * @param bufsize ペイロード長
+ */
+static void _receive_pedal_calib(uint8_t const *buffer, uint16_t bufsize) {
+  if (bufsize < sizeof(USB_Feature_PedalCalib_t) - 1) {
+    return;
+  }
+  _pedal_calib_command = buffer[0];
+  _pedal_calib_updated = true;
+}
+
+/**
+ * @brief Pedal Calibration (0x21) GET 応答 (自動校正の状態)
+ */
+static void _prepare_pedal_calib(uint8_t *buf, uint16_t *len) {
+  USB_Feature_PedalCalib_t resp;
+  resp.reportId = HID_ID_PEDAL_CALIB;
+  resp.mode = _pedal_calib_status;
+  memcpy(buf, (uint8_t *)&resp + 1, sizeof(resp) - 1);
+  *len = sizeof(resp) - 1;
+}
+
+/**
+ * @brief Steer Range (0x22) の受信
+ * @param buffer レポートIDを除いたペイロード
+ * @param bufsize ペイロード長
+ */
+static void _receive_steer_range(uint8_t const *buffer, uint16_t bufsize) {
+  USB_Feature_SteerRange_t rep;
+  if (bufsize < sizeof(rep) - 1) {
+    return;
+  }
+  memcpy((uint8_t *)&rep + 1, buffer, sizeof(rep) - 1);
+  _steer_range_command = rep.halfRangeDeg;
+  _steer_range_updated = true;
+}
+
+/**
+ * @brief Steer Range (0x22) GET 応答 (適用中の有効角度範囲)
+ */
+static void _prepare_steer_range(uint8_t *buf, uint16_t *len) {
+  USB_Feature_SteerRange_t resp;
+  resp.reportId = HID_ID_STEER_RANGE;
+  resp.halfRangeDeg = _steer_range_status;
+  memcpy(buf, (uint8_t *)&resp + 1, sizeof(resp) - 1);
+  *len = sizeof(resp) - 1;
+}
+
 // ============================================================================
 // Adafruit_USBD_HID コールバック (setReportCallback で登録)
 // ============================================================================
@@ -184,6 +280,12 @@ static uint16_t _hid_get_report_cb(uint8_t report_id,
   case HID_ID_PID_POOL:
     _prepare_pid_pool(buffer, &len);
     break;
+  case HID_ID_PEDAL_CALIB:
+    _prepare_pedal_calib(buffer, &len);
+    break;
+  case HID_ID_STEER_RANGE:
+    _prepare_steer_range(buffer, &len);
+    break;
   default:
     break;
   }
@@ -202,8 +304,10 @@ static uint16_t _hid_get_report_cb(uint8_t report_id,
  *   4. Host  →  Device: Output 0x05 (Set Constant Force etc.)
  *   5. Host  →  Device: Output 0x0A (Effect Operation: Start)
  */
-static void _hid_set_report_cb(uint8_t report_id, hid_report_type_t report_type,
-                               uint8_t const *buffer, uint16_t bufsize) {
+static void HOT_FUNC(_hid_set_report_cb)(uint8_t report_id,
+                                         hid_report_type_t report_type,
+                                         uint8_t const *buffer,
+                                         uint16_t bufsize) {
   // --- Feature SET: Create New Effect (0x05) ---
   // Output 0x05 (Set Constant Force) と同一IDだが、report_typeで区別する
   if (report_type == HID_REPORT_TYPE_FEATURE) {
@@ -213,6 +317,12 @@ static void _hid_set_report_cb(uint8_t report_id, hid_report_type_t report_type,
       if (_last_allocated_idx == 0) {
         _last_allocated_idx = _alloc_slot(); // 0 なら空きなし
       }
+    } else if (report_id == HID_ID_PEDAL_CURVE) {
+      _receive_pedal_curve(buffer, bufsize);
+    } else if (report_id == HID_ID_PEDAL_CALIB) {
+      _receive_pedal_calib(buffer, bufsize);
+    } else if (report_id == HID_ID_STEER_RANGE) {
+      _receive_steer_range(buffer, bufsize);
     }
     // その他のFeature SETは無視 (PID Block LoadはGET専用)
     return;
@@ -287,6 +397,60 @@ bool hidwffb_get_ffb_data(uint8_t *buffer) {
 
 void hidwffb_clear_ffb_flag(void) { _ffb_updated = false; }
 
+/**
+ * @brief 設定レポートで受信したペダルの応答曲線を取得する
+ * @param pedal HID_PEDAL_ACCEL / HID_PEDAL_BRAKE
+ * @param config 格納先
+ * @return true: 前回の取得以降に受信した
+ */
+bool hidwffb_get_pedal_curve(uint8_t pedal, PedalCurveConfig *config) {
+  if (pedal >= HID_PEDAL_COUNT || !_pedal_curve_updated[pedal])
+    return false;
+  *config = _pedal_curve[pedal];
+  _pedal_curve_updated[pedal] = false;
+  return true;
+}
+
+/**
+ * @brief 設定レポートで受信した自動校正の操作を取得する
+ * @param mode 格納先 (PEDAL_CALIB_RUN / PEDAL_CALIB_FINISH を想定)
+ * @return true: 前回の取得以降に受信した
+ */
+bool hidwffb_get_pedal_calib_command(uint8_t *mode) {
+  if (!_pedal_calib_updated)
+    return false;
+  *mode = _pedal_calib_command;
+  _pedal_calib_updated = false;
+  return true;
+}
+
+/**
+ * @brief GET Feature (Pedal Calibration) で返す自動校正の状態を設定する
+ */
+void hidwffb_set_pedal_calib_status(uint8_t mode) {
+  _pedal_calib_status = mode;
+}
+
+/**
+ * @brief 設定レポートで受信した有効角度範囲を取得する
+ * @param halfRangeDeg 格納先 (センターからの片側角度, 丸める前の値)
+ * @return true: 前回の取得以降に受信した
+ */
+bool hidwffb_get_steer_range(uint16_t *halfRangeDeg) {
+  if (!_steer_range_updated)
+    return false;
+  *halfRangeDeg = _steer_range_command;
+  _steer_range_updated = false;
+  return true;
+}
+
+/**
+ * @brief GET Feature (Steer Range) で返す有効角度範囲を設定する
+ */
+void hidwffb_set_steer_range_status(uint16_t halfRangeDeg) {
+  _steer_range_status = halfRangeDeg;
+}
+
 // ============================================================================
 // PID レポートパーサ
 // ============================================================================
@@ -304,7 +468,8 @@ static void print_raw_report_data(uint8_t const *buffer, uint16_t bufsize) {
 }
 #endif
 
-void PID_ParseReport(uint8_t const *buffer, uint16_t bufsize) {
+void HOT_FUNC(PID_ParseReport)(uint8_t const *buffer, uint16_t bufsize) {
+  PROFILE_SCOPE(PROFILE_PID_PARSE);
   if (buffer == NULL || bufsize == 0)
     return;
 
@@ -450,7 +615,7 @@ void PID_ParseReport(uint8_t const *buffer, uint16_t bufsize) {
   }
 }
 
-bool hidwffb_get_pid_debug_info(pid_debug_info_t *info) {
+bool HOT_FUNC(hidwffb_get_pid_debug_info)(pid_debug_info_t *info) {
   if (!_pid_debug.updated)
     return false;
   if (info != NULL) {
@@ -470,7 +635,7 @@ mutex_t ffb_shared_mutex;
 
 void ffb_shared_memory_init() { mutex_init(&ffb_shared_mutex); }
 
-void ffb_core0_update_shared(pid_debug_info_t *info) {
+void HOT_FUNC(ffb_core0_update_shared)(pid_debug_info_t *info) {
   if (mutex_enter_timeout_ms(&ffb_shared_mutex, 1)) {
     for (int i = 0; i < MAX_EFFECTS; i++) {
       shared_ffb_effects[i] = core0_ffb_effects[i];
@@ -483,8 +648,8 @@ void ffb_core0_update_shared(pid_debug_info_t *info) {
   }
 }
 
-void ffb_core1_update_shared(custom_gamepad_report_t *new_input,
-                             FFB_Shared_State_t *local_effects_dest) {
+void HOT_FUNC(ffb_core1_update_shared)(custom_gamepad_report_t *new_input,
+                                       FFB_Shared_State_t *local_effects_dest) {
   if (mutex_enter_timeout_ms(&ffb_shared_mutex, 1)) {
     shared_input_report = *new_input;
     for (int i = 0; i < MAX_EFFECTS; i++) {
@@ -515,7 +680,7 @@ void hidwffb_loopback_test_sync(custom_gamepad_report_t *new_input,
 #endif
 }
 
-void ffb_core0_get_input_report(custom_gamepad_report_t *dest) {
+void HOT_FUNC(ffb_core0_get_input_report)(custom_gamepad_report_t *dest) {
   if (mutex_enter_timeout_ms(&ffb_shared_mutex, 1)) {
     *dest = shared_input_report;
     mutex_exit(&ffb_shared_mutex);
@@ -4,18 +4,27 @@
  */
 
 #include "ADInput.h"
+#include "AlarmTrigger.h"
 #include "DigitalInput.h"
 #include "Ene1HandCont_IO.h"
+#include "DMASPITransport.h"
+#include "MCP2515_Driver.h"
 #include "MCP2515_Wrapper.h"
 #include "MF4015_Driver.h"
+#include "MotorGroup.h"
+#include "SimulatedMotorBus.h"
+#include "TaskScheduler.h"
+#include "ZoneProfiler.h"
 #include "config.h"
 #include "config_manager.h"
 #include "control.h"
 #include "ffb_engine.h"
+#include "hot_path.h"
 #include "shared_data.h"
 #include "util.h"
 #include <Adafruit_TinyUSB.h>
 #include <Arduino.h>
+#include <hardware/sync.h>
 
 // ============================================================================
 // グローバルインスタンス
@@ -24,14 +33,28 @@
 // 共有データの実体
 SharedData sharedData = {0};
 
-// CANバスラッパー (MCP2515固有の実装を内包)
+#if defined(CAN_BACKEND_SIM)
+// モーター・ハンドルの模擬 (実機なしで制御ロジックを閉ループ動作させる)
+SimulatedMotorBus canWrapper(Config::Steer::CAN_ID);
+#elif defined(CAN_BACKEND_AUTOWP)
+// CANバスラッパー (autowpライブラリ経由の実装)
 MCP2515_Wrapper canWrapper(Config::Pin::CAN_CS, Config::Pin::SPI_SCK,
                            Config::Pin::SPI_TX, Config::Pin::SPI_RX,
                            Config::Pin::SPI_INT);
+#else
+// CANバスドライバ (MCP2515ネイティブ実装, 高速命令 + DMA転送)
+DMASPITransport canSpi(Config::Pin::CAN_CS, Config::Pin::SPI_SCK,
+                       Config::Pin::SPI_TX, Config::Pin::SPI_RX,
+                       Config::Can::SPI_CLOCK_HZ);
+MCP2515_Driver canWrapper(&canSpi, Config::Pin::SPI_INT);
+#endif
 
 // MF4015モータードライバ (抽象インターフェースに依存)
 MF4015_Driver mfMotor(&canWrapper, Config::Steer::CAN_ID);
 
+// モーター群 (トルク指令の一括送信・応答の振り分け, 最大4台)
+MotorGroup motors(&canWrapper);
+
 // mf4015.cpp (旧コードとの互換用) で使用する extern ポインタも一応紐付けておく
 extern CANInterface *canBus;
 
@@ -39,24 +62,115 @@ extern CANInterface *canBus;
 extern volatile uint8_t shared_global_gain;
 
 // --- 周期管理 ---
-static IntervalTrigger_m hidReportTrigger(Config::Time::HIDREPO_INTERVAL_MS);
-static IntervalTrigger_u stearContTrigger(Config::Time::STEAR_CONT_INTERVAL_US);
-static IntervalTrigger_u sampleTrigger(Config::Time::SAMPLING_INTERVAL_US);
+#ifndef TICK_SOFTWARE_TIMER
+// Core 1 の制御周期・サンプリング周期はハードウェアアラームで刻む
+// (割り込みは Core 1 で処理, TICK_SOFTWARE_TIMER で micros() 判定に戻す)
+// 制御周期はエフェクト演算周期 (基本周期の EFFECT_RATE_MULTIPLIER 分の1)
+static AlarmTrigger stearContTrigger(Config::Time::EFFECT_INTERVAL_US);
+static AlarmTrigger sampleTrigger(Config::Time::SAMPLING_INTERVAL_US);
+#define CORE1_TICK_ALARM(trigger) (&(trigger))
+#else
+#define CORE1_TICK_ALARM(trigger) nullptr
+#endif // TICK_SOFTWARE_TIMER
 
 // --- Core間通信用 (hidwffb.h に実体があるが main.cpp でも管理が必要なフラグ等)
 // ---
 static custom_gamepad_report_t core1_input_report = {0};
 static FFB_Shared_State_t core1_effects[MAX_EFFECTS];
 
-// --- FFB 演算エンジン (Core 1 で使用) ---
-static FFBEngine ffbEngine;
+// --- ペダル応答曲線の反映済み変更番号 (Core 0 で使用) ---
+static uint8_t pedalCurveSeq = 0;
+
+// --- トルク指令を送信した周期の開始時刻 (パイプライン時間計測用) ---
+static uint32_t torqueCmdStartUs = 0;
 
-// --- 物理エフェクト (Core 1 で使用) ---
+// --- FFB 演算エンジン (Core 1 で使用, 速度推定は角度の取得周期) ---
+static FFBEngine ffbEngine(Config::Time::TORQUE_CMD_INTERVAL_US);
+
+// --- 物理エフェクト (Core 1 で使用, 角度の取得周期で更新) ---
 static PhysicalEffect steerEffect(Config::Steer::FRICTION_COEFF,
                                   Config::Steer::SPRING_COEFF,
                                   Config::Steer::DAMPER_COEFF,
                                   Config::Steer::INERTIA_COEFF,
-                                  Config::Time::STEAR_CONT_INTERVAL_US);
+                                  Config::Time::TORQUE_CMD_INTERVAL_US);
+
+// --- エフェクト演算・トルク指令の分周 ---
+// 基本周期ごとの処理 (共有メモリとの交換) を行う演算回数の間隔
+static constexpr uint32_t BASE_TICK_DIVIDER =
+    Config::Time::EFFECT_RATE_MULTIPLIER;
+// トルク指令1回あたりの演算回数 (間の演算は Periodic 系の平均に使う)
+static constexpr uint32_t TORQUE_CMD_DIVIDER =
+    Config::Time::TORQUE_CMD_INTERVAL_US / Config::Time::EFFECT_INTERVAL_US;
+
+// ============================================================================
+// タスク表 (コアごとに期限順で実行, TaskScheduler.h 参照)
+// ============================================================================
+// --- Core 0 ---
+static bool taskHidReport();
+static bool taskCore0Stats();
+static bool taskPidUpdate();
+static bool taskPedalCurve();
+static bool taskPedalCalib();
+static bool taskSteerRange();
+static bool taskConfigSave();
+// --- Core 1 ---
+static bool taskCanRx();
+static bool taskControl();
+static bool taskSample();
+static bool taskLinkStats();
+#ifdef ZONE_PROFILER_ENABLE
+static bool taskZoneStats0();
+static bool taskZoneStats1();
+#endif
+#ifdef PHYSICAL_INPUT_DEBUG_ENABLE
+static bool taskDebugPrint();
+#endif
+
+static constexpr uint32_t HID_REPORT_US =
+    Config::Time::HIDREPO_INTERVAL_MS * 1000;
+static constexpr uint32_t CONTROL_US = Config::Time::EFFECT_INTERVAL_US;
+static constexpr uint32_t SAMPLE_US = Config::Time::SAMPLING_INTERVAL_US;
+static constexpr uint32_t STATS_US = Config::Can::BUS_LOAD_WINDOW_MS * 1000;
+static constexpr uint32_t ZONE_STATS_US = 1000000; // ゾーン計測の集計区間
+
+// {名前, 処理, 周期, 位相, 優先度, 予算, アラーム} (周期 0 はポーリング)
+HOT_DATA(core0_tasks) static constexpr TaskEntry core0Tasks[] = {
+    {"HidReport", taskHidReport, HID_REPORT_US, 0, 1, 100, nullptr},
+    {"Stats0", taskCore0Stats, STATS_US, 0, 0, 50, nullptr},
+    {"PidUpdate", taskPidUpdate, 0, 0, 0, 200, nullptr},
+    {"PedalCurve", taskPedalCurve, 0, 0, 0, 0, nullptr}, // LUT 作成 (float)
+    {"PedalCalib", taskPedalCalib, 0, 0, 0, 50, nullptr},
+    {"SteerRange", taskSteerRange, 0, 0, 0, 50, nullptr},
+    {"ConfigSave", taskConfigSave, 0, 0, 0, 0, nullptr}, // フラッシュ書き込み
+#ifdef ZONE_PROFILER_ENABLE
+    {"Zones0", taskZoneStats0, ZONE_STATS_US, 0, 0, 100, nullptr},
+#endif
+};
+
+// サンプリングは制御周期と重ならないよう半周期ずらす
+HOT_DATA(core1_tasks) static constexpr TaskEntry core1Tasks[] = {
+    {"CanRx", taskCanRx, 0, 0, 0, 200, nullptr},
+    {"Control", taskControl, CONTROL_US, 0, 3, CONTROL_US / 2,
+     CORE1_TICK_ALARM(stearContTrigger)},
+    {"Sample", taskSample, SAMPLE_US, SAMPLE_US / 2, 2, SAMPLE_US / 2,
+     CORE1_TICK_ALARM(sampleTrigger)},
+    {"LinkStats", taskLinkStats, STATS_US, STATS_US / 2, 1, 100, nullptr},
+#ifdef ZONE_PROFILER_ENABLE
+    {"Zones1", taskZoneStats1, ZONE_STATS_US, 0, 0, 100, nullptr},
+#endif
+#ifdef PHYSICAL_INPUT_DEBUG_ENABLE
+    {"Debug", taskDebugPrint, 1000000, 0, 0, 0, nullptr}, // シリアル出力
+#endif
+};
+// 開始遅れを共有メモリへ書き出すタスク
+static constexpr uint8_t CONTROL_TASK = 1;
+static constexpr uint8_t SAMPLE_TASK = 2;
+static_assert(core1Tasks[CONTROL_TASK].run == taskControl &&
+                  core1Tasks[SAMPLE_TASK].run == taskSample,
+              "CONTROL_TASK/SAMPLE_TASK must match core1Tasks");
+
+static StaticTaskScheduler core0Scheduler(core0Tasks);
+static StaticTaskScheduler core1Scheduler(core1Tasks);
 
 void setup() {
   // Serial.begin(Config::SERIAL_BAUDRATE);
@@ -65,6 +179,9 @@ void setup() {
   if (ConfigManager::begin()) {
     ConfigManager::loadConfig();
   }
+  // 保存されていたペダル応答曲線の LUT を作成 (Core 1 が周期の境目で反映)
+  stagePedalCurves(sharedData.accelCurve, sharedData.brakeCurve);
+  pedalCurveSeq = sharedData.pedalCurveSeq;
 
   // HIDモジュールの初期化
   hidwffb_begin(Config::Time::USB_POLL_INTERVAL_MS);
@@ -72,39 +189,213 @@ void setup() {
   // 共有メモリ・ミューテックスの初期化
   ffb_shared_memory_init();
 
-  hidReportTrigger.init();
+  core0Scheduler.start();
   Serial.println("Core 0: System Initialized (USB/Setup)");
 }
 
+// ============================================================================
+// Core 0 タスク
+// ============================================================================
+
 /**
- * @brief Core 0 ループ
- *
- * USB HID通信の維持と、ホストからのFFBパケット解析を行う
+ * @brief HIDレポート送信 (HIDREPO_INTERVAL_MS ms周期)
  */
+static bool HOT_FUNC(taskHidReport)() {
+  if (hidwffb_ready()) { // HID送信バッファが空いている場合
+    PROFILE_SCOPE(PROFILE_HID_SEND);
+    custom_gamepad_report_t report = {0};
+    ffb_core0_get_input_report(&report); // 共有メモリから入力を取得
+    hidwffb_send_report(&report);        // HID送信
+  }
+  return true;
+}
 
-void loop() {
-  // 1. HIDレポート送信 (HIDREPO_INTERVAL_MS ms周期)
-  if (hidReportTrigger.hasExpired()) {
-    if (hidwffb_ready()) { // HID送信バッファが空いている場合
-      custom_gamepad_report_t report = {0};
-      ffb_core0_get_input_report(&report); // 共有メモリから入力を取得
-      hidwffb_send_report(&report);        // HID送信
-    }
+#ifdef ZONE_PROFILER_ENABLE
+/**
+ * @brief ゾーン [first, last) の集計を共有メモリへ書き出してリセットする
+ *
+ * ゾーンを記録するコアから呼ぶ。
+ */
+static void publishZones(uint8_t first, uint8_t last) {
+  for (uint8_t i = first; i < last; i++) {
+    ZoneStats zs = ZoneProfiler::takeStats((ProfileZone)i);
+    volatile ZoneStats &out = sharedData.zoneStats[i];
+    out.count = zs.count;
+    out.overruns = zs.overruns;
+    out.minUs = zs.minUs;
+    out.avgUs = zs.avgUs;
+    out.maxUs = zs.maxUs;
+    out.p99Us = zs.p99Us;
+    out.budgetUs = zs.budgetUs;
   }
+}
+
+/**
+ * @brief Core 0 のゾーンの集計を共有メモリへ (ZONE_STATS_US 周期)
+ */
+static bool taskZoneStats0() {
+  publishZones(PROFILE_CORE0_FIRST, PROFILE_ZONE_COUNT);
+  return true;
+}
 
-  // 2. PID 解析結果の共有 (FFB受信時)
+/**
+ * @brief Core 1 のゾーンの集計を共有メモリへ (ZONE_STATS_US 周期)
+ */
+static bool taskZoneStats1() {
+  publishZones(0, PROFILE_CORE0_FIRST);
+  return true;
+}
+#endif // ZONE_PROFILER_ENABLE
+
+/**
+ * @brief Core 0 の CPU 利用率・予算超過を共有メモリへ (BUS_LOAD_WINDOW_MS 周期)
+ */
+static bool taskCore0Stats() {
+  sharedData.core0Load.utilPermil = core0Scheduler.takeUtilizationPermil();
+  sharedData.core0Load.budgetViolations = core0Scheduler.getBudgetViolations();
+  return true;
+}
+
+/**
+ * @brief PID 解析結果の共有 (FFB受信時)
+ */
+static bool HOT_FUNC(taskPidUpdate)() {
   pid_debug_info_t pid_info;
-  if (hidwffb_get_pid_debug_info(&pid_info)) {
+  if (!hidwffb_get_pid_debug_info(&pid_info)) {
+    return false;
+  }
 #ifdef FFB_DEBUG_ENABLE
-    Serial.printf(
-        "[FFB] ID:0x%02X Idx:%2d Mag:%6d Op:%d Gain:%3d Active:%d CF:%d\n",
-        pid_info.lastReportId, pid_info.effectBlockIndex, pid_info.magnitude,
-        pid_info.operation, pid_info.deviceGain, pid_info.active ? 1 : 0,
-        pid_info.isConstantForce ? 1 : 0);
+  Serial.printf(
+      "[FFB] ID:0x%02X Idx:%2d Mag:%6d Op:%d Gain:%3d Active:%d CF:%d\n",
+      pid_info.lastReportId, pid_info.effectBlockIndex, pid_info.magnitude,
+      pid_info.operation, pid_info.deviceGain, pid_info.active ? 1 : 0,
+      pid_info.isConstantForce ? 1 : 0);
 #endif
-    // 解析結果（Gain, Magnitude等）を共有メモリへ
-    ffb_core0_update_shared(&pid_info);
+  // 解析結果（Gain, Magnitude等）を共有メモリへ
+  ffb_core0_update_shared(&pid_info);
+  return true;
+}
+
+/**
+ * @brief ペダル応答曲線の変更 (LUT の作成は Core 0、切り替えは Core 1)
+ *
+ * ホストからの設定 (Pedal Curve Feature Report) は共有メモリへ書き込み、
+ * 変更番号を進めて保存を要求する。
+ */
+static bool taskPedalCurve() {
+  PedalCurveConfig hostCurve;
+  if (hidwffb_get_pedal_curve(HID_PEDAL_ACCEL, &hostCurve)) {
+    sharedData.accelCurve = hostCurve;
+    sharedData.pedalCurveSeq++;
+    sharedData.configSaveRequest = true;
+  }
+  if (hidwffb_get_pedal_curve(HID_PEDAL_BRAKE, &hostCurve)) {
+    sharedData.brakeCurve = hostCurve;
+    sharedData.pedalCurveSeq++;
+    sharedData.configSaveRequest = true;
+  }
+
+  uint8_t curveSeq = sharedData.pedalCurveSeq;
+  if (curveSeq == pedalCurveSeq ||
+      !stagePedalCurves(sharedData.accelCurve, sharedData.brakeCurve)) {
+    return false;
+  }
+  pedalCurveSeq = curveSeq;
+  return true;
+}
+
+/**
+ * @brief ホストからの自動校正の操作 (Pedal Calibration Feature Report)
+ *
+ * 観測の開始は校正していないとき、終了は観測中のときのみ受け付ける
+ * (Core 1 が状態を書き換える FINISH の処理中には書き込まない)。
+ */
+static bool taskPedalCalib() {
+  uint8_t mode = sharedData.pedalCalibMode;
+  hidwffb_set_pedal_calib_status(mode);
+  uint8_t command;
+  if (!hidwffb_get_pedal_calib_command(&command)) {
+    return false;
+  }
+  if (command == PEDAL_CALIB_RUN &&
+      (mode == PEDAL_CALIB_IDLE || mode == PEDAL_CALIB_FAILED)) {
+    sharedData.pedalCalibMode = PEDAL_CALIB_RUN;
+  } else if (command == PEDAL_CALIB_FINISH && mode == PEDAL_CALIB_RUN) {
+    sharedData.pedalCalibMode = PEDAL_CALIB_FINISH;
+  }
+  return true;
+}
+
+/**
+ * @brief ホストからの有効角度範囲の変更 (Steer Range Feature Report)
+ *
+ * 範囲外の値は丸めてから共有メモリへ書き込み、保存を要求する
+ * (Core 1 が次の制御周期で MF4015_Driver::setAngleRange() に反映する)。
+ * GET には Core 1 が書き戻した適用中の値を返す。
+ */
+static bool taskSteerRange() {
+  hidwffb_set_steer_range_status(sharedData.steerRangeDeg);
+  uint16_t halfRangeDeg;
+  if (!hidwffb_get_steer_range(&halfRangeDeg)) {
+    return false;
+  }
+  if (halfRangeDeg < Config::Steer::ANGLE_RANGE_DEG_MIN) {
+    halfRangeDeg = Config::Steer::ANGLE_RANGE_DEG_MIN;
+  } else if (halfRangeDeg > Config::Steer::ANGLE_RANGE_DEG_MAX) {
+    halfRangeDeg = Config::Steer::ANGLE_RANGE_DEG_MAX;
   }
+  sharedData.steerRangeDeg = halfRangeDeg;
+  hidwffb_set_steer_range_status(halfRangeDeg);
+  sharedData.configSaveRequest = true;
+  return true;
+}
+
+/**
+ * @brief 設定の保存要求 (自動校正の完了時など)
+ *
+ * フラッシュの書き込み中は Core 1 が止まり、モーターは最後のトルクを
+ * 出し続けるため、Core 1 にトルク 0 を送らせてから書き込む。
+ */
+static bool taskConfigSave() {
+  static uint8_t holdSeq = 0;
+  if (!sharedData.configSaveRequest) {
+    return false;
+  }
+  if (sharedData.torqueHoldSeq == 0) {
+    holdSeq = (uint8_t)(holdSeq == 0xFF ? 1 : holdSeq + 1);
+    sharedData.torqueHoldSeq = holdSeq;
+  }
+  if (sharedData.torqueHeldSeq != holdSeq) {
+    return false; // トルク 0 の送信待ち
+  }
+  sharedData.configSaveRequest = false;
+  // Core 1 が要求の前に書き込んだ校正値を読む
+  __dmb();
+  ConfigManager::saveConfig();
+  sharedData.torqueHoldSeq = 0;
+  return true;
+}
+
+/**
+ * @brief Core 0 ループ
+ *
+ * USB HID通信の維持と、ホストからのFFBパケット解析を行う
+ * (core0Tasks のタスクを期限順に実行)
+ */
+void HOT_FUNC(loop)() {
+#ifdef ZONE_PROFILER_ENABLE
+  // 前回の loop() の終了からの時間 = loop() の外 (USB スタックなど)
+  static uint32_t loopEndUs = ZoneProfiler::now();
+  uint32_t loopStartUs = ZoneProfiler::now();
+  ZoneProfiler::record(PROFILE_USB_BG, loopStartUs - loopEndUs);
+#endif // ZONE_PROFILER_ENABLE
+
+  core0Scheduler.runOnce();
+
+#ifdef ZONE_PROFILER_ENABLE
+  loopEndUs = ZoneProfiler::now();
+  ZoneProfiler::record(PROFILE_LOOP0, loopEndUs - loopStartUs);
+#endif // ZONE_PROFILER_ENABLE
 }
 
 // ============================================================================
@@ -121,7 +412,8 @@ void loop() {
  * @param deviceGain グローバルゲイン (0..255)
  * @return           モーター指令値 (TORQUE_MIN..TORQUE_MAX)
  */
-static int16_t scaleMagnitudeToTorque(int16_t magnitude, uint8_t deviceGain) {
+static int16_t HOT_FUNC(scaleMagnitudeToTorque)(int16_t magnitude,
+                                                uint8_t deviceGain) {
   static constexpr int32_t MAG_MAX = 10000; // DirectInput 慣習値
   // ±MAG_MAX にクランプ
   int32_t clamped = (int32_t)magnitude;
@@ -137,27 +429,16 @@ static int16_t scaleMagnitudeToTorque(int16_t magnitude, uint8_t deviceGain) {
 }
 
 /**
- * @brief ステアリングエンコーダ値を HID X軸のフルレンジにスケーリングする
- *
- * MF4015 の生値（ANGLE_MIN～ANGLE_MAX）を
- * DirectInput の X軸全レンジ（-32767～+32767）にマップする。
- * 整数除算による桁落ちを防ぎ、float で演算してから四捨五入する。
- *
- * @param steerRaw  getSteerValue() の戻り値（ANGLE_MIN..ANGLE_MAX）
- * @return          HID X軸の値（-32767..+32767）
+ * @brief 開始遅れの集計値を共有メモリへ書き出し、次の集計区間を始める
  */
-static int16_t scaleSteerToHid(int16_t steerRaw) {
-  static constexpr int32_t HID_MAX = 32767; // DirectInput X軸全レンジ
-  // クランプ
-  int32_t clamped = (int32_t)steerRaw;
-  if (clamped > Config::Steer::ANGLE_MAX)
-    clamped = Config::Steer::ANGLE_MAX;
-  if (clamped < Config::Steer::ANGLE_MIN)
-    clamped = Config::Steer::ANGLE_MIN;
-  // float でスケーリング（桁落ち防止）、符号を考慮した四捨五入
-  float scaled =
-      (float)clamped * (float)HID_MAX / (float)Config::Steer::ANGLE_MAX;
-  return (int16_t)(scaled + (scaled >= 0.0f ? 0.5f : -0.5f));
+static void publishJitter(TickJitter &out, uint8_t task) {
+  auto clamp16 = [](uint32_t v) { return (uint16_t)(v > 0xFFFF ? 0xFFFF : v); };
+  LatenessStats &stats = core1Scheduler.getStats(task).lateness;
+  out.lateMinUs = clamp16(stats.getMinUs());
+  out.lateAvgUs = clamp16(stats.getAvgUs());
+  out.lateMaxUs = clamp16(stats.getMaxUs());
+  out.missed = core1Scheduler.getMissedCount(task);
+  stats.reset();
 }
 
 void setup1() {
@@ -170,13 +451,65 @@ void setup1() {
   // IOの初期化
   diKeyUp.Init();
   diKeyDown.Init();
+  buttonBox.Init();
   adAccel.Init();
   adBrake.Init();
-  sampleTrigger.init();
+  if (Config::Adc::ACCEL_ONE_EURO) {
+    adAccel.setOneEuro(Config::Adc::ONE_EURO_MIN_CUTOFF_HZ,
+                       Config::Adc::ONE_EURO_BETA,
+                       Config::Adc::ONE_EURO_DCUTOFF_HZ,
+                       Config::Adc::FILTER_SAMPLE_RATE_HZ);
+  }
+  if (Config::Adc::BRAKE_ONE_EURO) {
+    adBrake.setOneEuro(Config::Adc::ONE_EURO_MIN_CUTOFF_HZ,
+                       Config::Adc::ONE_EURO_BETA,
+                       Config::Adc::ONE_EURO_DCUTOFF_HZ,
+                       Config::Adc::FILTER_SAMPLE_RATE_HZ);
+  }
+  // アクセル・ブレーキは DMA で連続変換 (以降 analogRead() は使用しない)
+  adcSampler.attach(&adAccel);
+  adcSampler.attach(&adBrake);
+  if (!adcSampler.begin()) {
+    Serial.println("Core 1: ADC DMA sampler start FAILED");
+  }
+
+  // 登録できるモーター数はビットレートで決まるため、先に設定する
+  canWrapper.setBitrate(Config::Can::BITRATE);
+
+  // モーターの登録 (モーターを追加する場合はここで addMotor() する)
+  // (台数は Config::Steer::MOTOR_COUNT と合わせる: トルク指令周期の検査に使う)
+  if (!motors.addMotor(&mfMotor)) {
+    Serial.printf("Core 1: Motor 0x%03lX NOT added (ID or bus budget)\n",
+                  (unsigned long)mfMotor.getCanId());
+  }
+  if (motors.size() != Config::Steer::MOTOR_COUNT) {
+    Serial.printf("Core 1: %u motors added, Config::Steer::MOTOR_COUNT is %u\n",
+                  motors.size(), Config::Steer::MOTOR_COUNT);
+  }
+  // 有効角度範囲: 未設定 (0) なら既定値を共有メモリへ
+  if (sharedData.steerRangeDeg == 0) {
+    sharedData.steerRangeDeg = mfMotor.getAngleRange();
+  }
+
+  // 受信フィルタ: モーターの応答ID以外は MCP2515 内で破棄する
+  CANFilter canFilters[MotorGroup::MAX_MOTORS];
+  uint8_t filterCount =
+      motors.getRxFilters(canFilters, MotorGroup::MAX_MOTORS);
+  canWrapper.setFilters(canFilters, filterCount);
 
   // CAN通信開始
   if (canWrapper.begin()) {
-    Serial.println("Core 1: CAN Initialized");
+    Serial.printf("Core 1: CAN Initialized (%lu bps)\n",
+                  (unsigned long)canWrapper.getBitrate());
+    // 設定したビットレートでモーターが応答するか確認
+    if (mfMotor.probe(Config::Can::MOTOR_PROBE_TIMEOUT_MS)) {
+      Serial.println("Core 1: Motor responded");
+    } else {
+      Serial.printf("Core 1: Motor 0x%03lX NOT responding. "
+                    "Check the motor bitrate (expected %lu bps)\n",
+                    (unsigned long)Config::Steer::CAN_ID,
+                    (unsigned long)Config::Can::BITRATE);
+    }
     // モーターを有効化
     mfMotor.enable();
   } else {
@@ -205,33 +538,40 @@ void setup1() {
       break;
     }
   }
-  stearContTrigger.init();
+  // 周期タスクの開始 (アラームの割り込みは Core 1 で処理)
+  core1Scheduler.start();
   sharedData.lastCore1Micros = micros();
   Serial.println("Core 1: Control Loop Started");
 }
 
+// ============================================================================
+// Core 1 タスク
+// ============================================================================
+
 /**
- * @brief Core 1 ループ (1000us周期)
+ * @brief CAN受信処理 (ポーリング)
  *
- * センサー値の読み取り、CANメッセージの受信解析、
- * および目標トルクに基づくモーター制御指令の送出を行う。
- * 非ブロッキングでCANバッファを監視しつつ、高精度な周期実行を行う。
+ * MCP2515 INT割り込みで受信済みのフレームを一括処理する。
+ * setTorque()の応答でMF4015から角位置付きデータが返ってくる。
+ * CAN受信はINT割り込みでリングバッファに蓄積済みのため、
+ * 溜まったフレームをまとめて解析するだけで済む。
  */
-void loop1() {
-  // 1. INT検出トリガ (MCP2515 受信完了イベント)
-  //    setTorque()の応答でMF4015から角位置付きデータが返ってくる
-  if (canWrapper.available()) {
-    uint32_t id;
-    uint8_t len;
-    uint8_t data[8];
-    if (canWrapper.readFrame(id, len, data)) {
+static bool HOT_FUNC(taskCanRx)() {
+  CANFrame rxFrames[Config::Can::RX_BATCH_SIZE];
+  PROFILE_BEGIN(PROFILE_CAN_RX);
+  uint8_t rxCount = canWrapper.readFrames(rxFrames, Config::Can::RX_BATCH_SIZE);
+  if (rxCount > 0) {
+    PROFILE_END(PROFILE_CAN_RX);
+    PROFILE_SCOPE(PROFILE_PARSE);
+    uint32_t rxStartUs = micros();
+    for (uint8_t i = 0; i < rxCount; i++) {
       // パース（角位置含むステータス更新）
-      mfMotor.parseFrame(id, len, data);
+      motors.parseFrame(rxFrames[i]);
     }
 
-    // 角位置取得（parseFrameで更新済み）、ANGLE_MIN～ANGLE_MAX → ±32767
-    // にスケーリング
-    core1_input_report.steer = scaleSteerToHid(mfMotor.getSteerValue());
+    // 角位置取得（parseFrameで更新済み）、有効角度範囲 → ±32767
+    // にスケーリング (固定小数点の逆数を乗算)
+    core1_input_report.steer = mfMotor.getSteerHidValue();
 
     // AD変換値・スイッチ入力の最新値（フィルタ処理済み）を取得
     core1_input_report.accel = (int16_t)adAccel.getvalue();
@@ -242,59 +582,283 @@ void loop1() {
       btnMask |= (1 << 0);
     if (diKeyDown.getState() == LOW)
       btnMask |= (1 << 1);
+    btnMask |= (uint16_t)(buttonBox.getPressedMask()
+                          << Config::Hid::PADDLE_COUNT);
+    // 変化したパドルのエッジからレポート反映までの遅延を記録
+    uint16_t btnChanged = (btnMask ^ core1_input_report.buttons) & 0x3;
+    if (btnChanged != 0) {
+      const DigitalInputChannel &changed =
+          (btnChanged & (1 << 0)) ? diKeyUp : diKeyDown;
+      uint32_t latencyUs = micros() - changed.getLastEdgeUs();
+      sharedData.buttonLatencyUs =
+          (uint16_t)(latencyUs > 0xFFFF ? 0xFFFF : latencyUs);
+    }
     core1_input_report.buttons = btnMask;
 
-    // トルク補正用の物理量計算
-    steerEffect.update(core1_input_report.steer);
+    // トルク補正用の物理量計算 (トルク指令の応答で角度を取得した場合のみ,
+    // 指令周期で推定。周期の途中に届く状態要求の応答は使わない)
+    if (mfMotor.checkTorqueReplyUpdated()) {
+      steerEffect.update(core1_input_report.steer);
+      ffbEngine.updateMotion(core1_input_report.steer);
+    }
+    sharedData.tickTiming.rxParseUs = (uint16_t)(micros() - rxStartUs);
   }
 
-  // 2. ステアリング制御タイマートリガ (1000us周期)
-  //    トルク指令送信 → CAN送信 → MF4015が応答 → INT発生
-  if (stearContTrigger.hasExpired()) {
-    sharedData.lastCore1Micros = micros();
+  // 状態要求 (0x9A/0x9C/0x92) はトルク指令の応答後、次の周期までに
+  // 往復が収まる場合のみ送信する (トルク指令は遅らせない)
+  bool polled = motors.servicePolls(
+      micros(), torqueCmdStartUs + Config::Time::TORQUE_CMD_INTERVAL_US);
+  return rxCount > 0 || polled;
+}
+
+/**
+ * @brief ステアリング制御 (EFFECT_INTERVAL_US 周期)
+ *
+ * - 基本周期 (STEAR_CONT_INTERVAL_US) ごと: 設定の反映、共有メモリとの交換
+ * - トルク指令の間の演算周期: Periodic 系エフェクトの積算
+ * - トルク指令周期 (TORQUE_CMD_INTERVAL_US) ごと: FFB エフェクト
+ *   (Periodic 系は積算の平均) と物理エフェクトを合算して送信
+ *   → CAN送信 → MF4015が応答 → INT発生
+ *
+ * CAN送信はDMAで行われるため、送信中に後続のサンプリングを進められる。
+ */
+static bool HOT_FUNC(taskControl)() {
+  PROFILE_SCOPE(PROFILE_CONTROL);
+  static uint32_t effectTick = 0; // 演算回数
+  uint32_t tickStartUs = micros();
+  bool torqueCmdTick = (effectTick % TORQUE_CMD_DIVIDER) == 0;
+
+  if (effectTick++ % BASE_TICK_DIVIDER == 0) {
+    sharedData.lastCore1Micros = tickStartUs;
     sharedData.core1LoopCount++;
 
+    // 有効角度範囲の変更を反映 (範囲外の値は丸めて書き戻す)
+    if (sharedData.steerRangeDeg != mfMotor.getAngleRange()) {
+      sharedData.steerRangeDeg =
+          mfMotor.setAngleRange(sharedData.steerRangeDeg);
+    }
+    // Core 0 が作成したペダル応答曲線へ切り替え (変換の合間に行う)
+    commitPedalCurves();
+    // ペダル校正値の反映・自動校正の観測
+    updatePedalCalibration();
+
     // 共有メモリから FFB 命令を取得し、入力レポートをCore0へ渡す
+    PROFILE_BEGIN(PROFILE_SHARED);
     ffb_core1_update_shared(&core1_input_report, core1_effects);
+    PROFILE_END(PROFILE_SHARED);
+    sharedData.tickTiming.sharedUs = (uint16_t)(micros() - tickStartUs);
+  }
+  uint32_t effectStartUs = micros();
+  if (!torqueCmdTick) {
+    // 指令の間: Periodic 系を積算し、次の指令で平均を送る
+    PROFILE_BEGIN(PROFILE_EFFECT);
+    ffbEngine.samplePeriodic(core1_effects);
+    PROFILE_END(PROFILE_EFFECT);
+    return true;
+  }
 
-    // ================================================================
-    // トルク演算: 全アクティブエフェクトを合算 (FFBEngine)
-    // ================================================================
-    int32_t total_force =
-        ffbEngine.update(core1_effects, core1_input_report.steer);
-    int16_t torque =
-        scaleMagnitudeToTorque((int16_t)total_force, shared_global_gain);
-    sharedData.targetTorque = torque;
-    torque += steerEffect.getEffect(); // 物理エフェクトを加算
-    mfMotor.setTorque(torque);
+  // ================================================================
+  // トルク演算: 全アクティブエフェクトを合算 (FFBEngine)
+  // ================================================================
+  PROFILE_BEGIN(PROFILE_EFFECT);
+  int32_t total_force =
+      ffbEngine.update(core1_effects, core1_input_report.steer);
+  PROFILE_END(PROFILE_EFFECT);
+  PROFILE_BEGIN(PROFILE_SCALE);
+  int16_t torque =
+      scaleMagnitudeToTorque((int16_t)total_force, shared_global_gain);
+  sharedData.targetTorque = torque;
+  torque += steerEffect.getEffect(); // 物理エフェクトを加算
+  PROFILE_END(PROFILE_SCALE);
+  uint32_t effectDoneUs = micros();
+  sharedData.tickTiming.effectUs = (uint16_t)(effectDoneUs - effectStartUs);
+
+  // 前回の送信完了時刻 (DMA完了コールバックで記録) から送信遅延を算出
+  uint32_t txDoneUs = canWrapper.getLastTxCompleteUs();
+  if ((int32_t)(txDoneUs - torqueCmdStartUs) >= 0) {
+    sharedData.tickTiming.canTxDoneUs =
+        (uint16_t)(txDoneUs - torqueCmdStartUs);
   }
+  torqueCmdStartUs = tickStartUs;
 
-  // 3. ADC/DI サンプリング (250us周期)
-  //    生値の取得のみ行い、物理量変換はINT検出時に実行する
-  if (sampleTrigger.hasExpired()) {
-    adBrake.getadc();
-    adAccel.getadc();
-    diKeyUp.update();
-    diKeyDown.update();
+  // フラッシュ書き込みの前 (Core 0 の要求中) はトルク 0 を送る
+  static uint8_t holdSentSeq = 0;
+  uint8_t holdSeq = sharedData.torqueHoldSeq;
+  if (holdSeq != 0) {
+    torque = 0;
   }
 
+  PROFILE_BEGIN(PROFILE_CAN_SEND);
+  motors.setTorque(0, torque);
+  motors.flush();
+  PROFILE_END(PROFILE_CAN_SEND);
+  // 前回の指令 (トルク 0) は送信済み: Core 1 が止まってもトルク 0 を保持する
+  sharedData.torqueHeldSeq = (holdSeq == holdSentSeq) ? holdSeq : 0;
+  holdSentSeq = holdSeq;
+  sharedData.tickTiming.canSendUs = (uint16_t)(micros() - effectDoneUs);
+  return true;
+}
+
+/**
+ * @brief ADC/DI サンプリング (SAMPLING_INTERVAL_US 周期)
+ *
+ * 生値の取得のみ行い、物理量変換はINT検出時に実行する。
+ * ADC は DMA で変換済みのため、溜まったサンプルを各チャンネルへ渡すだけ。
+ */
+static bool HOT_FUNC(taskSample)() {
+  PROFILE_SCOPE(PROFILE_SAMPLE);
+  uint32_t sampleStartUs = micros();
+  adcSampler.read();
+  diKeyUp.update();
+  diKeyDown.update();
+  if (buttonBox.getCount() > 0) {
+    buttonBox.update();
+  }
+  sharedData.tickTiming.sampleUs = (uint16_t)(micros() - sampleStartUs);
+  return true;
+}
+
+/**
+ * @brief CANバス使用率・通信品質・周期処理の集計 (BUS_LOAD_WINDOW_MS 周期)
+ *
+ * バス使用率 = 送受信フレームの累積ビット数の増分 / (ビットレート × 集計時間)
+ */
+static bool taskLinkStats() {
+  static uint32_t busBitsPrev = 0;
+  uint32_t bits = canWrapper.getBusBitCount();
+  uint64_t capacity = (uint64_t)canWrapper.getBitrate() *
+                      Config::Can::BUS_LOAD_WINDOW_MS / 1000;
+  if (capacity > 0) {
+    uint64_t permil = (uint64_t)(bits - busBitsPrev) * 1000 / capacity;
+    sharedData.canBusLoadPermil = (uint16_t)(permil > 1000 ? 1000 : permil);
+  }
+  busBitsPrev = bits;
+
+  // モーターとの通信品質 (往復時間・欠落) を共有メモリへ
+  MF4015_Driver::LinkStats link = mfMotor.getLinkStats();
+  sharedData.canLink.missed = link.missed;
+  sharedData.canLink.late = link.late;
+  sharedData.canLink.rttMinUs = link.rttMinUs;
+  sharedData.canLink.rttAvgUs = link.rttAvgUs;
+  sharedData.canLink.rttMaxUs = link.rttMaxUs;
+  sharedData.canLink.rttP99Us = link.rttP99Us;
+
+  // 周期処理の開始遅れ・CPU 利用率
+  publishJitter(sharedData.controlJitter, CONTROL_TASK);
+  publishJitter(sharedData.sampleJitter, SAMPLE_TASK);
+  sharedData.core1Load.utilPermil = core1Scheduler.takeUtilizationPermil();
+  sharedData.core1Load.budgetViolations = core1Scheduler.getBudgetViolations();
+  return true;
+}
+
 #ifdef PHYSICAL_INPUT_DEBUG_ENABLE
-  // 4. デバッグ出力 (1秒周期)
-  static IntervalTrigger_m debugTrigger(1000);
-  static bool debugInit = false;
-  if (!debugInit) {
-    debugTrigger.init();
-    debugInit = true;
+/**
+ * @brief タスクごとの実行統計の出力 (出力後に開始遅れをリセット)
+ */
+static void printTaskStats(TaskScheduler &scheduler) {
+  for (uint8_t i = 0; i < scheduler.getTaskCount(); i++) {
+    TaskStats &ts = scheduler.getStats(i);
+    Serial.printf("[TASK] %-10s N:%lu ExecMax:%lu Over:%lu Missed:%lu "
+                  "LateMax:%lu\n",
+                  scheduler.getTask(i).name, (unsigned long)ts.runs,
+                  (unsigned long)ts.execMaxUs, (unsigned long)ts.overBudget,
+                  (unsigned long)scheduler.getMissedCount(i),
+                  (unsigned long)ts.lateness.getMaxUs());
   }
+}
 
-  if (debugTrigger.hasExpired()) {
-    Serial.printf("[PHYS_INPUT] Steer:%d, Accel:%d, Brake:%d, Buttons:0x%04X\n",
-                  core1_input_report.steer, core1_input_report.accel,
-                  core1_input_report.brake, core1_input_report.buttons);
-    // Serial.printf("[PID] effects[0].magnitude:%d\n",
-    //               core1_effects[0].magnitude);
-    // Serial.printf("[RAW_ADC] Accel:%d, Brake:%d\n", adAccel.getRawLatest(),
-    //               adBrake.getRawLatest());
+/**
+ * @brief デバッグ出力 (1秒周期)
+ */
+static bool taskDebugPrint() {
+  Serial.printf("[PHYS_INPUT] Steer:%d, Accel:%d, Brake:%d, Buttons:0x%04X\n",
+                core1_input_report.steer, core1_input_report.accel,
+                core1_input_report.brake, core1_input_report.buttons);
+  Serial.printf("[TICK_US] Rx:%u, Shared:%u, Effect:%u, CanSend:%u, "
+                "CanTxDone:%u, Sample:%u\n",
+                sharedData.tickTiming.rxParseUs,
+                sharedData.tickTiming.sharedUs,
+                sharedData.tickTiming.effectUs,
+                sharedData.tickTiming.canSendUs,
+                sharedData.tickTiming.canTxDoneUs,
+                sharedData.tickTiming.sampleUs);
+  Serial.printf("[CAN_FILTER] Motor:%lu, Rejected:%lu\n",
+                (unsigned long)canWrapper.getFilterHitCount(0),
+                (unsigned long)canWrapper.getFilterRejectCount());
+  Serial.printf("[CAN_BUS] Load:%u.%u%%\n",
+                sharedData.canBusLoadPermil / 10,
+                sharedData.canBusLoadPermil % 10);
+  Serial.printf("[CAN_RTT] Min:%u, Avg:%u, Max:%u, P99:%u, Missed:%lu, "
+                "Late:%lu\n",
+                sharedData.canLink.rttMinUs, sharedData.canLink.rttAvgUs,
+                sharedData.canLink.rttMaxUs, sharedData.canLink.rttP99Us,
+                (unsigned long)sharedData.canLink.missed,
+                (unsigned long)sharedData.canLink.late);
+  const CANTxStats &txStats = canWrapper.getTxStats();
+  Serial.printf("[CAN_TX] Queued:%lu, Superseded:%lu, Dropped:%lu, "
+                "Depth:%u, MaxDepth:%u\n",
+                (unsigned long)txStats.queued,
+                (unsigned long)txStats.superseded,
+                (unsigned long)txStats.dropped, txStats.depth,
+                txStats.maxDepth);
+  Serial.printf("[DI] Latency:%u, Edges:%lu/%lu, Bounces:%lu/%lu\n",
+                sharedData.buttonLatencyUs,
+                (unsigned long)diKeyUp.getEdgeCount(),
+                (unsigned long)diKeyDown.getEdgeCount(),
+                (unsigned long)diKeyUp.getBounceCount(),
+                (unsigned long)diKeyDown.getBounceCount());
+  Serial.printf("[TICK_LATE] Control:%u/%u/%u (%lu), "
+                "Sample:%u/%u/%u (%lu)\n",
+                sharedData.controlJitter.lateMinUs,
+                sharedData.controlJitter.lateAvgUs,
+                sharedData.controlJitter.lateMaxUs,
+                (unsigned long)sharedData.controlJitter.missed,
+                sharedData.sampleJitter.lateMinUs,
+                sharedData.sampleJitter.lateAvgUs,
+                sharedData.sampleJitter.lateMaxUs,
+                (unsigned long)sharedData.sampleJitter.missed);
+  printTaskStats(core0Scheduler);
+  printTaskStats(core1Scheduler);
+  Serial.printf("[CPU] Core0:%u.%u%% (Over:%lu), Core1:%u.%u%% (Over:%lu)\n",
+                sharedData.core0Load.utilPermil / 10,
+                sharedData.core0Load.utilPermil % 10,
+                (unsigned long)sharedData.core0Load.budgetViolations,
+                sharedData.core1Load.utilPermil / 10,
+                sharedData.core1Load.utilPermil % 10,
+                (unsigned long)sharedData.core1Load.budgetViolations);
+#ifdef ZONE_PROFILER_ENABLE
+  // ゾーンごとの集計 (直近の ZONE_STATS_US 区間)
+  for (uint8_t i = 0; i < PROFILE_ZONE_COUNT; i++) {
+    const volatile ZoneStats &zs = sharedData.zoneStats[i];
+    Serial.printf("[ZONE] %-8s N:%lu Min:%u Avg:%u Max:%u P99:%u "
+                  "Over:%lu\n",
+                  ZoneProfiler::getName((ProfileZone)i),
+                  (unsigned long)zs.count, zs.minUs, zs.avgUs, zs.maxUs,
+                  zs.p99Us, (unsigned long)zs.overruns);
   }
+#endif // ZONE_PROFILER_ENABLE
+  Serial.printf("[ADC_DMA] Rate:%lu, Overruns:%lu\n",
+                (unsigned long)adcSampler.getSampleRateHz(),
+                (unsigned long)adcSampler.getOverrunCount());
+#ifdef CAN_BACKEND_SIM
+  Serial.printf("[SIM] Angle:%.1f, Vel:%.1f, Iq:%d, DroppedReplies:%lu\n",
+                canWrapper.getAngle() * 57.29578f,
+                canWrapper.getVelocity() * 57.29578f, canWrapper.getIq(),
+                (unsigned long)canWrapper.getDroppedReplies());
 #endif
+  // Serial.printf("[PID] effects[0].magnitude:%d\n",
+  //               core1_effects[0].magnitude);
+  // Serial.printf("[RAW_ADC] Accel:%d, Brake:%d\n", adAccel.getRawLatest(),
+  //               adBrake.getRawLatest());
+  return true;
 }
+#endif // PHYSICAL_INPUT_DEBUG_ENABLE
+
+/**
+ * @brief Core 1 ループ
+ *
+ * センサー値の読み取り、CANメッセージの受信解析、
+ * および目標トルクに基づくモーター制御指令の送出を行う
+ * (core1Tasks のタスクを期限順に実行)
+ */
+void HOT_FUNC(loop1)() { core1Scheduler.runOnce(); }
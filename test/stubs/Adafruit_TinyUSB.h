@@ -0,0 +1,102 @@
+#ifndef HOST_ADAFRUIT_TINYUSB_H
+#define HOST_ADAFRUIT_TINYUSB_H
+
+/**
+ * @file Adafruit_TinyUSB.h
+ * @brief ホスト (native) ビルド用の Adafruit TinyUSB (HID のみ)
+ * @date 2026-10-19
+ *
+ * USB は接続されていない状態 (mounted() = false) で始まります。
+ * テストはホストからのレポートを HostUsb::setReport() で渡し、
+ * ファームウェアの受信処理 (setReportCallback() の登録先) を呼び出せます。
+ */
+
+#include <Arduino.h>
+#include <cstdint>
+
+typedef enum {
+  HID_REPORT_TYPE_INVALID = 0,
+  HID_REPORT_TYPE_INPUT,
+  HID_REPORT_TYPE_OUTPUT,
+  HID_REPORT_TYPE_FEATURE
+} hid_report_type_t;
+
+/**
+ * @class Adafruit_USBD_HID
+ * @brief HID インターフェース (送信は件数のみ数える)
+ */
+class Adafruit_USBD_HID {
+public:
+  typedef uint16_t (*get_report_callback_t)(uint8_t reportId,
+                                            hid_report_type_t reportType,
+                                            uint8_t *buffer, uint16_t reqlen);
+  typedef void (*set_report_callback_t)(uint8_t reportId,
+                                        hid_report_type_t reportType,
+                                        uint8_t const *buffer,
+                                        uint16_t bufsize);
+
+  void setPollInterval(uint8_t intervalMs) { (void)intervalMs; }
+  void setReportDescriptor(const uint8_t *desc, uint16_t len) {
+    (void)desc;
+    (void)len;
+  }
+  void setReportCallback(get_report_callback_t get, set_report_callback_t set) {
+    getCallback = get;
+    setCallback = set;
+  }
+  bool begin();
+  bool ready() { return true; }
+  bool sendReport(uint8_t reportId, const void *report, uint8_t len) {
+    (void)reportId;
+    (void)report;
+    (void)len;
+    sent++;
+    return true;
+  }
+
+  get_report_callback_t getCallback = nullptr;
+  set_report_callback_t setCallback = nullptr;
+  uint32_t sent = 0; ///< 送信したレポート数
+};
+
+/**
+ * @class HostUsbDevice
+ * @brief USB デバイスの接続状態
+ */
+class HostUsbDevice {
+public:
+  bool mounted() const { return isMounted; }
+  bool suspended() const { return false; }
+
+  bool isMounted = false; ///< テストから接続状態を切り替える
+};
+
+inline HostUsbDevice TinyUSBDevice;
+
+namespace HostUsb {
+inline Adafruit_USBD_HID *hid = nullptr; ///< begin() した HID
+
+/// ホストからのレポート (SET_REPORT / OUT) を受信させる
+inline void setReport(uint8_t reportId, hid_report_type_t type,
+                      const uint8_t *buffer, uint16_t len) {
+  if (hid != nullptr && hid->setCallback != nullptr) {
+    hid->setCallback(reportId, type, buffer, len);
+  }
+}
+
+/// ホストからのレポート要求 (GET_REPORT) に応答させる
+inline uint16_t getReport(uint8_t reportId, hid_report_type_t type,
+                          uint8_t *buffer, uint16_t len) {
+  if (hid == nullptr || hid->getCallback == nullptr) {
+    return 0;
+  }
+  return hid->getCallback(reportId, type, buffer, len);
+}
+} // namespace HostUsb
+
+inline bool Adafruit_USBD_HID::begin() {
+  HostUsb::hid = this;
+  return true;
+}
+
+#endif // HOST_ADAFRUIT_TINYUSB_H
@@ -0,0 +1,227 @@
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+/**
+ * @file Arduino.h
+ * @brief ホスト (native) ビルド用の Arduino API の代替実装
+ * @date 2026-10-19
+ *
+ * pio test -e native でファームウェアのソースをそのままPC上で
+ * コンパイル・実行するためのヘッダです (test/stubs 以下は同じ目的)。
+ *
+ * - 時刻は仮想時計 (HostClock) で、テストが進めない限り止まっています。
+ *   micros() / millis() / delay() / time_us_32() はすべてこれを参照するため、
+ *   実時間より速く (または遅く) ファームウェアの周期処理を実行できます。
+ *   時刻を読むだけの待ちループ (応答待ちなど) を抜けられるよう、
+ *   HostClock::readAdvanceNs で1回の読み出しごとに進める時間を設定できます。
+ * - GPIO はピンごとのレベルを保持し (HostGpio)、レベルの変化で
+ *   attachInterrupt() のハンドラをその場で呼び出します。
+ * - 割り込み禁止・メモリバリアは何もしません (単一スレッドで実行)。
+ */
+
+#include <cmath>
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+// ============================================================================
+// 仮想時計
+// ============================================================================
+namespace HostClock {
+inline uint64_t nowNs = 0; ///< 起動からの経過時間 (ns)
+/// micros() / millis() の1回の呼び出しで進める時間 (ns, 既定 0: 進めない)
+inline uint64_t readAdvanceNs = 0;
+
+/// 仮想時計を進める (ns)
+inline void advanceNs(uint64_t ns) { nowNs += ns; }
+/// 仮想時計を進める (us)
+inline void advanceUs(uint64_t us) { nowNs += us * 1000; }
+/// 起動からの経過時間 (us)
+inline uint64_t nowUs() { return nowNs / 1000; }
+/// ファームウェアからの時刻の読み出し (readAdvanceNs だけ進めてから返す)
+inline uint64_t readUs() {
+  nowNs += readAdvanceNs;
+  return nowUs();
+}
+} // namespace HostClock
+
+inline unsigned long micros() { return (uint32_t)HostClock::readUs(); }
+inline unsigned long millis() { return (uint32_t)(HostClock::readUs() / 1000); }
+inline void delay(unsigned long ms) { HostClock::advanceUs(ms * 1000ULL); }
+inline void delayMicroseconds(unsigned int us) { HostClock::advanceUs(us); }
+inline void yield() {}
+
+// ============================================================================
+// GPIO
+// ============================================================================
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define FALLING 2
+#define RISING 3
+#define CHANGE 4
+#define HEX 16
+#define DEC 10
+#define MSBFIRST 1
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+namespace HostGpio {
+inline constexpr uint8_t PIN_COUNT = 30;
+
+/// ピンのレベル (入力はプルアップ相当の HIGH で始まる)
+inline uint8_t level[PIN_COUNT] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1};
+inline uint16_t analog[PIN_COUNT] = {}; ///< analogRead() の値
+inline void (*isr[PIN_COUNT])(void) = {};
+inline void (*isrParam[PIN_COUNT])(void *) = {}; ///< 引数付きのハンドラ
+inline void *isrArg[PIN_COUNT] = {};
+inline int isrMode[PIN_COUNT] = {};
+
+/// 出力ピンの変化の通知先 (SPI の CS を模擬デバイスへ伝える)
+inline void (*onOutput)(uint8_t pin, uint8_t value, void *ctx) = nullptr;
+inline void *onOutputCtx = nullptr;
+
+/// ピンのレベルを変更し、該当するエッジの割り込みハンドラを呼ぶ
+inline void drive(uint8_t pin, uint8_t value) {
+  if (pin >= PIN_COUNT) {
+    return;
+  }
+  uint8_t prev = level[pin];
+  level[pin] = value ? 1 : 0;
+  if ((isr[pin] == nullptr && isrParam[pin] == nullptr) ||
+      prev == level[pin]) {
+    return;
+  }
+  int mode = isrMode[pin];
+  if (mode == CHANGE || (mode == FALLING && prev) ||
+      (mode == RISING && !prev)) {
+    if (isrParam[pin] != nullptr) {
+      isrParam[pin](isrArg[pin]);
+    } else {
+      isr[pin]();
+    }
+  }
+}
+} // namespace HostGpio
+
+inline void pinMode(uint8_t pin, uint8_t mode) {
+  (void)pin;
+  (void)mode;
+}
+inline int digitalRead(uint8_t pin) {
+  return pin < HostGpio::PIN_COUNT ? HostGpio::level[pin] : LOW;
+}
+inline void digitalWrite(uint8_t pin, uint8_t value) {
+  HostGpio::drive(pin, value);
+  if (HostGpio::onOutput != nullptr) {
+    HostGpio::onOutput(pin, value, HostGpio::onOutputCtx);
+  }
+}
+inline int analogRead(uint8_t pin) {
+  return pin < HostGpio::PIN_COUNT ? HostGpio::analog[pin] : 0;
+}
+inline void analogReadResolution(int bits) { (void)bits; }
+
+#define digitalPinToInterrupt(p) (p)
+inline void attachInterrupt(uint8_t pin, void (*handler)(void), int mode) {
+  if (pin < HostGpio::PIN_COUNT) {
+    HostGpio::isr[pin] = handler;
+    HostGpio::isrMode[pin] = mode;
+  }
+}
+inline void attachInterruptParam(uint8_t pin, void (*handler)(void *),
+                                 int mode, void *param) {
+  if (pin < HostGpio::PIN_COUNT) {
+    HostGpio::isrParam[pin] = handler;
+    HostGpio::isrArg[pin] = param;
+    HostGpio::isrMode[pin] = mode;
+  }
+}
+inline void detachInterrupt(uint8_t pin) {
+  if (pin < HostGpio::PIN_COUNT) {
+    HostGpio::isr[pin] = nullptr;
+    HostGpio::isrParam[pin] = nullptr;
+  }
+}
+inline void noInterrupts() {}
+inline void interrupts() {}
+
+// ============================================================================
+// 数値
+// ============================================================================
+inline long map(long x, long inMin, long inMax, long outMin, long outMax) {
+  return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+#define constrain(amt, low, high)                                              \
+  ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+// ============================================================================
+// pico/platform.h
+// ============================================================================
+// ホストでは配置先の指定は不要
+#define __not_in_flash(group)
+#define __not_in_flash_func(func_name) func_name
+inline void tight_loop_contents() {}
+
+// ============================================================================
+// Serial
+// ============================================================================
+/**
+ * @class HostSerial
+ * @brief 標準出力へ書き出す Serial
+ *
+ * echo = false でテスト中の出力を抑止できます。
+ */
+class HostSerial {
+public:
+  bool echo = true; ///< 標準出力へ書き出すか
+
+  void begin(unsigned long baud) { (void)baud; }
+  explicit operator bool() const { return true; }
+
+  int printf(const char *format, ...) {
+    if (!echo) {
+      return 0;
+    }
+    va_list args;
+    va_start(args, format);
+    int n = vprintf(format, args);
+    va_end(args);
+    return n;
+  }
+  void print(const char *s) { printf("%s", s); }
+  void print(char c) { printf("%c", c); }
+  void print(int v, int base = DEC) { printLong(v, base); }
+  void print(unsigned int v, int base = DEC) { printULong(v, base); }
+  void print(long v, int base = DEC) { printLong(v, base); }
+  void print(unsigned long v, int base = DEC) { printULong(v, base); }
+  void print(double v, int digits = 2) { printf("%.*f", digits, v); }
+  template <class T> void println(T v) {
+    print(v);
+    println();
+  }
+  template <class T> void println(T v, int format) {
+    print(v, format);
+    println();
+  }
+  void println() { printf("\n"); }
+
+private:
+  void printLong(long v, int base) {
+    printf(base == HEX ? "%lX" : "%ld", v);
+  }
+  void printULong(unsigned long v, int base) {
+    printf(base == HEX ? "%lX" : "%lu", v);
+  }
+};
+
+inline HostSerial Serial;
+
+#endif // HOST_ARDUINO_H
@@ -0,0 +1,124 @@
+#ifndef HOST_LITTLEFS_H
+#define HOST_LITTLEFS_H
+
+/**
+ * @file LittleFS.h
+ * @brief ホスト (native) ビルド用の LittleFS (メモリ上のファイル)
+ * @date 2026-10-19
+ *
+ * ファイルの内容はプロセス内に保持され、HostFs::clear() で消去できます。
+ * 書き込みにかかる時間 (フラッシュの消去・書き込み) は
+ * HostFs::writeStallUs だけ仮想時計を進めて模擬します。
+ */
+
+#include <Arduino.h>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace HostFs {
+inline std::map<std::string, std::vector<uint8_t>> files; ///< ファイル
+inline uint32_t writeStallUs = 0; ///< close() (書き込み) 1回で進める時間
+inline uint32_t writeCount = 0;   ///< 書き込みで閉じた回数
+/// close() (書き込み) の直前に呼ぶ関数 (書き込み時の状態の確認用)
+inline void (*onWrite)() = nullptr;
+
+/// すべてのファイルを消去する
+inline void clear() {
+  files.clear();
+  writeCount = 0;
+}
+} // namespace HostFs
+
+/**
+ * @class File
+ * @brief 開いたファイル (読み出し位置・書き込み内容を保持)
+ */
+class File {
+public:
+  File() = default;
+  File(const std::string &fileName, bool forWrite)
+      : name(fileName), writing(forWrite), valid(true) {
+    if (!writing) {
+      data = HostFs::files[name];
+    }
+  }
+
+  explicit operator bool() const { return valid; }
+
+  size_t write(const uint8_t *buf, size_t len) {
+    if (!valid || !writing) {
+      return 0;
+    }
+    data.insert(data.end(), buf, buf + len);
+    return len;
+  }
+  size_t read(uint8_t *buf, size_t len) {
+    if (!valid || writing) {
+      return 0;
+    }
+    size_t n = data.size() - pos < len ? data.size() - pos : len;
+    for (size_t i = 0; i < n; i++) {
+      buf[i] = data[pos + i];
+    }
+    pos += n;
+    return n;
+  }
+  size_t size() const { return data.size(); }
+  void close() {
+    if (valid && writing) {
+      if (HostFs::onWrite != nullptr) {
+        HostFs::onWrite();
+      }
+      HostFs::files[name] = data;
+      HostFs::writeCount++;
+      HostClock::advanceUs(HostFs::writeStallUs);
+    }
+    valid = false;
+  }
+
+private:
+  std::string name;
+  std::vector<uint8_t> data;
+  size_t pos = 0;
+  bool writing = false;
+  bool valid = false;
+};
+
+/**
+ * @class HostLittleFS
+ * @brief LittleFS のファイル操作
+ */
+class HostLittleFS {
+public:
+  bool begin() { return true; }
+  bool format() {
+    HostFs::clear();
+    return true;
+  }
+  bool exists(const char *path) {
+    return HostFs::files.count(path) > 0;
+  }
+  File open(const char *path, const char *mode) {
+    bool forWrite = mode[0] == 'w';
+    if (!forWrite && !exists(path)) {
+      return File();
+    }
+    return File(path, forWrite);
+  }
+  bool remove(const char *path) { return HostFs::files.erase(path) > 0; }
+  bool rename(const char *from, const char *to) {
+    auto it = HostFs::files.find(from);
+    if (it == HostFs::files.end()) {
+      return false;
+    }
+    HostFs::files[to] = it->second;
+    HostFs::files.erase(from);
+    return true;
+  }
+};
+
+inline HostLittleFS LittleFS;
+
+#endif // HOST_LITTLEFS_H
@@ -0,0 +1,88 @@
+#ifndef HOST_SPI_H
+#define HOST_SPI_H
+
+/**
+ * @file SPI.h
+ * @brief ホスト (native) ビルド用の Arduino SPI ライブラリの代替実装
+ * @date 2026-10-19
+ *
+ * 転送したバイトは接続先の模擬デバイス (HostSPIDevice) へ渡します。
+ * 1バイトごとに SPI クロックでのシフト時間だけ仮想時計を進め、
+ * beginTransaction() ごとに overheadNs (CS 操作・関数呼び出し) を加えます。
+ */
+
+#include <Arduino.h>
+
+#define SPI_MODE0 0
+
+/**
+ * @class HostSPIDevice
+ * @brief SPI の接続先 (CS は digitalWrite() の通知で受け取る)
+ */
+class HostSPIDevice {
+public:
+  virtual ~HostSPIDevice() {}
+  virtual uint8_t exchange(uint8_t mosi) = 0;
+};
+
+class SPISettings {
+public:
+  SPISettings() : clockHz(4000000) {}
+  SPISettings(uint32_t clock, uint8_t bitOrder, uint8_t dataMode)
+      : clockHz(clock) {
+    (void)bitOrder;
+    (void)dataMode;
+  }
+  uint32_t clockHz;
+};
+
+class SPIClass {
+public:
+  HostSPIDevice *device = nullptr; ///< 接続先 (nullptr: 0xFF を返す)
+  uint32_t overheadNs = 0;         ///< トランザクションごとの固定時間
+
+  bool setRX(uint8_t pin) {
+    (void)pin;
+    return true;
+  }
+  bool setTX(uint8_t pin) {
+    (void)pin;
+    return true;
+  }
+  bool setSCK(uint8_t pin) {
+    (void)pin;
+    return true;
+  }
+  void begin() {}
+  void end() {}
+  void usingInterrupt(int pin) { (void)pin; }
+  void notUsingInterrupt(int pin) { (void)pin; }
+
+  void beginTransaction(SPISettings settings) {
+    clockHz = settings.clockHz;
+    HostClock::advanceNs(overheadNs);
+  }
+  void endTransaction() {}
+
+  uint8_t transfer(uint8_t data) {
+    HostClock::advanceNs(8000000000ULL / clockHz);
+    return device != nullptr ? device->exchange(data) : 0xFF;
+  }
+  void transfer(const void *tx, void *rx, size_t len) {
+    const uint8_t *out = static_cast<const uint8_t *>(tx);
+    uint8_t *in = static_cast<uint8_t *>(rx);
+    for (size_t i = 0; i < len; i++) {
+      uint8_t v = transfer(out != nullptr ? out[i] : 0xFF);
+      if (in != nullptr) {
+        in[i] = v;
+      }
+    }
+  }
+
+private:
+  uint32_t clockHz = 4000000;
+};
+
+inline SPIClass SPI;
+
+#endif // HOST_SPI_H
@@ -0,0 +1,39 @@
+#ifndef HOST_HARDWARE_ADC_H
+#define HOST_HARDWARE_ADC_H
+
+/**
+ * @file adc.h
+ * @brief ホスト (native) ビルド用の hardware/adc.h (設定のみ, 変換しない)
+ * @date 2026-10-19
+ */
+
+#include <cstdint>
+
+typedef struct {
+  volatile uint32_t cs;
+  volatile uint32_t result;
+  volatile uint32_t fcs;
+  volatile uint32_t fifo;
+  volatile uint32_t div;
+} adc_hw_t;
+
+inline adc_hw_t host_adc_hw;
+#define adc_hw (&host_adc_hw)
+
+inline void adc_init() {}
+inline void adc_gpio_init(unsigned gpio) { (void)gpio; }
+inline void adc_select_input(unsigned input) { (void)input; }
+inline void adc_set_round_robin(unsigned mask) { (void)mask; }
+inline void adc_fifo_setup(bool en, bool dreqEn, unsigned dreqThresh,
+                           bool errInFifo, bool byteShift) {
+  (void)en;
+  (void)dreqEn;
+  (void)dreqThresh;
+  (void)errInFifo;
+  (void)byteShift;
+}
+inline void adc_set_clkdiv(float clkdiv) { (void)clkdiv; }
+inline void adc_run(bool run) { (void)run; }
+inline void adc_fifo_drain() {}
+
+#endif // HOST_HARDWARE_ADC_H
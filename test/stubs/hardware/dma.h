@@ -0,0 +1,113 @@
+#ifndef HOST_HARDWARE_DMA_H
+#define HOST_HARDWARE_DMA_H
+
+/**
+ * @file dma.h
+ * @brief ホスト (native) ビルド用の hardware/dma.h
+ * @date 2026-10-19
+ *
+ * 転送は行いません。チャネルの書き込み先アドレスだけを保持するため、
+ * DMA の書き込み位置を参照する処理 (DMAADCSampler) は
+ * 「新しいサンプルなし」として動作します。
+ */
+
+#include <cstdint>
+
+#define DREQ_ADC 36
+
+enum dma_channel_transfer_size {
+  DMA_SIZE_8 = 0,
+  DMA_SIZE_16 = 1,
+  DMA_SIZE_32 = 2
+};
+
+typedef struct {
+  uint32_t ctrl;
+} dma_channel_config;
+
+typedef struct {
+  volatile uint32_t read_addr;
+  volatile uint32_t write_addr;
+  volatile uint32_t transfer_count;
+  volatile uint32_t ctrl_trig;
+  volatile uint32_t al1_transfer_count_trig;
+} dma_channel_hw_t;
+
+typedef struct {
+  dma_channel_hw_t ch[12];
+} dma_hw_t;
+
+inline dma_hw_t host_dma_hw;
+#define dma_hw (&host_dma_hw)
+
+inline int dma_claim_unused_channel(bool required) {
+  static int next = 0;
+  (void)required;
+  return next < 12 ? next++ : -1;
+}
+inline void dma_channel_unclaim(unsigned ch) { (void)ch; }
+inline dma_channel_config dma_channel_get_default_config(unsigned ch) {
+  (void)ch;
+  return dma_channel_config{0};
+}
+inline void channel_config_set_transfer_data_size(
+    dma_channel_config *c, dma_channel_transfer_size size) {
+  (void)c;
+  (void)size;
+}
+inline void channel_config_set_dreq(dma_channel_config *c, unsigned dreq) {
+  (void)c;
+  (void)dreq;
+}
+inline void channel_config_set_read_increment(dma_channel_config *c,
+                                              bool incr) {
+  (void)c;
+  (void)incr;
+}
+inline void channel_config_set_write_increment(dma_channel_config *c,
+                                               bool incr) {
+  (void)c;
+  (void)incr;
+}
+inline void channel_config_set_ring(dma_channel_config *c, bool write,
+                                    unsigned sizeBits) {
+  (void)c;
+  (void)write;
+  (void)sizeBits;
+}
+inline void channel_config_set_chain_to(dma_channel_config *c, unsigned ch) {
+  (void)c;
+  (void)ch;
+}
+inline void dma_channel_configure(unsigned ch, const dma_channel_config *c,
+                                  volatile void *write,
+                                  const volatile void *read, unsigned count,
+                                  bool trigger) {
+  (void)c;
+  (void)trigger;
+  host_dma_hw.ch[ch].write_addr = (uint32_t)(uintptr_t)write;
+  host_dma_hw.ch[ch].read_addr = (uint32_t)(uintptr_t)read;
+  host_dma_hw.ch[ch].transfer_count = count;
+}
+inline void dma_start_channel_mask(uint32_t mask) { (void)mask; }
+inline void dma_channel_start(unsigned ch) { (void)ch; }
+inline void dma_channel_abort(unsigned ch) { (void)ch; }
+inline bool dma_channel_is_busy(unsigned ch) {
+  (void)ch;
+  return false;
+}
+inline void dma_channel_set_irq0_enabled(unsigned ch, bool enabled) {
+  (void)ch;
+  (void)enabled;
+}
+inline void dma_channel_set_irq1_enabled(unsigned ch, bool enabled) {
+  (void)ch;
+  (void)enabled;
+}
+inline bool dma_channel_get_irq1_status(unsigned ch) {
+  (void)ch;
+  return false;
+}
+inline void dma_channel_acknowledge_irq1(unsigned ch) { (void)ch; }
+
+#endif // HOST_HARDWARE_DMA_H
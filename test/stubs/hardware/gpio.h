@@ -0,0 +1,43 @@
+#ifndef HOST_HARDWARE_GPIO_H
+#define HOST_HARDWARE_GPIO_H
+
+/**
+ * @file gpio.h
+ * @brief ホスト (native) ビルド用の hardware/gpio.h
+ * @date 2026-10-19
+ *
+ * ピンのレベルは Arduino.h の HostGpio と共有します。
+ */
+
+#include <Arduino.h>
+
+#define GPIO_OUT 1
+#define GPIO_IN 0
+
+enum gpio_function { GPIO_FUNC_SPI = 1, GPIO_FUNC_SIO = 5 };
+
+inline void gpio_init(unsigned pin) { (void)pin; }
+inline void gpio_set_function(unsigned pin, gpio_function fn) {
+  (void)pin;
+  (void)fn;
+}
+inline void gpio_set_dir(unsigned pin, bool out) {
+  (void)pin;
+  (void)out;
+}
+inline void gpio_pull_up(unsigned pin) { (void)pin; }
+inline void gpio_put(unsigned pin, bool value) {
+  digitalWrite((uint8_t)pin, value ? HIGH : LOW);
+}
+inline bool gpio_get(unsigned pin) { return digitalRead((uint8_t)pin) != 0; }
+
+/// 全ピンのレベル (bit n = GPn)
+inline uint32_t gpio_get_all() {
+  uint32_t all = 0;
+  for (uint8_t pin = 0; pin < HostGpio::PIN_COUNT; pin++) {
+    all |= (uint32_t)HostGpio::level[pin] << pin;
+  }
+  return all;
+}
+
+#endif // HOST_HARDWARE_GPIO_H
@@ -0,0 +1,42 @@
+#ifndef HOST_HARDWARE_IRQ_H
+#define HOST_HARDWARE_IRQ_H
+
+/**
+ * @file irq.h
+ * @brief ホスト (native) ビルド用の hardware/irq.h (登録のみ)
+ * @date 2026-10-19
+ */
+
+#include <cstdint>
+
+#define TIMER_IRQ_0 0
+#define DMA_IRQ_0 11
+#define DMA_IRQ_1 12
+#define PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY 0x80
+
+typedef void (*irq_handler_t)(void);
+
+inline void irq_add_shared_handler(unsigned num, irq_handler_t handler,
+                                   uint8_t order) {
+  (void)num;
+  (void)handler;
+  (void)order;
+}
+inline void irq_remove_handler(unsigned num, irq_handler_t handler) {
+  (void)num;
+  (void)handler;
+}
+inline void irq_set_exclusive_handler(unsigned num, irq_handler_t handler) {
+  (void)num;
+  (void)handler;
+}
+inline void irq_set_enabled(unsigned num, bool enabled) {
+  (void)num;
+  (void)enabled;
+}
+inline void irq_set_priority(unsigned num, uint8_t priority) {
+  (void)num;
+  (void)priority;
+}
+
+#endif // HOST_HARDWARE_IRQ_H
@@ -0,0 +1,60 @@
+#ifndef HOST_HARDWARE_SPI_H
+#define HOST_HARDWARE_SPI_H
+
+/**
+ * @file spi.h
+ * @brief ホスト (native) ビルド用の hardware/spi.h (コンパイル用の空実装)
+ * @date 2026-10-19
+ *
+ * DMASPITransport はホストでは使用しません (テストは SPITransport の
+ * 模擬実装を注入します)。
+ */
+
+#include <cstddef>
+#include <cstdint>
+
+typedef struct {
+  volatile uint32_t cr0, cr1, dr, sr;
+} spi_hw_t;
+
+struct spi_inst {
+  spi_hw_t hw;
+};
+typedef struct spi_inst spi_inst_t;
+
+inline spi_inst_t host_spi[2];
+#define spi0 (&host_spi[0])
+#define spi1 (&host_spi[1])
+
+typedef enum { SPI_CPOL_0 = 0, SPI_CPOL_1 = 1 } spi_cpol_t;
+typedef enum { SPI_CPHA_0 = 0, SPI_CPHA_1 = 1 } spi_cpha_t;
+typedef enum { SPI_LSB_FIRST = 0, SPI_MSB_FIRST = 1 } spi_order_t;
+
+inline unsigned spi_init(spi_inst_t *spi, unsigned baudrate) {
+  (void)spi;
+  return baudrate;
+}
+inline void spi_set_format(spi_inst_t *spi, unsigned bits, spi_cpol_t cpol,
+                           spi_cpha_t cpha, spi_order_t order) {
+  (void)spi;
+  (void)bits;
+  (void)cpol;
+  (void)cpha;
+  (void)order;
+}
+inline spi_hw_t *spi_get_hw(spi_inst_t *spi) { return &spi->hw; }
+inline unsigned spi_get_dreq(spi_inst_t *spi, bool isTx) {
+  (void)spi;
+  return isTx ? 16 : 17;
+}
+inline int spi_write_read_blocking(spi_inst_t *spi, const uint8_t *src,
+                                   uint8_t *dst, size_t len) {
+  (void)spi;
+  (void)src;
+  for (size_t i = 0; i < len; i++) {
+    dst[i] = 0xFF;
+  }
+  return (int)len;
+}
+
+#endif // HOST_HARDWARE_SPI_H
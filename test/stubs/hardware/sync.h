@@ -0,0 +1,19 @@
+#ifndef HOST_HARDWARE_SYNC_H
+#define HOST_HARDWARE_SYNC_H
+
+/**
+ * @file sync.h
+ * @brief ホスト (native) ビルド用の hardware/sync.h (単一スレッドのため空実装)
+ * @date 2026-10-19
+ */
+
+#include <cstdint>
+
+inline uint32_t save_and_disable_interrupts() { return 0; }
+inline void restore_interrupts(uint32_t status) { (void)status; }
+inline void __dmb() {}
+inline void __sev() {}
+inline void __wfe() {}
+inline void __wfi() {}
+
+#endif // HOST_HARDWARE_SYNC_H
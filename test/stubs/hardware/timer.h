@@ -0,0 +1,45 @@
+#ifndef HOST_HARDWARE_TIMER_H
+#define HOST_HARDWARE_TIMER_H
+
+/**
+ * @file timer.h
+ * @brief ホスト (native) ビルド用の hardware/timer.h
+ * @date 2026-10-19
+ *
+ * 時刻は仮想時計 (HostClock) を返します。アラームは登録のみで割り込みは
+ * 発生しないため、周期処理は TICK_SOFTWARE_TIMER (micros() 判定) で動かします。
+ */
+
+#include <Arduino.h>
+#include <cstdint>
+
+typedef unsigned int uint;
+typedef uint64_t absolute_time_t;
+typedef void (*hardware_alarm_callback_t)(uint alarm_num);
+
+#define NUM_TIMERS 4
+
+inline uint64_t time_us_64() { return HostClock::readUs(); }
+inline uint32_t time_us_32() { return (uint32_t)HostClock::readUs(); }
+inline absolute_time_t from_us_since_boot(uint64_t us) { return us; }
+
+inline int hardware_alarm_claim_unused(bool required) {
+  static int next = 0;
+  (void)required;
+  return next < NUM_TIMERS ? next++ : -1;
+}
+inline void hardware_alarm_unclaim(uint alarm_num) { (void)alarm_num; }
+inline void hardware_alarm_set_callback(uint alarm_num,
+                                        hardware_alarm_callback_t callback) {
+  (void)alarm_num;
+  (void)callback;
+}
+/// @return false: 設定した (時刻が過ぎていても発生しない)
+inline bool hardware_alarm_set_target(uint alarm_num, absolute_time_t t) {
+  (void)alarm_num;
+  (void)t;
+  return false;
+}
+inline void hardware_alarm_cancel(uint alarm_num) { (void)alarm_num; }
+
+#endif // HOST_HARDWARE_TIMER_H
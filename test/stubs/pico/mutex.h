@@ -0,0 +1,25 @@
+#ifndef HOST_PICO_MUTEX_H
+#define HOST_PICO_MUTEX_H
+
+/**
+ * @file mutex.h
+ * @brief ホスト (native) ビルド用の pico/mutex.h (単一スレッドのため常に取得)
+ * @date 2026-10-19
+ */
+
+#include <cstdint>
+
+typedef struct {
+  bool owned;
+} mutex_t;
+
+inline void mutex_init(mutex_t *mtx) { mtx->owned = false; }
+inline bool mutex_enter_timeout_ms(mutex_t *mtx, uint32_t timeoutMs) {
+  (void)timeoutMs;
+  mtx->owned = true;
+  return true;
+}
+inline void mutex_enter_blocking(mutex_t *mtx) { mtx->owned = true; }
+inline void mutex_exit(mutex_t *mtx) { mtx->owned = false; }
+
+#endif // HOST_PICO_MUTEX_H
@@ -0,0 +1,441 @@
+#ifndef MOCK_MCP2515_H
+#define MOCK_MCP2515_H
+
+/**
+ * @file MockMCP2515.h
+ * @brief ホストテスト用の MCP2515 の模擬デバイス
+ * @date 2026-10-19
+ *
+ * SPI 命令 (RESET / READ / WRITE / BIT MODIFY / READ STATUS / RX STATUS /
+ * LOAD TX BUFFER / RTS / READ RX BUFFER) をレジスタ単位で解釈します。
+ * MCP2515_Driver (SPITransport 経由) と MCP2515_Wrapper (autowp ライブラリ,
+ * SPI.h 経由) のどちらからも同じデバイスとして見えます。
+ *
+ * - 送信: transmitNext() で、送信要求中のバッファから MCP2515 と同じ順序
+ *   (TXP の高い順, 同じ TXP では番号の大きい順) に1フレームを送出します。
+ *   beginTransmit() で送出を始めたバッファ (調停に勝って送信中) は、
+ *   TXREQ を 0 にしても取り消されません。それ以外の送信要求を取り消すと
+ *   ABTF が 1 になります (RTS で 0 に戻ります)。
+ * - 受信: deliver() で受信バッファに格納し、INT ピンを Low にします。
+ *
+ * SPI の所要時間は仮想時計 (HostClock) で計ります。
+ */
+
+#include "MCP2515_Defs.h"
+#include "SPITransport.h"
+#include <Arduino.h>
+#include <SPI.h>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class MockMCP2515
+ * @brief MCP2515 の模擬デバイス
+ */
+class MockMCP2515 : public HostSPIDevice {
+public:
+  /**
+   * @struct Frame
+   * @brief 送受信フレーム
+   */
+  struct Frame {
+    uint32_t id; ///< CAN ID (拡張フレームは CAN_EFF_FLAG 付き)
+    uint8_t len;
+    uint8_t data[8];
+  };
+
+  /**
+   * @brief コンストラクタ
+   * @param cs CSピン番号 (digitalWrite() で選択される場合)
+   * @param interrupt INTピン番号
+   */
+  MockMCP2515(uint8_t cs, uint8_t interrupt) : csPin(cs), intPin(interrupt) {
+    powerOn();
+  }
+
+  /// 電源投入・RESET 命令後の状態
+  void powerOn() {
+    for (uint8_t &r : reg) {
+      r = 0;
+    }
+    reg[MCP2515Defs::REG_CANSTAT] = MCP2515Defs::MODE_CONFIG;
+    reg[MCP2515Defs::REG_CANCTRL] = MCP2515Defs::MODE_CONFIG | 0x07;
+    updateInt();
+  }
+
+  /// CS を digitalWrite() から受け取るよう登録する (Arduino SPI 経由の場合)
+  void attachArduinoCs() {
+    HostGpio::onOutput = onDigitalWrite;
+    HostGpio::onOutputCtx = this;
+    SPI.device = this;
+  }
+
+  // --- SPI トランザクション ---
+  void select() {
+    selected = true;
+    pos = 0;
+    transactions++;
+  }
+
+  void deselect() {
+    if (!selected) {
+      return;
+    }
+    selected = false;
+    // READ RX BUFFER は CS 解除時に RXnIF をクリアする
+    if ((instr & 0xF9) == 0x90 && pos > 0) {
+      reg[MCP2515Defs::REG_CANINTF] &= (instr & 0x04) ? ~0x02 : ~0x01;
+    }
+    updateInt();
+  }
+
+  uint8_t exchange(uint8_t mosi) override {
+    bytes++;
+    uint8_t miso = 0xFF;
+    if (pos == 0) {
+      instr = mosi;
+      pos++;
+      if (instr == MCP2515Defs::INSTR_RESET) {
+        powerOn();
+      } else if ((instr & 0xF8) == MCP2515Defs::INSTR_RTS) {
+        for (uint8_t n = 0; n < 3; n++) {
+          if (instr & (1 << n)) {
+            reg[ctrlReg(n)] = (reg[ctrlReg(n)] | 0x08) & ~0x40; // TXREQ, ABTF
+          }
+        }
+      } else if ((instr & 0xF8) == 0x40) {
+        // LOAD TX BUFFER: abc = 000 TXB0SIDH, 001 TXB0D0, 010 TXB1SIDH ...
+        uint8_t n = (instr >> 1) & 0x03;
+        addr = ctrlReg(n) + ((instr & 0x01) ? 6 : 1);
+      } else if ((instr & 0xF9) == 0x90) {
+        // READ RX BUFFER: nm = 00 RXB0SIDH, 01 RXB0D0, 10 RXB1SIDH ...
+        addr = ((instr & 0x04) ? MCP2515Defs::REG_RXB1CTRL
+                               : MCP2515Defs::REG_RXB0CTRL) +
+               ((instr & 0x02) ? 6 : 1);
+      }
+      return miso;
+    }
+
+    switch (instr) {
+    case MCP2515Defs::INSTR_READ:
+      if (pos == 1) {
+        addr = mosi;
+      } else {
+        miso = reg[addr++ & 0x7F];
+      }
+      break;
+    case MCP2515Defs::INSTR_WRITE:
+      if (pos == 1) {
+        addr = mosi;
+      } else {
+        writeReg(addr++ & 0x7F, mosi);
+      }
+      break;
+    case MCP2515Defs::INSTR_BIT_MODIFY:
+      if (pos == 1) {
+        addr = mosi;
+      } else if (pos == 2) {
+        bitMask = mosi;
+      } else if (pos == 3) {
+        writeReg(addr, (reg[addr] & ~bitMask) | (mosi & bitMask));
+      }
+      break;
+    case MCP2515Defs::INSTR_READ_STATUS:
+      miso = readStatus();
+      break;
+    case MCP2515Defs::INSTR_RX_STATUS:
+      miso = (uint8_t)((reg[MCP2515Defs::REG_CANINTF] & 0x03) << 6);
+      break;
+    default:
+      if ((instr & 0xF8) == 0x40) {
+        reg[addr++ & 0x7F] = mosi;
+      } else if ((instr & 0xF9) == 0x90) {
+        miso = reg[addr++ & 0x7F];
+      }
+      break;
+    }
+    pos++;
+    return miso;
+  }
+
+  // --- バス側の操作 ---
+  /**
+   * @brief 送信要求中のバッファから1フレームを送出する
+   *
+   * TXP の高いバッファから、同じ TXP では番号の大きいバッファから送信する
+   * (データシート 3.2 の送信優先度)。
+   *
+   * @return true: 送出した, false: 送信要求なし
+   */
+  bool transmitNext() {
+    int best = onBus >= 0 ? onBus : nextBuffer();
+    if (best < 0) {
+      return false;
+    }
+    onBus = -1;
+    uint8_t base = ctrlReg(best);
+    reg[base] &= ~0x08;
+    reg[MCP2515Defs::REG_CANINTF] |= (uint8_t)(0x04 << best); // TXnIF
+    sent.push_back(decodeFrame(&reg[base + 1]));
+    updateInt();
+    return true;
+  }
+
+  /**
+   * @brief 次に送出するバッファの送信を始める (調停に勝った状態)
+   *
+   * 送出を終えるのは次の transmitNext() の呼び出し。
+   *
+   * @return true: 送信を始めた, false: 送信要求なし
+   */
+  bool beginTransmit() {
+    onBus = nextBuffer();
+    return onBus >= 0;
+  }
+
+  /// 送信要求中のフレームをすべて送出する
+  void transmitAll() {
+    while (transmitNext()) {
+    }
+  }
+
+  /**
+   * @brief フレームを受信バッファに格納する (RXB0 が使用中なら RXB1)
+   * @return true: 格納した, false: 両バッファ使用中で破棄
+   */
+  bool deliver(const Frame &frame) {
+    uint8_t intf = reg[MCP2515Defs::REG_CANINTF];
+    uint8_t base;
+    uint8_t flag;
+    if (!(intf & 0x01)) {
+      base = MCP2515Defs::REG_RXB0CTRL;
+      flag = 0x01;
+    } else if (!(intf & 0x02) &&
+               (reg[MCP2515Defs::REG_RXB0CTRL] & MCP2515Defs::RXB0_BUKT)) {
+      base = MCP2515Defs::REG_RXB1CTRL;
+      flag = 0x02;
+    } else {
+      rxOverflow++;
+      return false;
+    }
+    encodeFrame(frame, &reg[base + 1]);
+    reg[MCP2515Defs::REG_CANINTF] |= flag;
+    updateInt();
+    return true;
+  }
+
+  /// 統計のリセット
+  void resetCounters() {
+    transactions = 0;
+    bytes = 0;
+  }
+
+  uint8_t reg[128];        ///< レジスタ
+  std::vector<Frame> sent; ///< 送出したフレーム (送出順)
+  uint32_t transactions = 0;
+  uint32_t bytes = 0;
+  uint32_t rxOverflow = 0;
+
+private:
+  static uint8_t ctrlReg(uint8_t n) {
+    return (uint8_t)(MCP2515Defs::REG_TXB0CTRL + n * 0x10);
+  }
+
+  /// 送信要求中で最も優先度の高いバッファ (-1: なし)
+  int nextBuffer() const {
+    int best = -1;
+    for (uint8_t n = 0; n < 3; n++) {
+      uint8_t ctrl = reg[ctrlReg(n)];
+      if (!(ctrl & 0x08)) {
+        continue;
+      }
+      if (best < 0 || (ctrl & 0x03) >= (reg[ctrlReg(best)] & 0x03)) {
+        best = n;
+      }
+    }
+    return best;
+  }
+
+  static void onDigitalWrite(uint8_t pin, uint8_t value, void *ctx) {
+    MockMCP2515 *self = static_cast<MockMCP2515 *>(ctx);
+    if (pin != self->csPin) {
+      return;
+    }
+    if (value == LOW) {
+      self->select();
+    } else {
+      self->deselect();
+    }
+  }
+
+  void writeReg(uint8_t a, uint8_t value) {
+    if (a == MCP2515Defs::REG_CANSTAT) {
+      return; // 読み出し専用
+    }
+    for (int n = 0; n < 3; n++) {
+      if (a != ctrlReg(n)) {
+        continue;
+      }
+      // ABTF は読み出し専用。送信要求の取り消しは送信中でなければ成立する
+      value = (value & ~0x40) | (reg[a] & 0x40);
+      if ((reg[a] & 0x08) && !(value & 0x08)) {
+        value |= (n == onBus) ? 0x08 : 0x40;
+      }
+    }
+    reg[a] = value;
+    if (a == MCP2515Defs::REG_CANCTRL) {
+      // モード遷移は即座に完了する
+      reg[MCP2515Defs::REG_CANSTAT] =
+          (reg[MCP2515Defs::REG_CANSTAT] & ~MCP2515Defs::MODE_MASK) |
+          (value & MCP2515Defs::MODE_MASK);
+    }
+  }
+
+  uint8_t readStatus() const {
+    uint8_t intf = reg[MCP2515Defs::REG_CANINTF];
+    uint8_t s = intf & 0x03;
+    for (uint8_t n = 0; n < 3; n++) {
+      if (reg[ctrlReg(n)] & 0x08) {
+        s |= (uint8_t)(0x04 << (n * 2)); // TXREQ
+      }
+      if (intf & (0x04 << n)) {
+        s |= (uint8_t)(0x08 << (n * 2)); // TXnIF
+      }
+    }
+    return s;
+  }
+
+  void updateInt() {
+    bool active =
+        (reg[MCP2515Defs::REG_CANINTF] & reg[MCP2515Defs::REG_CANINTE]) != 0;
+    if (intPin != 255) {
+      HostGpio::drive(intPin, active ? LOW : HIGH);
+    }
+  }
+
+  static Frame decodeFrame(const uint8_t *buf) {
+    Frame f;
+    if (buf[1] & MCP2515Defs::SIDL_IDE) {
+      f.id = ((uint32_t)buf[0] << 21) | ((uint32_t)(buf[1] & 0xE0) << 13) |
+             ((uint32_t)(buf[1] & 0x03) << 16) | ((uint32_t)buf[2] << 8) |
+             buf[3];
+      f.id |= MCP2515Defs::CAN_EFF_FLAG;
+    } else {
+      f.id = ((uint32_t)buf[0] << 3) | (buf[1] >> 5);
+    }
+    f.len = buf[4] & MCP2515Defs::DLC_MASK;
+    for (uint8_t i = 0; i < 8; i++) {
+      f.data[i] = buf[5 + i];
+    }
+    return f;
+  }
+
+  static void encodeFrame(const Frame &f, uint8_t *buf) {
+    buf[0] = (uint8_t)(f.id >> 3);
+    buf[1] = (uint8_t)((f.id & 0x07) << 5);
+    buf[2] = 0;
+    buf[3] = 0;
+    buf[4] = f.len;
+    for (uint8_t i = 0; i < 8; i++) {
+      buf[5 + i] = f.data[i];
+    }
+  }
+
+  uint8_t csPin;
+  uint8_t intPin;
+  bool selected = false;
+  uint8_t pos = 0;
+  uint8_t instr = 0;
+  uint8_t addr = 0;
+  uint8_t bitMask = 0;
+  int onBus = -1; ///< 送信中 (取り消せない) のバッファ
+};
+
+/**
+ * @class MockSPITransport
+ * @brief MockMCP2515 へ接続する SPITransport
+ *
+ * 1バイトあたり SPI クロックでのシフト時間、1トランザクションあたり
+ * overheadNs だけ仮想時計を進めます。
+ *
+ * deferAsync を true にすると、transferAsync() は転送を保留して戻り、
+ * completeAsync() で転送と完了コールバックを行います (DMA 転送中に
+ * 割り込みが入る順序を再現するため)。
+ */
+class MockSPITransport : public SPITransport {
+public:
+  MockSPITransport(MockMCP2515 &dev, uint32_t spiClockHz, uint32_t overhead)
+      : device(dev), clockHz(spiClockHz), overheadNs(overhead) {}
+
+  void begin() override {}
+
+  void transfer(const uint8_t *tx, uint8_t *rx, uint16_t len) override {
+    syncTransfers++;
+    shift(tx, rx, len);
+  }
+
+  bool transferAsync(const uint8_t *tx, uint8_t *rx, uint16_t len,
+                     Callback callback, void *ctx) override {
+    if (!deferAsync) {
+      shift(tx, rx, len);
+      if (callback != nullptr) {
+        callback(ctx);
+      }
+      return true;
+    }
+    if (pending) {
+      return false;
+    }
+    pending = true;
+    pendingTx = tx;
+    pendingRx = rx;
+    pendingLen = len;
+    pendingCallback = callback;
+    pendingCtx = ctx;
+    return true;
+  }
+
+  bool busy() const override { return pending; }
+
+  /**
+   * @brief 保留中の非同期転送を実行し、完了コールバックを呼ぶ
+   * @return true: 実行した, false: 保留中の転送なし
+   */
+  bool completeAsync() {
+    if (!pending) {
+      return false;
+    }
+    shift(pendingTx, pendingRx, pendingLen);
+    pending = false;
+    if (pendingCallback != nullptr) {
+      pendingCallback(pendingCtx);
+    }
+    return true;
+  }
+
+  bool deferAsync = false;    ///< 非同期転送を completeAsync() まで保留する
+  uint32_t syncTransfers = 0; ///< 同期転送 (transfer()) の回数
+
+private:
+  void shift(const uint8_t *tx, uint8_t *rx, uint16_t len) {
+    HostClock::advanceNs(overheadNs);
+    device.select();
+    for (uint16_t i = 0; i < len; i++) {
+      HostClock::advanceNs(8000000000ULL / clockHz);
+      rx[i] = device.exchange(tx[i]);
+    }
+    device.deselect();
+  }
+
+  MockMCP2515 &device;
+  uint32_t clockHz;
+  uint32_t overheadNs;
+  bool pending = false;
+  const uint8_t *pendingTx = nullptr;
+  uint8_t *pendingRx = nullptr;
+  uint16_t pendingLen = 0;
+  Callback pendingCallback = nullptr;
+  void *pendingCtx = nullptr;
+};
+
+#endif // MOCK_MCP2515_H
@@ -0,0 +1,150 @@
+#ifndef PEDAL_TRACE_H
+#define PEDAL_TRACE_H
+
+/**
+ * @file PedalTrace.h
+ * @brief ホストテスト用のペダル信号 (ADC 変換値) の合成
+ * @date 2026-10-19
+ *
+ * ペダル位置の真値 (12bit LSB, 小数を含む) にガウスノイズを加え、
+ * ADC と同じく整数 (0〜4095) に丸めた変換値の列を作ります。
+ * 乱数は種から決定的に生成するため、同じ条件なら同じ結果になります。
+ */
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @struct TracePoint
+ * @brief フィルタ出力の記録 (値は 12bit LSB)
+ */
+struct TracePoint {
+  double t;     ///< 時刻 (s)
+  double truth; ///< 真値
+  double value; ///< フィルタ出力
+};
+
+/**
+ * @class PedalTrace
+ * @brief ノイズ付きの ADC 変換値の生成
+ */
+class PedalTrace {
+public:
+  /**
+   * @brief コンストラクタ
+   * @param seed 乱数の種
+   * @param noiseLsb ノイズの標準偏差 (12bit LSB)
+   */
+  PedalTrace(uint32_t seed, float noiseLsb) : rng(seed), sigma(noiseLsb) {}
+
+  /// 標準正規分布の乱数 (Box-Muller)
+  float gaussian() {
+    if (hasSpare) {
+      hasSpare = false;
+      return spare;
+    }
+    float u1 = (next() + 1.0f) / 4294967296.0f;
+    float u2 = next() / 4294967296.0f;
+    float r = sqrtf(-2.0f * logf(u1));
+    spare = r * sinf(6.2831853f * u2);
+    hasSpare = true;
+    return r * cosf(6.2831853f * u2);
+  }
+
+  /// 真値 (12bit LSB) → ノイズを加えて丸めた変換値
+  uint16_t convert(float level) {
+    float v = roundf(level + sigma * gaussian());
+    return (uint16_t)(v < 0.0f ? 0.0f : (v > 4095.0f ? 4095.0f : v));
+  }
+
+  /**
+   * @brief 区間の変換値を生成する
+   * @param level 時刻 (s) → 真値 (12bit LSB)
+   * @param t0 先頭サンプルの時刻 (s)
+   * @param sampleRateHz 1チャンネルあたりのサンプルレート (Hz)
+   * @param count サンプル数
+   */
+  template <class Level>
+  std::vector<uint16_t> generate(Level level, double t0, double sampleRateHz,
+                                 uint16_t count) {
+    std::vector<uint16_t> out(count);
+    for (uint16_t i = 0; i < count; i++) {
+      out[i] = convert(level(t0 + i / sampleRateHz));
+    }
+    return out;
+  }
+
+  /**
+   * @brief 変換値をブロックごとにチャンネルへ渡し、出力を記録する
+   *
+   * サンプリングタスク (blockSamples ごとの putSamples()) と、
+   * blocksPerReport ブロックごとの入力レポートの作成を模擬します。
+   *
+   * @param ch 入力チャンネル (putSamples() / getFiltered())
+   * @param level 時刻 (s) → 真値 (12bit LSB)
+   * @param seconds 記録する時間 (s)
+   * @param sampleRateHz 1チャンネルあたりのサンプルレート (Hz)
+   * @param blockSamples 1回に渡すサンプル数
+   * @param blocksPerReport 出力を記録する間隔 (ブロック数)
+   * @return 記録 (出力は 16bit 基準を 12bit LSB に換算)
+   */
+  template <class Channel, class Level>
+  std::vector<TracePoint> record(Channel &ch, Level level, double seconds,
+                                 double sampleRateHz, uint16_t blockSamples,
+                                 uint16_t blocksPerReport) {
+    std::vector<TracePoint> out;
+    const double block = blockSamples / sampleRateHz;
+    int blocks = (int)(seconds / block + 0.5);
+    for (int b = 0; b < blocks; b++) {
+      double t0 = b * block;
+      std::vector<uint16_t> s = generate(level, t0, sampleRateHz, blockSamples);
+      ch.putSamples(s.data(), blockSamples, 1);
+      int value;
+      if ((b + 1) % blocksPerReport == 0 && ch.getFiltered(value)) {
+        double t = t0 + block;
+        out.push_back({t, level(t), value / 16.0});
+      }
+    }
+    return out;
+  }
+
+private:
+  uint32_t next() {
+    // xorshift32
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+  }
+
+  uint32_t rng;
+  float sigma;
+  float spare = 0.0f;
+  bool hasSpare = false;
+};
+
+/**
+ * @struct TraceStats
+ * @brief 値の列の平均・標準偏差
+ */
+struct TraceStats {
+  double mean;
+  double stddev;
+
+  static TraceStats of(const std::vector<double> &values) {
+    double sum = 0.0;
+    for (double v : values) {
+      sum += v;
+    }
+    double mean = values.empty() ? 0.0 : sum / values.size();
+    double sq = 0.0;
+    for (double v : values) {
+      sq += (v - mean) * (v - mean);
+    }
+    double sd = values.empty() ? 0.0 : sqrt(sq / values.size());
+    return TraceStats{mean, sd};
+  }
+};
+
+#endif // PEDAL_TRACE_H
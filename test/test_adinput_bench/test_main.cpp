@@ -0,0 +1,102 @@
+/**
+ * @file test_main.cpp
+ * @brief ADInputChannel<N> と ADInputChannelDynamic の比較 (出力と処理時間)
+ * @date 2026-10-19
+ *
+ * 同じ変換値の列を両方のチャンネルへ渡し、出力が一致することと、
+ * 1サンプルあたりの処理時間 (間引きなし = 全サンプルを移動平均へ) を
+ * ホスト PC で計ります。移動平均の操作は ADInputChannelImpl から静的に
+ * 呼ばれるため、差はバッファの添字と平均の計算 (マスク・シフト / 剰余・除算)
+ * だけです。
+ *
+ * 実行: pio test -e native -f test_adinput_bench -v
+ */
+
+#include "ADInput.h"
+#include "PedalTrace.h"
+#include "config.h"
+#include <chrono>
+#include <unity.h>
+
+/// サンプリングタスクの周期で渡すサンプル数 (1チャンネル, 250us 分)
+static constexpr uint16_t BLOCK_SAMPLES =
+    (uint16_t)(Config::Adc::DMA_SAMPLE_RATE_HZ / 2 *
+               Config::Time::SAMPLING_INTERVAL_US / 1000000);
+/// 計測するサンプル数
+static constexpr int SAMPLES = 1 << 20;
+
+static std::vector<uint16_t> input;
+
+/// putSamples() の1サンプルあたりの処理時間 (ns)
+static double timePerSample(ADInputChannelBase &ch, uint8_t stride) {
+  ch.Init();
+  const int count = SAMPLES / stride;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i + BLOCK_SAMPLES <= count; i += BLOCK_SAMPLES) {
+    ch.putSamples(&input[(size_t)i * stride], BLOCK_SAMPLES, stride);
+  }
+  auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start)
+                .count();
+  int value;
+  TEST_ASSERT_TRUE(ch.getFiltered(value));
+  return (double)ns / count;
+}
+
+static void report(const char *name, double ns) {
+  char line[96];
+  snprintf(line, sizeof(line), "%-30s %6.2f ns/sample", name, ns);
+  TEST_MESSAGE(line);
+}
+
+void setUp() {}
+void tearDown() {}
+
+/**
+ * @brief 同じ入力に対して両方のチャンネルの出力が一致する
+ */
+void test_variants_agree() {
+  ADInputChannel<Config::Adc::AVERAGE_COUNT> fixed(
+      26, nullptr, Config::Adc::DECIMATION_SHIFT);
+  ADInputChannelDynamic dynamic(26, Config::Adc::AVERAGE_COUNT, nullptr,
+                                Config::Adc::DECIMATION_SHIFT);
+  fixed.Init();
+  dynamic.Init();
+  for (int i = 0; i + BLOCK_SAMPLES <= SAMPLES; i += BLOCK_SAMPLES) {
+    fixed.putSamples(&input[i], BLOCK_SAMPLES, 1);
+    dynamic.putSamples(&input[i], BLOCK_SAMPLES, 1);
+    int a = -1, b = -1;
+    TEST_ASSERT_EQUAL(fixed.getFiltered(a), dynamic.getFiltered(b));
+    TEST_ASSERT_EQUAL_INT(a, b);
+    TEST_ASSERT_EQUAL_INT(fixed.getRawLatest(), dynamic.getRawLatest());
+  }
+}
+
+/**
+ * @brief 1サンプルあたりの処理時間 (1チャンネル / 2チャンネル交互)
+ */
+void test_cost_per_sample() {
+  ADInputChannel<Config::Adc::AVERAGE_COUNT> fixed(26, nullptr, 0);
+  ADInputChannelDynamic dynamic(26, Config::Adc::AVERAGE_COUNT, nullptr, 0);
+  report("ADInputChannel<N>", timePerSample(fixed, 1));
+  report("ADInputChannelDynamic", timePerSample(dynamic, 1));
+  // DMA のリングと同じく2チャンネルが交互に並ぶ場合
+  report("ADInputChannel<N> stride 2", timePerSample(fixed, 2));
+  report("ADInputChannelDynamic stride 2", timePerSample(dynamic, 2));
+}
+
+int main() {
+  PedalTrace trace(4242, 1.5f);
+  input.resize(SAMPLES);
+  for (int i = 0; i < SAMPLES; i++) {
+    // 1000 → 3000 LSB の三角波 (周期 4096 サンプル)
+    int phase = i & 4095;
+    float level = 1000.0f + (phase < 2048 ? phase : 4096 - phase) * 0.977f;
+    input[i] = trace.convert(level);
+  }
+
+  UNITY_BEGIN();
+  RUN_TEST(test_variants_agree);
+  RUN_TEST(test_cost_per_sample);
+  return UNITY_END();
+}
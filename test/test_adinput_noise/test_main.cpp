@@ -0,0 +1,160 @@
+/**
+ * @file test_main.cpp
+ * @brief ペダル入力 (間引き + 移動平均) のノイズ付き合成信号での確認
+ * @date 2026-10-19
+ *
+ * ADC の変換値 (σ = 1.5 LSB のガウスノイズ) を、実機と同じ設定
+ * (各 64kHz, 64 サンプルの間引き, AVERAGE_COUNT の移動平均) で
+ * ADInputChannel へ渡し、静止時の分解能・揺らぎと踏み込み中の遅れを測ります。
+ * DMAADCSampler については、リング1周より長い停止 (フラッシュ書き込み) が
+ * オーバーランになることを確認します。
+ *
+ * 実行: pio test -e native -f test_adinput_noise -v
+ */
+
+#include "ADInput.h"
+#include "DMAADCSampler.h"
+#include "PedalTrace.h"
+#include "config.h"
+#include <hardware/adc.h>
+#include <hardware/dma.h>
+#include <unity.h>
+
+/// 1チャンネルあたりのサンプルレート (Hz, アクセル・ブレーキの2入力)
+static constexpr double CHANNEL_RATE_HZ = Config::Adc::DMA_SAMPLE_RATE_HZ / 2;
+/// サンプリングタスクの周期で渡すサンプル数 (250us 分)
+static constexpr uint16_t BLOCK_SAMPLES =
+    (uint16_t)(CHANNEL_RATE_HZ * Config::Time::SAMPLING_INTERVAL_US / 1e6);
+/// 入力レポートの作成周期 (s)
+static constexpr double REPORT_PERIOD_S = 0.001;
+/// ADC のノイズ (12bit LSB)
+static constexpr float NOISE_LSB = 1.5f;
+
+/// 合成信号を250us ごとに渡し、1ms ごとに平滑化した値を記録する
+template <class Level>
+static std::vector<TracePoint>
+run(ADInputChannelBase &ch, PedalTrace &trace, Level level, double seconds) {
+  const double block = BLOCK_SAMPLES / CHANNEL_RATE_HZ;
+  return trace.record(ch, level, seconds, CHANNEL_RATE_HZ, BLOCK_SAMPLES,
+                      (uint16_t)(REPORT_PERIOD_S / block + 0.5));
+}
+
+static void report(const char *label, double value, const char *unit) {
+  char line[96];
+  snprintf(line, sizeof(line), "%-28s %8.3f %s", label, value, unit);
+  TEST_MESSAGE(line);
+}
+
+void setUp() {}
+void tearDown() {}
+
+/**
+ * @brief 静止時: ノイズがディザとして働き、1 LSB 未満の位置を区別できる
+ */
+void test_hold_resolution_and_jitter() {
+  ADInputChannel<Config::Adc::AVERAGE_COUNT> ch(26, nullptr,
+                                                Config::Adc::DECIMATION_SHIFT);
+  ch.Init();
+  PedalTrace trace(12345, NOISE_LSB);
+  const float level = 2000.25f;
+  auto samples = run(ch, trace, [&](double) { return level; }, 1.0);
+
+  std::vector<double> values;
+  for (const auto &s : samples) {
+    values.push_back(s.value);
+  }
+  TraceStats stats = TraceStats::of(values);
+  report("hold mean (true 2000.25)", stats.mean, "LSB");
+  report("hold jitter (raw 1.5)", stats.stddev, "LSB");
+  TEST_ASSERT_FLOAT_WITHIN(0.05, level, stats.mean);
+  // 128 サンプルの平均: 1.5 / sqrt(128) = 0.13 LSB
+  TEST_ASSERT_TRUE(stats.stddev < 0.2);
+}
+
+/**
+ * @brief 踏み込み中: 出力の遅れは 間引き (0.5ms) + 移動平均 (0.5ms) 程度
+ */
+void test_ramp_group_delay() {
+  ADInputChannel<Config::Adc::AVERAGE_COUNT> ch(26, nullptr,
+                                                Config::Adc::DECIMATION_SHIFT);
+  ch.Init();
+  PedalTrace trace(777, NOISE_LSB);
+  // 100ms 静止 → 60ms で 1000 → 3000 LSB → 静止
+  const double slope = 2000.0 / 0.060;
+  auto level = [&](double t) {
+    if (t < 0.100) {
+      return 1000.0f;
+    }
+    if (t < 0.160) {
+      return (float)(1000.0 + slope * (t - 0.100));
+    }
+    return 3000.0f;
+  };
+  auto samples = run(ch, trace, level, 0.3);
+
+  // 踏み込みの中央部分で (真値 - 出力) / 傾き の平均
+  std::vector<double> lags;
+  for (const auto &s : samples) {
+    if (s.t > 0.110 && s.t < 0.155) {
+      lags.push_back((s.truth - s.value) / slope * 1000.0);
+    }
+  }
+  TraceStats stats = TraceStats::of(lags);
+  report("ramp lag", stats.mean, "ms");
+  TEST_ASSERT_FLOAT_WITHIN(0.1, 1.0, stats.mean);
+}
+
+/**
+ * @brief リング1周 (8ms) より短い停止はサンプルを取りこぼさず、
+ *        フラッシュの消去 (数十ms) による停止はオーバーランになる
+ *
+ * DMA の書き込み位置はテストが進める (変換値は 0)。
+ */
+void test_sampler_ring_covers_short_stalls_only() {
+  ADInputChannel<Config::Adc::AVERAGE_COUNT> accel(26, nullptr, 0);
+  ADInputChannel<Config::Adc::AVERAGE_COUNT> brake(28, nullptr, 0);
+  DMAADCSampler sampler(Config::Adc::DMA_SAMPLE_RATE_HZ);
+  TEST_ASSERT_TRUE(sampler.attach(&accel));
+  TEST_ASSERT_TRUE(sampler.attach(&brake));
+  TEST_ASSERT_TRUE(sampler.begin());
+
+  // ADC FIFO から読むチャネルがデータチャネル
+  dma_channel_hw_t *data = nullptr;
+  for (dma_channel_hw_t &ch : dma_hw->ch) {
+    if (ch.read_addr == (uint32_t)(uintptr_t)&adc_hw->fifo) {
+      data = &ch;
+    }
+  }
+  TEST_ASSERT_NOT_NULL(data);
+  auto convertFor = [&](uint32_t us) {
+    uint32_t n = (uint32_t)((uint64_t)us * Config::Adc::DMA_SAMPLE_RATE_HZ /
+                            1000000);
+    data->write_addr += n * sizeof(uint16_t);
+    HostClock::advanceUs(us);
+    return n % DMAADCSampler::RING_SAMPLES;
+  };
+
+  // 通常の周期 (250us = 32 サンプル)
+  uint32_t n = convertFor(Config::Time::SAMPLING_INTERVAL_US);
+  TEST_ASSERT_EQUAL_UINT16(n, sampler.read());
+  // 7ms の遅れ (USB 処理など) は吸収する
+  n = convertFor(7000);
+  TEST_ASSERT_EQUAL_UINT16(n, sampler.read());
+  TEST_ASSERT_EQUAL_UINT32(0, sampler.getOverrunCount());
+
+  // LittleFS のセクタ消去 (標準 45ms) の間 Core 1 は停止する
+  convertFor(45000);
+  TEST_ASSERT_EQUAL_UINT16(0, sampler.read());
+  TEST_ASSERT_EQUAL_UINT32(1, sampler.getOverrunCount());
+  // 再開後は新しいサンプルから継続
+  n = convertFor(Config::Time::SAMPLING_INTERVAL_US);
+  TEST_ASSERT_EQUAL_UINT16(n, sampler.read());
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_hold_resolution_and_jitter);
+  RUN_TEST(test_ramp_group_delay);
+  RUN_TEST(test_sampler_ring_covers_short_stalls_only);
+  return UNITY_END();
+}
@@ -0,0 +1,193 @@
+/**
+ * @file test_main.cpp
+ * @brief ButtonBank (縦型カウンタ) の確認と 32 ボタンの処理時間
+ * @date 2026-10-19
+ *
+ * チャタリングを含む 32 ボタンの入力を、ボタンごとの 2bit カウンタで
+ * 書いた参照モデルと比べ、全サンプルで確定状態が一致することを確認します。
+ * また、同じ 32 ボタンを DigitalInputChannel × 32 (サンプリング方式) で
+ * 処理した場合と、1サンプルあたりの処理時間をホスト PC で比べます。
+ *
+ * 実行: pio test -e native -f test_button_bank -v
+ */
+
+#include "ButtonBank.h"
+#include "DigitalInput.h"
+#include <chrono>
+#include <unity.h>
+#include <vector>
+
+/// 計測するサンプル数
+static constexpr int SAMPLES = 1 << 20;
+
+/**
+ * @brief ボタンごとの 2bit カウンタ (参照モデル)
+ *
+ * 確定状態と異なる値が CONFIRM_SAMPLES 回連続すると反転し、
+ * 同じ値に戻るとカウンタを 0 に戻す。
+ */
+struct ReferenceBank {
+  uint32_t state = 0xFFFFFFFFu;
+  uint8_t counter[ButtonBank::MAX_BUTTONS] = {};
+
+  uint32_t update(uint32_t raw) {
+    for (uint8_t i = 0; i < ButtonBank::MAX_BUTTONS; i++) {
+      uint32_t bit = 1u << i;
+      if ((raw ^ state) & bit) {
+        counter[i] = (uint8_t)((counter[i] + 1) % ButtonBank::CONFIRM_SAMPLES);
+        if (counter[i] == 0) {
+          state ^= bit;
+        }
+      } else {
+        counter[i] = 0;
+      }
+    }
+    return state;
+  }
+};
+
+static uint32_t rng = 2463534242u;
+static uint32_t next() {
+  // xorshift32
+  rng ^= rng << 13;
+  rng ^= rng >> 17;
+  rng ^= rng << 5;
+  return rng;
+}
+
+/**
+ * @brief チャタリングを含む 32 ボタンの入力 (ビット i = ボタン i, 1 = HIGH)
+ *
+ * 各ボタンは平均 256 サンプルごとに押下・解放が切り替わり、
+ * 切り替わりの後 8 サンプルは 1/2 の確率で逆の値になる。
+ */
+static std::vector<uint32_t> bouncingInput(int count) {
+  std::vector<uint32_t> raw(count);
+  uint32_t level = 0xFFFFFFFFu;
+  uint8_t bounce[ButtonBank::MAX_BUTTONS] = {};
+  for (int n = 0; n < count; n++) {
+    uint32_t noise = 0;
+    for (uint8_t i = 0; i < ButtonBank::MAX_BUTTONS; i++) {
+      if ((next() & 0xFF) == 0) {
+        level ^= 1u << i;
+        bounce[i] = 8;
+      }
+      if (bounce[i] > 0) {
+        bounce[i]--;
+        noise |= (next() & 1) << i;
+      }
+    }
+    raw[n] = level ^ noise;
+  }
+  return raw;
+}
+
+static void report(const char *name, double ns) {
+  char line[96];
+  snprintf(line, sizeof(line), "%-26s %7.2f ns/sample (32 buttons)", name, ns);
+  TEST_MESSAGE(line);
+}
+
+void setUp() {}
+void tearDown() {}
+
+/**
+ * @brief 32 ボタンの確定状態が全サンプルで参照モデルと一致する
+ */
+void test_matches_per_button_model() {
+  ButtonBank bank(0, ButtonBank::MAX_BUTTONS);
+  ReferenceBank ref;
+  std::vector<uint32_t> raw = bouncingInput(200000);
+  uint32_t flips = 0;
+  uint32_t prev = bank.update(0xFFFFFFFFu);
+  ref.update(0xFFFFFFFFu);
+  for (uint32_t word : raw) {
+    uint32_t state = bank.update(word);
+    TEST_ASSERT_EQUAL_HEX32(ref.update(word), state);
+    flips += (uint32_t)__builtin_popcount(state ^ prev);
+    prev = state;
+  }
+  TEST_ASSERT_EQUAL_HEX32(~prev, bank.getPressedMask());
+  // 切り替わり (約 25000 回) のほとんどが確定している
+  TEST_ASSERT_TRUE(flips > 20000);
+}
+
+/**
+ * @brief 使用しないビット (count 以上) は入力によらず 0 のまま (押下にならない)
+ */
+void test_unused_bits_stay_released() {
+  ButtonBank bank(6, 8);
+  for (int i = 0; i < ButtonBank::CONFIRM_SAMPLES; i++) {
+    bank.update(0);
+  }
+  TEST_ASSERT_EQUAL_HEX32(0x000000FFu, bank.getPressedMask());
+  TEST_ASSERT_EQUAL(LOW, bank.getState(7));
+  uint32_t state = 0;
+  for (int i = 0; i < ButtonBank::CONFIRM_SAMPLES; i++) {
+    state = bank.update(0xFFFFFFFFu);
+  }
+  TEST_ASSERT_EQUAL_HEX32(0x000000FFu, state);
+  TEST_ASSERT_EQUAL_HEX32(0, bank.getPressedMask());
+}
+
+/**
+ * @brief 1サンプル (32 ボタン) あたりの処理時間
+ *
+ * DigitalInputChannel は GPIO (RP2040 は 30 本) を読み出すため、
+ * 32 チャンネルのピンは 30 本を繰り返して使う。入力の切り替わりは
+ * 64 サンプルごとにまとめて反映する (ピンのレベル設定を計測から外す)。
+ */
+void test_cost_32_buttons() {
+  std::vector<uint32_t> raw = bouncingInput(SAMPLES);
+  using Clock = std::chrono::steady_clock;
+  auto nsPerSample = [](Clock::time_point start, int count) {
+    return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(
+               Clock::now() - start)
+               .count() /
+           count;
+  };
+
+  ButtonBank bank(0, ButtonBank::MAX_BUTTONS);
+  volatile uint32_t sink = 0;
+  auto start = Clock::now();
+  for (int n = 0; n < SAMPLES; n++) {
+    sink = sink ^ bank.update(raw[n]);
+  }
+  double bankNs = nsPerSample(start, SAMPLES);
+
+  std::vector<DigitalInputChannel> channels;
+  channels.reserve(ButtonBank::MAX_BUTTONS);
+  for (uint8_t i = 0; i < ButtonBank::MAX_BUTTONS; i++) {
+    channels.emplace_back((uint8_t)(i % HostGpio::PIN_COUNT),
+                          ButtonBank::CONFIRM_SAMPLES);
+    channels.back().Init();
+  }
+  constexpr int BLOCK = 64;
+  double channelNs = 0.0;
+  for (int n = 0; n < SAMPLES; n += BLOCK) {
+    for (uint8_t pin = 0; pin < HostGpio::PIN_COUNT; pin++) {
+      HostGpio::level[pin] = (raw[n] >> pin) & 1;
+    }
+    start = Clock::now();
+    for (int k = 0; k < BLOCK; k++) {
+      uint32_t state = 0;
+      for (uint8_t i = 0; i < ButtonBank::MAX_BUTTONS; i++) {
+        state |= (uint32_t)channels[i].update() << i;
+      }
+      sink = sink ^ state;
+    }
+    channelNs += nsPerSample(start, SAMPLES);
+  }
+
+  report("ButtonBank", bankNs);
+  report("DigitalInputChannel x 32", channelNs);
+  TEST_ASSERT_TRUE(bankNs < channelNs);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_matches_per_button_model);
+  RUN_TEST(test_unused_bits_stay_released);
+  RUN_TEST(test_cost_32_buttons);
+  return UNITY_END();
+}
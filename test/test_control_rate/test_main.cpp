@@ -0,0 +1,300 @@
+/**
+ * @file test_main.cpp
+ * @brief トルク指令の周期と閉ループの安定性 (SteeringModule.md §6.4)
+ * @date 2026-10-19
+ *
+ * Control タスクと同じ手順 (CAN受信 → 角度の取得 → エフェクトの合算 →
+ * トルク指令) を、仮想時計と SimulatedMotorBus で実行します。
+ * 物理エフェクトのダンパ係数 (k_d) を上げていき、ハンドを離した状態で
+ * トルクが発散し始める k_d を、トルク指令の周期・ビットレート・
+ * エフェクト演算の倍率ごとに求めます。
+ * 既定の k_d (Config::Steer::DAMPER_COEFF) との比が安定余裕です。
+ * また、Periodic 系エフェクトの指令値 (指令の間の演算の平均) を倍率ごとに
+ * 比べます。
+ *
+ * 実行: pio test -e native -f test_control_rate -v
+ */
+
+#include "MF4015_Driver.h"
+#include "SimulatedMotorBus.h"
+#include "config.h"
+#include "control.h"
+#include "ffb_engine.h"
+#include <math.h>
+#include <unity.h>
+
+/// 受信・送信の確認間隔 (us)
+static constexpr uint32_t LOOP_STEP_US = 5;
+/// 1回の実行時間 (us)
+static constexpr uint32_t RUN_US = 600000;
+/// トルクの評価区間の開始 (us, 外乱の後)
+static constexpr uint32_t SETTLED_US = 400000;
+/// 外乱 (手で弾く) のトルク (N*m) と区間 (us)
+static constexpr float KICK_NM = 0.02f;
+static constexpr uint32_t KICK_START_US = 50000;
+static constexpr uint32_t KICK_END_US = 55000;
+/// 発散と判定するトルク (iq) の RMS
+static constexpr double UNSTABLE_IQ_RMS = 100.0;
+
+/**
+ * @struct RateMode
+ * @brief トルク指令の周期・エフェクト演算の周期とビットレート
+ *
+ * 表示名は「指令 / 演算」のレート。演算レート (kHz) が
+ * Config::Time::EFFECT_RATE_MULTIPLIER に当たる (基本周期 1ms)。
+ */
+struct RateMode {
+  const char *name;  ///< 表示名
+  uint32_t cmdUs;    ///< トルク指令の周期 (us)
+  uint32_t effectUs; ///< エフェクト演算の周期 (us, cmdUs の約数)
+  uint32_t bitrate;  ///< CAN ビットレート (bps)
+};
+
+static const RateMode MODE_1K_500K = {"1k/1k @500k", 1000, 1000, 500000};
+static const RateMode MODE_1K_E4_500K = {"1k/4k @500k", 1000, 250, 500000};
+static const RateMode MODE_1K_1M = {"1k/1k @1M", 1000, 1000, 1000000};
+static const RateMode MODE_1K_E2_1M = {"1k/2k @1M", 1000, 500, 1000000};
+static const RateMode MODE_1K_E4_1M = {"1k/4k @1M", 1000, 250, 1000000};
+static const RateMode MODE_2K_1M = {"2k/2k @1M", 500, 500, 1000000};
+static const RateMode MODE_2K_E4_1M = {"2k/4k @1M", 500, 250, 1000000};
+/// 予算超過 (指令・応答の2フレームが周期に収まらない)
+static const RateMode MODE_4K_1M = {"4k/4k @1M", 250, 250, 1000000};
+
+/**
+ * @brief ハンドを離した状態で外乱を与え、落ち着いた後のトルクの RMS を返す
+ */
+static double settledIqRms(const RateMode &mode, float kd) {
+  SimulatedMotorBus bus(Config::Steer::CAN_ID);
+  bus.setBitrate(mode.bitrate);
+  SimulatedMotorBus::Params params = bus.getParams();
+  params.inertia = 0.0005f;
+  params.coulombFriction = 0.002f;
+  params.viscousFriction = 0.0005f;
+  bus.setParams(params);
+  bus.begin();
+  MF4015_Driver motor(&bus, Config::Steer::CAN_ID);
+  motor.enable();
+  PhysicalEffect effect(0.0f, 0.0f, kd, 0.0f, mode.cmdUs);
+  FFBEngine engine(mode.cmdUs);
+  FFB_Shared_State_t effects[MAX_EFFECTS] = {};
+
+  const uint64_t startUs = HostClock::nowUs();
+  const uint32_t cmdDivider = mode.cmdUs / mode.effectUs;
+  uint32_t nextEffectUs = micros() + mode.effectUs;
+  uint32_t nextCmdUs = micros() + mode.cmdUs;
+  uint32_t effectTick = 0;
+  int16_t steer = 0;
+  double iqSquares = 0.0;
+  uint32_t samples = 0;
+  while (HostClock::nowUs() - startUs < RUN_US) {
+    const uint32_t t = (uint32_t)(HostClock::nowUs() - startUs);
+    bus.setExternalTorque((t >= KICK_START_US && t < KICK_END_US) ? KICK_NM
+                                                                  : 0.0f);
+    CANFrame frames[Config::Can::RX_BATCH_SIZE];
+    uint8_t count = bus.readFrames(frames, Config::Can::RX_BATCH_SIZE);
+    for (uint8_t i = 0; i < count; i++) {
+      motor.parseFrame(frames[i]);
+    }
+    if (motor.checkTorqueReplyUpdated()) {
+      steer = motor.getSteerHidValue();
+      effect.update(steer);
+      engine.updateMotion(steer);
+    }
+    motor.servicePolls(micros(), nextCmdUs);
+
+    if ((int32_t)(micros() - nextEffectUs) >= 0) {
+      nextEffectUs += mode.effectUs;
+      if (++effectTick % cmdDivider != 0) {
+        engine.samplePeriodic(effects); // 指令の間の演算
+      } else {
+        nextCmdUs += mode.cmdUs;
+        int32_t torque = engine.update(effects, steer) + effect.getEffect();
+        motor.setTorque((int16_t)torque);
+        if (t >= SETTLED_US) {
+          iqSquares += (double)bus.getIq() * bus.getIq();
+          samples++;
+        }
+      }
+    }
+    HostClock::advanceUs(LOOP_STEP_US);
+  }
+  return sqrt(iqSquares / samples);
+}
+
+static bool isStable(const RateMode &mode, float kd) {
+  return settledIqRms(mode, kd) < UNSTABLE_IQ_RMS;
+}
+
+/**
+ * @brief 発散し始める k_d (対数で二分探索, 誤差 1% 未満)
+ */
+static float criticalKd(const RateMode &mode) {
+  float stable = Config::Steer::DAMPER_COEFF;
+  float unstable = 1.0f;
+  TEST_ASSERT_TRUE(isStable(mode, stable));
+  TEST_ASSERT_FALSE(isStable(mode, unstable));
+  while (unstable / stable > 1.01f) {
+    float kd = sqrtf(stable * unstable);
+    if (isStable(mode, kd)) {
+      stable = kd;
+    } else {
+      unstable = kd;
+    }
+  }
+  return unstable;
+}
+
+static float reportMargin(const RateMode &mode) {
+  float kd = criticalKd(mode);
+  float margin = kd / Config::Steer::DAMPER_COEFF;
+  char line[96];
+  snprintf(line, sizeof(line), "%-12s critical k_d %.4f (margin x%.0f)",
+           mode.name, kd, margin);
+  TEST_MESSAGE(line);
+  return margin;
+}
+
+/**
+ * @struct PeriodicResult
+ * @brief Periodic 系エフェクトの指令値の平均と RMS (PID 単位)
+ */
+struct PeriodicResult {
+  double mean; ///< 指令値の平均 (折り返しによる直流分)
+  double rms;  ///< 平均を除いた RMS (振動の大きさ)
+};
+
+/// Periodic 系エフェクトの振幅 (PID 単位)
+static constexpr uint16_t PERIODIC_MAGNITUDE = 5000;
+
+/**
+ * @brief 正弦波エフェクト (初期位相 90度) の指令値を 200ms 分集計する
+ */
+static PeriodicResult periodicCommands(const RateMode &mode,
+                                       uint16_t periodMs) {
+  FFBEngine engine(mode.cmdUs);
+  FFB_Shared_State_t effects[MAX_EFFECTS] = {};
+  effects[0].type = HID_ET_SINE;
+  effects[0].gain = 255;
+  effects[0].periodicMagnitude = PERIODIC_MAGNITUDE;
+  effects[0].periodicPhase = 9000;
+  effects[0].periodicPeriod = periodMs;
+  effects[0].startTimeUs = micros();
+  effects[0].active = true;
+
+  const uint32_t cmdDivider = mode.cmdUs / mode.effectUs;
+  double sum = 0.0;
+  double squares = 0.0;
+  uint32_t count = 0;
+  for (uint32_t tick = 1; tick <= 200000 / mode.effectUs; tick++) {
+    HostClock::advanceUs(mode.effectUs);
+    if (tick % cmdDivider != 0) {
+      engine.samplePeriodic(effects);
+      continue;
+    }
+    double torque = engine.update(effects, 0);
+    sum += torque;
+    squares += torque * torque;
+    count++;
+  }
+  double mean = sum / count;
+  return PeriodicResult{mean, sqrt(squares / count - mean * mean)};
+}
+
+static PeriodicResult reportPeriodic(const RateMode &mode, uint16_t periodMs) {
+  PeriodicResult r = periodicCommands(mode, periodMs);
+  char line[96];
+  snprintf(line, sizeof(line), "%-12s sine %2ums: mean %6.0f, rms %6.0f",
+           mode.name, periodMs, r.mean, r.rms);
+  TEST_MESSAGE(line);
+  return r;
+}
+
+void setUp() {}
+void tearDown() {}
+
+/**
+ * @brief 速度推定の標本はトルク指令の応答 (0xA1) のみ
+ *
+ * 状態要求 (0x90 / 0x9C) の応答もエンコーダ位置を更新するが、
+ * 指令周期の途中に届くため、速度推定の標本にはしない。
+ */
+void test_only_torque_reply_is_sampled() {
+  SimulatedMotorBus bus(Config::Steer::CAN_ID);
+  MF4015_Driver motor(&bus, Config::Steer::CAN_ID);
+  uint8_t data[8] = {0, 25, 0, 0, 0, 0, 0x00, 0x20};
+  const uint8_t pollReplies[] = {0x9C, 0x90};
+  for (uint8_t cmd : pollReplies) {
+    data[0] = cmd;
+    data[7]++;
+    TEST_ASSERT_TRUE(motor.parseFrame(Config::Steer::CAN_ID, 8, data));
+    TEST_ASSERT_TRUE(motor.checkEncoderUpdated());
+    TEST_ASSERT_FALSE(motor.checkTorqueReplyUpdated());
+  }
+  data[0] = 0xA1;
+  data[7]++;
+  TEST_ASSERT_TRUE(motor.parseFrame(Config::Steer::CAN_ID, 8, data));
+  TEST_ASSERT_TRUE(motor.checkEncoderUpdated());
+  TEST_ASSERT_TRUE(motor.checkTorqueReplyUpdated());
+  TEST_ASSERT_FALSE(motor.checkTorqueReplyUpdated());
+}
+
+/**
+ * @brief トルク指令の周期・エフェクト演算の周期ごとの安定余裕
+ *
+ * - 予算内の周期・ビットレートでは既定の k_d で安定
+ * - 2kHz の余裕は 1kHz の 1.4 倍を超える
+ * - 4kHz は指令・応答の2フレームが周期に収まらず、2kHz より余裕が小さい
+ * - 演算レートを上げても余裕は下がらない (Condition 系・物理エフェクトは
+ *   指令ごとに最新の角度・速度で演算し、平均しない)
+ */
+void test_stability_margin_by_rate() {
+  float margin1k500 = reportMargin(MODE_1K_500K);
+  float margin1k500e4 = reportMargin(MODE_1K_E4_500K);
+  float margin1k = reportMargin(MODE_1K_1M);
+  float margin1ke2 = reportMargin(MODE_1K_E2_1M);
+  float margin1ke4 = reportMargin(MODE_1K_E4_1M);
+  float margin2k = reportMargin(MODE_2K_1M);
+  float margin2ke4 = reportMargin(MODE_2K_E4_1M);
+  float margin4k = reportMargin(MODE_4K_1M);
+
+  TEST_ASSERT_TRUE(margin1k500 > 1.0f);
+  TEST_ASSERT_TRUE(margin1k > 1.0f);
+  TEST_ASSERT_TRUE(margin2k > margin1k * 1.4f);
+  TEST_ASSERT_TRUE(margin4k < margin2k);
+  TEST_ASSERT_TRUE(margin1k500e4 >= margin1k500 * 0.99f);
+  TEST_ASSERT_TRUE(margin1ke2 >= margin1k * 0.99f);
+  TEST_ASSERT_TRUE(margin1ke4 >= margin1k * 0.99f);
+  TEST_ASSERT_TRUE(margin2ke4 >= margin2k * 0.99f);
+}
+
+/**
+ * @brief Periodic 系エフェクトの指令値 (演算レートごと)
+ *
+ * - 1ms 周期の正弦波は 1kHz 指令では毎回同じ位相で標本化され、
+ *   振幅がそのまま直流のトルクになる。演算 2kHz 以上では指令の間の平均で
+ *   消える
+ * - 10ms 周期の正弦波の振幅は、演算 4kHz でも 95% 以上残る
+ */
+void test_periodic_alias_by_multiplier() {
+  PeriodicResult e1 = reportPeriodic(MODE_1K_1M, 1);
+  PeriodicResult e2 = reportPeriodic(MODE_1K_E2_1M, 1);
+  PeriodicResult e4 = reportPeriodic(MODE_1K_E4_1M, 1);
+  TEST_ASSERT_TRUE(fabs(e1.mean) > PERIODIC_MAGNITUDE * 0.9);
+  TEST_ASSERT_TRUE(fabs(e2.mean) < PERIODIC_MAGNITUDE * 0.01);
+  TEST_ASSERT_TRUE(fabs(e4.mean) < PERIODIC_MAGNITUDE * 0.01);
+
+  reportPeriodic(MODE_1K_1M, 2);
+  reportPeriodic(MODE_1K_E4_1M, 2);
+
+  PeriodicResult slow1 = reportPeriodic(MODE_1K_1M, 10);
+  PeriodicResult slow4 = reportPeriodic(MODE_1K_E4_1M, 10);
+  TEST_ASSERT_TRUE(slow4.rms > slow1.rms * 0.95);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_only_torque_reply_is_sampled);
+  RUN_TEST(test_stability_margin_by_rate);
+  RUN_TEST(test_periodic_alias_by_multiplier);
+  return UNITY_END();
+}
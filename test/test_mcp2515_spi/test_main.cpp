@@ -0,0 +1,179 @@
+/**
+ * @file test_main.cpp
+ * @brief 0xA1 往復あたりの SPI 転送量・所要時間の計測 (模擬 MCP2515)
+ * @date 2026-10-19
+ *
+ * トルク指令 (0xA1) の送信から応答の取り出しまでを1往復とし、
+ * MCP2515_Driver (ネイティブ) と MCP2515_Wrapper (autowp ライブラリ) の
+ * SPI トランザクション数・バイト数・所要時間を比べます。
+ *
+ * 所要時間は SPI 10MHz (0.8us/バイト) に、トランザクションごとの
+ * 固定時間 TRANSACTION_OVERHEAD_NS (CS 操作・転送の準備) を加えた値です。
+ * CAN バス上の伝送時間は含みません。
+ *
+ * 実行: pio test -e native -f test_mcp2515_spi -v
+ */
+
+#include "MCP2515_Driver.h"
+#include "MockMCP2515.h"
+#include "config.h"
+#include <unity.h>
+
+#if __has_include(<mcp2515.h>)
+#include "MCP2515_Wrapper.h"
+#define HAS_AUTOWP 1
+#endif
+
+/// トランザクションごとの固定時間 (両実装で同じ値とする)
+static constexpr uint32_t TRANSACTION_OVERHEAD_NS = 1000;
+/// 往復の計測回数 (初回はバッファの TXP 設定を含むため除外)
+static constexpr int ROUND_TRIPS = 10;
+
+/**
+ * @struct RoundTrip
+ * @brief 1往復あたりの計測値
+ */
+struct RoundTrip {
+  uint32_t transactions;
+  uint32_t bytes;
+  double us;
+};
+
+static const uint8_t TORQUE_CMD[8] = {0xA1, 0, 0, 0, 0x64, 0x00, 0, 0};
+static const MockMCP2515::Frame TORQUE_REPLY = {
+    Config::Steer::CAN_ID, 8, {0xA1, 0x20, 0x64, 0, 0, 0, 0x00, 0x10}};
+
+/**
+ * @brief 0xA1 の往復を繰り返し、1往復あたりの平均を求める
+ */
+static RoundTrip measure(CANInterface &can, MockMCP2515 &dev) {
+  CANFrame frames[4];
+  RoundTrip total = {0, 0, 0.0};
+  for (int i = 0; i <= ROUND_TRIPS; i++) {
+    dev.resetCounters();
+    uint64_t start = HostClock::nowNs;
+
+    TEST_ASSERT_TRUE(can.queueFrame(Config::Steer::CAN_ID, 8, TORQUE_CMD,
+                                    CAN_TX_PRIO_URGENT, CAN_TX_SUPERSEDE_ID));
+    dev.transmitAll();
+    TEST_ASSERT_TRUE(dev.deliver(TORQUE_REPLY));
+    TEST_ASSERT_EQUAL_UINT8(1, can.readFrames(frames, 4));
+    TEST_ASSERT_EQUAL_HEX32(Config::Steer::CAN_ID, frames[0].id);
+    TEST_ASSERT_EQUAL_HEX8(0xA1, frames[0].data[0]);
+
+    if (i == 0) {
+      continue;
+    }
+    total.transactions += dev.transactions;
+    total.bytes += dev.bytes;
+    total.us += (HostClock::nowNs - start) / 1000.0;
+  }
+  TEST_ASSERT_EQUAL_UINT32(ROUND_TRIPS, dev.sent.size() - 1);
+  total.transactions /= ROUND_TRIPS;
+  total.bytes /= ROUND_TRIPS;
+  total.us /= ROUND_TRIPS;
+  return total;
+}
+
+static void report(const char *name, const RoundTrip &r) {
+  char line[96];
+  snprintf(line, sizeof(line), "%-16s %2u transactions, %3u bytes, %5.1f us",
+           name, (unsigned)r.transactions, (unsigned)r.bytes, r.us);
+  TEST_MESSAGE(line);
+}
+
+static RoundTrip measureNative() {
+  MockMCP2515 dev(Config::Pin::CAN_CS, Config::Pin::SPI_INT);
+  MockSPITransport spi(dev, Config::Can::SPI_CLOCK_HZ,
+                       TRANSACTION_OVERHEAD_NS);
+  MCP2515_Driver can(&spi, Config::Pin::SPI_INT);
+  TEST_ASSERT_TRUE(can.begin());
+  return measure(can, dev);
+}
+
+void setUp() {}
+void tearDown() {}
+
+/**
+ * @brief ネイティブドライバ: READ STATUS + LOAD TX BUFFER + RTS,
+ *        READ STATUS + READ RX BUFFER
+ */
+void test_native_round_trip() {
+  RoundTrip r = measureNative();
+  report("MCP2515_Driver", r);
+  TEST_ASSERT_EQUAL_UINT32(5, r.transactions);
+  TEST_ASSERT_EQUAL_UINT32(2 + 14 + 1 + 2 + 14, r.bytes);
+}
+
+/**
+ * @brief 送信の書き込み中に届いた応答: 割り込み側は非同期転送のみで進み、
+ *        受信時刻は保留した時刻ではなく INT のエッジの時刻
+ */
+void test_deferred_rx_keeps_edge_time() {
+  MockMCP2515 dev(Config::Pin::CAN_CS, Config::Pin::SPI_INT);
+  MockSPITransport spi(dev, Config::Can::SPI_CLOCK_HZ,
+                       TRANSACTION_OVERHEAD_NS);
+  MCP2515_Driver can(&spi, Config::Pin::SPI_INT);
+  TEST_ASSERT_TRUE(can.begin());
+  spi.deferAsync = true;
+  spi.syncTransfers = 0;
+
+  // READ STATUS の転送中に応答が届く (受信は送信手順の完了まで保留)
+  TEST_ASSERT_TRUE(can.queueFrame(Config::Steer::CAN_ID, 8, TORQUE_CMD,
+                                  CAN_TX_PRIO_URGENT, CAN_TX_SUPERSEDE_ID));
+  TEST_ASSERT_TRUE(spi.busy());
+  HostClock::advanceUs(10);
+  const uint32_t edgeUs = micros();
+  TEST_ASSERT_TRUE(dev.deliver(TORQUE_REPLY));
+  HostClock::advanceUs(30);
+
+  // READ STATUS → LOAD TX BUFFER → RTS → READ STATUS → READ RX BUFFER
+  int steps = 0;
+  while (spi.completeAsync()) {
+    steps++;
+  }
+  TEST_ASSERT_EQUAL_INT(5, steps);
+  TEST_ASSERT_EQUAL_UINT32(0, spi.syncTransfers);
+  dev.transmitAll();
+  TEST_ASSERT_EQUAL_UINT32(1, dev.sent.size());
+
+  CANFrame frames[2];
+  TEST_ASSERT_EQUAL_UINT8(1, can.readFrames(frames, 2));
+  TEST_ASSERT_EQUAL_HEX8(0xA1, frames[0].data[0]);
+  TEST_ASSERT_EQUAL_UINT32(edgeUs, frames[0].timestampUs);
+  TEST_ASSERT_TRUE(micros() - edgeUs > 40);
+}
+
+#ifdef HAS_AUTOWP
+/**
+ * @brief autowp ラッパー: レジスタ単位の READ / WRITE / BIT MODIFY
+ */
+void test_autowp_round_trip() {
+  MockMCP2515 dev(Config::Pin::CAN_CS, Config::Pin::SPI_INT);
+  dev.attachArduinoCs();
+  SPI.overheadNs = TRANSACTION_OVERHEAD_NS;
+  MCP2515_Wrapper can(Config::Pin::CAN_CS, Config::Pin::SPI_SCK,
+                      Config::Pin::SPI_TX, Config::Pin::SPI_RX,
+                      Config::Pin::SPI_INT);
+  TEST_ASSERT_TRUE(can.begin());
+  RoundTrip before = measure(can, dev);
+  HostGpio::onOutput = nullptr;
+  SPI.device = nullptr;
+  report("MCP2515_Wrapper", before);
+
+  RoundTrip after = measureNative();
+  TEST_ASSERT_LESS_THAN_UINT32(before.transactions, after.transactions);
+  TEST_ASSERT_LESS_THAN_UINT32(before.bytes, after.bytes);
+  TEST_ASSERT_TRUE(after.us < before.us);
+}
+#endif
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_native_round_trip);
+  RUN_TEST(test_deferred_rx_keeps_edge_time);
+#ifdef HAS_AUTOWP
+  RUN_TEST(test_autowp_round_trip);
+#endif
+  return UNITY_END();
+}
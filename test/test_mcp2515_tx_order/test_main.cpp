@@ -0,0 +1,161 @@
+/**
+ * @file test_main.cpp
+ * @brief MCP2515_Driver の送信順序 (同じ優先度は投入順) と指令の置き換えの確認
+ * @date 2026-10-19
+ *
+ * 模擬 MCP2515 は送信待ちのバッファを実機と同じ順序
+ * (TXP の高い順, 同じ TXP では番号の大きい順) で送出します。
+ * 送出するまで (transmitNext() を呼ぶまで) はバスが使用中の状態です。
+ *
+ * 実行: pio test -e native -f test_mcp2515_tx_order
+ */
+
+#include "MCP2515_Driver.h"
+#include "MockMCP2515.h"
+#include "config.h"
+#include <unity.h>
+
+static MockMCP2515 *dev;
+static MockSPITransport *spi;
+static MCP2515_Driver *can;
+
+static void queue(uint32_t id, CANTxPriority priority) {
+  const uint8_t data[8] = {(uint8_t)id, 0, 0, 0, 0, 0, 0, 0};
+  TEST_ASSERT_TRUE(can->queueFrame(id, 8, data, priority, CAN_TX_APPEND));
+}
+
+/// トルク指令 (0xA1) を MF4015_Driver と同じ指定で投入する
+static void queueTorque(uint8_t value) {
+  const uint8_t data[8] = {0xA1, 0, 0, 0, value, 0, 0, 0};
+  TEST_ASSERT_TRUE(can->queueFrame(Config::Steer::CAN_ID, 8, data,
+                                   CAN_TX_PRIO_URGENT, CAN_TX_SUPERSEDE_CMD));
+}
+
+/**
+ * @brief 1フレームずつ送出し、再試行間隔を空けて残りを書き込ませる
+ */
+static void drain() {
+  for (int i = 0; i < 16; i++) {
+    dev->transmitAll();
+    HostClock::advanceUs(200);
+    can->available();
+  }
+  dev->transmitAll();
+}
+
+static void assertSentOrder(const uint32_t *ids, size_t n) {
+  TEST_ASSERT_EQUAL_UINT32(n, dev->sent.size());
+  for (size_t i = 0; i < n; i++) {
+    TEST_ASSERT_EQUAL_HEX32(ids[i], dev->sent[i].id);
+  }
+}
+
+void setUp() {
+  dev = new MockMCP2515(Config::Pin::CAN_CS, Config::Pin::SPI_INT);
+  spi = new MockSPITransport(*dev, Config::Can::SPI_CLOCK_HZ, 1000);
+  can = new MCP2515_Driver(spi, Config::Pin::SPI_INT);
+  TEST_ASSERT_TRUE(can->begin());
+}
+
+void tearDown() {
+  delete can;
+  delete spi;
+  delete dev;
+}
+
+/**
+ * @brief 同じ優先度の3フレーム (全バッファ使用) は投入順に送信される
+ */
+void test_same_priority_keeps_fifo_order() {
+  queue(0x141, CAN_TX_PRIO_NORMAL);
+  queue(0x142, CAN_TX_PRIO_NORMAL);
+  queue(0x143, CAN_TX_PRIO_NORMAL);
+  dev->transmitAll();
+  const uint32_t expected[] = {0x141, 0x142, 0x143};
+  assertSentOrder(expected, 3);
+}
+
+/**
+ * @brief バッファ数を超える場合も、先に書き込んだフレームを追い越さない
+ */
+void test_overflow_waits_for_earlier_frames() {
+  for (uint32_t id = 0x141; id <= 0x146; id++) {
+    queue(id, CAN_TX_PRIO_LOW);
+  }
+  // 1フレームだけ送出: 空いた TXB2 に書くと残りの2フレームを追い越す
+  dev->transmitNext();
+  HostClock::advanceUs(200);
+  can->available();
+  dev->transmitAll();
+  TEST_ASSERT_EQUAL_UINT32(3, dev->sent.size());
+
+  drain();
+  const uint32_t expected[] = {0x141, 0x142, 0x143, 0x144, 0x145, 0x146};
+  assertSentOrder(expected, 6);
+}
+
+/**
+ * @brief 優先度の高いフレームは送信待ちの低優先度フレームより先に送信される
+ */
+void test_higher_priority_overtakes() {
+  queue(0x141, CAN_TX_PRIO_LOW);
+  queue(0x142, CAN_TX_PRIO_LOW);
+  queue(0x143, CAN_TX_PRIO_URGENT);
+  dev->transmitAll();
+  const uint32_t expected[] = {0x143, 0x141, 0x142};
+  assertSentOrder(expected, 3);
+}
+
+/**
+ * @brief 送信待ちのバッファにある古いトルク指令は、送信要求を取り消して
+ *        同じバッファで新しい指令に置き換える (全バッファ使用中でも)
+ */
+void test_pending_torque_replaced_in_buffer() {
+  // バスが他ノードで埋まっている間 (送出なし) に3バッファとも送信待ち
+  queueTorque(1);
+  queue(0x142, CAN_TX_PRIO_LOW);
+  queue(0x143, CAN_TX_PRIO_LOW);
+  queueTorque(2);
+  queueTorque(3);
+  TEST_ASSERT_EQUAL_UINT32(2, can->getTxStats().superseded);
+  TEST_ASSERT_EQUAL_UINT8(0, can->getTxStats().depth);
+
+  dev->transmitAll();
+  TEST_ASSERT_EQUAL_UINT32(3, dev->sent.size());
+  TEST_ASSERT_EQUAL_HEX32(Config::Steer::CAN_ID, dev->sent[0].id);
+  TEST_ASSERT_EQUAL_UINT8(3, dev->sent[0].data[4]);
+  TEST_ASSERT_EQUAL_HEX32(0x142, dev->sent[1].id);
+  TEST_ASSERT_EQUAL_HEX32(0x143, dev->sent[2].id);
+}
+
+/**
+ * @brief 調停に勝って送信中の指令は取り消せないため、新しい指令はその後に送る
+ */
+void test_torque_on_bus_is_followed() {
+  queueTorque(1);
+  TEST_ASSERT_TRUE(dev->beginTransmit());
+  queueTorque(2);
+  TEST_ASSERT_EQUAL_UINT32(0, can->getTxStats().superseded);
+
+  dev->transmitAll();
+  TEST_ASSERT_EQUAL_UINT32(2, dev->sent.size());
+  TEST_ASSERT_EQUAL_UINT8(1, dev->sent[0].data[4]);
+  TEST_ASSERT_EQUAL_UINT8(2, dev->sent[1].data[4]);
+
+  // 次の指令は空いたバッファへ (取り消しの対象なし)
+  queueTorque(3);
+  dev->transmitAll();
+  TEST_ASSERT_EQUAL_UINT32(3, dev->sent.size());
+  TEST_ASSERT_EQUAL_UINT8(3, dev->sent[2].data[4]);
+  TEST_ASSERT_EQUAL_UINT32(0, can->getTxStats().superseded);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_same_priority_keeps_fifo_order);
+  RUN_TEST(test_overflow_waits_for_earlier_frames);
+  RUN_TEST(test_higher_priority_overtakes);
+  RUN_TEST(test_pending_torque_replaced_in_buffer);
+  RUN_TEST(test_torque_on_bus_is_followed);
+  return UNITY_END();
+}
@@ -0,0 +1,81 @@
+/**
+ * @file test_main.cpp
+ * @brief MotorGroup の登録台数の上限 (1周期のバス占有) の確認
+ * @date 2026-10-19
+ *
+ * 実行: pio test -e native -f test_motor_group
+ */
+
+#include "MotorGroup.h"
+#include "SimulatedMotorBus.h"
+#include "config.h"
+#include <unity.h>
+
+static SimulatedMotorBus *bus;
+static MF4015_Driver *drivers[MotorGroup::MAX_MOTORS];
+
+void setUp() {
+  bus = new SimulatedMotorBus(Config::Steer::CAN_ID);
+  for (uint8_t i = 0; i < MotorGroup::MAX_MOTORS; i++) {
+    drivers[i] = new MF4015_Driver(bus, MotorGroup::MOTOR_CAN_ID_BASE + 1 + i);
+  }
+}
+
+void tearDown() {
+  for (MF4015_Driver *d : drivers) {
+    delete d;
+  }
+  delete bus;
+}
+
+/// 登録できた台数
+static uint8_t addAll(MotorGroup &group) {
+  for (MF4015_Driver *d : drivers) {
+    group.addMotor(d);
+  }
+  return group.size();
+}
+
+/**
+ * @brief 1周期は (1 + 台数) フレーム (8バイト標準フレーム各 135bit)
+ */
+void test_cycle_bits() {
+  TEST_ASSERT_EQUAL_UINT32(2 * 135, MotorGroup::torqueCycleBits(1));
+  TEST_ASSERT_EQUAL_UINT32(5 * 135, MotorGroup::torqueCycleBits(4));
+}
+
+/**
+ * @brief 500kbps: 3台 (4 x 270us = 1080us) は 1ms 周期に収まらない
+ */
+void test_500kbps_caps_at_two_motors() {
+  bus->setBitrate(500000);
+  MotorGroup group(bus);
+  TEST_ASSERT_EQUAL_UINT8(2, addAll(group));
+}
+
+/**
+ * @brief 1Mbps: 4台 (5 x 135us = 675us) まで登録できる
+ */
+void test_1mbps_allows_four_motors() {
+  bus->setBitrate(1000000);
+  MotorGroup group(bus);
+  TEST_ASSERT_EQUAL_UINT8(4, addAll(group));
+}
+
+/**
+ * @brief 125kbps: 1台 (2 x 1080us) でも収まらない
+ */
+void test_125kbps_rejects_single_motor() {
+  bus->setBitrate(125000);
+  MotorGroup group(bus);
+  TEST_ASSERT_EQUAL_UINT8(0, addAll(group));
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_cycle_bits);
+  RUN_TEST(test_500kbps_caps_at_two_motors);
+  RUN_TEST(test_1mbps_allows_four_motors);
+  RUN_TEST(test_125kbps_rejects_single_motor);
+  return UNITY_END();
+}
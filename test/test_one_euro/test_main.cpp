@@ -0,0 +1,171 @@
+/**
+ * @file test_main.cpp
+ * @brief One-Euro フィルタと移動平均の比較 (ペダルの踏み込み信号)
+ * @date 2026-10-19
+ *
+ * 静止 → 60ms でフルストローク (アクセルの既定範囲) の踏み込み → 静止
+ * の合成信号 (σ = 1.5 LSB のノイズ) を実機と同じ設定で処理し、
+ * 踏み込み中の遅れと静止時の揺らぎを比べます。
+ * また、1サンプルあたりの処理時間をホスト PC で計ります。
+ *
+ * 実行: pio test -e native -f test_one_euro -v
+ */
+
+#include "ADInput.h"
+#include "PedalTrace.h"
+#include "config.h"
+#include <chrono>
+#include <unity.h>
+
+/// 1チャンネルあたりのサンプルレート (Hz, アクセル・ブレーキの2入力)
+static constexpr double CHANNEL_RATE_HZ = Config::Adc::DMA_SAMPLE_RATE_HZ / 2;
+/// サンプリングタスクの周期で渡すサンプル数 (250us 分)
+static constexpr uint16_t BLOCK_SAMPLES =
+    (uint16_t)(CHANNEL_RATE_HZ * Config::Time::SAMPLING_INTERVAL_US / 1e6);
+/// 入力レポートの作成周期 (ブロック数, 1ms)
+static constexpr uint16_t BLOCKS_PER_REPORT = 4;
+/// ADC のノイズ (12bit LSB)
+static constexpr float NOISE_LSB = 1.5f;
+
+// 踏み込み信号 (12bit LSB): アクセルの既定範囲を 60ms で踏み込む
+static constexpr double RELEASED = Config::Adc::ACCEL_MIN / 16.0;
+static constexpr double PRESSED = Config::Adc::ACCEL_MAX / 16.0;
+static constexpr double PRESS_START_S = 0.200;
+static constexpr double PRESS_TIME_S = 0.060;
+static constexpr double SLOPE = (PRESSED - RELEASED) / PRESS_TIME_S;
+
+static double pedalLevel(double t) {
+  if (t < PRESS_START_S) {
+    return RELEASED;
+  }
+  if (t < PRESS_START_S + PRESS_TIME_S) {
+    return RELEASED + SLOPE * (t - PRESS_START_S);
+  }
+  return PRESSED;
+}
+
+/**
+ * @struct FilterResult
+ * @brief 踏み込み中の遅れと静止時の揺らぎ
+ */
+struct FilterResult {
+  double lagMs;      ///< 踏み込み中の遅れ (ms)
+  double holdJitter; ///< 静止時の標準偏差 (12bit LSB)
+  double settleMs;   ///< 踏み込み終了から真値 ±1 LSB に入るまで (ms)
+};
+
+static FilterResult measure(ADInputChannelBase &ch) {
+  ch.Init();
+  PedalTrace trace(2024, NOISE_LSB);
+  std::vector<TracePoint> rec =
+      trace.record(ch, [](double t) { return (float)pedalLevel(t); }, 0.5,
+                   CHANNEL_RATE_HZ, BLOCK_SAMPLES, BLOCKS_PER_REPORT);
+
+  std::vector<double> lags;
+  std::vector<double> hold;
+  double settleS = -1.0;
+  const double pressEnd = PRESS_START_S + PRESS_TIME_S;
+  for (const TracePoint &p : rec) {
+    // 踏み込みの中央部分 (始まり・終わりの過渡を除く)
+    if (p.t > PRESS_START_S + 0.010 && p.t < pressEnd - 0.005) {
+      lags.push_back((p.truth - p.value) / SLOPE * 1000.0);
+    }
+    // 離した位置で十分に落ち着いた区間
+    if (p.t > 0.100 && p.t < PRESS_START_S) {
+      hold.push_back(p.value);
+    }
+    if (p.t >= pressEnd && fabs(p.value - PRESSED) > 1.0) {
+      settleS = -1.0;
+    } else if (p.t >= pressEnd && settleS < 0.0) {
+      settleS = p.t - pressEnd;
+    }
+  }
+  return FilterResult{TraceStats::of(lags).mean,
+                      TraceStats::of(hold).stddev, settleS * 1000.0};
+}
+
+static void report(const char *name, const FilterResult &r) {
+  char line[112];
+  snprintf(line, sizeof(line),
+           "%-16s lag %5.2f ms, hold jitter %5.3f LSB, settle %5.1f ms", name,
+           r.lagMs, r.holdJitter, r.settleMs);
+  TEST_MESSAGE(line);
+}
+
+static void useOneEuro(ADInputChannelBase &ch) {
+  ch.setOneEuro(Config::Adc::ONE_EURO_MIN_CUTOFF_HZ, Config::Adc::ONE_EURO_BETA,
+                Config::Adc::ONE_EURO_DCUTOFF_HZ,
+                Config::Adc::FILTER_SAMPLE_RATE_HZ);
+}
+
+void setUp() {}
+void tearDown() {}
+
+/**
+ * @brief One-Euro は静止時の揺らぎを移動平均の 1/3 以下に抑え、
+ *        踏み込み中の遅れは移動平均以下
+ *
+ * 速度の推定 (ONE_EURO_DCUTOFF_HZ で平滑化) が遅いと、踏み込みの始まりで
+ * 遮断周波数が上がりきらず、遅れが移動平均を超える (既定値の回帰検出)。
+ */
+void test_one_euro_lag_and_jitter() {
+  ADInputChannel<Config::Adc::AVERAGE_COUNT> average(
+      26, nullptr, Config::Adc::DECIMATION_SHIFT);
+  ADInputChannel<Config::Adc::AVERAGE_COUNT> oneEuro(
+      26, nullptr, Config::Adc::DECIMATION_SHIFT);
+  useOneEuro(oneEuro);
+
+  FilterResult avg = measure(average);
+  FilterResult oe = measure(oneEuro);
+  report("moving average", avg);
+  report("One-Euro", oe);
+
+  TEST_ASSERT_TRUE(oe.holdJitter * 3.0 < avg.holdJitter);
+  TEST_ASSERT_TRUE(oe.lagMs <= avg.lagMs);
+  // 踏み込みの終了から 5ms 以内に落ち着く
+  TEST_ASSERT_TRUE(oe.settleMs >= 0.0 && oe.settleMs <= 5.0);
+}
+
+/**
+ * @brief 1サンプルあたりの処理時間 (間引きなしで全サンプルをフィルタへ)
+ */
+void test_one_euro_cost_per_sample() {
+  constexpr int SAMPLES = 1 << 20;
+  std::vector<uint16_t> input(SAMPLES);
+  PedalTrace trace(99, NOISE_LSB);
+  for (int i = 0; i < SAMPLES; i++) {
+    input[i] = trace.convert((float)pedalLevel((i % 500) / 1000.0));
+  }
+
+  auto timePerSample = [&](ADInputChannelBase &ch) {
+    ch.Init();
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < SAMPLES; i += BLOCK_SAMPLES) {
+      ch.putSamples(&input[i], BLOCK_SAMPLES, 1);
+    }
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                  std::chrono::steady_clock::now() - start)
+                  .count();
+    int value;
+    TEST_ASSERT_TRUE(ch.getFiltered(value));
+    return (double)ns / SAMPLES;
+  };
+
+  ADInputChannel<Config::Adc::AVERAGE_COUNT> average(26, nullptr, 0);
+  ADInputChannel<Config::Adc::AVERAGE_COUNT> oneEuro(26, nullptr, 0);
+  useOneEuro(oneEuro);
+  double avgNs = timePerSample(average);
+  double oeNs = timePerSample(oneEuro);
+  char line[96];
+  snprintf(line, sizeof(line), "moving average %6.2f ns/sample", avgNs);
+  TEST_MESSAGE(line);
+  snprintf(line, sizeof(line), "One-Euro       %6.2f ns/sample", oeNs);
+  TEST_MESSAGE(line);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_one_euro_lag_and_jitter);
+  RUN_TEST(test_one_euro_cost_per_sample);
+  return UNITY_END();
+}
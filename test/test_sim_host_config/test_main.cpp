@@ -0,0 +1,294 @@
+/**
+ * @file test_main.cpp
+ * @brief ホストからの設定 (ベンダー定義 Feature Report) の反映と保存
+ * @date 2026-10-19
+ *
+ * ファームウェア (src/) を native_sim でビルドし、setup() / setup1() の後、
+ * HostUsb::setReport() で設定レポートを受信させてから、仮想時計を進めながら
+ * loop() (Core 0) と loop1() (Core 1) を交互に呼び出します。
+ * 設定の保存 (LittleFS の書き込み) は HostFs::writeStallUs だけ時計を進め、
+ * その間 Core 1 は止まります (実機のフラッシュ書き込みと同じ)。
+ *
+ * 実行: pio test -e native_sim -f test_sim_host_config
+ */
+
+#include "Ene1HandCont_IO.h"
+#include "MF4015_Driver.h"
+#include "SimulatedMotorBus.h"
+#include "config.h"
+#include "config_manager.h"
+#include "hidwffb.h"
+#include "shared_data.h"
+#include <LittleFS.h>
+#include <string.h>
+#include <unity.h>
+
+void setup();
+void loop();
+void setup1();
+void loop1();
+extern SimulatedMotorBus canWrapper; // main.cpp (CAN_BACKEND_SIM)
+extern MF4015_Driver mfMotor;        // main.cpp
+
+/// loop() / loop1() の呼び出し間隔 (us)
+static constexpr uint32_t LOOP_STEP_US = 5;
+
+/// 仮想時計で us だけ両コアを動かす
+static void runFor(uint32_t us) {
+  uint64_t end = HostClock::nowUs() + us;
+  while (HostClock::nowUs() < end) {
+    loop();
+    loop1();
+    HostClock::advanceUs(LOOP_STEP_US);
+  }
+}
+
+/// 設定レポートを受信させる (TinyUSB と同じくレポートIDを除いて渡す)
+template <class Report> static void sendFeature(const Report &report) {
+  HostUsb::setReport(report.reportId, HID_REPORT_TYPE_FEATURE,
+                     (const uint8_t *)&report + 1, sizeof(report) - 1);
+}
+
+/// 両ペダルへ同じ変換値 (12bit) を渡す (DMA の代わり, 間引き・平均を満たす量)
+static void feedPedals(uint16_t accel, uint16_t brake) {
+  static uint16_t block[512];
+  for (uint16_t &v : block) {
+    v = accel;
+  }
+  adAccel.putSamples(block, 512, 1);
+  for (uint16_t &v : block) {
+    v = brake;
+  }
+  adBrake.putSamples(block, 512, 1);
+}
+
+static void sendCalib(uint8_t mode) {
+  USB_Feature_PedalCalib_t report = {HID_ID_PEDAL_CALIB, mode};
+  sendFeature(report);
+}
+
+static uint8_t readCalibStatus() {
+  uint8_t buf[8] = {0};
+  uint16_t len = HostUsb::getReport(HID_ID_PEDAL_CALIB,
+                                    HID_REPORT_TYPE_FEATURE, buf, sizeof(buf));
+  TEST_ASSERT_EQUAL_UINT16(sizeof(USB_Feature_PedalCalib_t) - 1, len);
+  return buf[0];
+}
+
+static void sendSteerRange(uint16_t halfRangeDeg) {
+  USB_Feature_SteerRange_t report = {HID_ID_STEER_RANGE, halfRangeDeg};
+  sendFeature(report);
+}
+
+static uint16_t readSteerRange() {
+  uint8_t buf[8] = {0};
+  uint16_t len = HostUsb::getReport(HID_ID_STEER_RANGE,
+                                    HID_REPORT_TYPE_FEATURE, buf, sizeof(buf));
+  TEST_ASSERT_EQUAL_UINT16(sizeof(USB_Feature_SteerRange_t) - 1, len);
+  return (uint16_t)(buf[0] | (buf[1] << 8));
+}
+
+/// 書き込み時のモーターの iq 指令値
+static int16_t iqAtWrite = 0;
+
+void setUp() {}
+void tearDown() {}
+
+/**
+ * @brief Pedal Curve (0x20): 曲線を共有メモリへ書き込み、LUT を切り替えて保存する
+ */
+void test_host_sets_pedal_curve() {
+  const uint8_t seq = sharedData.pedalCurveSeq;
+  const uint32_t writes = HostFs::writeCount;
+  // 切り替え前は直線: ストローク中央 → HID 値の中央
+  TEST_ASSERT_UINT32_WITHIN(64, 32768, accelCurve.apply(32768));
+
+  USB_Feature_PedalCurve_t report = {};
+  report.reportId = HID_ID_PEDAL_CURVE;
+  report.pedal = HID_PEDAL_ACCEL;
+  report.type = PEDAL_CURVE_GAMMA;
+  report.param = 200; // y = t^2
+  sendFeature(report);
+  runFor(10000);
+
+  TEST_ASSERT_EQUAL_UINT8(PEDAL_CURVE_GAMMA, sharedData.accelCurve.type);
+  TEST_ASSERT_EQUAL_UINT16(200, sharedData.accelCurve.param);
+  TEST_ASSERT_EQUAL_UINT8(PEDAL_CURVE_LINEAR, sharedData.brakeCurve.type);
+  TEST_ASSERT_TRUE(sharedData.pedalCurveSeq != seq);
+  // Core 1 が切り替えた後: 中央 → 1/4
+  TEST_ASSERT_UINT32_WITHIN(256, 16384, accelCurve.apply(32768));
+  TEST_ASSERT_UINT32_WITHIN(64, 32768, brakeCurve.apply(32768));
+  // 保存済み
+  TEST_ASSERT_FALSE(sharedData.configSaveRequest);
+  TEST_ASSERT_EQUAL_UINT32(writes + 1, HostFs::writeCount);
+}
+
+/**
+ * @brief 範囲外のペダル番号・短いレポートは無視する
+ */
+void test_invalid_pedal_curve_ignored() {
+  const uint8_t seq = sharedData.pedalCurveSeq;
+  USB_Feature_PedalCurve_t report = {};
+  report.reportId = HID_ID_PEDAL_CURVE;
+  report.pedal = HID_PEDAL_COUNT;
+  report.type = PEDAL_CURVE_SCURVE;
+  sendFeature(report);
+  report.pedal = HID_PEDAL_BRAKE;
+  HostUsb::setReport(HID_ID_PEDAL_CURVE, HID_REPORT_TYPE_FEATURE,
+                     (const uint8_t *)&report + 1, 4);
+  runFor(10000);
+  TEST_ASSERT_EQUAL_UINT8(seq, sharedData.pedalCurveSeq);
+  TEST_ASSERT_EQUAL_UINT8(PEDAL_CURVE_LINEAR, sharedData.brakeCurve.type);
+}
+
+/**
+ * @brief Pedal Calibration (0x21): 観測 → 校正値の作成 → 保存
+ *
+ * 保存 (フラッシュ書き込み) の間はトルク 0 を保持している。
+ */
+void test_host_runs_pedal_calibration() {
+  // バネが手のトルクに抗してトルクを出している状態 (摩擦なし)
+  SimulatedMotorBus::Params params = canWrapper.getParams();
+  params.coulombFriction = 0.0f;
+  canWrapper.setParams(params);
+  canWrapper.setExternalTorque(0.015f);
+  runFor(500000);
+  TEST_ASSERT_TRUE(canWrapper.getIq() != 0);
+  HostFs::writeStallUs = 45000;
+  HostFs::onWrite = [] { iqAtWrite = canWrapper.getIq(); };
+  const uint32_t writes = HostFs::writeCount;
+  const uint8_t seq = sharedData.pedalCalibSeq;
+
+  // 観測中以外の終了要求は無視する
+  sendCalib(PEDAL_CALIB_FINISH);
+  runFor(5000);
+  TEST_ASSERT_EQUAL_UINT8(PEDAL_CALIB_IDLE, sharedData.pedalCalibMode);
+
+  sendCalib(PEDAL_CALIB_RUN);
+  runFor(5000);
+  TEST_ASSERT_EQUAL_UINT8(PEDAL_CALIB_RUN, sharedData.pedalCalibMode);
+  TEST_ASSERT_EQUAL_UINT8(PEDAL_CALIB_RUN, readCalibStatus());
+  feedPedals(1000, 500);
+  runFor(5000);
+  feedPedals(3000, 3500);
+  runFor(5000);
+
+  sendCalib(PEDAL_CALIB_FINISH);
+  runFor(20000);
+  TEST_ASSERT_EQUAL_UINT8(PEDAL_CALIB_IDLE, sharedData.pedalCalibMode);
+  TEST_ASSERT_EQUAL_UINT8(PEDAL_CALIB_IDLE, readCalibStatus());
+  TEST_ASSERT_TRUE(sharedData.pedalCalibSeq != seq);
+  TEST_ASSERT_EQUAL_UINT16(1000 << 4, sharedData.accelCalib.rawMin);
+  TEST_ASSERT_EQUAL_UINT16(3000 << 4, sharedData.accelCalib.rawMax);
+  TEST_ASSERT_EQUAL_UINT16(500 << 4, sharedData.brakeCalib.rawMin);
+  TEST_ASSERT_EQUAL_UINT16(3500 << 4, sharedData.brakeCalib.rawMax);
+
+  // 保存済み、書き込みの間はトルク 0、その後は出力を再開
+  TEST_ASSERT_EQUAL_UINT32(writes + 1, HostFs::writeCount);
+  TEST_ASSERT_EQUAL_INT16(0, iqAtWrite);
+  runFor(200000);
+  TEST_ASSERT_EQUAL_UINT8(0, sharedData.torqueHoldSeq);
+  TEST_ASSERT_TRUE(canWrapper.getIq() != 0);
+
+  HostFs::onWrite = nullptr;
+  HostFs::writeStallUs = 0;
+  canWrapper.setExternalTorque(0.0f);
+}
+
+/**
+ * @brief Steer Range (0x22): 有効角度範囲を変更して保存し、適用値を返す
+ *
+ * 範囲外の値は ANGLE_RANGE_DEG_MIN..MAX に丸める。
+ */
+void test_host_sets_steer_range() {
+  runFor(5000);
+  TEST_ASSERT_EQUAL_UINT16(mfMotor.getAngleRange(), readSteerRange());
+  const uint32_t writes = HostFs::writeCount;
+
+  sendSteerRange(450);
+  runFor(10000);
+  TEST_ASSERT_EQUAL_UINT16(450, sharedData.steerRangeDeg);
+  TEST_ASSERT_EQUAL_UINT16(450, mfMotor.getAngleRange());
+  TEST_ASSERT_EQUAL_UINT16(450, readSteerRange());
+  TEST_ASSERT_FALSE(sharedData.configSaveRequest);
+  TEST_ASSERT_EQUAL_UINT32(writes + 1, HostFs::writeCount);
+
+  sendSteerRange(5000);
+  runFor(10000);
+  TEST_ASSERT_EQUAL_UINT16(Config::Steer::ANGLE_RANGE_DEG_MAX,
+                           mfMotor.getAngleRange());
+  TEST_ASSERT_EQUAL_UINT16(Config::Steer::ANGLE_RANGE_DEG_MAX,
+                           readSteerRange());
+  sendSteerRange(0);
+  runFor(10000);
+  TEST_ASSERT_EQUAL_UINT16(Config::Steer::ANGLE_RANGE_DEG_MIN,
+                           mfMotor.getAngleRange());
+  TEST_ASSERT_EQUAL_UINT16(Config::Steer::ANGLE_RANGE_DEG_MIN,
+                           readSteerRange());
+  TEST_ASSERT_EQUAL_UINT32(writes + 3, HostFs::writeCount);
+
+  sendSteerRange(450);
+  runFor(10000);
+}
+
+/**
+ * @brief 保存ファイルは設定のみ (版付き) で、読み込みは実行中の状態を変えない
+ */
+void test_config_file_holds_settings_only() {
+  const std::vector<uint8_t> &file = HostFs::files["/config.bin"];
+  TEST_ASSERT_EQUAL_UINT32(sizeof(StoredConfig), file.size());
+  StoredConfig stored;
+  memcpy(&stored, file.data(), sizeof(stored));
+  TEST_ASSERT_EQUAL_HEX32(StoredConfig::MAGIC, stored.magic);
+  TEST_ASSERT_EQUAL_UINT16(StoredConfig::VERSION, stored.version);
+  TEST_ASSERT_EQUAL_UINT8(PEDAL_CURVE_GAMMA, stored.accelCurve.type);
+  TEST_ASSERT_EQUAL_UINT16(3000 << 4, stored.accelCalib.rawMax);
+  TEST_ASSERT_EQUAL_UINT16(450, stored.steerRangeDeg);
+
+  // 設定を書き換えてから読み込むと、設定だけが戻る
+  const uint8_t curveSeq = sharedData.pedalCurveSeq;
+  const uint8_t calibSeq = sharedData.pedalCalibSeq;
+  const uint32_t loops = sharedData.core1LoopCount;
+  sharedData.accelCalib = PedalCalibConfig{};
+  sharedData.accelCurve.type = PEDAL_CURVE_LINEAR;
+  sharedData.pedalCalibMode = PEDAL_CALIB_FAILED;
+  TEST_ASSERT_TRUE(ConfigManager::loadConfig());
+  TEST_ASSERT_EQUAL_UINT16(3000 << 4, sharedData.accelCalib.rawMax);
+  TEST_ASSERT_EQUAL_UINT8(PEDAL_CURVE_GAMMA, sharedData.accelCurve.type);
+  TEST_ASSERT_EQUAL_UINT8(PEDAL_CALIB_FAILED, sharedData.pedalCalibMode);
+  TEST_ASSERT_EQUAL_UINT8(curveSeq, sharedData.pedalCurveSeq);
+  TEST_ASSERT_EQUAL_UINT8(calibSeq, sharedData.pedalCalibSeq);
+  TEST_ASSERT_EQUAL_UINT32(loops, sharedData.core1LoopCount);
+  sharedData.pedalCalibMode = PEDAL_CALIB_IDLE;
+
+  // 版の異なるファイル・旧形式 (SharedData 全体) は読み込まない
+  std::vector<uint8_t> saved = file;
+  stored.version = StoredConfig::VERSION + 1;
+  const uint8_t *bytes = (const uint8_t *)&stored;
+  HostFs::files["/config.bin"].assign(bytes, bytes + sizeof(stored));
+  sharedData.accelCalib = PedalCalibConfig{};
+  TEST_ASSERT_FALSE(ConfigManager::loadConfig());
+  TEST_ASSERT_EQUAL_UINT16(0, sharedData.accelCalib.rawMax);
+  HostFs::files["/config.bin"].assign(sizeof(SharedData), 0);
+  TEST_ASSERT_FALSE(ConfigManager::loadConfig());
+  HostFs::files["/config.bin"] = saved;
+  TEST_ASSERT_TRUE(ConfigManager::loadConfig());
+}
+
+int main() {
+  Serial.echo = false;
+  HostFs::clear();
+  // 起動時の応答確認 (probe) は時刻を読みながら待つため、読み出しで進める
+  HostClock::readAdvanceNs = 1000;
+  setup();
+  setup1();
+  HostClock::readAdvanceNs = 0;
+
+  UNITY_BEGIN();
+  RUN_TEST(test_host_sets_pedal_curve);
+  RUN_TEST(test_invalid_pedal_curve_ignored);
+  RUN_TEST(test_host_runs_pedal_calibration);
+  RUN_TEST(test_host_sets_steer_range);
+  RUN_TEST(test_config_file_holds_settings_only);
+  return UNITY_END();
+}
@@ -0,0 +1,212 @@
+"""
+Hot Path Report - SRAM 配置 (HOT_PATH_IN_RAM) の効果の集計
+=========================================================
+HOT_PATH_IN_RAM の有無でビルドした2つのファームウェアを比べ、
+RAM の消費量と、周期処理の所要時間の変化を表にします。
+
+1. RAM の消費量 (ELF の比較)
+    python hot_path_report.py elf before.elf after.elf
+   フラッシュ (XIP) から SRAM へ移った関数・テーブルと、
+   .data / .bss / .text の増減を出力します。
+   arm-none-eabi-nm / arm-none-eabi-size を使用します
+   (PlatformIO のツールチェーン: ~/.platformio/packages/toolchain-*/bin)。
+
+2. 所要時間 (シリアルログの比較)
+    python hot_path_report.py log before.log after.log
+   ZONE_PROFILER_ENABLE + PHYSICAL_INPUT_DEBUG_ENABLE のビルドが
+   1秒ごとに出力する [ZONE] / [TASK] 行を集計します。
+
+出力は Markdown の表です (SteeringModule.md §6.5 に貼り付けられます)。
+"""
+
+import argparse
+import re
+import statistics
+import subprocess
+import sys
+
+# ============================================================
+# 定数
+# ============================================================
+NM = "arm-none-eabi-nm"
+SIZE = "arm-none-eabi-size"
+
+XIP_BASE = 0x10000000  # フラッシュ (XIP キャッシュ経由)
+XIP_END = 0x11000000
+SRAM_BASE = 0x20000000  # SRAM (264KB, SCRATCH_X/Y を含む)
+SRAM_END = 0x20042000
+
+# [ZONE] Control  N:1000 Min:40 Avg:52 Max:180 P99:96 Over:0
+ZONE_RE = re.compile(
+    r"\[ZONE\]\s+(\S+)\s+N:(\d+)\s+Min:(\d+)\s+Avg:(\d+)\s+Max:(\d+)"
+    r"\s+P99:(\d+)\s+Over:(\d+)")
+# [TASK] Control    N:1000 ExecMax:120 Over:0 Missed:0 LateMax:12
+TASK_RE = re.compile(
+    r"\[TASK\]\s+(\S+)\s+N:(\d+)\s+ExecMax:(\d+)\s+Over:(\d+)"
+    r"\s+Missed:(\d+)\s+LateMax:(\d+)")
+
+
+# ============================================================
+# ELF の比較
+# ============================================================
+def region(addr):
+    if XIP_BASE <= addr < XIP_END:
+        return "flash"
+    if SRAM_BASE <= addr < SRAM_END:
+        return "ram"
+    return "other"
+
+
+def parse_nm(text):
+    """nm -S -C の出力 → {名前: (領域, サイズ, 種別)} (サイズのある記号のみ)"""
+    symbols = {}
+    for line in text.splitlines():
+        parts = line.split(None, 3)
+        if len(parts) < 4:
+            continue
+        addr, size, kind, name = parts
+        try:
+            addr = int(addr, 16)
+            size = int(size, 16)
+        except ValueError:
+            continue
+        # Thumb の関数アドレスは bit0 が立っている
+        symbols[name] = (region(addr & ~1), size, kind)
+    return symbols
+
+
+def parse_size(text):
+    """size -A の出力 → {セクション名: バイト数}"""
+    sections = {}
+    for line in text.splitlines():
+        parts = line.split()
+        if len(parts) >= 2 and parts[0].startswith(".") and parts[1].isdigit():
+            sections[parts[0]] = int(parts[1])
+    return sections
+
+
+def moved_to_ram(before, after):
+    """フラッシュ → SRAM へ移った記号の一覧 [(名前, サイズ, 種別)]"""
+    moved = []
+    for name, (reg, size, kind) in after.items():
+        prev = before.get(name)
+        if reg == "ram" and prev is not None and prev[0] == "flash":
+            moved.append((name, size, kind))
+    moved.sort(key=lambda m: -m[1])
+    return moved
+
+
+def run_tool(tool, args):
+    try:
+        return subprocess.run([tool] + args, check=True, capture_output=True,
+                              text=True).stdout
+    except FileNotFoundError:
+        sys.exit(f"ERROR: {tool} が見つかりません。PATH を確認してください。")
+
+
+def report_elf(before_elf, after_elf):
+    nm_args = ["-S", "-C"]
+    before = parse_nm(run_tool(NM, nm_args + [before_elf]))
+    after = parse_nm(run_tool(NM, nm_args + [after_elf]))
+    moved = moved_to_ram(before, after)
+
+    code = sum(size for _, size, kind in moved if kind in "tTwW")
+    data = sum(size for _, size, kind in moved if kind not in "tTwW")
+    print("## SRAM へ移った関数・テーブル\n")
+    print("| 記号 | バイト |")
+    print("| :--- | ---: |")
+    for name, size, _ in moved:
+        print(f"| `{name}` | {size} |")
+    print(f"| **合計 (コード {code} + テーブル {data})** | **{code + data}** |")
+
+    size_before = parse_size(run_tool(SIZE, ["-A", before_elf]))
+    size_after = parse_size(run_tool(SIZE, ["-A", after_elf]))
+    print("\n## セクションの増減\n")
+    print("| セクション | 変更前 | 変更後 | 差 |")
+    print("| :--- | ---: | ---: | ---: |")
+    for sec in (".text", ".rodata", ".data", ".bss"):
+        b = size_before.get(sec, 0)
+        a = size_after.get(sec, 0)
+        print(f"| {sec} | {b} | {a} | {a - b:+d} |")
+
+
+# ============================================================
+# ログの比較
+# ============================================================
+def parse_log(text):
+    """[ZONE] / [TASK] 行 → {(種別, 名前): [1秒区間ごとの値の辞書]}"""
+    windows = {}
+    for line in text.splitlines():
+        m = ZONE_RE.search(line)
+        if m:
+            name, n, mn, avg, mx, p99, over = m.groups()
+            if int(n) == 0:
+                continue
+            windows.setdefault(("ZONE", name), []).append(
+                {"avg": int(avg), "max": int(mx), "p99": int(p99),
+                 "over": int(over)})
+            continue
+        m = TASK_RE.search(line)
+        if m:
+            name, n, exec_max, over, missed, late_max = m.groups()
+            # 累積値のため、最後の行が全区間の値になる
+            windows.setdefault(("TASK", name), []).append(
+                {"max": int(exec_max), "over": int(over),
+                 "missed": int(missed), "late": int(late_max)})
+    return windows
+
+
+def summarize(kind, samples):
+    """区間ごとの値 → (平均の中央値, p99 の最大, 最大値, 超過数)"""
+    if kind == "ZONE":
+        return (statistics.median(s["avg"] for s in samples),
+                max(s["p99"] for s in samples),
+                max(s["max"] for s in samples),
+                sum(s["over"] for s in samples))
+    last = samples[-1]
+    return (None, None, last["max"], last["over"])
+
+
+def fmt(value):
+    return "-" if value is None else f"{value:g}"
+
+
+def report_log(before_log, after_log):
+    with open(before_log, encoding="utf-8", errors="replace") as f:
+        before = parse_log(f.read())
+    with open(after_log, encoding="utf-8", errors="replace") as f:
+        after = parse_log(f.read())
+
+    print("| 区間 | Avg 前→後 | P99 前→後 | Max 前→後 | 超過 前→後 |")
+    print("| :--- | ---: | ---: | ---: | ---: |")
+    for key in sorted(set(before) & set(after)):
+        kind, name = key
+        b = summarize(kind, before[key])
+        a = summarize(kind, after[key])
+        cols = [f"{fmt(b[i])}→{fmt(a[i])}" for i in range(4)]
+        print(f"| {kind} {name} | " + " | ".join(cols) + " |")
+
+
+# ============================================================
+# エントリーポイント
+# ============================================================
+def main():
+    parser = argparse.ArgumentParser(
+        description="HOT_PATH_IN_RAM の有無によるRAM消費量・所要時間の比較")
+    sub = parser.add_subparsers(dest="mode", required=True)
+    p_elf = sub.add_parser("elf", help="ELF の比較 (RAM 消費量)")
+    p_elf.add_argument("before")
+    p_elf.add_argument("after")
+    p_log = sub.add_parser("log", help="シリアルログの比較 (所要時間)")
+    p_log.add_argument("before")
+    p_log.add_argument("after")
+    args = parser.parse_args()
+
+    if args.mode == "elf":
+        report_elf(args.before, args.after)
+    else:
+        report_log(args.before, args.after)
+
+
+if __name__ == "__main__":
+    main()